@@ -0,0 +1,691 @@
+#include "Bvh.h"
+#include "Parallel.h"
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QVarLengthArray>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BVH_USE_SSE
+#endif
+
+namespace {
+
+// 이보다 큰 구간은 작업 스레드로 나누어 구축
+constexpr int ParallelSubtreeSize = 16384;
+constexpr int ParallelBinningSize = 262144;
+
+// SAH 비용 (삼각형 교차 1 기준)
+constexpr float TraversalCost = 1.0f;
+
+inline QVector3D componentMin(const QVector3D& a, const QVector3D& b)
+{
+    return QVector3D(qMin(a.x(), b.x()), qMin(a.y(), b.y()), qMin(a.z(), b.z()));
+}
+
+inline QVector3D componentMax(const QVector3D& a, const QVector3D& b)
+{
+    return QVector3D(qMax(a.x(), b.x()), qMax(a.y(), b.y()), qMax(a.z(), b.z()));
+}
+
+struct Aabb {
+    QVector3D min = QVector3D(FLT_MAX, FLT_MAX, FLT_MAX);
+    QVector3D max = QVector3D(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    void grow(const QVector3D& point) { min = componentMin(min, point); max = componentMax(max, point); }
+    void grow(const Aabb& box) { min = componentMin(min, box.min); max = componentMax(max, box.max); }
+
+    float area() const {
+        QVector3D extent = max - min;
+        if (extent.x() < 0.0f) return 0.0f;
+        return extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x();
+    }
+};
+
+struct Bin {
+    Aabb bounds;
+    int count = 0;
+};
+
+// 세 축의 빈을 한 번에 채움
+struct BinSet {
+    Bin bins[3][Bvh::BinCount];
+};
+
+struct Split {
+    int axis = -1;
+    int bin = 0;            // 오른쪽 첫 빈
+    float cost = FLT_MAX;   // 왼쪽/오른쪽 (넓이 x 개수) 합
+};
+
+struct BuildContext {
+    const Aabb* triangleBounds;
+    const QVector3D* centroids;
+    quint32* order;
+    BvhNode* nodes;
+    std::atomic<int> nodeCount;
+    const std::atomic_bool* cancel;
+
+    bool isCancelled() const { return cancel && cancel->load(std::memory_order_relaxed); }
+};
+
+inline int binOf(float centroid, float centroidMin, float scale)
+{
+    return qBound(0, int((centroid - centroidMin) * scale), Bvh::BinCount - 1);
+}
+
+void computeBounds(const BuildContext& ctx, int first, int count, Aabb& bounds, Aabb& centroidBounds)
+{
+    auto accumulate = [&ctx](qsizetype begin, qsizetype end, Aabb& box, Aabb& centroidBox) {
+        for (qsizetype i = begin; i < end; ++i) {
+            quint32 triangle = ctx.order[i];
+            box.grow(ctx.triangleBounds[triangle]);
+            centroidBox.grow(ctx.centroids[triangle]);
+        }
+    };
+
+    if (count < ParallelBinningSize) {
+        accumulate(first, first + count, bounds, centroidBounds);
+        return;
+    }
+
+    QVector<Aabb> partial(Parallel::chunkCount(count, ParallelBinningSize / 4) * 2);
+    Parallel::forEachChunk(count, ParallelBinningSize / 4, [&](int chunk, qsizetype begin, qsizetype end) {
+        accumulate(first + begin, first + end, partial[chunk * 2], partial[chunk * 2 + 1]);
+    });
+    for (int i = 0; i < partial.size(); i += 2) {
+        bounds.grow(partial[i]);
+        centroidBounds.grow(partial[i + 1]);
+    }
+}
+
+Split findBestSplit(const BuildContext& ctx, int first, int count, const Aabb& centroidBounds)
+{
+    QVector3D extent = centroidBounds.max - centroidBounds.min;
+    float scale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        scale[axis] = extent[axis] > 0.0f ? Bvh::BinCount / extent[axis] : 0.0f;
+    }
+
+    auto fill = [&](qsizetype begin, qsizetype end, BinSet& set) {
+        for (qsizetype i = begin; i < end; ++i) {
+            quint32 triangle = ctx.order[i];
+            const QVector3D& centroid = ctx.centroids[triangle];
+            for (int axis = 0; axis < 3; ++axis) {
+                Bin& bin = set.bins[axis][binOf(centroid[axis], centroidBounds.min[axis], scale[axis])];
+                bin.bounds.grow(ctx.triangleBounds[triangle]);
+                ++bin.count;
+            }
+        }
+    };
+
+    // 큰 구간은 조각별로 빈을 채운 뒤 합침
+    BinSet set;
+    if (count < ParallelBinningSize) {
+        fill(first, first + count, set);
+    } else {
+        QVector<BinSet> partial(Parallel::chunkCount(count, ParallelBinningSize / 4));
+        Parallel::forEachChunk(count, ParallelBinningSize / 4, [&](int chunk, qsizetype begin, qsizetype end) {
+            fill(first + begin, first + end, partial[chunk]);
+        });
+        for (const BinSet& part : partial) {
+            for (int axis = 0; axis < 3; ++axis) {
+                for (int b = 0; b < Bvh::BinCount; ++b) {
+                    set.bins[axis][b].bounds.grow(part.bins[axis][b].bounds);
+                    set.bins[axis][b].count += part.bins[axis][b].count;
+                }
+            }
+        }
+    }
+
+    // 빈 경계마다 양쪽 비용을 누적 합으로 계산
+    Split best;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (scale[axis] == 0.0f) continue;
+
+        float leftArea[Bvh::BinCount - 1];
+        int leftCount[Bvh::BinCount - 1];
+        Aabb box;
+        int sum = 0;
+        for (int b = 0; b < Bvh::BinCount - 1; ++b) {
+            box.grow(set.bins[axis][b].bounds);
+            sum += set.bins[axis][b].count;
+            leftArea[b] = box.area();
+            leftCount[b] = sum;
+        }
+
+        box = Aabb();
+        sum = 0;
+        for (int b = Bvh::BinCount - 1; b > 0; --b) {
+            box.grow(set.bins[axis][b].bounds);
+            sum += set.bins[axis][b].count;
+            if (sum == 0 || leftCount[b - 1] == 0) continue;
+            float cost = leftArea[b - 1] * leftCount[b - 1] + box.area() * sum;
+            if (cost < best.cost) {
+                best.axis = axis;
+                best.bin = b;
+                best.cost = cost;
+            }
+        }
+    }
+    return best;
+}
+
+void subdivide(BuildContext& ctx, int nodeIndex, int first, int count)
+{
+    BvhNode& node = ctx.nodes[nodeIndex];
+
+    Aabb bounds, centroidBounds;
+    computeBounds(ctx, first, count, bounds, centroidBounds);
+    for (int axis = 0; axis < 3; ++axis) {
+        node.boundsMin[axis] = bounds.min[axis];
+        node.boundsMax[axis] = bounds.max[axis];
+    }
+    node.leftFirst = first;
+    node.count = count;
+
+    // 취소되면 남은 구간을 리프로 남기고 빠져나옴 (결과는 버려짐)
+    if (count <= 1 || ctx.isCancelled()) return;
+
+    Split split = findBestSplit(ctx, first, count, centroidBounds);
+    float leafCost = bounds.area() * count;
+    float splitCost = bounds.area() * TraversalCost + split.cost;
+
+    int middle;
+    if (split.axis >= 0 && (splitCost < leafCost || count > Bvh::MaxLeafSize)) {
+        const int axis = split.axis;
+        const float centroidMin = centroidBounds.min[axis];
+        const float scale = Bvh::BinCount / (centroidBounds.max[axis] - centroidBounds.min[axis]);
+        quint32* middlePointer = std::partition(ctx.order + first, ctx.order + first + count,
+            [&ctx, axis, centroidMin, scale, &split](quint32 triangle) {
+                return binOf(ctx.centroids[triangle][axis], centroidMin, scale) < split.bin;
+            });
+        middle = int(middlePointer - ctx.order);
+    } else if (count > Bvh::MaxLeafSize) {
+        // 중심이 모두 같은 삼각형들: 임의로 절반씩 나눔
+        middle = first + count / 2;
+    } else {
+        return;
+    }
+
+    const int leftCount = middle - first;
+    const int rightCount = count - leftCount;
+    const int left = ctx.nodeCount.fetch_add(2, std::memory_order_relaxed);
+    node.leftFirst = left;
+    node.count = 0;
+
+    if (count >= ParallelSubtreeSize) {
+        QFuture<void> right = QtConcurrent::run(QThreadPool::globalInstance(), [&ctx, left, middle, rightCount]() {
+            subdivide(ctx, left + 1, middle, rightCount);
+        });
+        subdivide(ctx, left, first, leftCount);
+        right.waitForFinished();
+    } else {
+        subdivide(ctx, left, first, leftCount);
+        subdivide(ctx, left + 1, middle, rightCount);
+    }
+}
+
+// 광선 (역방향은 0 성분을 아주 작은 값으로 바꿔 0 x 무한대가 나오지 않게 함)
+struct Ray {
+    QVector3D origin;
+    QVector3D direction;
+    float invDirection[3];
+#ifdef BVH_USE_SSE
+    __m128 originLanes;
+    __m128 invDirectionLanes;
+    __m128 xyzMask;
+#endif
+
+    Ray(const QVector3D& o, const QVector3D& d) : origin(o), direction(d) {
+        for (int axis = 0; axis < 3; ++axis) {
+            float component = d[axis];
+            if (qAbs(component) < 1e-20f) component = component < 0.0f ? -1e-20f : 1e-20f;
+            invDirection[axis] = 1.0f / component;
+        }
+#ifdef BVH_USE_SSE
+        originLanes = _mm_set_ps(0.0f, o.z(), o.y(), o.x());
+        invDirectionLanes = _mm_set_ps(0.0f, invDirection[2], invDirection[1], invDirection[0]);
+        xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+#endif
+    }
+};
+
+// 슬랩 검사. 교차하면 진입 거리를 entry에 기록
+inline bool intersectBox(const BvhNode& node, const Ray& ray, float maxDistance, float& entry)
+{
+#ifdef BVH_USE_SSE
+    // x, y, z 세 슬랩을 한 번에 계산. 4번째 성분은 노드의 정수 필드라 비트 마스크로 0으로 만듦
+    const __m128 boxMin = _mm_and_ps(_mm_loadu_ps(node.boundsMin), ray.xyzMask);
+    const __m128 boxMax = _mm_and_ps(_mm_loadu_ps(node.boundsMax), ray.xyzMask);
+    const __m128 t1 = _mm_mul_ps(_mm_sub_ps(boxMin, ray.originLanes), ray.invDirectionLanes);
+    const __m128 t2 = _mm_mul_ps(_mm_sub_ps(boxMax, ray.originLanes), ray.invDirectionLanes);
+    const __m128 nearLanes = _mm_min_ps(t1, t2);
+    const __m128 farLanes = _mm_max_ps(t1, t2);
+
+    __m128 nearMax = _mm_max_ss(nearLanes, _mm_shuffle_ps(nearLanes, nearLanes, _MM_SHUFFLE(1, 1, 1, 1)));
+    nearMax = _mm_max_ss(nearMax, _mm_movehl_ps(nearLanes, nearLanes));
+    __m128 farMin = _mm_min_ss(farLanes, _mm_shuffle_ps(farLanes, farLanes, _MM_SHUFFLE(1, 1, 1, 1)));
+    farMin = _mm_min_ss(farMin, _mm_movehl_ps(farLanes, farLanes));
+
+    const float tNear = _mm_cvtss_f32(nearMax);
+    const float tFar = _mm_cvtss_f32(farMin);
+#else
+    float tNear = -FLT_MAX;
+    float tFar = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        float t1 = (node.boundsMin[axis] - ray.origin[axis]) * ray.invDirection[axis];
+        float t2 = (node.boundsMax[axis] - ray.origin[axis]) * ray.invDirection[axis];
+        tNear = qMax(tNear, qMin(t1, t2));
+        tFar = qMin(tFar, qMax(t1, t2));
+    }
+#endif
+    entry = tNear;
+    return tFar >= tNear && tFar > 0.0f && tNear < maxDistance;
+}
+
+// Möller–Trumbore (양면). (0, maxDistance) 안에서 교차하면 true
+inline bool intersectTriangle(const QVector3D& v0, const QVector3D& edge1, const QVector3D& edge2,
+                              const Ray& ray, float maxDistance, float& t, float& u, float& v)
+{
+    QVector3D p = QVector3D::crossProduct(ray.direction, edge2);
+    float determinant = QVector3D::dotProduct(edge1, p);
+    if (determinant == 0.0f) return false;
+
+    float inverse = 1.0f / determinant;
+    QVector3D s = ray.origin - v0;
+    u = QVector3D::dotProduct(s, p) * inverse;
+    if (u < 0.0f || u > 1.0f) return false;
+
+    QVector3D q = QVector3D::crossProduct(s, edge1);
+    v = QVector3D::dotProduct(ray.direction, q) * inverse;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    t = QVector3D::dotProduct(edge2, q) * inverse;
+    return t > 0.0f && t < maxDistance;
+}
+
+inline float boxDistanceSquared(const BvhNode& node, const QVector3D& point)
+{
+    float distance = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        float value = point[axis];
+        if (value < node.boundsMin[axis]) {
+            distance += (node.boundsMin[axis] - value) * (node.boundsMin[axis] - value);
+        } else if (value > node.boundsMax[axis]) {
+            distance += (value - node.boundsMax[axis]) * (value - node.boundsMax[axis]);
+        }
+    }
+    return distance;
+}
+
+// 삼각형 위의 최근접점 (보로노이 영역 판별, 퇴화 삼각형은 꼭짓점/변으로 처리)
+QVector3D closestPointOnTriangle(const QVector3D& p, const QVector3D& a, const QVector3D& b, const QVector3D& c)
+{
+    const QVector3D ab = b - a;
+    const QVector3D ac = c - a;
+    const QVector3D ap = p - a;
+    float d1 = QVector3D::dotProduct(ab, ap);
+    float d2 = QVector3D::dotProduct(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    const QVector3D bp = p - b;
+    float d3 = QVector3D::dotProduct(ab, bp);
+    float d4 = QVector3D::dotProduct(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f && d1 - d3 > 0.0f) {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    const QVector3D cp = p - c;
+    float d5 = QVector3D::dotProduct(ab, cp);
+    float d6 = QVector3D::dotProduct(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f && d2 - d6 > 0.0f) {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f && (d4 - d3) + (d5 - d6) > 0.0f) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    float sum = va + vb + vc;
+    if (sum <= 0.0f) return a;
+    return a + ab * (vb / sum) + ac * (vc / sum);
+}
+
+struct StackEntry {
+    int node;
+    float distance;     // 광선: 진입 거리, 최근접점: 상자까지 거리 제곱
+};
+
+} // namespace
+
+Bvh::Bvh()
+{
+}
+
+void Bvh::clear()
+{
+    m_nodes.clear();
+    m_triangles.clear();
+    m_triangleIds.clear();
+    m_positions.clear();
+    m_indices.clear();
+    m_parents.clear();
+    m_leafOfSlot.clear();
+    m_slotOfTriangle.clear();
+}
+
+bool Bvh::build(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                const std::atomic_bool* cancel)
+{
+    clear();
+
+    const int triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    m_positions.resize(vertices.size());
+    m_indices = indices;
+    QVector3D* positions = m_positions.data();
+    Parallel::parallelFor(vertices.size(), 65536, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            positions[i] = vertices[i].position;
+        }
+    });
+
+    // 삼각형별 경계 상자와 중심
+    QVector<Aabb> triangleBounds(triangleCount);
+    QVector<QVector3D> centroids(triangleCount);
+    QVector<quint32> order(triangleCount);
+    Aabb* boundsData = triangleBounds.data();
+    QVector3D* centroidData = centroids.data();
+    quint32* orderData = order.data();
+    const unsigned int* indexData = indices.constData();
+    Parallel::parallelFor(triangleCount, 16384, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype t = begin; t < end; ++t) {
+            Aabb box;
+            box.grow(positions[indexData[t * 3]]);
+            box.grow(positions[indexData[t * 3 + 1]]);
+            box.grow(positions[indexData[t * 3 + 2]]);
+            boundsData[t] = box;
+            centroidData[t] = (box.min + box.max) * 0.5f;
+            orderData[t] = quint32(t);
+        }
+    });
+
+    // 분할 한 번에 노드 2개 → 최대 2N개 (0: 루트, 1: 비움)
+    m_nodes.resize(triangleCount * 2);
+    m_nodes[1] = BvhNode();
+
+    BuildContext ctx;
+    ctx.triangleBounds = boundsData;
+    ctx.centroids = centroidData;
+    ctx.order = orderData;
+    ctx.nodes = m_nodes.data();
+    ctx.nodeCount = 2;
+    ctx.cancel = cancel;
+
+    subdivide(ctx, 0, 0, triangleCount);
+
+    if (ctx.isCancelled()) {
+        clear();
+        return false;
+    }
+
+    m_nodes.resize(qMax(ctx.nodeCount.load(), 1));
+    m_nodes.squeeze();
+
+    // 리프 순서로 삼각형 재배치 (리프 검사가 연속 메모리를 읽도록)
+    m_triangles.resize(triangleCount);
+    m_triangleIds = order;
+    Triangle* triangles = m_triangles.data();
+    Parallel::parallelFor(triangleCount, 16384, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            quint32 t = orderData[i];
+            const QVector3D& v0 = positions[indexData[t * 3]];
+            triangles[i].v0 = v0;
+            triangles[i].edge1 = positions[indexData[t * 3 + 1]] - v0;
+            triangles[i].edge2 = positions[indexData[t * 3 + 2]] - v0;
+        }
+    });
+
+    qDebug() << "BVH built:" << triangleCount << "triangles," << m_nodes.size() << "nodes in"
+             << timer.elapsed() << "ms";
+    return true;
+}
+
+void Bvh::buildRefitTables()
+{
+    m_parents.fill(-1, m_nodes.size());
+    m_leafOfSlot.resize(m_triangles.size());
+    m_slotOfTriangle.resize(m_triangles.size());
+
+    for (int n = 0; n < m_nodes.size(); ++n) {
+        const BvhNode& node = m_nodes[n];
+        if (n == 1) continue;
+        if (node.isLeaf()) {
+            for (int i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+                m_leafOfSlot[i] = n;
+            }
+        } else {
+            m_parents[node.leftFirst] = n;
+            m_parents[node.leftFirst + 1] = n;
+        }
+    }
+    for (int i = 0; i < m_triangleIds.size(); ++i) {
+        m_slotOfTriangle[m_triangleIds[i]] = i;
+    }
+}
+
+void Bvh::refit(const QVector<VertexData>& meshVertices, const QVector<int>& vertices, const QVector<int>& triangles)
+{
+    if (m_nodes.isEmpty() || triangles.isEmpty()) return;
+    if (m_parents.isEmpty()) {
+        buildRefitTables();
+    }
+
+    for (int v : vertices) {
+        m_positions[v] = meshVertices[v].position;
+    }
+
+    // 바뀐 삼각형 다시 기록하고 속한 리프 수집
+    QVector<int> leaves;
+    leaves.reserve(triangles.size());
+    for (int t : triangles) {
+        const int slot = m_slotOfTriangle[t];
+        const QVector3D& v0 = m_positions[m_indices[t * 3]];
+        m_triangles[slot].v0 = v0;
+        m_triangles[slot].edge1 = m_positions[m_indices[t * 3 + 1]] - v0;
+        m_triangles[slot].edge2 = m_positions[m_indices[t * 3 + 2]] - v0;
+        leaves.append(m_leafOfSlot[slot]);
+    }
+    std::sort(leaves.begin(), leaves.end());
+    leaves.erase(std::unique(leaves.begin(), leaves.end()), leaves.end());
+
+    auto setBounds = [](BvhNode& node, const Aabb& box) {
+        for (int axis = 0; axis < 3; ++axis) {
+            node.boundsMin[axis] = box.min[axis];
+            node.boundsMax[axis] = box.max[axis];
+        }
+    };
+
+    // 리프 경계를 다시 구하고, 부모는 두 자식의 합으로 루트까지 (상자가 그대로면 멈춤)
+    BvhNode* nodes = m_nodes.data();
+    for (int leaf : leaves) {
+        Aabb box;
+        for (int i = nodes[leaf].leftFirst; i < nodes[leaf].leftFirst + nodes[leaf].count; ++i) {
+            const Triangle& triangle = m_triangles[i];
+            box.grow(triangle.v0);
+            box.grow(triangle.v0 + triangle.edge1);
+            box.grow(triangle.v0 + triangle.edge2);
+        }
+        setBounds(nodes[leaf], box);
+
+        for (int n = m_parents[leaf]; n >= 0; n = m_parents[n]) {
+            const BvhNode& left = nodes[nodes[n].leftFirst];
+            const BvhNode& right = nodes[nodes[n].leftFirst + 1];
+            Aabb parent;
+            for (int axis = 0; axis < 3; ++axis) {
+                parent.min[axis] = qMin(left.boundsMin[axis], right.boundsMin[axis]);
+                parent.max[axis] = qMax(left.boundsMax[axis], right.boundsMax[axis]);
+            }
+            bool unchanged = true;
+            for (int axis = 0; axis < 3; ++axis) {
+                unchanged = unchanged && nodes[n].boundsMin[axis] == parent.min[axis]
+                                      && nodes[n].boundsMax[axis] == parent.max[axis];
+            }
+            if (unchanged) break;
+            setBounds(nodes[n], parent);
+        }
+    }
+}
+
+void Bvh::updateTriangles(const QVector<unsigned int>& meshIndices, const QVector<int>& triangles)
+{
+    if (m_nodes.isEmpty() || meshIndices.size() != m_indices.size()) return;
+
+    for (int t : triangles) {
+        for (int corner = 0; corner < 3; ++corner) {
+            m_indices[t * 3 + corner] = meshIndices[t * 3 + corner];
+        }
+    }
+
+    // 위치는 그대로이므로 정점 없이 삼각형만 다시 기록
+    refit(QVector<VertexData>(), QVector<int>(), triangles);
+}
+
+bool Bvh::raycast(const QVector3D& origin, const QVector3D& direction, BvhHit& hit, float maxDistance,
+                  const SelectionSet* ignoredTriangles) const
+{
+    if (m_nodes.isEmpty()) return false;
+
+    const Ray ray(origin, direction);
+    const BvhNode* nodes = m_nodes.constData();
+    const Triangle* triangles = m_triangles.constData();
+
+    float best = maxDistance;
+    int bestIndex = -1;
+    float bestU = 0.0f, bestV = 0.0f;
+
+    QVarLengthArray<StackEntry, 64> stack;
+    float entry;
+    if (!intersectBox(nodes[0], ray, best, entry)) return false;
+    stack.append({ 0, entry });
+
+    while (!stack.isEmpty()) {
+        StackEntry current = stack.takeLast();
+        if (current.distance >= best) continue;
+
+        const BvhNode& node = nodes[current.node];
+        if (node.isLeaf()) {
+            for (int i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+                float t, u, v;
+                if (intersectTriangle(triangles[i].v0, triangles[i].edge1, triangles[i].edge2, ray, best, t, u, v)) {
+                    if (ignoredTriangles && ignoredTriangles->test(int(m_triangleIds[i]))) continue;
+                    best = t;
+                    bestIndex = i;
+                    bestU = u;
+                    bestV = v;
+                }
+            }
+            continue;
+        }
+
+        // 가까운 자식을 먼저 방문하도록 나중에 쌓음
+        float nearDistance, farDistance;
+        int nearChild = node.leftFirst;
+        int farChild = node.leftFirst + 1;
+        bool nearHit = intersectBox(nodes[nearChild], ray, best, nearDistance);
+        bool farHit = intersectBox(nodes[farChild], ray, best, farDistance);
+        if (nearHit && farHit && farDistance < nearDistance) {
+            std::swap(nearChild, farChild);
+            std::swap(nearDistance, farDistance);
+        }
+        if (farHit) {
+            stack.append({ farChild, farDistance });
+        }
+        if (nearHit) {
+            stack.append({ nearChild, nearDistance });
+        }
+    }
+
+    if (bestIndex < 0) return false;
+
+    hit.distance = best;
+    hit.triangle = m_triangleIds[bestIndex];
+    hit.u = bestU;
+    hit.v = bestV;
+    hit.position = origin + direction * best;
+    return true;
+}
+
+bool Bvh::closestPoint(const QVector3D& point, BvhClosestPoint& result, float maxDistance) const
+{
+    if (m_nodes.isEmpty()) return false;
+
+    const BvhNode* nodes = m_nodes.constData();
+    const Triangle* triangles = m_triangles.constData();
+
+    float best = maxDistance < FLT_MAX ? maxDistance * maxDistance : FLT_MAX;
+    int bestIndex = -1;
+    QVector3D bestPoint;
+
+    QVarLengthArray<StackEntry, 64> stack;
+    stack.append({ 0, boxDistanceSquared(nodes[0], point) });
+
+    while (!stack.isEmpty()) {
+        StackEntry current = stack.takeLast();
+        if (current.distance >= best) continue;
+
+        const BvhNode& node = nodes[current.node];
+        if (node.isLeaf()) {
+            for (int i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+                const Triangle& triangle = triangles[i];
+                QVector3D candidate = closestPointOnTriangle(point, triangle.v0,
+                                                             triangle.v0 + triangle.edge1,
+                                                             triangle.v0 + triangle.edge2);
+                float distance = (candidate - point).lengthSquared();
+                if (distance < best) {
+                    best = distance;
+                    bestIndex = i;
+                    bestPoint = candidate;
+                }
+            }
+            continue;
+        }
+
+        int nearChild = node.leftFirst;
+        int farChild = node.leftFirst + 1;
+        float nearDistance = boxDistanceSquared(nodes[nearChild], point);
+        float farDistance = boxDistanceSquared(nodes[farChild], point);
+        if (farDistance < nearDistance) {
+            std::swap(nearChild, farChild);
+            std::swap(nearDistance, farDistance);
+        }
+        if (farDistance < best) {
+            stack.append({ farChild, farDistance });
+        }
+        if (nearDistance < best) {
+            stack.append({ nearChild, nearDistance });
+        }
+    }
+
+    if (bestIndex < 0) return false;
+
+    result.distance = std::sqrt(best);
+    result.triangle = m_triangleIds[bestIndex];
+    result.position = bestPoint;
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <QVector>
+#include <QVector3D>
+#include <atomic>
+#include <cfloat>
+#include "Mesh.h"
+#include "SelectionSet.h"
+
+// 평탄화된 BVH 노드 (32바이트). 형제 노드는 항상 연속으로 배치되어 한 캐시 라인에 함께 들어감
+struct BvhNode {
+    float boundsMin[3];
+    qint32 leftFirst;       // 내부 노드: 왼쪽 자식 번호 (오른쪽은 +1), 리프: 첫 삼각형 위치
+    float boundsMax[3];
+    qint32 count;           // 리프의 삼각형 수 (0이면 내부 노드)
+
+    bool isLeaf() const { return count > 0; }
+};
+
+// 광선 교차 결과 (객체 공간)
+struct BvhHit {
+    float distance = FLT_MAX;       // 광선 매개변수 t (direction 길이 단위)
+    quint32 triangle = 0;           // 메시 인덱스 버퍼 순서의 삼각형 번호 (GPU 픽킹과 같음)
+    float u = 0.0f;                 // 무게중심 좌표 (두 번째, 세 번째 정점 가중치)
+    float v = 0.0f;
+    QVector3D position;
+};
+
+// 최근접점 결과 (객체 공간)
+struct BvhClosestPoint {
+    float distance = FLT_MAX;
+    quint32 triangle = 0;
+    QVector3D position;
+};
+
+// 삼각형 BVH (binned SAH)
+// 로드 후 작업 스레드에서 병렬로 구축하며, 측정/스냅용 CPU 광선 질의와 최근접점 질의에 사용
+class Bvh
+{
+public:
+    static constexpr int BinCount = 16;
+    static constexpr int MaxLeafSize = 8;
+
+    Bvh();
+
+    // 메시 데이터로 구축 (GL 호출 없음, 스레드 안전). cancel이 설정되면 중단하고 false 반환
+    bool build(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+               const std::atomic_bool* cancel = nullptr);
+    void clear();
+
+    bool isEmpty() const { return m_nodes.isEmpty(); }
+    int getNodeCount() const { return m_nodes.size(); }
+    int getTriangleCount() const { return m_triangles.size(); }
+
+    // 정점이 움직인 뒤 트리 구조는 그대로 두고 경계 상자만 다시 맞춤
+    // vertices: 움직인 정점, triangles: 모양이 바뀐 삼각형 (메시 삼각형 번호)
+    // 바뀐 리프에서 루트까지만 갱신하므로 비용은 바뀐 삼각형 수 x 트리 깊이
+    void refit(const QVector<VertexData>& meshVertices, const QVector<int>& vertices, const QVector<int>& triangles);
+
+    // 삼각형의 정점이 바뀐 뒤(위상 편집) 그 삼각형만 새 정점으로 다시 기록하고 리핏
+    // 삼각형은 원래 리프에 남으므로 편집이 많이 쌓이면 다시 구축하는 편이 질의가 빠름
+    void updateTriangles(const QVector<unsigned int>& meshIndices, const QVector<int>& triangles);
+
+    // maxDistance 이내의 첫 교차점 (양면). direction은 정규화되지 않아도 됨
+    // ignoredTriangles가 있으면 비트가 설정된 삼각형(숨긴 면 등)은 건너뜀
+    bool raycast(const QVector3D& origin, const QVector3D& direction, BvhHit& hit,
+                 float maxDistance = FLT_MAX, const SelectionSet* ignoredTriangles = nullptr) const;
+
+    // maxDistance 이내에서 point와 가장 가까운 표면 위의 점
+    bool closestPoint(const QVector3D& point, BvhClosestPoint& result, float maxDistance = FLT_MAX) const;
+
+    // 삼각형의 정점 번호/위치 (corner 0~2, 스냅용)
+    quint32 getVertexIndex(quint32 triangle, int corner) const { return m_indices[triangle * 3 + corner]; }
+    QVector3D getVertexPosition(quint32 vertex) const { return m_positions[vertex]; }
+
+private:
+    // 리프 순서로 재배치한 교차 검사용 삼각형
+    struct Triangle {
+        QVector3D v0;
+        QVector3D edge1;
+        QVector3D edge2;
+    };
+
+    QVector<BvhNode> m_nodes;           // 0번이 루트, 1번은 비워 형제 쌍을 짝수 번호에 맞춤
+    QVector<Triangle> m_triangles;
+    QVector<quint32> m_triangleIds;     // 리프 순서 → 메시 삼각형 번호
+    QVector<QVector3D> m_positions;
+    QVector<unsigned int> m_indices;
+
+    // 리핏용 역참조 (처음 리핏할 때 만듦)
+    QVector<qint32> m_parents;          // 노드 → 부모 (루트는 -1)
+    QVector<qint32> m_leafOfSlot;       // 리프 순서 위치 → 리프 노드
+    QVector<qint32> m_slotOfTriangle;   // 메시 삼각형 번호 → 리프 순서 위치
+
+    void buildRefitTables();
+};
+
+#endif // BVH_H
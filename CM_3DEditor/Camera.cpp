@@ -1,5 +1,6 @@
 #include "Camera.h"
 #include <QtMath>
+#include <cmath>
 
 Camera::Camera()
     : m_position(0, 0, 5)
@@ -10,6 +11,7 @@ Camera::Camera()
     , m_aspect(1.0f)
     , m_nearPlane(0.1f)
     , m_farPlane(1000.0f)
+    , m_projectionWindow(-1.0, -1.0, 2.0, 2.0)
     , m_viewMatrixDirty(true)
     , m_projectionMatrixDirty(true)
 {
@@ -67,6 +69,12 @@ void Camera::setProjectionType(ProjectionType type)
     invalidateProjectionMatrix();
 }
 
+void Camera::setProjectionWindow(const QRectF& window)
+{
+    m_projectionWindow = window;
+    invalidateProjectionMatrix();
+}
+
 void Camera::orbit(float deltaX, float deltaY)
 {
     float distance = getDistance();
@@ -148,6 +156,34 @@ QMatrix4x4 Camera::getViewProjectionMatrix() const
     return getProjectionMatrix() * getViewMatrix();
 }
 
+void Camera::getFrustumPlanes(QVector4D planes[6]) const
+{
+    extractFrustumPlanes(getViewProjectionMatrix(), planes);
+}
+
+void Camera::extractFrustumPlanes(const QMatrix4x4& viewProjection, QVector4D planes[6])
+{
+    // Gribb-Hartmann 방식: clip = M * p 에서 -w <= x,y,z <= w
+    QVector4D row0 = viewProjection.row(0);
+    QVector4D row1 = viewProjection.row(1);
+    QVector4D row2 = viewProjection.row(2);
+    QVector4D row3 = viewProjection.row(3);
+
+    planes[0] = row3 + row0;
+    planes[1] = row3 - row0;
+    planes[2] = row3 + row1;
+    planes[3] = row3 - row1;
+    planes[4] = row3 + row2;
+    planes[5] = row3 - row2;
+
+    for (int i = 0; i < 6; ++i) {
+        float length = planes[i].toVector3D().length();
+        if (length > 0.0f) {
+            planes[i] /= length;
+        }
+    }
+}
+
 void Camera::setDistance(float distance)
 {
     QVector3D direction = (m_position - m_target).normalized();
@@ -155,6 +191,49 @@ void Camera::setDistance(float distance)
     invalidateViewMatrix();
 }
 
+void Camera::frameBounds(const QVector3D& center, float radius, const QVector3D& direction, const QVector3D& up)
+{
+    // ViewerWidget::fitToView와 같은 거리 (반지름 * 2 * sqrt(3))
+    float distance = qMax(radius, 1e-4f) * 2.0f * std::sqrt(3.0f);
+    
+    m_target = center;
+    m_position = center + direction.normalized() * distance;
+    m_up = up;
+    invalidateViewMatrix();
+    
+    m_nearPlane = qMax(distance - radius * 1.5f, distance * 0.01f);
+    m_farPlane = distance + radius * 1.5f;
+    invalidateProjectionMatrix();
+}
+
+bool Camera::applyPreset(const QString& name, const QVector3D& center, float radius)
+{
+    QString preset = name.toLower();
+    if (preset == "iso") {
+        frameBounds(center, radius, QVector3D(1, 1, 1), QVector3D(0, 1, 0));
+    } else if (preset == "front") {
+        frameBounds(center, radius, QVector3D(0, 0, 1), QVector3D(0, 1, 0));
+    } else if (preset == "back") {
+        frameBounds(center, radius, QVector3D(0, 0, -1), QVector3D(0, 1, 0));
+    } else if (preset == "left") {
+        frameBounds(center, radius, QVector3D(-1, 0, 0), QVector3D(0, 1, 0));
+    } else if (preset == "right") {
+        frameBounds(center, radius, QVector3D(1, 0, 0), QVector3D(0, 1, 0));
+    } else if (preset == "top") {
+        frameBounds(center, radius, QVector3D(0, 1, 0), QVector3D(0, 0, -1));
+    } else if (preset == "bottom") {
+        frameBounds(center, radius, QVector3D(0, -1, 0), QVector3D(0, 0, 1));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QStringList Camera::getPresetNames()
+{
+    return { "iso", "front", "back", "left", "right", "top", "bottom" };
+}
+
 void Camera::updateViewMatrix() const
 {
     m_viewMatrix.setToIdentity();
@@ -174,6 +253,17 @@ void Camera::updateProjectionMatrix() const
         m_projectionMatrix.ortho(-halfWidth, halfWidth, -halfHeight, halfHeight, m_nearPlane, m_farPlane);
     }
     
+    // 부분 절두체: clip 공간에서 window를 -1..1로 옮기는 변환을 앞에 곱함 (원근/직교 공통)
+    if (m_projectionWindow != QRectF(-1.0, -1.0, 2.0, 2.0)) {
+        float scaleX = 2.0f / float(m_projectionWindow.width());
+        float scaleY = 2.0f / float(m_projectionWindow.height());
+        QMatrix4x4 crop;
+        crop.translate(-float(m_projectionWindow.center().x()) * scaleX,
+                       -float(m_projectionWindow.center().y()) * scaleY);
+        crop.scale(scaleX, scaleY, 1.0f);
+        m_projectionMatrix = crop * m_projectionMatrix;
+    }
+    
     m_projectionMatrixDirty = false;
 }
 
@@ -4,6 +4,9 @@
 #include <QVector3D>
 #include <QMatrix4x4>
 #include <QQuaternion>
+#include <QVector4D>
+#include <QStringList>
+#include <QRectF>
 
 class Camera
 {
@@ -24,6 +27,10 @@ public:
     void setNearPlane(float nearPlane);
     void setFarPlane(float farPlane);
     void setProjectionType(ProjectionType type);
+    
+    // 투영 결과 중 NDC 영역 window만 화면 전체로 확대 (타일 렌더링용, 기본값은 전체 -1..1)
+    void setProjectionWindow(const QRectF& window);
+    QRectF getProjectionWindow() const { return m_projectionWindow; }
 
     // 카메라 이동 및 회전
     void orbit(float deltaX, float deltaY);
@@ -35,6 +42,10 @@ public:
     QMatrix4x4 getViewMatrix() const;
     QMatrix4x4 getProjectionMatrix() const;
     QMatrix4x4 getViewProjectionMatrix() const;
+    
+    // 절두체 평면 (left, right, bottom, top, near, far; 법선은 안쪽, 정규화됨)
+    void getFrustumPlanes(QVector4D planes[6]) const;
+    static void extractFrustumPlanes(const QMatrix4x4& viewProjection, QVector4D planes[6]);
 
     // 카메라 정보
     QVector3D getPosition() const { return m_position; }
@@ -46,6 +57,13 @@ public:
     // 거리 계산
     float getDistance() const { return (m_target - m_position).length(); }
     void setDistance(float distance);
+    
+    // 경계 구가 화면에 들어오도록 주어진 방향에서 바라봄 (near/far도 맞춤)
+    void frameBounds(const QVector3D& center, float radius, const QVector3D& direction, const QVector3D& up);
+    
+    // 이름 있는 시점 프리셋 (iso, front, back, left, right, top, bottom)
+    bool applyPreset(const QString& name, const QVector3D& center, float radius);
+    static QStringList getPresetNames();
 
 private:
     // 카메라 속성
@@ -59,6 +77,7 @@ private:
     float m_aspect;
     float m_nearPlane;
     float m_farPlane;
+    QRectF m_projectionWindow;
     
     // 초기값 저장
     QVector3D m_initialPosition;
@@ -0,0 +1,56 @@
+#include "CameraPath.h"
+#include <QQuaternion>
+#include <QtMath>
+
+namespace {
+    // 균일 Catmull-Rom (p1~p2 구간, s는 0~1)
+    QVector3D catmullRom(const QVector3D& p0, const QVector3D& p1, const QVector3D& p2, const QVector3D& p3, float s)
+    {
+        float s2 = s * s;
+        float s3 = s2 * s;
+        return 0.5f * ((2.0f * p1)
+                       + (p2 - p0) * s
+                       + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * s2
+                       + (3.0f * p1 - p0 - 3.0f * p2 + p3) * s3);
+    }
+}
+
+void CameraPath::addKeyframe(const Camera& camera)
+{
+    m_keyframes.append({ camera.getPosition(), camera.getTarget(), camera.getUpVector() });
+}
+
+void CameraPath::evaluate(float t, Camera& camera) const
+{
+    if (m_keyframes.isEmpty()) return;
+
+    const int count = m_keyframes.size();
+    float position = qBound(0.0f, t, 1.0f) * float(count - 1);
+    int segment = qMin(int(position), qMax(count - 2, 0));
+    float s = position - float(segment);
+
+    // 양 끝은 끝점을 반복해 스플라인이 키프레임을 지나도록 함
+    auto key = [&](int index) -> const Keyframe& {
+        return m_keyframes[qBound(0, index, count - 1)];
+    };
+    const Keyframe& k0 = key(segment - 1);
+    const Keyframe& k1 = key(segment);
+    const Keyframe& k2 = key(segment + 1);
+    const Keyframe& k3 = key(segment + 2);
+
+    camera.setPosition(catmullRom(k0.position, k1.position, k2.position, k3.position, s));
+    camera.setTarget(catmullRom(k0.target, k1.target, k2.target, k3.target, s));
+
+    QVector3D up = k1.up * (1.0f - s) + k2.up * s;
+    camera.setUpVector(up.lengthSquared() > 0.0f ? up : k1.up);
+}
+
+void CameraPath::orbit(const Camera& start, float degrees, Camera& camera)
+{
+    QQuaternion rotation = QQuaternion::fromAxisAndAngle(start.getUpVector(), degrees);
+    QVector3D offset = start.getPosition() - start.getTarget();
+
+    camera.setTarget(start.getTarget());
+    camera.setPosition(start.getTarget() + rotation.rotatedVector(offset));
+    camera.setUpVector(start.getUpVector());
+}
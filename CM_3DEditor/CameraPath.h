@@ -0,0 +1,35 @@
+#ifndef CAMERAPATH_H
+#define CAMERAPATH_H
+
+#include <QVector>
+#include <QVector3D>
+#include "Camera.h"
+
+// 이미지 시퀀스 내보내기용 카메라 경로
+// 키프레임(위치/타깃/업 벡터)을 Catmull-Rom 스플라인으로 보간하거나, 타깃을 중심으로 한 바퀴 회전
+class CameraPath
+{
+public:
+    struct Keyframe {
+        QVector3D position;
+        QVector3D target;
+        QVector3D up;
+    };
+
+    void addKeyframe(const Camera& camera);
+    void clear() { m_keyframes.clear(); }
+    int getKeyframeCount() const { return m_keyframes.size(); }
+    bool isEmpty() const { return m_keyframes.isEmpty(); }
+    const QVector<Keyframe>& getKeyframes() const { return m_keyframes; }
+
+    // t(0~1)에서의 시점을 camera에 적용 (투영 설정은 유지)
+    void evaluate(float t, Camera& camera) const;
+
+    // 타깃을 지나는 업 벡터 축으로 degrees만큼 궤도 회전한 시점 적용
+    static void orbit(const Camera& start, float degrees, Camera& camera);
+
+private:
+    QVector<Keyframe> m_keyframes;
+};
+
+#endif // CAMERAPATH_H
@@ -0,0 +1,141 @@
+#include "DepthPyramid.h"
+#include "Shader.h"
+#include <QOpenGLContext>
+#include <QDebug>
+
+DepthPyramid::DepthPyramid()
+    : m_depthTexture(0)
+    , m_depthFramebuffer(0)
+    , m_pyramidTexture(0)
+    , m_levelCount(0)
+    , m_width(0)
+    , m_height(0)
+    , m_reduceShader(nullptr)
+{
+}
+
+DepthPyramid::~DepthPyramid()
+{
+    destroy();
+}
+
+bool DepthPyramid::create()
+{
+    if (isCreated()) return true;
+    if (!QOpenGLContext::currentContext()) return false;
+
+    initializeOpenGLFunctions();
+
+    m_reduceShader = Shader::createDepthReduceShader();
+    if (!m_reduceShader) {
+        qDebug() << "Failed to create depth reduction shader";
+        return false;
+    }
+
+    glGenFramebuffers(1, &m_depthFramebuffer);
+    return true;
+}
+
+void DepthPyramid::destroy()
+{
+    if (QOpenGLContext::currentContext()) {
+        if (m_depthTexture) glDeleteTextures(1, &m_depthTexture);
+        if (m_pyramidTexture) glDeleteTextures(1, &m_pyramidTexture);
+        if (m_depthFramebuffer) glDeleteFramebuffers(1, &m_depthFramebuffer);
+    }
+
+    m_depthTexture = 0;
+    m_pyramidTexture = 0;
+    m_depthFramebuffer = 0;
+    m_levelCount = 0;
+    m_width = 0;
+    m_height = 0;
+
+    delete m_reduceShader;
+    m_reduceShader = nullptr;
+}
+
+bool DepthPyramid::build(int width, int height)
+{
+    if (!isCreated() || width <= 1 || height <= 1) return false;
+
+    GLint drawFramebuffer = 0;
+    GLint readFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+
+    if (width != m_width || height != m_height) {
+        resize(width, height);
+    }
+
+    // 위젯의 프레임버퍼 깊이를 샘플링 가능한 텍스처로 복사
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, GLuint(drawFramebuffer));
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_depthFramebuffer);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, GLuint(readFramebuffer));
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GLuint(drawFramebuffer));
+
+    // 깊이 → 레벨 0 → 레벨 1 → ...
+    m_reduceShader->bind();
+    reduce(m_depthTexture, 0, 0);
+    for (int level = 1; level < m_levelCount; ++level) {
+        reduce(m_pyramidTexture, level - 1, level);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+void DepthPyramid::resize(int width, int height)
+{
+    if (m_depthTexture) glDeleteTextures(1, &m_depthTexture);
+    if (m_pyramidTexture) glDeleteTextures(1, &m_pyramidTexture);
+
+    m_width = width;
+    m_height = height;
+
+    glGenTextures(1, &m_depthTexture);
+    glBindTexture(GL_TEXTURE_2D, m_depthTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH24_STENCIL8, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+
+    int baseWidth = qMax(1, width / 2);
+    int baseHeight = qMax(1, height / 2);
+    m_levelCount = 1;
+    while ((qMax(baseWidth, baseHeight) >> m_levelCount) > 0) {
+        ++m_levelCount;
+    }
+
+    glGenTextures(1, &m_pyramidTexture);
+    glBindTexture(GL_TEXTURE_2D, m_pyramidTexture);
+    glTexStorage2D(GL_TEXTURE_2D, m_levelCount, GL_R32F, baseWidth, baseHeight);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_depthFramebuffer);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
+    if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        qDebug() << "Depth pyramid framebuffer is incomplete";
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+}
+
+void DepthPyramid::reduce(GLuint sourceTexture, int sourceLevel, int destLevel)
+{
+    int destWidth = qMax(1, (m_width / 2) >> destLevel);
+    int destHeight = qMax(1, (m_height / 2) >> destLevel);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, sourceTexture);
+    m_reduceShader->setUniformValue(m_reduceShader->getUniformLocation("sourceLevel"), sourceLevel);
+    glBindImageTexture(0, m_pyramidTexture, destLevel, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+    glDispatchCompute((destWidth + 7) / 8, (destHeight + 7) / 8, 1);
+
+    // 다음 레벨이 방금 쓴 레벨을 읽음
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
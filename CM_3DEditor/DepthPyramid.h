@@ -0,0 +1,47 @@
+#ifndef DEPTHPYRAMID_H
+#define DEPTHPYRAMID_H
+
+#include <QOpenGLExtraFunctions>
+
+class Shader;
+
+// 계층적 깊이 버퍼 (Hi-Z)
+// 현재 프레임버퍼의 깊이를 복사한 뒤 컴퓨트 쉐이더로 2x2 최대값 밉 체인을 만듦
+// 레벨 0은 원본의 절반 해상도이며, 각 텍셀은 덮는 화면 영역의 가장 먼 깊이를 가짐
+class DepthPyramid : protected QOpenGLExtraFunctions
+{
+public:
+    DepthPyramid();
+    ~DepthPyramid();
+
+    bool create();
+    void destroy();
+    bool isCreated() const { return m_reduceShader != nullptr; }
+
+    // 현재 바인딩된 프레임버퍼의 깊이로 피라미드 생성 (프레임버퍼 바인딩은 복원됨)
+    bool build(int width, int height);
+
+    GLuint getTextureId() const { return m_pyramidTexture; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getLevelCount() const { return m_levelCount; }
+
+private:
+    // 원본 깊이 복사본 (위젯 프레임버퍼와 같은 D24S8 형식이어야 blit 가능)
+    GLuint m_depthTexture;
+    GLuint m_depthFramebuffer;
+
+    // R32F 밉 체인
+    GLuint m_pyramidTexture;
+    int m_levelCount;
+
+    int m_width;
+    int m_height;
+
+    Shader* m_reduceShader;
+
+    void resize(int width, int height);
+    void reduce(GLuint sourceTexture, int sourceLevel, int destLevel);
+};
+
+#endif // DEPTHPYRAMID_H
@@ -0,0 +1,529 @@
+#include "EditHistory.h"
+#include <QDebug>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+    static_assert(sizeof(QVector3D) == 3 * sizeof(float), "QVector3D must be tightly packed");
+    static_assert(sizeof(VertexData) == 11 * sizeof(float), "VertexData must be tightly packed");
+    static_assert(sizeof(MeshCluster) == 6 * sizeof(float), "MeshCluster must be tightly packed");
+
+    // 메시 전체 기록의 머리: 정점, 인덱스, 클러스터, 재배치, 숨김 워드 수 + 경계 상자와 반지름
+    const int MeshHeaderUnits = 5 + 7;
+
+    // 원소 하나가 차지하는 4바이트 값 수 (번호 간격 제외)
+    int valuesPerElement(EditDelta::Kind kind)
+    {
+        switch (kind) {
+            case EditDelta::Vertices:
+                return 6;
+            case EditDelta::Triangles:
+                return 3;
+            default:
+                return 2;
+        }
+    }
+
+    qsizetype meshUnits(qsizetype vertices, qsizetype indices, qsizetype clusters, qsizetype order, qsizetype words)
+    {
+        return MeshHeaderUnits + vertices * 11 + indices + clusters * 6 + order + words * 2;
+    }
+
+    // 숨김 비트셋까지 넣은 메시 기록의 압축 전 크기 (재배치가 orderCount개)
+    qint64 meshSize(const MeshData& mesh, int orderCount)
+    {
+        const qsizetype words = (mesh.indices.size() / 3 + 63) / 64 + (mesh.vertices.size() + 63) / 64;
+        return qint64(meshUnits(mesh.vertices.size(), mesh.indices.size(), mesh.clusters.size(), orderCount, words)) * 4;
+    }
+
+    // 셔플 전 배치에서 차례로 놓이는 4바이트 값 구간
+    struct Segment {
+        const void* data;
+        qsizetype units;
+    };
+
+    template <typename T>
+    Segment segmentOf(const QVector<T>& values)
+    {
+        static_assert(sizeof(T) % 4 == 0, "values must be made of 4-byte units");
+        return { values.constData(), qsizetype(values.size()) * qsizetype(sizeof(T) / 4) };
+    }
+
+    // 구간들을 이은 값을 바이트 자리별로 모음. 이어 붙인 사본 없이 원본에서 바로 씀
+    QByteArray shuffle(const QVector<Segment>& segments)
+    {
+        qsizetype units = 0;
+        for (const Segment& segment : segments) {
+            units += segment.units;
+        }
+        QByteArray shuffled(units * 4, Qt::Uninitialized);
+        uchar* target = reinterpret_cast<uchar*>(shuffled.data());
+        qsizetype at = 0;
+        for (const Segment& segment : segments) {
+            const uchar* source = static_cast<const uchar*>(segment.data);
+            for (int byte = 0; byte < 4; ++byte) {
+                uchar* plane = target + byte * units + at;
+                for (qsizetype i = 0; i < segment.units; ++i) {
+                    plane[i] = source[i * 4 + byte];
+                }
+            }
+            at += segment.units;
+        }
+        return shuffled;
+    }
+
+    // shuffle의 반대: at번째 값부터 units개를 target에 씀
+    void unshuffle(const QByteArray& shuffled, qsizetype at, void* target, qsizetype units)
+    {
+        const qsizetype total = shuffled.size() / 4;
+        const uchar* source = reinterpret_cast<const uchar*>(shuffled.constData());
+        uchar* out = static_cast<uchar*>(target);
+        for (int byte = 0; byte < 4; ++byte) {
+            const uchar* plane = source + byte * total + at;
+            for (qsizetype i = 0; i < units; ++i) {
+                out[i * 4 + byte] = plane[i];
+            }
+        }
+    }
+
+    template <typename T>
+    qsizetype readSegment(const QByteArray& shuffled, qsizetype at, QVector<T>& values, qsizetype count)
+    {
+        values.resize(count);
+        const qsizetype units = count * qsizetype(sizeof(T) / 4);
+        unshuffle(shuffled, at, values.data(), units);
+        return at + units;
+    }
+}
+
+EditHistory::EditHistory()
+    : m_index(0)
+    , m_memoryLimit(DefaultMemoryLimit)
+    , m_memoryUsage(0)
+    , m_diskUsage(0)
+    , m_spillFile(nullptr)
+    , m_recording(false)
+{
+}
+
+EditHistory::~EditHistory()
+{
+    delete m_spillFile;
+}
+
+void EditHistory::clear()
+{
+    m_entries.clear();
+    m_index = 0;
+    m_memoryUsage = 0;
+    m_diskUsage = 0;
+    delete m_spillFile;
+    m_spillFile = nullptr;
+
+    m_recording = false;
+    m_recorded.resize(0);
+    m_recordVertices.clear();
+    m_recordPositions.clear();
+    m_recordNormals.clear();
+}
+
+void EditHistory::setMemoryLimit(qint64 bytes)
+{
+    m_memoryLimit = qMax<qint64>(bytes, 0);
+    enforceMemoryLimit();
+}
+
+void EditHistory::beginVertexEdit(const QString& text, int vertexCount)
+{
+    m_recording = true;
+    m_recordText = text;
+    m_recorded.resize(vertexCount);
+    m_recordVertices.clear();
+    m_recordPositions.clear();
+    m_recordNormals.clear();
+}
+
+void EditHistory::recordVertices(const QVector<int>& vertices, const QVector<QVector3D>& positions,
+                                 const QVector<QVector3D>& normals)
+{
+    if (!m_recording || positions.size() != vertices.size() || normals.size() != vertices.size()) return;
+
+    // 스트로크 안에서 처음 바뀌는 정점의 값(= 스트로크 전 상태)만 남김
+    for (int i = 0; i < vertices.size(); ++i) {
+        int v = vertices[i];
+        if (v < 0 || v >= m_recorded.size() || m_recorded.test(v)) continue;
+        m_recorded.set(v);
+        m_recordVertices.append(v);
+        m_recordPositions.append(positions[i]);
+        m_recordNormals.append(normals[i]);
+    }
+}
+
+bool EditHistory::endVertexEdit()
+{
+    if (!m_recording) return false;
+    m_recording = false;
+
+    EditDelta delta;
+    delta.kind = EditDelta::Vertices;
+    const int count = m_recordVertices.size();
+    if (count > 0) {
+        QVector<int> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](int a, int b) {
+            return m_recordVertices[a] < m_recordVertices[b];
+        });
+
+        delta.elements.resize(count);
+        delta.positions.resize(count);
+        delta.normals.resize(count);
+        for (int i = 0; i < count; ++i) {
+            delta.elements[i] = m_recordVertices[order[i]];
+            delta.positions[i] = m_recordPositions[order[i]];
+            delta.normals[i] = m_recordNormals[order[i]];
+        }
+    }
+
+    // 스트로크 버퍼는 메시 크기에 비례하므로 바로 해제
+    m_recorded = SelectionSet();
+    m_recordVertices = QVector<int>();
+    m_recordPositions = QVector<QVector3D>();
+    m_recordNormals = QVector<QVector3D>();
+
+    if (count == 0) return false;
+    return push(m_recordText, delta.kind, encode(delta));
+}
+
+bool EditHistory::pushHidden(bool faces, const SelectionSet& before, const SelectionSet& after, const QString& text)
+{
+    if (before.size() != after.size()) return false;
+
+    EditDelta delta;
+    delta.kind = faces ? EditDelta::HiddenFaces : EditDelta::HiddenVertices;
+    const quint64* beforeWords = before.constData();
+    const quint64* afterWords = after.constData();
+    for (int w = 0; w < before.getWordCount(); ++w) {
+        if (beforeWords[w] != afterWords[w]) {
+            delta.elements.append(w);
+            delta.words.append(beforeWords[w]);
+        }
+    }
+    if (delta.elements.isEmpty()) return false;
+
+    return push(text, delta.kind, encode(delta));
+}
+
+bool EditHistory::pushTriangles(const QVector<int>& triangles, const QVector<unsigned int>& before,
+                                const QString& text)
+{
+    if (triangles.isEmpty() || before.size() != triangles.size() * 3) return false;
+
+    EditDelta delta;
+    delta.kind = EditDelta::Triangles;
+    delta.elements = triangles;
+    delta.indices = before;
+    return push(text, delta.kind, encode(delta));
+}
+
+bool EditHistory::pushMesh(const QByteArray& encoded, const QString& text)
+{
+    return push(text, EditDelta::WholeMesh, encoded);
+}
+
+QByteArray EditHistory::encodeMesh(const EditDelta& before, const MeshData& after)
+{
+    if (before.kind != EditDelta::WholeMesh || meshSize(before.mesh, before.order.size()) > MaxEntrySize
+        || meshSize(after, 0) > MaxEntrySize) {
+        return QByteArray();
+    }
+    return encode(before);
+}
+
+bool EditHistory::undo(const ApplyFunction& apply)
+{
+    if (!canUndo() || !swap(m_index - 1, apply)) return false;
+    --m_index;
+    enforceMemoryLimit();
+    return true;
+}
+
+bool EditHistory::redo(const ApplyFunction& apply)
+{
+    if (!canRedo() || !swap(m_index, apply)) return false;
+    ++m_index;
+    enforceMemoryLimit();
+    return true;
+}
+
+bool EditHistory::push(const QString& text, EditDelta::Kind kind, const QByteArray& data)
+{
+    // 한도를 넘어 압축하지 못한 편집 뒤에는 이전 기록이 현재 상태와 맞지 않으므로 모두 버림
+    if (data.isEmpty()) {
+        clear();
+        return false;
+    }
+
+    // 새 편집은 다시 하기 기록을 버림
+    for (int i = m_index; i < m_entries.size(); ++i) {
+        release(m_entries[i]);
+    }
+    m_entries.resize(m_index);
+
+    Entry entry;
+    entry.kind = kind;
+    entry.text = text;
+    entry.data = data;
+    m_entries.append(entry);
+    m_memoryUsage += data.size();
+    m_index = m_entries.size();
+
+    enforceMemoryLimit();
+    return true;
+}
+
+bool EditHistory::swap(int entry, const ApplyFunction& apply)
+{
+    EditDelta delta;
+    if (!load(m_entries[entry], delta) || !apply(delta)) return false;
+
+    // apply가 delta에 적용 전 값을 넣어 줬으므로 같은 자리에 반대 방향 기록으로 저장
+    store(m_entries[entry], delta);
+    return true;
+}
+
+void EditHistory::store(Entry& entry, const EditDelta& delta)
+{
+    release(entry);
+    if (delta.kind == EditDelta::WholeMesh) {
+        // 메시 전체는 압축이 메시 크기에 비례하므로 작업 스레드에서 (끝나기 전에 다시 쓰이면 기다림)
+        // 기록한 시점에 맞바꿀 두 메시 모두 한도 안인지 확인했으므로 실패하지 않음
+        entry.encoding = true;
+        entry.encoded = QtConcurrent::run([delta]() { return encode(delta); });
+        return;
+    }
+    entry.data = encode(delta);
+    m_memoryUsage += entry.data.size();
+}
+
+void EditHistory::finishEncoding(Entry& entry)
+{
+    if (!entry.encoding) return;
+    entry.data = entry.encoded.result();
+    entry.encoded = QFuture<QByteArray>();
+    entry.encoding = false;
+    m_memoryUsage += entry.data.size();
+}
+
+bool EditHistory::load(Entry& entry, EditDelta& delta)
+{
+    finishEncoding(entry);
+    if (entry.diskOffset < 0) {
+        return decode(entry.data, entry.kind, delta);
+    }
+
+    QByteArray data;
+    if (m_spillFile && m_spillFile->seek(entry.diskOffset)) {
+        data = m_spillFile->read(entry.diskSize);
+    }
+    if (data.size() != entry.diskSize) {
+        qDebug() << "Failed to read spilled edit history:" << (m_spillFile ? m_spillFile->errorString() : QString());
+        return false;
+    }
+    return decode(data, entry.kind, delta);
+}
+
+void EditHistory::release(Entry& entry)
+{
+    // 압축 중인 결과는 기다리지 않고 버림 (작업은 기록을 참조하지 않음)
+    entry.encoding = false;
+    entry.encoded = QFuture<QByteArray>();
+    m_memoryUsage -= entry.data.size();
+    entry.data = QByteArray();
+
+    if (entry.diskOffset >= 0) {
+        m_diskUsage -= entry.diskSize;
+        entry.diskOffset = -1;
+        entry.diskSize = 0;
+
+        // 살아 있는 기록이 없으면 파일을 비움 (중간에 버려진 자리는 재사용하지 않음)
+        if (m_diskUsage == 0 && m_spillFile) {
+            m_spillFile->resize(0);
+        }
+    }
+}
+
+bool EditHistory::spill(Entry& entry)
+{
+    if (!m_spillFile) {
+        m_spillFile = new QTemporaryFile();
+        if (!m_spillFile->open()) {
+            qDebug() << "Failed to create edit history file:" << m_spillFile->errorString();
+            delete m_spillFile;
+            m_spillFile = nullptr;
+            return false;
+        }
+    }
+
+    const qint64 offset = m_spillFile->size();
+    if (!m_spillFile->seek(offset) || m_spillFile->write(entry.data) != entry.data.size()) {
+        qDebug() << "Failed to spill edit history:" << m_spillFile->errorString();
+        return false;
+    }
+
+    m_memoryUsage -= entry.data.size();
+    m_diskUsage += entry.data.size();
+    entry.diskOffset = offset;
+    entry.diskSize = entry.data.size();
+    entry.data = QByteArray();
+    return true;
+}
+
+void EditHistory::enforceMemoryLimit()
+{
+    // 끝난 압축만 옮김 (아직 압축 중인 기록은 메모리 사용량에 들어가지 않고 다음 기회에 셈)
+    for (Entry& entry : m_entries) {
+        if (entry.encoding && entry.encoded.isFinished()) {
+            finishEncoding(entry);
+        }
+    }
+
+    // 가장 오래된 기록부터 디스크로 (되돌리기는 보통 최근 기록부터 쓰임)
+    for (int i = 0; i < m_entries.size() && m_memoryUsage > m_memoryLimit; ++i) {
+        if (m_entries[i].data.isEmpty()) continue;
+        if (!spill(m_entries[i])) {
+            // 디스크에 쓸 수 없으면 오래된 기록을 버려 한도를 지킴
+            removeFront(i + 1);
+            i = -1;
+        }
+    }
+}
+
+void EditHistory::removeFront(int count)
+{
+    count = qMin(count, int(m_entries.size()));
+    if (m_index < count) {
+        // 다시 하기 기록의 앞부분이 사라지면 나머지도 이어 적용할 수 없음
+        count = m_entries.size();
+    }
+    for (int i = 0; i < count; ++i) {
+        release(m_entries[i]);
+    }
+    m_entries.remove(0, count);
+    m_index = qMax(0, m_index - count);
+}
+
+QByteArray EditHistory::encode(const EditDelta& delta)
+{
+    // [머리][번호 간격...][값...]을 4바이트 단위로 이어 바이트 자리별로 모음 (셔플)
+    // 간격의 상위 바이트와 float의 지수 바이트가 한데 모여 zlib이 잘 압축함
+    quint32 header[MeshHeaderUnits];
+    QVector<quint32> gaps;
+    QVector<Segment> segments;
+    if (delta.kind == EditDelta::WholeMesh) {
+        // [정점, 인덱스, 클러스터, 재배치, 숨김 워드 수][경계][정점...][인덱스...][클러스터...][재배치...][숨김 워드...]
+        const MeshData& mesh = delta.mesh;
+        header[0] = quint32(mesh.vertices.size());
+        header[1] = quint32(mesh.indices.size());
+        header[2] = quint32(mesh.clusters.size());
+        header[3] = quint32(delta.order.size());
+        header[4] = quint32(delta.words.size());
+        const float bounds[7] = { mesh.boundingBoxMin.x(), mesh.boundingBoxMin.y(), mesh.boundingBoxMin.z(),
+                                  mesh.boundingBoxMax.x(), mesh.boundingBoxMax.y(), mesh.boundingBoxMax.z(),
+                                  mesh.boundingRadius };
+        std::memcpy(header + 5, bounds, sizeof(bounds));
+        segments << Segment{ header, MeshHeaderUnits } << segmentOf(mesh.vertices) << segmentOf(mesh.indices)
+                 << segmentOf(mesh.clusters) << segmentOf(delta.order) << segmentOf(delta.words);
+    } else {
+        const int count = delta.elements.size();
+        header[0] = quint32(count);
+        gaps.resize(count);
+        int previous = 0;
+        for (int i = 0; i < count; ++i) {
+            gaps[i] = quint32(delta.elements[i] - previous);
+            previous = delta.elements[i];
+        }
+        segments << Segment{ header, 1 } << segmentOf(gaps);
+        if (delta.kind == EditDelta::Vertices) {
+            segments << segmentOf(delta.positions) << segmentOf(delta.normals);
+        } else if (delta.kind == EditDelta::Triangles) {
+            segments << segmentOf(delta.indices);
+        } else {
+            segments << segmentOf(delta.words);
+        }
+    }
+
+    qsizetype units = 0;
+    for (const Segment& segment : segments) {
+        units += segment.units;
+    }
+    if (qint64(units) * 4 > MaxEntrySize) {
+        qDebug() << "Edit history entry too large:" << qint64(units) * 4 << "bytes";
+        return QByteArray();
+    }
+    return qCompress(shuffle(segments));
+}
+
+bool EditHistory::decode(const QByteArray& data, EditDelta::Kind kind, EditDelta& delta)
+{
+    const QByteArray shuffled = qUncompress(data);
+    if (shuffled.isEmpty() || shuffled.size() % 4 != 0) {
+        qDebug() << "Corrupt edit history entry";
+        return false;
+    }
+    const qsizetype units = shuffled.size() / 4;
+    delta.kind = kind;
+
+    if (kind == EditDelta::WholeMesh) {
+        quint32 header[MeshHeaderUnits];
+        if (units < MeshHeaderUnits) {
+            qDebug() << "Corrupt edit history entry";
+            return false;
+        }
+        unshuffle(shuffled, 0, header, MeshHeaderUnits);
+        if (units != meshUnits(header[0], header[1], header[2], header[3], header[4])) {
+            qDebug() << "Corrupt edit history entry";
+            return false;
+        }
+
+        float bounds[7];
+        std::memcpy(bounds, header + 5, sizeof(bounds));
+        MeshData& mesh = delta.mesh;
+        mesh.boundingBoxMin = QVector3D(bounds[0], bounds[1], bounds[2]);
+        mesh.boundingBoxMax = QVector3D(bounds[3], bounds[4], bounds[5]);
+        mesh.boundingRadius = bounds[6];
+        qsizetype at = MeshHeaderUnits;
+        at = readSegment(shuffled, at, mesh.vertices, header[0]);
+        at = readSegment(shuffled, at, mesh.indices, header[1]);
+        at = readSegment(shuffled, at, mesh.clusters, header[2]);
+        at = readSegment(shuffled, at, delta.order, header[3]);
+        readSegment(shuffled, at, delta.words, header[4]);
+        return true;
+    }
+
+    quint32 count = 0;
+    unshuffle(shuffled, 0, &count, 1);
+    if (units != 1 + qsizetype(count) * (1 + valuesPerElement(kind))) {
+        qDebug() << "Corrupt edit history entry";
+        return false;
+    }
+
+    QVector<quint32> gaps;
+    qsizetype at = readSegment(shuffled, 1, gaps, count);
+    delta.elements.resize(count);
+    int element = 0;
+    for (qsizetype i = 0; i < qsizetype(count); ++i) {
+        element += int(gaps[i]);
+        delta.elements[i] = element;
+    }
+    if (kind == EditDelta::Vertices) {
+        at = readSegment(shuffled, at, delta.positions, count);
+        readSegment(shuffled, at, delta.normals, count);
+    } else if (kind == EditDelta::Triangles) {
+        readSegment(shuffled, at, delta.indices, qsizetype(count) * 3);
+    } else {
+        readSegment(shuffled, at, delta.words, count);
+    }
+    return true;
+}
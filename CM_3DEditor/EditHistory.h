@@ -0,0 +1,129 @@
+#ifndef EDITHISTORY_H
+#define EDITHISTORY_H
+
+#include <QVector>
+#include <QVector3D>
+#include <QString>
+#include <QByteArray>
+#include <QTemporaryFile>
+#include <QFuture>
+#include <functional>
+#include "SelectionSet.h"
+#include "Mesh.h"
+
+// 편집 한 단계의 변경분 (바뀐 원소 번호와 그 자리의 값만 보관)
+struct EditDelta {
+    enum Kind {
+        Vertices,           // 정점 위치/법선
+        Triangles,          // 삼각형의 정점 번호 (위상 편집)
+        HiddenFaces,        // 면 숨김 비트셋 워드
+        HiddenVertices,     // 정점 숨김 비트셋 워드
+        WholeMesh           // 메시 전체 (정점/면 수가 바뀌는 처리 결과)
+    };
+
+    Kind kind = Vertices;
+    QVector<int> elements;          // 정점, 삼각형 또는 워드 번호 (오름차순)
+    QVector<QVector3D> positions;   // Vertices
+    QVector<QVector3D> normals;     // Vertices
+    QVector<unsigned int> indices;  // Triangles (원소마다 3개)
+    QVector<quint64> words;         // HiddenFaces, HiddenVertices, WholeMesh (면 숨김 워드 뒤에 정점 숨김 워드)
+    MeshData mesh;                  // WholeMesh (정점, 인덱스, 클러스터, 경계)
+    QVector<int> order;             // WholeMesh: 정점 → 파일 번호 (재배치하지 않았으면 비어 있음)
+};
+
+// 변경분 기반 되돌리기/다시 하기 기록
+// 전체 스냅샷 대신 바뀐 원소만 바이트 셔플 + zlib으로 압축해 보관하고,
+// 메모리 한도를 넘으면 오래된 기록부터 임시 파일로 내렸다가 필요할 때 다시 읽음.
+// 기록 하나가 되돌리기와 다시 하기에 번갈아 쓰임 (적용할 때 저장된 값과 현재 값을 맞바꿈).
+// 메시 전체 기록은 압축이 메시 크기에 비례하므로 작업 스레드에서 만들고, 맞바꾼 뒤의 압축도 작업 스레드에서 함
+class EditHistory
+{
+public:
+    // apply(delta): delta의 값을 현재 상태에 쓰고, 그 자리에 쓰기 전 값을 넣어 돌려줌
+    using ApplyFunction = std::function<bool(EditDelta&)>;
+
+    static constexpr qint64 DefaultMemoryLimit = 64 * 1024 * 1024;
+    
+    // 기록 하나의 압축 전 최대 바이트 (qCompress가 원래 크기를 32비트로 적음)
+    static constexpr qint64 MaxEntrySize = 0xFFFFFFFFll;
+
+    EditHistory();
+    ~EditHistory();
+
+    void clear();
+
+    // 압축된 기록이 메모리에서 차지할 최대 바이트 (넘으면 오래된 것부터 디스크로)
+    void setMemoryLimit(qint64 bytes);
+    qint64 getMemoryLimit() const { return m_memoryLimit; }
+    qint64 getMemoryUsage() const { return m_memoryUsage; }
+    qint64 getDiskUsage() const { return m_diskUsage; }
+
+    bool canUndo() const { return !m_recording && m_index > 0; }
+    bool canRedo() const { return !m_recording && m_index < m_entries.size(); }
+    QString getUndoText() const { return canUndo() ? m_entries[m_index - 1].text : QString(); }
+    QString getRedoText() const { return canRedo() ? m_entries[m_index].text : QString(); }
+
+    // 연속 편집(스트로크) 기록: 처음 바뀌는 정점의 원래 값만 남겼다가 끝날 때 한 단계로 쌓음
+    void beginVertexEdit(const QString& text, int vertexCount);
+    void recordVertices(const QVector<int>& vertices, const QVector<QVector3D>& positions,
+                        const QVector<QVector3D>& normals);
+    bool endVertexEdit();
+    bool isRecording() const { return m_recording; }
+
+    // 숨김 변경 (before와 after가 다른 워드만 보관). 바뀐 것이 없으면 false
+    bool pushHidden(bool faces, const SelectionSet& before, const SelectionSet& after, const QString& text);
+
+    // 위상 편집 (triangles는 오름차순, before는 삼각형마다 편집 전 정점 3개)
+    bool pushTriangles(const QVector<int>& triangles, const QVector<unsigned int>& before, const QString& text);
+
+    // 메시 전체 교체 (encoded는 encodeMesh 결과). 비어 있으면 (한도를 넘은 메시) 기록을 모두 버리고 false
+    bool pushMesh(const QByteArray& encoded, const QString& text);
+
+    // 처리 전 메시 before(WholeMesh)를 압축 (GL 호출 없음, 스레드 안전). 되돌리면 처리 결과 after가 같은 자리에
+    // 보관되므로 둘 중 하나라도 MaxEntrySize를 넘으면 빈 배열
+    static QByteArray encodeMesh(const EditDelta& before, const MeshData& after);
+
+    bool undo(const ApplyFunction& apply);
+    bool redo(const ApplyFunction& apply);
+
+private:
+    struct Entry {
+        EditDelta::Kind kind = EditDelta::Vertices;
+        QString text;
+        QByteArray data;            // 압축된 변경분 (디스크로 내렸으면 비어 있음)
+        qint64 diskOffset = -1;
+        qint64 diskSize = 0;
+        bool encoding = false;      // 작업 스레드에서 압축 중 (끝나면 data로 옮김)
+        QFuture<QByteArray> encoded;
+    };
+
+    QVector<Entry> m_entries;
+    int m_index;                    // 다음에 쌓일 자리 (앞은 되돌리기, 뒤는 다시 하기)
+    qint64 m_memoryLimit;
+    qint64 m_memoryUsage;
+    qint64 m_diskUsage;
+    QTemporaryFile* m_spillFile;
+
+    // 진행 중인 스트로크
+    bool m_recording;
+    QString m_recordText;
+    SelectionSet m_recorded;
+    QVector<int> m_recordVertices;
+    QVector<QVector3D> m_recordPositions;
+    QVector<QVector3D> m_recordNormals;
+
+    bool push(const QString& text, EditDelta::Kind kind, const QByteArray& data);
+    bool swap(int entry, const ApplyFunction& apply);
+    void store(Entry& entry, const EditDelta& delta);
+    void finishEncoding(Entry& entry);
+    bool load(Entry& entry, EditDelta& delta);
+    void release(Entry& entry);
+    bool spill(Entry& entry);
+    void enforceMemoryLimit();
+    void removeFront(int count);
+
+    static QByteArray encode(const EditDelta& delta);
+    static bool decode(const QByteArray& data, EditDelta::Kind kind, EditDelta& delta);
+};
+
+#endif // EDITHISTORY_H
@@ -0,0 +1,240 @@
+#include "FrameProfiler.h"
+#include <QOpenGLContext>
+#include <QOpenGLTimerQuery>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QDebug>
+
+FrameProfiler::FrameProfiler()
+    : m_frameIndex(0)
+    , m_currentSlot(0)
+    , m_currentPass(-1)
+    , m_inFrame(false)
+    , m_initialized(false)
+    , m_gpuTimingSupported(false)
+{
+    for (int i = 0; i < QueryLatency; ++i) {
+        m_frames[i].pending = false;
+    }
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    destroy();
+}
+
+void FrameProfiler::initialize()
+{
+    if (m_initialized) return;
+
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) return;
+
+    // GL_TIME_ELAPSED는 데스크톱 GL 3.3 또는 ARB_timer_query 필요
+    m_gpuTimingSupported = !context->isOpenGLES()
+        && (context->format().version() >= qMakePair(3, 3) || context->hasExtension("GL_ARB_timer_query"));
+    if (!m_gpuTimingSupported) {
+        qDebug() << "GPU timer queries unavailable; profiler records CPU time only";
+    }
+
+    m_initialized = true;
+}
+
+void FrameProfiler::destroy()
+{
+    for (int i = 0; i < QueryLatency; ++i) {
+        qDeleteAll(m_frames[i].queries);
+        m_frames[i].queries.clear();
+        m_frames[i].pending = false;
+    }
+
+    m_inFrame = false;
+    m_currentPass = -1;
+    m_initialized = false;
+}
+
+void FrameProfiler::beginFrame()
+{
+    if (m_inFrame) return;
+
+    // 이 슬롯의 이전 프레임은 QueryLatency 프레임 전에 제출되었으므로 대부분 결과가 준비됨
+    m_currentSlot = int(m_frameIndex % QueryLatency);
+    PendingFrame& frame = m_frames[m_currentSlot];
+    if (frame.pending) {
+        resolve(frame);
+    }
+
+    frame.record = FrameRecord();
+    frame.record.frameIndex = m_frameIndex;
+    frame.record.intervalMs = m_intervalTimer.isValid() ? m_intervalTimer.nsecsElapsed() / 1000000.0 : 0.0;
+    m_intervalTimer.start();
+    m_frameTimer.start();
+
+    m_currentPass = -1;
+    m_inFrame = true;
+}
+
+void FrameProfiler::endFrame(const GLStateCache::Stats& stats)
+{
+    if (!m_inFrame) return;
+
+    endPass();
+
+    FrameRecord& record = m_frames[m_currentSlot].record;
+    record.cpuMs = m_frameTimer.nsecsElapsed() / 1000000.0;
+    record.gpuMs = -1.0;
+    record.drawCalls = stats.drawCalls;
+    record.stateChanges = stats.stateChanges;
+    record.triangles = stats.triangles;
+    record.points = stats.points;
+
+    m_frames[m_currentSlot].pending = true;
+    m_inFrame = false;
+    ++m_frameIndex;
+}
+
+void FrameProfiler::beginPass(const QString& name)
+{
+    if (!m_inFrame) return;
+
+    // GL_TIME_ELAPSED 쿼리는 중첩될 수 없으므로 열린 패스는 먼저 닫음
+    endPass();
+
+    PendingFrame& frame = m_frames[m_currentSlot];
+    m_currentPass = frame.record.passes.size();
+    frame.record.passes.append({ name, 0.0, -1.0 });
+
+    QOpenGLTimerQuery* query = acquireQuery(frame, m_currentPass);
+    if (query) {
+        query->begin();
+    }
+    m_passTimer.start();
+}
+
+void FrameProfiler::endPass()
+{
+    if (!m_inFrame || m_currentPass < 0) return;
+
+    PendingFrame& frame = m_frames[m_currentSlot];
+    frame.record.passes[m_currentPass].cpuMs = m_passTimer.nsecsElapsed() / 1000000.0;
+
+    if (m_currentPass < frame.queries.size() && frame.queries[m_currentPass]) {
+        frame.queries[m_currentPass]->end();
+    }
+    m_currentPass = -1;
+}
+
+double FrameProfiler::getAverageFps() const
+{
+    // 최근 1초 정도의 간격 평균
+    double total = 0.0;
+    int count = 0;
+    for (int i = m_history.size() - 1; i >= 0 && total < 1000.0; --i) {
+        if (m_history[i].intervalMs <= 0.0) continue;
+        total += m_history[i].intervalMs;
+        ++count;
+    }
+    return total > 0.0 ? count * 1000.0 / total : 0.0;
+}
+
+bool FrameProfiler::exportCsv(const QString& filename) const
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "Failed to open profile output:" << filename;
+        return false;
+    }
+
+    // 프레임마다 패스 구성이 다를 수 있으므로 등장 순서대로 열 구성
+    QStringList passNames;
+    for (const FrameRecord& record : m_history) {
+        for (const PassTiming& pass : record.passes) {
+            if (!passNames.contains(pass.name)) {
+                passNames.append(pass.name);
+            }
+        }
+    }
+
+    auto formatMs = [](double ms) {
+        return ms < 0.0 ? QString() : QString::number(ms, 'f', 3);
+    };
+
+    QTextStream out(&file);
+    out << "frame,interval_ms,cpu_ms,gpu_ms,draw_calls,state_changes,triangles,points";
+    for (const QString& name : passNames) {
+        out << "," << name << "_cpu_ms," << name << "_gpu_ms";
+    }
+    out << "\n";
+
+    for (const FrameRecord& record : m_history) {
+        out << record.frameIndex << ","
+            << formatMs(record.intervalMs) << ","
+            << formatMs(record.cpuMs) << ","
+            << formatMs(record.gpuMs) << ","
+            << record.drawCalls << ","
+            << record.stateChanges << ","
+            << record.triangles << ","
+            << record.points;
+
+        for (const QString& name : passNames) {
+            double cpuMs = -1.0;
+            double gpuMs = -1.0;
+            for (const PassTiming& pass : record.passes) {
+                if (pass.name == name) {
+                    cpuMs = pass.cpuMs;
+                    gpuMs = pass.gpuMs;
+                    break;
+                }
+            }
+            out << "," << formatMs(cpuMs) << "," << formatMs(gpuMs);
+        }
+        out << "\n";
+    }
+
+    qDebug() << "Exported" << m_history.size() << "profiled frames to" << filename;
+    return true;
+}
+
+QOpenGLTimerQuery* FrameProfiler::acquireQuery(PendingFrame& frame, int index)
+{
+    if (!m_gpuTimingSupported) return nullptr;
+
+    // 쿼리 객체는 슬롯마다 재사용
+    while (frame.queries.size() <= index) {
+        QOpenGLTimerQuery* query = new QOpenGLTimerQuery();
+        if (!query->create()) {
+            qDebug() << "Failed to create GPU timer query; profiler records CPU time only";
+            delete query;
+            m_gpuTimingSupported = false;
+            return nullptr;
+        }
+        frame.queries.append(query);
+    }
+    return frame.queries[index];
+}
+
+void FrameProfiler::resolve(PendingFrame& frame)
+{
+    FrameRecord& record = frame.record;
+
+    // 준비되지 않은 쿼리는 기다리지 않고 측정 불가로 남김
+    double gpuTotal = 0.0;
+    bool gpuComplete = m_gpuTimingSupported;
+    for (int i = 0; i < record.passes.size(); ++i) {
+        QOpenGLTimerQuery* query = i < frame.queries.size() ? frame.queries[i] : nullptr;
+        if (query && query->isResultAvailable()) {
+            record.passes[i].gpuMs = query->waitForResult() / 1000000.0;
+            gpuTotal += record.passes[i].gpuMs;
+        } else {
+            gpuComplete = false;
+        }
+    }
+    record.gpuMs = gpuComplete ? gpuTotal : -1.0;
+
+    m_history.append(record);
+    if (m_history.size() > HistorySize) {
+        m_history.remove(0, m_history.size() - HistorySize);
+    }
+    frame.pending = false;
+}
@@ -0,0 +1,104 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QString>
+#include <QVector>
+#include <QElapsedTimer>
+#include "GLStateCache.h"
+
+class QOpenGLTimerQuery;
+
+// 프레임 프로파일러
+// 렌더 패스마다 CPU 시간(QElapsedTimer)과 GPU 시간(GL_TIME_ELAPSED 쿼리)을 측정
+// GPU 결과는 QueryLatency 프레임 뒤에 대기 없이 읽으므로 기록은 그만큼 늦게 확정됨
+class FrameProfiler
+{
+public:
+    static constexpr int QueryLatency = 3;
+    static constexpr int HistorySize = 240;
+
+    struct PassTiming {
+        QString name;
+        double cpuMs;
+        double gpuMs;   // 측정 불가 시 음수
+    };
+
+    struct FrameRecord {
+        quint64 frameIndex;
+        double intervalMs;  // 이전 프레임 시작부터의 간격
+        double cpuMs;
+        double gpuMs;       // 패스 GPU 시간의 합 (측정 불가 시 음수)
+        int drawCalls;
+        int stateChanges;
+        qint64 triangles;
+        qint64 points;
+        QVector<PassTiming> passes;
+    };
+
+    // 패스 범위 측정 (패스는 중첩되지 않음)
+    class Scope
+    {
+    public:
+        Scope(FrameProfiler* profiler, const QString& name)
+            : m_profiler(profiler)
+        {
+            if (m_profiler) m_profiler->beginPass(name);
+        }
+        ~Scope()
+        {
+            if (m_profiler) m_profiler->endPass();
+        }
+
+    private:
+        FrameProfiler* m_profiler;
+    };
+
+    FrameProfiler();
+    ~FrameProfiler();
+
+    // GL 리소스 (현재 컨텍스트 필요)
+    void initialize();
+    void destroy();
+    bool isGpuTimingSupported() const { return m_gpuTimingSupported; }
+
+    // 프레임/패스 측정
+    void beginFrame();
+    void endFrame(const GLStateCache::Stats& stats);
+    void beginPass(const QString& name);
+    void endPass();
+
+    // 확정된 기록
+    const QVector<FrameRecord>& getHistory() const { return m_history; }
+    const FrameRecord* getLatest() const { return m_history.isEmpty() ? nullptr : &m_history.last(); }
+    double getAverageFps() const;
+
+    // 기록을 CSV로 저장 (패스별 CPU/GPU 열 포함)
+    bool exportCsv(const QString& filename) const;
+
+private:
+    // 쿼리 결과를 기다리는 프레임
+    struct PendingFrame {
+        bool pending;
+        FrameRecord record;
+        QVector<QOpenGLTimerQuery*> queries;
+    };
+
+    PendingFrame m_frames[QueryLatency];
+    QVector<FrameRecord> m_history;
+
+    quint64 m_frameIndex;
+    int m_currentSlot;
+    int m_currentPass;
+    bool m_inFrame;
+    bool m_initialized;
+    bool m_gpuTimingSupported;
+
+    QElapsedTimer m_intervalTimer;
+    QElapsedTimer m_frameTimer;
+    QElapsedTimer m_passTimer;
+
+    QOpenGLTimerQuery* acquireQuery(PendingFrame& frame, int index);
+    void resolve(PendingFrame& frame);
+};
+
+#endif // FRAMEPROFILER_H
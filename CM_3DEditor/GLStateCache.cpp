@@ -0,0 +1,248 @@
+#include "GLStateCache.h"
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLVersionFunctionsFactory>
+
+GLStateCache::GLStateCache()
+    : m_program(0)
+    , m_vao(0)
+    , m_polygonMode(GL_FILL)
+    , m_blend(false)
+    , m_depthTest(true)
+    , m_depthWrite(true)
+    , m_cullFace(true)
+    , m_clipDistances(0)
+    , m_gl33(nullptr)
+{
+    for (int i = 0; i < MaxUniformBindings; ++i) {
+        m_uniformRanges[i] = { 0, 0, 0 };
+    }
+    resetStats();
+}
+
+void GLStateCache::initialize()
+{
+    initializeOpenGLFunctions();
+    
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    m_gl33 = context && !context->isOpenGLES()
+                 ? QOpenGLVersionFunctionsFactory::get<QOpenGLFunctions_3_3_Core>(context) : nullptr;
+    if (m_gl33 && !m_gl33->initializeOpenGLFunctions()) {
+        m_gl33 = nullptr;
+    }
+    reset();
+}
+
+void GLStateCache::reset()
+{
+    // 실제 GL 상태를 캐시 값과 일치시킴
+    m_program = 0;
+    glUseProgram(0);
+
+    m_vao = 0;
+    glBindVertexArray(0);
+
+    m_polygonMode = GL_FILL;
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    m_blend = false;
+    glDisable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    m_depthTest = true;
+    glEnable(GL_DEPTH_TEST);
+
+    m_depthWrite = true;
+    glDepthMask(GL_TRUE);
+
+    m_cullFace = true;
+    glEnable(GL_CULL_FACE);
+
+    m_clipDistances = 0;
+    for (int i = 0; i < MaxClipDistances; ++i) {
+        glDisable(GL_CLIP_DISTANCE0 + i);
+    }
+
+    for (int i = 0; i < MaxUniformBindings; ++i) {
+        m_uniformRanges[i] = { 0, 0, 0 };
+    }
+}
+
+void GLStateCache::useProgram(GLuint program)
+{
+    if (m_program == program) {
+        ++m_stats.redundantSkipped;
+        return;
+    }
+
+    glUseProgram(program);
+    m_program = program;
+    ++m_stats.stateChanges;
+}
+
+void GLStateCache::bindVertexArray(GLuint vao)
+{
+    if (m_vao == vao) {
+        ++m_stats.redundantSkipped;
+        return;
+    }
+
+    glBindVertexArray(vao);
+    m_vao = vao;
+    ++m_stats.stateChanges;
+}
+
+void GLStateCache::setPolygonMode(GLenum mode)
+{
+    if (m_polygonMode == mode) {
+        ++m_stats.redundantSkipped;
+        return;
+    }
+
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    m_polygonMode = mode;
+    ++m_stats.stateChanges;
+}
+
+void GLStateCache::setBlend(bool enabled)
+{
+    setCapability(GL_BLEND, enabled, m_blend);
+}
+
+void GLStateCache::setDepthTest(bool enabled)
+{
+    setCapability(GL_DEPTH_TEST, enabled, m_depthTest);
+}
+
+void GLStateCache::setDepthWrite(bool enabled)
+{
+    if (m_depthWrite == enabled) {
+        ++m_stats.redundantSkipped;
+        return;
+    }
+
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    m_depthWrite = enabled;
+    ++m_stats.stateChanges;
+}
+
+void GLStateCache::setCullFace(bool enabled)
+{
+    setCapability(GL_CULL_FACE, enabled, m_cullFace);
+}
+
+void GLStateCache::setClipDistances(int count)
+{
+    count = qBound(0, count, MaxClipDistances);
+    if (m_clipDistances == count) {
+        ++m_stats.redundantSkipped;
+        return;
+    }
+
+    for (int i = qMin(m_clipDistances, count); i < qMax(m_clipDistances, count); ++i) {
+        if (i < count) {
+            glEnable(GL_CLIP_DISTANCE0 + i);
+        } else {
+            glDisable(GL_CLIP_DISTANCE0 + i);
+        }
+    }
+    m_clipDistances = count;
+    ++m_stats.stateChanges;
+}
+
+void GLStateCache::bindUniformRange(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    if (binding < GLuint(MaxUniformBindings)) {
+        UniformRange& range = m_uniformRanges[binding];
+        if (range.buffer == buffer && range.offset == offset && range.size == size) {
+            ++m_stats.redundantSkipped;
+            return;
+        }
+        range = { buffer, offset, size };
+    }
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size);
+    ++m_stats.stateChanges;
+}
+
+void GLStateCache::drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    glDrawElements(mode, count, type, indices);
+    recordDraw(mode, count);
+}
+
+void GLStateCache::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    glDrawArrays(mode, first, count);
+    recordDraw(mode, count);
+}
+
+void GLStateCache::multiDrawElements(GLenum mode, const GLsizei* counts, const void* const* offsets, GLsizei drawCount)
+{
+    if (drawCount <= 0) return;
+    
+    qint64 elementCount = 0;
+    for (GLsizei i = 0; i < drawCount; ++i) {
+        elementCount += counts[i];
+    }
+    
+    if (m_gl33) {
+        m_gl33->glMultiDrawElements(mode, counts, GL_UNSIGNED_INT, offsets, drawCount);
+    } else {
+        for (GLsizei i = 0; i < drawCount; ++i) {
+            glDrawElements(mode, counts[i], GL_UNSIGNED_INT, offsets[i]);
+        }
+    }
+    recordDraw(mode, elementCount);
+}
+
+void GLStateCache::multiDrawArrays(GLenum mode, const GLint* firsts, const GLsizei* counts, GLsizei drawCount)
+{
+    if (drawCount <= 0) return;
+    
+    qint64 elementCount = 0;
+    for (GLsizei i = 0; i < drawCount; ++i) {
+        elementCount += counts[i];
+    }
+    
+    if (m_gl33) {
+        m_gl33->glMultiDrawArrays(mode, firsts, counts, drawCount);
+    } else {
+        for (GLsizei i = 0; i < drawCount; ++i) {
+            glDrawArrays(mode, firsts[i], counts[i]);
+        }
+    }
+    recordDraw(mode, elementCount);
+}
+
+void GLStateCache::recordDraw(GLenum mode, qint64 elementCount)
+{
+    ++m_stats.drawCalls;
+
+    if (mode == GL_TRIANGLES) {
+        m_stats.triangles += elementCount / 3;
+    } else if (mode == GL_POINTS) {
+        m_stats.points += elementCount;
+    }
+}
+
+void GLStateCache::resetStats()
+{
+    m_stats = { 0, 0, 0, 0, 0 };
+}
+
+void GLStateCache::setCapability(GLenum capability, bool enabled, bool& cached)
+{
+    if (cached == enabled) {
+        ++m_stats.redundantSkipped;
+        return;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+    cached = enabled;
+    ++m_stats.stateChanges;
+}
@@ -0,0 +1,82 @@
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#include <QOpenGLExtraFunctions>
+
+class QOpenGLFunctions_3_3_Core;
+
+// 마지막으로 설정한 GL 상태를 기억하여 중복 호출을 건너뛰는 상태 캐시
+// 외부 코드(QPainter 등)가 GL 상태를 바꾼 뒤에는 reset()으로 다시 동기화해야 함
+class GLStateCache : protected QOpenGLExtraFunctions
+{
+public:
+    // 프레임 통계
+    struct Stats {
+        int drawCalls;
+        int stateChanges;
+        int redundantSkipped;
+        qint64 triangles;
+        qint64 points;
+    };
+
+    static constexpr int MaxUniformBindings = 8;
+    static constexpr int MaxClipDistances = 8;     // GL이 보장하는 최소 개수
+
+    GLStateCache();
+
+    void initialize();
+
+    // 캐시된 상태를 기본값으로 강제 설정
+    void reset();
+
+    // 상태 변경
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void setPolygonMode(GLenum mode);
+    void setBlend(bool enabled);
+    void setDepthTest(bool enabled);
+    void setDepthWrite(bool enabled);
+    void setCullFace(bool enabled);
+    void setClipDistances(int count);              // GL_CLIP_DISTANCE0..count-1만 켬
+    void bindUniformRange(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    GLuint getProgram() const { return m_program; }
+
+    // 드로우 호출 (통계 집계)
+    void drawElements(GLenum mode, GLsizei count, GLenum type = GL_UNSIGNED_INT, const void* indices = nullptr);
+    void drawArrays(GLenum mode, GLint first, GLsizei count);
+    
+    // 여러 구간을 한 번에 그림 (glMultiDraw*, 데스크톱 함수를 얻지 못하면 구간마다 드로우)
+    void multiDrawElements(GLenum mode, const GLsizei* counts, const void* const* offsets, GLsizei drawCount);
+    void multiDrawArrays(GLenum mode, const GLint* firsts, const GLsizei* counts, GLsizei drawCount);
+    
+    // 캐시 밖에서 발행된 드로우(간접 멀티 드로우 등)의 통계 기록
+    void recordDraw(GLenum mode, qint64 elementCount);
+
+    // 통계
+    void resetStats();
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    GLuint m_program;
+    GLuint m_vao;
+    GLenum m_polygonMode;
+    bool m_blend;
+    bool m_depthTest;
+    bool m_depthWrite;
+    bool m_cullFace;
+    int m_clipDistances;
+    QOpenGLFunctions_3_3_Core* m_gl33;     // glMultiDraw* (ES 함수 집합에 없음)
+
+    struct UniformRange {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+    UniformRange m_uniformRanges[MaxUniformBindings];
+
+    Stats m_stats;
+
+    void setCapability(GLenum capability, bool enabled, bool& cached);
+};
+
+#endif // GLSTATECACHE_H
@@ -0,0 +1,218 @@
+#include "GeometryArena.h"
+#include "Mesh.h"
+#include <QOpenGLContext>
+#include <QDebug>
+
+GeometryArena::GeometryArena()
+    : m_vao(0)
+    , m_vertexBuffer(0)
+    , m_indexBuffer(0)
+    , m_drawIdBuffer(0)
+    , m_vertexCapacity(0)
+    , m_indexCapacity(0)
+    , m_vertexCount(0)
+    , m_indexCount(0)
+{
+}
+
+GeometryArena::~GeometryArena()
+{
+    destroy();
+}
+
+bool GeometryArena::create(int vertexCapacity, int indexCapacity)
+{
+    if (!QOpenGLContext::currentContext()) return false;
+
+    initializeOpenGLFunctions();
+    destroy();
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vertexBuffer);
+    glGenBuffers(1, &m_indexBuffer);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, GLsizeiptr(vertexCapacity) * sizeof(VertexData), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, GLsizeiptr(indexCapacity) * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    m_vertexCapacity = vertexCapacity;
+    m_indexCapacity = indexCapacity;
+    m_vertexCount = 0;
+    m_indexCount = 0;
+
+    setupVertexArray();
+    return true;
+}
+
+void GeometryArena::destroy()
+{
+    if (QOpenGLContext::currentContext()) {
+        if (m_vao) glDeleteVertexArrays(1, &m_vao);
+        if (m_vertexBuffer) glDeleteBuffers(1, &m_vertexBuffer);
+        if (m_indexBuffer) glDeleteBuffers(1, &m_indexBuffer);
+    }
+
+    m_vao = 0;
+    m_vertexBuffer = 0;
+    m_indexBuffer = 0;
+    m_vertexCapacity = 0;
+    m_indexCapacity = 0;
+    m_vertexCount = 0;
+    m_indexCount = 0;
+}
+
+void GeometryArena::clear()
+{
+    m_vertexCount = 0;
+    m_indexCount = 0;
+}
+
+bool GeometryArena::append(const Mesh* mesh, Allocation& allocation)
+{
+    if (!m_vao || !mesh || !mesh->hasData()) return false;
+
+    int vertexCount = mesh->getVertexCount();
+    int indexCount = mesh->getIndexCount();
+
+    if (!reserve(m_vertexCount + vertexCount, m_indexCount + indexCount)) {
+        return false;
+    }
+
+    // CPU를 거치지 않고 메시 버퍼에서 아레나로 직접 복사
+    glBindBuffer(GL_COPY_READ_BUFFER, mesh->getVertexBufferId());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+                        GLintptr(m_vertexCount) * sizeof(VertexData),
+                        GLsizeiptr(vertexCount) * sizeof(VertexData));
+
+    glBindBuffer(GL_COPY_READ_BUFFER, mesh->getIndexBufferId());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+                        GLintptr(m_indexCount) * sizeof(unsigned int),
+                        GLsizeiptr(indexCount) * sizeof(unsigned int));
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // 인덱스는 메시 로컬 값 그대로 두고 baseVertex로 보정
+    allocation.baseVertex = m_vertexCount;
+    allocation.firstIndex = m_indexCount;
+    allocation.vertexCount = vertexCount;
+    allocation.indexCount = indexCount;
+
+    m_vertexCount += vertexCount;
+    m_indexCount += indexCount;
+    return true;
+}
+
+bool GeometryArena::copyIndices(const Mesh* mesh, const Allocation& allocation)
+{
+    if (!m_vao || !mesh || mesh->getIndexCount() != allocation.indexCount) return false;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, mesh->getIndexBufferId());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+                        GLintptr(allocation.firstIndex) * sizeof(unsigned int),
+                        GLsizeiptr(allocation.indexCount) * sizeof(unsigned int));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
+bool GeometryArena::copyVertices(const Mesh* mesh, const Allocation& allocation, const MeshDrawRanges* ranges)
+{
+    if (!m_vao || !mesh || mesh->getVertexCount() != allocation.vertexCount) return false;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, mesh->getVertexBufferId());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer);
+    if (ranges) {
+        for (int i = 0; i < ranges->size(); ++i) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                GLintptr(ranges->first[i]) * sizeof(VertexData),
+                                GLintptr(allocation.baseVertex + ranges->first[i]) * sizeof(VertexData),
+                                GLsizeiptr(ranges->count[i]) * sizeof(VertexData));
+        }
+    } else {
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+                            GLintptr(allocation.baseVertex) * sizeof(VertexData),
+                            GLsizeiptr(allocation.vertexCount) * sizeof(VertexData));
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
+void GeometryArena::setDrawIdBuffer(GLuint buffer)
+{
+    m_drawIdBuffer = buffer;
+    if (m_vao) {
+        setupVertexArray();
+    }
+}
+
+bool GeometryArena::reserve(int vertexCapacity, int indexCapacity)
+{
+    if (vertexCapacity > m_vertexCapacity) {
+        int newCapacity = qMax(vertexCapacity, m_vertexCapacity * 2);
+        m_vertexBuffer = growBuffer(m_vertexBuffer, GLsizeiptr(m_vertexCount) * sizeof(VertexData),
+                                    GLsizeiptr(newCapacity) * sizeof(VertexData));
+        if (!m_vertexBuffer) return false;
+        m_vertexCapacity = newCapacity;
+    }
+
+    if (indexCapacity > m_indexCapacity) {
+        int newCapacity = qMax(indexCapacity, m_indexCapacity * 2);
+        m_indexBuffer = growBuffer(m_indexBuffer, GLsizeiptr(m_indexCount) * sizeof(unsigned int),
+                                   GLsizeiptr(newCapacity) * sizeof(unsigned int));
+        if (!m_indexBuffer) return false;
+        m_indexCapacity = newCapacity;
+    }
+
+    // 버퍼가 교체되었을 수 있으므로 VAO 갱신
+    setupVertexArray();
+    return true;
+}
+
+GLuint GeometryArena::growBuffer(GLuint buffer, GLsizeiptr usedBytes, GLsizeiptr newBytes)
+{
+    GLuint grown = 0;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, newBytes, nullptr, GL_STATIC_DRAW);
+
+    if (usedBytes > 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, &buffer);
+    return grown;
+}
+
+void GeometryArena::setupVertexArray()
+{
+    glBindVertexArray(m_vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    for (int attribute = 0; attribute < 4; ++attribute) {
+        glEnableVertexAttribArray(attribute);
+    }
+    Mesh::setupVertexAttributes(this);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+
+    // baseInstance로 오프셋되는 인스턴스 attribute를 드로우 ID로 사용
+    if (m_drawIdBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_drawIdBuffer);
+        glEnableVertexAttribArray(8);
+        glVertexAttribIPointer(8, 1, GL_UNSIGNED_INT, 0, nullptr);
+        glVertexAttribDivisor(8, 1);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
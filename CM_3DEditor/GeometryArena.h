@@ -0,0 +1,62 @@
+#ifndef GEOMETRYARENA_H
+#define GEOMETRYARENA_H
+
+#include <QOpenGLExtraFunctions>
+
+class Mesh;
+struct MeshDrawRanges;
+
+// 여러 메시가 공유하는 버텍스/인덱스 버퍼
+// 메시 데이터는 GPU 버퍼 간 복사로 추가되며, 공간이 부족하면 두 배로 늘림
+class GeometryArena : protected QOpenGLExtraFunctions
+{
+public:
+    struct Allocation {
+        int baseVertex;
+        int firstIndex;
+        int vertexCount;
+        int indexCount;
+    };
+
+    GeometryArena();
+    ~GeometryArena();
+
+    bool create(int vertexCapacity, int indexCapacity);
+    void destroy();
+
+    // 내용만 비움 (버퍼는 유지)
+    void clear();
+
+    // 메시의 GPU 버퍼를 아레나 끝에 복사
+    bool append(const Mesh* mesh, Allocation& allocation);
+
+    // 이미 추가된 메시의 인덱스 버퍼를 다시 복사 (숨김 등으로 인덱스만 바뀐 경우)
+    bool copyIndices(const Mesh* mesh, const Allocation& allocation);
+
+    // 이미 추가된 메시의 정점을 다시 복사 (ranges가 있으면 그 정점 구간만)
+    bool copyVertices(const Mesh* mesh, const Allocation& allocation, const MeshDrawRanges* ranges = nullptr);
+
+    // 드로우 ID attribute (location 8, 인스턴스당 1씩 증가) 소스 버퍼 연결
+    void setDrawIdBuffer(GLuint buffer);
+
+    GLuint getVertexArrayId() const { return m_vao; }
+    int getVertexCount() const { return m_vertexCount; }
+    int getIndexCount() const { return m_indexCount; }
+
+private:
+    GLuint m_vao;
+    GLuint m_vertexBuffer;
+    GLuint m_indexBuffer;
+    GLuint m_drawIdBuffer;
+
+    int m_vertexCapacity;
+    int m_indexCapacity;
+    int m_vertexCount;
+    int m_indexCount;
+
+    bool reserve(int vertexCapacity, int indexCapacity);
+    GLuint growBuffer(GLuint buffer, GLsizeiptr usedBytes, GLsizeiptr newBytes);
+    void setupVertexArray();
+};
+
+#endif // GEOMETRYARENA_H
@@ -0,0 +1,324 @@
+#include "HalfEdgeMesh.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 16;
+
+    // 방향 없는 변 키 (작은 정점 번호가 상위 32비트)와 반변
+    struct EdgeKey {
+        quint64 key;
+        qint32 halfEdge;
+
+        bool operator<(const EdgeKey& other) const
+        {
+            return key < other.key || (key == other.key && halfEdge < other.halfEdge);
+        }
+    };
+
+    inline quint64 edgeKey(unsigned int a, unsigned int b)
+    {
+        return a < b ? (quint64(a) << 32) | b : (quint64(b) << 32) | a;
+    }
+
+    // 조각별 std::sort 후 두 조각씩 병렬 병합
+    void parallelSort(QVector<EdgeKey>& keys)
+    {
+        const qsizetype count = keys.size();
+        const int chunks = Parallel::chunkCount(count, ParallelGrain);
+        if (chunks <= 1) {
+            std::sort(keys.begin(), keys.end());
+            return;
+        }
+
+        QVector<qsizetype> bounds(chunks + 1);
+        for (int c = 0; c <= chunks; ++c) {
+            bounds[c] = count * c / chunks;
+        }
+
+        EdgeKey* data = keys.data();
+        Parallel::parallelFor(chunks, 1, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype c = begin; c < end; ++c) {
+                std::sort(data + bounds[c], data + bounds[c + 1]);
+            }
+        });
+
+        QVector<EdgeKey> buffer(count);
+        EdgeKey* source = data;
+        EdgeKey* target = buffer.data();
+        for (int width = 1; width < chunks; width *= 2) {
+            const int pairs = (chunks + 2 * width - 1) / (2 * width);
+            Parallel::parallelFor(pairs, 1, [&](qsizetype begin, qsizetype end) {
+                for (qsizetype p = begin; p < end; ++p) {
+                    const int first = int(p) * 2 * width;
+                    const int middle = qMin(first + width, chunks);
+                    const int last = qMin(first + 2 * width, chunks);
+                    std::merge(source + bounds[first], source + bounds[middle],
+                               source + bounds[middle], source + bounds[last], target + bounds[first]);
+                }
+            });
+            std::swap(source, target);
+        }
+        if (source != data) {
+            std::copy(source, source + count, data);
+        }
+    }
+}
+
+HalfEdgeMesh::HalfEdgeMesh() : m_nonManifoldEdgeCount(0)
+{
+}
+
+void HalfEdgeMesh::clear()
+{
+    m_indices.clear();
+    m_twins.clear();
+    m_vertexHalfEdges.clear();
+    m_nonManifoldEdgeCount = 0;
+}
+
+bool HalfEdgeMesh::build(const QVector<unsigned int>& indices, int vertexCount, const std::atomic_bool* cancel)
+{
+    QElapsedTimer timer;
+    timer.start();
+    clear();
+
+    const int halfEdgeCount = indices.size() / 3 * 3;
+    if (halfEdgeCount == 0 || vertexCount == 0) return false;
+
+    // 1) 반변마다 방향 없는 변 키
+    QVector<EdgeKey> keys(halfEdgeCount);
+    EdgeKey* keyData = keys.data();
+    const unsigned int* indexData = indices.constData();
+    std::atomic_bool valid(true);
+    Parallel::parallelFor(halfEdgeCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype h = begin; h < end; ++h) {
+            const unsigned int a = indexData[h];
+            const unsigned int b = indexData[next(int(h))];
+            if (a >= unsigned(vertexCount) || b >= unsigned(vertexCount)) valid = false;
+            keyData[h] = { edgeKey(a, b), qint32(h) };
+        }
+    });
+    if (!valid.load()) {
+        qDebug() << "Half-edge build failed: index out of range";
+        return false;
+    }
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    // 2) 키 정렬로 같은 변의 반변을 이웃하게 모음
+    parallelSort(keys);
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    // 3) 키가 같은 반변이 정확히 둘이고 방향이 반대면 짝으로 연결
+    //    조각 경계에 걸친 변은 그 변이 시작된 조각이 처리
+    QVector<qint32> twins(halfEdgeCount, -1);
+    qint32* twinData = twins.data();
+    std::atomic_int nonManifold(0);
+    Parallel::parallelFor(halfEdgeCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        qsizetype i = begin;
+        while (i > 0 && i < halfEdgeCount && keyData[i].key == keyData[i - 1].key) ++i;
+
+        int localNonManifold = 0;
+        while (i < end) {
+            qsizetype runEnd = i + 1;
+            while (runEnd < halfEdgeCount && keyData[runEnd].key == keyData[i].key) ++runEnd;
+
+            if (runEnd - i == 2) {
+                const qint32 h0 = keyData[i].halfEdge;
+                const qint32 h1 = keyData[i + 1].halfEdge;
+                if (indexData[h0] != indexData[h1]) {
+                    twinData[h0] = h1;
+                    twinData[h1] = h0;
+                } else {
+                    ++localNonManifold;
+                }
+            } else if (runEnd - i > 2) {
+                ++localNonManifold;
+            }
+            i = runEnd;
+        }
+        nonManifold += localNonManifold;
+    });
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    // 4) 정점마다 나가는 반변 하나 (경계 반변 우선, 같으면 번호가 작은 것)
+    QVector<qint32> vertexHalfEdges(vertexCount, -1);
+    qint32* vertexData = vertexHalfEdges.data();
+    for (int h = 0; h < halfEdgeCount; ++h) {
+        qint32& current = vertexData[indexData[h]];
+        if (current < 0 || (twinData[h] < 0 && twinData[current] >= 0)) {
+            current = h;
+        }
+    }
+
+    m_indices = indices;
+    m_indices.resize(halfEdgeCount);
+    m_twins.swap(twins);
+    m_vertexHalfEdges.swap(vertexHalfEdges);
+    m_nonManifoldEdgeCount = nonManifold.load();
+
+    qDebug() << "Half-edge mesh built:" << halfEdgeCount << "half-edges," << getBoundaryHalfEdgeCount()
+             << "boundary," << m_nonManifoldEdgeCount << "non-manifold edges in" << timer.elapsed() << "ms";
+    return true;
+}
+
+void HalfEdgeMesh::oneRing(int v, QVector<int>& vertices) const
+{
+    vertices.clear();
+    int last = -1;
+    forEachOutgoing(v, [&](int h) {
+        vertices.append(target(h));
+        last = h;
+    });
+
+    // 경계에서 멈췄으면 마지막 면의 들어오는 변 건너편 정점까지
+    if (last >= 0 && m_twins[prev(last)] < 0) {
+        vertices.append(origin(prev(last)));
+    }
+}
+
+int HalfEdgeMesh::valence(int v) const
+{
+    QVector<int> ring;
+    oneRing(v, ring);
+    return ring.size();
+}
+
+int HalfEdgeMesh::findHalfEdge(int from, int to) const
+{
+    int found = -1;
+    forEachOutgoing(from, [&](int h) {
+        if (found < 0 && target(h) == to) found = h;
+    });
+    return found;
+}
+
+int HalfEdgeMesh::getBoundaryHalfEdgeCount() const
+{
+    const qint32* twins = m_twins.constData();
+    std::atomic_int total(0);
+    Parallel::parallelFor(m_twins.size(), ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        int count = 0;
+        for (qsizetype h = begin; h < end; ++h) {
+            if (twins[h] < 0) ++count;
+        }
+        total += count;
+    });
+    return total.load();
+}
+
+bool HalfEdgeMesh::canFlip(int h) const
+{
+    if (h < 0 || h >= m_twins.size() || m_twins[h] < 0) return false;
+
+    const int t = m_twins[h];
+    const int c = origin(prev(h));
+    const int d = origin(prev(t));
+    return c != d && findHalfEdge(c, d) < 0 && findHalfEdge(d, c) < 0;
+}
+
+bool HalfEdgeMesh::flipEdge(int h, QVector<int>* faces)
+{
+    if (!canFlip(h)) return false;
+
+    // (a, b, c) + (b, a, d) → (a, d, c) + (d, b, c)
+    const int t = m_twins[h];
+    const unsigned int a = m_indices[h];
+    const unsigned int b = m_indices[t];
+    const unsigned int c = m_indices[prev(h)];
+    const unsigned int d = m_indices[prev(t)];
+
+    QVector<int> flipped = { face(h), face(t) };
+    QVector<unsigned int> triples = { a, d, c, d, b, c };
+    if (flipped[0] > flipped[1]) {
+        std::swap(flipped[0], flipped[1]);
+        triples = { d, b, c, a, d, c };
+    }
+    if (!replaceTriangles(flipped, triples)) return false;
+
+    if (faces) *faces = flipped;
+    return true;
+}
+
+bool HalfEdgeMesh::replaceTriangles(const QVector<int>& faces, const QVector<unsigned int>& triples)
+{
+    if (triples.size() != faces.size() * 3) return false;
+    const int vertexCount = m_vertexHalfEdges.size();
+    for (int f : faces) {
+        if (f < 0 || f >= getFaceCount()) return false;
+    }
+    for (unsigned int v : triples) {
+        if (v >= unsigned(vertexCount)) return false;
+    }
+
+    auto inRegion = [&faces](int h) { return faces.contains(face(h)); };
+
+    // 1) 바깥 반변과의 연결을 끊고, 다시 이을 후보로 모음
+    QVector<int> outside;
+    QVector<int> touched;
+    for (int f : faces) {
+        for (int h = f * 3; h < f * 3 + 3; ++h) {
+            touched.append(origin(h));
+            const int t = m_twins[h];
+            if (t >= 0 && !inRegion(t)) {
+                m_twins[t] = -1;
+                outside.append(t);
+            }
+            m_twins[h] = -1;
+        }
+    }
+
+    // 2) 새 정점 기록
+    for (int i = 0; i < faces.size(); ++i) {
+        for (int corner = 0; corner < 3; ++corner) {
+            m_indices[faces[i] * 3 + corner] = triples[i * 3 + corner];
+            touched.append(int(triples[i * 3 + corner]));
+        }
+    }
+
+    // 3) 반대 반변은 묶음 안 또는 끊어 둔 바깥 반변에서만 찾음
+    auto pairWith = [this](int h, int candidate) {
+        if (candidate == h || m_twins[candidate] >= 0) return false;
+        if (origin(candidate) != target(h) || target(candidate) != origin(h)) return false;
+        m_twins[h] = candidate;
+        m_twins[candidate] = h;
+        return true;
+    };
+    for (int f : faces) {
+        for (int h = f * 3; h < f * 3 + 3; ++h) {
+            if (m_twins[h] >= 0) continue;
+            bool paired = false;
+            for (int g : faces) {
+                for (int candidate = g * 3; candidate < g * 3 + 3 && !paired; ++candidate) {
+                    paired = pairWith(h, candidate);
+                }
+                if (paired) break;
+            }
+            for (int i = 0; i < outside.size() && !paired; ++i) {
+                paired = pairWith(h, outside[i]);
+            }
+        }
+    }
+
+    // 4) 닿은 정점의 나가는 반변 다시 고름 (묶음 밖의 유효한 포인터는 유지, 경계 반변 우선)
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (int v : touched) {
+        int best = m_vertexHalfEdges[v];
+        if (best >= 0 && (inRegion(best) || origin(best) != v)) best = -1;
+        for (int f : faces) {
+            for (int h = f * 3; h < f * 3 + 3; ++h) {
+                if (origin(h) != v) continue;
+                if (best < 0 || (m_twins[h] < 0 && m_twins[best] >= 0)) best = h;
+            }
+        }
+        for (int t : outside) {
+            if (best < 0 && origin(t) == v) best = t;
+        }
+        m_vertexHalfEdges[v] = best;
+    }
+    return true;
+}
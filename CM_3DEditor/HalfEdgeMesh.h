@@ -0,0 +1,85 @@
+#ifndef HALFEDGEMESH_H
+#define HALFEDGEMESH_H
+
+#include <QVector>
+#include <atomic>
+
+// 배열 기반 반변(half-edge) 위상 구조
+// 삼각형 f의 반변은 3f, 3f+1, 3f+2로 고정되어 next/prev/face가 계산만으로 나오고,
+// 반변 h의 시작 정점은 인덱스 버퍼의 h번째 값과 같음 (getIndices()가 그대로 GPU 인덱스 버퍼).
+// 원소별 힙 노드 없이 반대 반변(twin)과 정점별 나가는 반변 배열만 추가로 보관
+// 세 개 이상의 면이 공유하거나 방향이 엇갈린 변은 연결하지 않고 경계처럼 취급
+class HalfEdgeMesh
+{
+public:
+    HalfEdgeMesh();
+
+    // 인덱스 버퍼로 구축 (GL 호출 없음, 스레드 안전). 변 키를 병렬 정렬해 짝을 찾음
+    // cancel이 설정되면 중단하고 false 반환
+    bool build(const QVector<unsigned int>& indices, int vertexCount, const std::atomic_bool* cancel = nullptr);
+    void clear();
+
+    bool isEmpty() const { return m_indices.isEmpty(); }
+    int getVertexCount() const { return m_vertexHalfEdges.size(); }
+    int getFaceCount() const { return m_indices.size() / 3; }
+    int getHalfEdgeCount() const { return m_indices.size(); }
+
+    // O(1) 질의
+    static int face(int h) { return h / 3; }
+    static int next(int h) { return h % 3 == 2 ? h - 2 : h + 1; }
+    static int prev(int h) { return h % 3 == 0 ? h + 2 : h - 1; }
+    int origin(int h) const { return int(m_indices[h]); }
+    int target(int h) const { return int(m_indices[next(h)]); }
+    int twin(int h) const { return m_twins[h]; }
+    bool isBoundary(int h) const { return m_twins[h] < 0; }
+
+    // 정점에서 나가는 반변 하나 (경계 정점이면 경계 반변, 면이 없으면 -1)
+    int outgoing(int v) const { return m_vertexHalfEdges[v]; }
+    bool isBoundaryVertex(int v) const { return m_vertexHalfEdges[v] >= 0 && m_twins[m_vertexHalfEdges[v]] < 0; }
+
+    // 정점 주위 질의 (O(차수)). 한 정점에 면 부채꼴이 여럿인 비다양체 정점은 첫 부채꼴만 돎
+    template <typename Function>
+    void forEachOutgoing(int v, Function function) const;
+    void oneRing(int v, QVector<int>& vertices) const;
+    int valence(int v) const;
+    int findHalfEdge(int from, int to) const;
+
+    // 경계 반변 수 (비다양체 변 포함), 구축 시점의 비다양체 변 수
+    int getBoundaryHalfEdgeCount() const;
+    int getNonManifoldEdgeCount() const { return m_nonManifoldEdgeCount; }
+
+    // 변 뒤집기: h와 반대편 삼각형이 이루는 사각형의 다른 대각선으로 바꿈
+    // 경계 변이거나 새 대각선이 이미 있으면 false. faces에 바뀐 두 면 번호(오름차순)
+    bool canFlip(int h) const;
+    bool flipEdge(int h, QVector<int>* faces = nullptr);
+
+    // 면들의 정점을 바꾸고 그 면들의 반대 반변과 정점 포인터만 다시 연결
+    // 바뀐 면 묶음의 바깥 경계 변이 그대로인 작은 편집(변 뒤집기, 그 되돌리기 등)용
+    // triples: faces와 같은 순서로 면마다 정점 3개
+    bool replaceTriangles(const QVector<int>& faces, const QVector<unsigned int>& triples);
+
+    // GPU 인덱스 버퍼와 같은 배치 (반변 h의 시작 정점 = 인덱스 h)
+    const QVector<unsigned int>& getIndices() const { return m_indices; }
+
+private:
+    QVector<unsigned int> m_indices;    // 반변 → 시작 정점
+    QVector<qint32> m_twins;            // 반변 → 반대 반변 (-1: 경계)
+    QVector<qint32> m_vertexHalfEdges;  // 정점 → 나가는 반변
+    int m_nonManifoldEdgeCount;
+};
+
+template <typename Function>
+void HalfEdgeMesh::forEachOutgoing(int v, Function function) const
+{
+    // 들어오는 반변(prev)의 반대편이 다음 나가는 반변. 경계 반변에서 시작하므로 경계를 만나면 끝
+    const int start = m_vertexHalfEdges[v];
+    if (start < 0) return;
+
+    int h = start;
+    do {
+        function(h);
+        h = m_twins[prev(h)];
+    } while (h >= 0 && h != start);
+}
+
+#endif // HALFEDGEMESH_H
@@ -0,0 +1,179 @@
+#include "KdTree.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 14;
+
+    struct BuildPoint {
+        QVector3D position;
+        int vertex;
+    };
+
+    // 구간 [begin, end)의 두 자식 경계 (리프 판정과 질의가 같은 규칙을 씀)
+    inline int splitPoint(int begin, int end)
+    {
+        return begin + (end - begin) / 2;
+    }
+}
+
+KdTree::KdTree()
+{
+}
+
+void KdTree::clear()
+{
+    m_points.clear();
+    m_order.clear();
+    m_splitAxes.clear();
+    m_splitValues.clear();
+}
+
+bool KdTree::build(const QVector<VertexData>& vertices, const std::atomic_bool* cancel)
+{
+    QElapsedTimer timer;
+    timer.start();
+    clear();
+
+    const int count = vertices.size();
+    if (count == 0) return false;
+
+    QVector<BuildPoint> points(count);
+    BuildPoint* pointData = points.data();
+    Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            pointData[i] = { vertices[i].position, int(i) };
+        }
+    });
+
+    // 가장 큰 노드(올림)도 MaxLeafSize 이하가 될 때까지 깊이마다 반씩 나눔
+    int depth = 0;
+    while (((count - 1) >> depth) + 1 > MaxLeafSize) ++depth;
+    const int nodeCount = (1 << depth) - 1;
+    QVector<quint8> axes(nodeCount, 0);
+    QVector<float> values(nodeCount, 0.0f);
+
+    QVector<int> begins = { 0 };
+    QVector<int> ends = { count };
+    for (int level = 0; level < depth; ++level) {
+        // 같은 깊이의 노드는 겹치지 않는 구간이므로 병렬로 분할 (위쪽 깊이는 노드 수가 적어 한 스레드)
+        const int firstNode = (1 << level) - 1;
+        QVector<int> nextBegins(begins.size() * 2);
+        QVector<int> nextEnds(begins.size() * 2);
+        Parallel::parallelFor(begins.size(), qMax<qsizetype>(1, ParallelGrain / qMax(1, count >> level)),
+                              [&](qsizetype first, qsizetype last) {
+            for (qsizetype n = first; n < last; ++n) {
+                const int begin = begins[n];
+                const int end = ends[n];
+                const int middle = splitPoint(begin, end);
+                nextBegins[n * 2] = begin;
+                nextEnds[n * 2] = middle;
+                nextBegins[n * 2 + 1] = middle;
+                nextEnds[n * 2 + 1] = end;
+                if (end - begin <= MaxLeafSize) continue;
+
+                // 가장 긴 축에서 중앙값으로 분할
+                QVector3D boxMin = pointData[begin].position;
+                QVector3D boxMax = boxMin;
+                for (int i = begin + 1; i < end; ++i) {
+                    const QVector3D& p = pointData[i].position;
+                    boxMin = QVector3D(qMin(boxMin.x(), p.x()), qMin(boxMin.y(), p.y()), qMin(boxMin.z(), p.z()));
+                    boxMax = QVector3D(qMax(boxMax.x(), p.x()), qMax(boxMax.y(), p.y()), qMax(boxMax.z(), p.z()));
+                }
+                const QVector3D extent = boxMax - boxMin;
+                int axis = extent.x() >= extent.y() ? 0 : 1;
+                if (extent.z() > extent[axis]) axis = 2;
+
+                std::nth_element(pointData + begin, pointData + middle, pointData + end,
+                                 [axis](const BuildPoint& a, const BuildPoint& b) {
+                    return a.position[axis] < b.position[axis];
+                });
+                axes[firstNode + n] = quint8(axis);
+                values[firstNode + n] = pointData[middle].position[axis];
+            }
+        });
+        begins.swap(nextBegins);
+        ends.swap(nextEnds);
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+    }
+
+    QVector<QVector3D> positions(count);
+    QVector<int> order(count);
+    QVector3D* positionData = positions.data();
+    int* orderData = order.data();
+    Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            positionData[i] = pointData[i].position;
+            orderData[i] = pointData[i].vertex;
+        }
+    });
+
+    m_points.swap(positions);
+    m_order.swap(order);
+    m_splitAxes.swap(axes);
+    m_splitValues.swap(values);
+
+    qDebug() << "KD-tree built:" << count << "points," << nodeCount << "nodes in" << timer.elapsed() << "ms";
+    return true;
+}
+
+int KdTree::findNearest(const QVector3D& point, int k, int* vertices, float* distancesSquared) const
+{
+    k = qMin(qMin(k, MaxNeighbors), int(m_points.size()));
+    if (k <= 0) return 0;
+
+    // 가까운 자식을 먼저 내려가고, 먼 자식은 분할 평면까지 거리가 현재 k번째보다 가까울 때만 봄
+    struct Entry {
+        int node;
+        int begin;
+        int end;
+        float distance;     // 분할 평면까지 거리 제곱 (하한)
+    };
+    Entry stack[64];
+    int top = 0;
+    stack[top++] = { 0, 0, int(m_points.size()), 0.0f };
+
+    const QVector3D* points = m_points.constData();
+    int found = 0;
+    while (top > 0) {
+        const Entry entry = stack[--top];
+        if (found == k && entry.distance >= distancesSquared[k - 1]) continue;
+
+        if (entry.end - entry.begin <= MaxLeafSize) {
+            // 거리순 삽입 정렬 (k가 작으므로 힙보다 빠름)
+            for (int i = entry.begin; i < entry.end; ++i) {
+                const float d = (points[i] - point).lengthSquared();
+                if (found == k && d >= distancesSquared[k - 1]) continue;
+
+                int slot = found < k ? found++ : k - 1;
+                while (slot > 0 && distancesSquared[slot - 1] > d) {
+                    distancesSquared[slot] = distancesSquared[slot - 1];
+                    vertices[slot] = vertices[slot - 1];
+                    --slot;
+                }
+                distancesSquared[slot] = d;
+                vertices[slot] = i;
+            }
+            continue;
+        }
+
+        const int axis = m_splitAxes[entry.node];
+        const float diff = point[axis] - m_splitValues[entry.node];
+        const int middle = splitPoint(entry.begin, entry.end);
+        const Entry left = { entry.node * 2 + 1, entry.begin, middle, entry.distance };
+        const Entry right = { entry.node * 2 + 2, middle, entry.end, entry.distance };
+        Entry farEntry = diff < 0.0f ? right : left;
+        farEntry.distance = qMax(entry.distance, diff * diff);
+        stack[top++] = farEntry;
+        stack[top++] = diff < 0.0f ? left : right;
+    }
+
+    // 트리 위치를 원래 정점 번호로
+    for (int i = 0; i < found; ++i) {
+        vertices[i] = m_order[vertices[i]];
+    }
+    return found;
+}
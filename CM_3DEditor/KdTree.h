@@ -0,0 +1,42 @@
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <QVector>
+#include <QVector3D>
+#include <atomic>
+#include "Mesh.h"
+
+// 점 k-최근접 이웃 색인 (암시적 균형 KD-트리)
+// 노드 h의 자식은 2h+1, 2h+2이고 구간은 항상 반으로 나뉘므로 노드에는 분할 축과 값만 둠.
+// 점은 트리 순서로 재배치해 보관하므로 한 리프의 점이 메모리에 붙어 있고,
+// 같은 깊이의 노드는 서로 독립이라 깊이마다 병렬로 분할
+class KdTree
+{
+public:
+    static constexpr int MaxLeafSize = 16;
+    static constexpr int MaxNeighbors = 64;
+
+    KdTree();
+
+    // 정점 위치로 구축 (GL 호출 없음, 스레드 안전). cancel이 설정되면 중단하고 false 반환
+    bool build(const QVector<VertexData>& vertices, const std::atomic_bool* cancel = nullptr);
+    void clear();
+
+    bool isEmpty() const { return m_points.isEmpty(); }
+    int getPointCount() const { return m_points.size(); }
+
+    // 트리 순서 → 원래 정점 번호 (공간적으로 가까운 점이 이웃하므로 질의 순서로 쓰면 캐시 효율이 좋음)
+    const QVector<int>& getOrder() const { return m_order; }
+
+    // point에서 가까운 순서로 최대 k개 (k <= MaxNeighbors). 원래 정점 번호와 거리 제곱을 쓰고 찾은 수 반환
+    // 질의는 읽기만 하므로 여러 스레드에서 동시에 호출 가능
+    int findNearest(const QVector3D& point, int k, int* vertices, float* distancesSquared) const;
+
+private:
+    QVector<QVector3D> m_points;    // 트리 순서
+    QVector<int> m_order;           // 트리 순서 → 원래 정점 번호
+    QVector<quint8> m_splitAxes;    // 내부 노드의 분할 축
+    QVector<float> m_splitValues;
+};
+
+#endif // KDTREE_H
@@ -1,16 +1,119 @@
 #include "Mesh.h"
+#include "Parallel.h"
+#include "MeshComponents.h"
 #include <QDebug>
 #include <QVector>
+#include <QFile>
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+
+namespace {
+    // 클러스터당 목표 삼각형 수
+    const int ClusterTriangles = 1024;
+
+    // 이보다 작은 연결 성분은 따로 클러스터를 만들지 않고 같은 셀의 다른 작은 성분과 묶음
+    const int ComponentClusterTriangles = ClusterTriangles / 8;
+
+    // 클러스터 키 계산/정렬의 조각 크기
+    const int ClusterGrain = 1 << 14;
+
+    // 다시 올릴 구간 사이의 빈틈이 이 워드 수(워드 = 삼각형 64개) 이하면 한 번에 올림
+    const int UploadMergeWords = 64;
+
+    // 바뀐 정점 사이의 빈틈이 이 정점 수 이하면 한 구간으로 올림
+    const int UploadMergeVertices = 32;
+
+    // 숨김 비트셋 비교/구간 추출의 조각 크기
+    const int VisibilityGrain = 1 << 14;
+
+    // 저장할 때 한 번에 문자열로 바꾸는 줄 수 (묶음 안에서 조각별 병렬 변환 후 순서대로 씀)
+    const int SaveBlockLines = 1 << 18;
+    const int SaveGrain = 1 << 12;
+
+    // format(line, buffer, size)로 count줄을 만들어 순서대로 씀 (줄 길이는 buffer 크기 이하)
+    template <typename Format>
+    bool writeLines(QFile& file, int count, Format format)
+    {
+        for (int blockBegin = 0; blockBegin < count; blockBegin += SaveBlockLines) {
+            const int blockSize = qMin(SaveBlockLines, count - blockBegin);
+            QVector<QByteArray> parts(Parallel::chunkCount(blockSize, SaveGrain));
+            Parallel::forEachChunk(blockSize, SaveGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+                QByteArray& part = parts[chunk];
+                part.reserve(int(end - begin) * 64);
+                char line[256];
+                for (qsizetype i = begin; i < end; ++i) {
+                    part.append(line, format(blockBegin + int(i), line, int(sizeof(line))));
+                }
+            });
+            for (const QByteArray& part : parts) {
+                if (file.write(part) != part.size()) return false;
+            }
+        }
+        return true;
+    }
 
-struct VertexData {
-    QVector3D position;
-    QVector3D normal;
-    QVector3D color;
-    QVector2D texCoord;
-};
+    struct WordSpan {
+        int first;
+        int end;
+    };
+
+    // [begin, end)에서 비트 값이 value인 첫 위치 (없으면 end)
+    int findBit(const quint64* words, int begin, int end, bool value)
+    {
+        if (begin >= end) return end;
+        int w = begin >> 6;
+        quint64 word = (value ? words[w] : ~words[w]) & (~quint64(0) << (begin & 63));
+        while (!word) {
+            if (++w * 64 >= end) return end;
+            word = value ? words[w] : ~words[w];
+        }
+        return qMin(w * 64 + int(qCountTrailingZeroBits(word)), end);
+    }
 
-Mesh::Mesh() : m_vertexCount(0), m_indexCount(0), m_boundingRadius(0.0f)
+    // [begin, end)에서 비트 값이 value인 마지막 위치 (없으면 begin - 1)
+    int findLastBit(const quint64* words, int begin, int end, bool value)
+    {
+        if (begin >= end) return begin - 1;
+        int w = (end - 1) >> 6;
+        quint64 word = (value ? words[w] : ~words[w]) & (~quint64(0) >> (63 - ((end - 1) & 63)));
+        while (!word) {
+            if (--w < 0 || (w + 1) * 64 <= begin) return begin - 1;
+            word = value ? words[w] : ~words[w];
+        }
+        int bit = w * 64 + 63 - int(qCountLeadingZeroBits(word));
+        return bit >= begin ? bit : begin - 1;
+    }
+}
+
+void MeshDrawRanges::clear()
+{
+    first.clear();
+    count.clear();
+    offset.clear();
+}
+
+void MeshDrawRanges::append(int start, int length)
+{
+    if (length <= 0) return;
+    if (!count.isEmpty() && first.last() + count.last() == start) {
+        count.last() += length;
+        return;
+    }
+    first.append(start);
+    count.append(length);
+    offset.append(reinterpret_cast<const void*>(qintptr(start) * sizeof(unsigned int)));
+}
+
+Mesh::Mesh()
+    : m_vertexCount(0)
+    , m_indexCount(0)
+    , m_revision(0)
+    , m_vertexRevision(0)
+    , m_hiddenFaceCount(0)
+    , m_hiddenVertexCount(0)
+    , m_visibilityRevision(0)
+    , m_boundingRadius(0.0f)
 {
     initializeOpenGLFunctions();
     initializeBuffers();
@@ -22,6 +125,21 @@ Mesh::~Mesh()
 }
 
 bool Mesh::loadFromPLY(const QString& filename)
+{
+    MeshData data;
+    if (!loadData(filename, data)) {
+        return false;
+    }
+
+    if (!upload(data)) {
+        return false;
+    }
+    
+    qDebug() << "Mesh loaded successfully:" << m_vertexCount << "vertices," << m_indexCount << "indices";
+    return true;
+}
+
+bool Mesh::loadData(const QString& filename, MeshData& data)
 {
     PLYLoader loader;
     if (!loader.loadPLY(filename)) {
@@ -29,13 +147,404 @@ bool Mesh::loadFromPLY(const QString& filename)
         return false;
     }
 
-    uploadData(loader);
-    calculateBoundingBox(loader);
+    prepareData(loader, data);
+    calculateBoundingBox(loader, data);
+    return true;
+}
+
+bool Mesh::saveData(const QString& filename, const MeshData& data)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Failed to open PLY file for writing:" << filename;
+        return false;
+    }
+
+    const QVector<VertexData>& vertices = data.vertices;
+    const int faceCount = data.indices.size() / 3;
+    const bool texCoords = std::any_of(vertices.begin(), vertices.end(), [](const VertexData& vertex) {
+        return !vertex.texCoord.isNull();
+    });
+
+    // PLYLoader가 읽는 속성 순서 (위치, 법선, 색, 텍스처 좌표)
+    QByteArray header = "ply\nformat ascii 1.0\ncomment CM_3DEditor\n";
+    header += "element vertex " + QByteArray::number(vertices.size()) + "\n";
+    header += "property float x\nproperty float y\nproperty float z\n";
+    header += "property float nx\nproperty float ny\nproperty float nz\n";
+    header += "property uchar red\nproperty uchar green\nproperty uchar blue\nproperty uchar alpha\n";
+    if (texCoords) {
+        header += "property float s\nproperty float t\n";
+    }
+    header += "element face " + QByteArray::number(faceCount) + "\n";
+    header += "property list uchar int vertex_indices\nend_header\n";
+
+    const VertexData* vertexData = vertices.constData();
+    const unsigned int* indexData = data.indices.constData();
+    bool written = file.write(header) == header.size();
+    written = written && writeLines(file, vertices.size(), [vertexData, texCoords](int v, char* line, int size) {
+        const VertexData& vertex = vertexData[v];
+        int length = std::snprintf(line, size, "%.9g %.9g %.9g %.6g %.6g %.6g %d %d %d 255",
+                                   vertex.position.x(), vertex.position.y(), vertex.position.z(),
+                                   vertex.normal.x(), vertex.normal.y(), vertex.normal.z(),
+                                   qBound(0, qRound(vertex.color.x() * 255.0f), 255),
+                                   qBound(0, qRound(vertex.color.y() * 255.0f), 255),
+                                   qBound(0, qRound(vertex.color.z() * 255.0f), 255));
+        if (texCoords) {
+            length += std::snprintf(line + length, size - length, " %.9g %.9g", vertex.texCoord.x(), vertex.texCoord.y());
+        }
+        line[length++] = '\n';
+        return length;
+    });
+    written = written && writeLines(file, faceCount, [indexData](int f, char* line, int size) {
+        return std::snprintf(line, size, "3 %u %u %u\n", indexData[f * 3], indexData[f * 3 + 1], indexData[f * 3 + 2]);
+    });
+    file.close();
+
+    if (!written) {
+        qDebug() << "Failed to write PLY file:" << filename;
+        return false;
+    }
+    qDebug() << "Saved PLY file with" << vertices.size() << "vertices and" << faceCount << "faces:" << filename;
+    return true;
+}
+
+void Mesh::completeData(MeshData& data)
+{
+    buildClusters(data.vertices, data.indices, data.clusters, data.components);
+    
+    data.boundingBoxMin = QVector3D();
+    data.boundingBoxMax = QVector3D();
+    data.boundingRadius = 0.0f;
+    if (data.vertices.isEmpty()) return;
+    
+    data.boundingBoxMin = data.vertices.first().position;
+    data.boundingBoxMax = data.boundingBoxMin;
+    for (const VertexData& vertex : data.vertices) {
+        const QVector3D& p = vertex.position;
+        data.boundingBoxMin = QVector3D(qMin(data.boundingBoxMin.x(), p.x()), qMin(data.boundingBoxMin.y(), p.y()), qMin(data.boundingBoxMin.z(), p.z()));
+        data.boundingBoxMax = QVector3D(qMax(data.boundingBoxMax.x(), p.x()), qMax(data.boundingBoxMax.y(), p.y()), qMax(data.boundingBoxMax.z(), p.z()));
+    }
+    
+    QVector3D center = (data.boundingBoxMin + data.boundingBoxMax) * 0.5f;
+    for (const VertexData& vertex : data.vertices) {
+        data.boundingRadius = qMax(data.boundingRadius, (vertex.position - center).length());
+    }
+}
+
+bool Mesh::upload(const MeshData& data)
+{
+    if (!m_vao.isCreated()) {
+        qDebug() << "Cannot upload mesh without GL buffers";
+        return false;
+    }
+
+    m_vertexCount = data.vertices.size();
+    m_indexCount = data.indices.size();
+    m_clusters = data.clusters;
+    m_boundingBoxMin = data.boundingBoxMin;
+    m_boundingBoxMax = data.boundingBoxMax;
+    m_boundingRadius = data.boundingRadius;
+    ++m_revision;
     
-    qDebug() << "Mesh loaded successfully:" << m_vertexCount << "vertices," << m_indexCount << "indices";
+    // CPU 사본과 숨김 초기화 (암시적 공유라 복사 없음)
+    m_vertices = data.vertices;
+    m_sourceIndices = data.indices;
+    m_updatedVertices.clear();
+    ++m_vertexRevision;
+    m_hiddenFaces.resize(m_indexCount / 3);
+    m_hiddenVertices.resize(m_vertexCount);
+    m_hiddenFaceCount = 0;
+    m_hiddenVertexCount = 0;
+    updateVisibleFaces();
+    updateVisiblePoints();
+    ++m_visibilityRevision;
+
+    // VAO 바인딩
+    m_vao.bind();
+
+    // Vertex buffer 업로드
+    m_vertexBuffer.bind();
+    m_vertexBuffer.allocate(data.vertices.constData(), data.vertices.size() * sizeof(VertexData));
+
+    // Vertex attributes 설정
+    setupVertexAttributes(this);
+
+    // Index buffer 업로드
+    m_indexBuffer.bind();
+    m_indexBuffer.allocate(data.indices.constData(), data.indices.size() * sizeof(unsigned int));
+
+    m_vao.release();
+    return true;
+}
+
+bool Mesh::updateVertices(const QVector<int>& vertices, const QVector<int>& triangles)
+{
+    if (vertices.isEmpty() || !m_vertexBuffer.isCreated()) return false;
+    
+    // 가까운 정점끼리 묶어 호출 수를 줄임 (빈틈은 변하지 않은 값을 다시 올릴 뿐)
+    m_updatedVertices.clear();
+    int runStart = vertices.first();
+    int runEnd = runStart + 1;
+    for (int i = 1; i < vertices.size(); ++i) {
+        int v = vertices[i];
+        if (v - runEnd <= UploadMergeVertices) {
+            runEnd = qMax(runEnd, v + 1);
+        } else {
+            m_updatedVertices.append(runStart, runEnd - runStart);
+            runStart = v;
+            runEnd = v + 1;
+        }
+    }
+    m_updatedVertices.append(runStart, runEnd - runStart);
+    
+    // VAO 상태를 건드리지 않도록 복사용 타깃으로 올림
+    const VertexData* vertexData = m_vertices.constData();
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer.bufferId());
+    for (int i = 0; i < m_updatedVertices.size(); ++i) {
+        glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(m_updatedVertices.first[i]) * sizeof(VertexData),
+                        GLsizeiptr(m_updatedVertices.count[i]) * sizeof(VertexData),
+                        vertexData + m_updatedVertices.first[i]);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    
+    updateClusterBounds(triangles);
+    
+    // 경계 상자와 반지름은 넓히기만 함
+    const QVector3D oldCenter = getCenter();
+    for (int v : vertices) {
+        const QVector3D& p = vertexData[v].position;
+        m_boundingBoxMin = QVector3D(qMin(m_boundingBoxMin.x(), p.x()), qMin(m_boundingBoxMin.y(), p.y()), qMin(m_boundingBoxMin.z(), p.z()));
+        m_boundingBoxMax = QVector3D(qMax(m_boundingBoxMax.x(), p.x()), qMax(m_boundingBoxMax.y(), p.y()), qMax(m_boundingBoxMax.z(), p.z()));
+    }
+    
+    // 중심이 옮겨 간 만큼 기존 반지름을 늘려 나머지 정점도 계속 감싸고, 움직인 정점까지의 거리로 넓힘
+    const QVector3D center = getCenter();
+    if (center != oldCenter) {
+        m_boundingRadius += (center - oldCenter).length();
+    }
+    for (int v : vertices) {
+        m_boundingRadius = qMax(m_boundingRadius, (vertexData[v].position - center).length());
+    }
+    
+    ++m_vertexRevision;
     return true;
 }
 
+bool Mesh::updateTriangles(const unsigned int* indices, const QVector<int>& triangles)
+{
+    if (triangles.isEmpty() || !m_indexBuffer.isCreated()) return false;
+    
+    // 원본 인덱스를 고치고, 숨긴 삼각형은 퇴화 삼각형으로 만들어 바로 올림
+    // (편집은 몇 개의 삼각형만 바꾸므로 이어지는 번호끼리만 한 번에 올림)
+    unsigned int* source = m_sourceIndices.data();
+    const quint64* hiddenWords = m_hiddenFaces.constData();
+    QVector<unsigned int> staging;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer.bufferId());
+    for (int i = 0; i < triangles.size(); ++i) {
+        const int t = triangles[i];
+        unsigned int* triangle = source + qsizetype(t) * 3;
+        triangle[0] = indices[qsizetype(t) * 3];
+        triangle[1] = indices[qsizetype(t) * 3 + 1];
+        triangle[2] = indices[qsizetype(t) * 3 + 2];
+        
+        bool hide = (hiddenWords[t >> 6] >> (t & 63)) & 1u;
+        staging.append(triangle[0]);
+        staging.append(hide ? triangle[0] : triangle[1]);
+        staging.append(hide ? triangle[0] : triangle[2]);
+        
+        if (i + 1 == triangles.size() || triangles[i + 1] != t + 1) {
+            const int first = t + 1 - int(staging.size() / 3);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(first) * 3 * sizeof(unsigned int),
+                            GLsizeiptr(staging.size()) * sizeof(unsigned int), staging.constData());
+            staging.clear();
+        }
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    
+    updateClusterBounds(triangles);
+    ++m_visibilityRevision;
+    return true;
+}
+
+void Mesh::updateClusterBounds(const QVector<int>& triangles)
+{
+    // 바뀐 삼각형(오름차순)이 속한 클러스터의 경계 구 다시 계산 (클러스터는 인덱스 순서로 정렬됨)
+    const VertexData* vertexData = m_vertices.constData();
+    QVector<int> dirtyClusters;
+    for (int t : triangles) {
+        auto it = std::upper_bound(m_clusters.constBegin(), m_clusters.constEnd(), t * 3,
+                                   [](int index, const MeshCluster& cluster) { return index < cluster.firstIndex; });
+        int cluster = int(it - m_clusters.constBegin()) - 1;
+        if (cluster >= 0 && (dirtyClusters.isEmpty() || dirtyClusters.last() != cluster)) {
+            dirtyClusters.append(cluster);
+        }
+    }
+    for (int c : dirtyClusters) {
+        MeshCluster& cluster = m_clusters[c];
+        const unsigned int* indexData = m_sourceIndices.constData() + cluster.firstIndex;
+        QVector3D clusterMin = vertexData[indexData[0]].position;
+        QVector3D clusterMax = clusterMin;
+        for (int i = 1; i < cluster.indexCount; ++i) {
+            const QVector3D& p = vertexData[indexData[i]].position;
+            clusterMin = QVector3D(qMin(clusterMin.x(), p.x()), qMin(clusterMin.y(), p.y()), qMin(clusterMin.z(), p.z()));
+            clusterMax = QVector3D(qMax(clusterMax.x(), p.x()), qMax(clusterMax.y(), p.y()), qMax(clusterMax.z(), p.z()));
+        }
+        cluster.center = (clusterMin + clusterMax) * 0.5f;
+        cluster.radius = (clusterMax - clusterMin).length() * 0.5f;
+        m_visibleClusters[c].center = cluster.center;
+        m_visibleClusters[c].radius = cluster.radius;
+    }
+}
+
+bool Mesh::setHiddenFaces(const SelectionSet& hidden)
+{
+    const int faceCount = m_indexCount / 3;
+    if (hidden.size() != faceCount || !m_indexBuffer.isCreated()) return false;
+    
+    // 이전 숨김과 다른 워드 구간 (조각마다 모은 뒤 이어 붙임)
+    const quint64* oldWords = m_hiddenFaces.constData();
+    const quint64* newWords = hidden.constData();
+    const int wordCount = hidden.getWordCount();
+    QVector<QVector<WordSpan>> chunkSpans(Parallel::chunkCount(wordCount, VisibilityGrain));
+    Parallel::forEachChunk(wordCount, VisibilityGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        QVector<WordSpan>& spans = chunkSpans[chunk];
+        for (qsizetype w = begin; w < end; ++w) {
+            if (oldWords[w] == newWords[w]) continue;
+            if (!spans.isEmpty() && w - spans.last().end <= UploadMergeWords) {
+                spans.last().end = int(w) + 1;
+            } else {
+                spans.append({ int(w), int(w) + 1 });
+            }
+        }
+    });
+    
+    QVector<WordSpan> spans;
+    for (const QVector<WordSpan>& chunk : chunkSpans) {
+        for (const WordSpan& span : chunk) {
+            if (!spans.isEmpty() && span.first - spans.last().end <= UploadMergeWords) {
+                spans.last().end = span.end;
+            } else {
+                spans.append(span);
+            }
+        }
+    }
+    
+    // 바뀐 구간의 인덱스를 원본에서 다시 만들어 스테이징 버퍼에 모음
+    // 숨긴 삼각형은 첫 정점을 세 번 써서 래스터화되지 않게 함 (정점 캐시에도 부담 없음)
+    QVector<qsizetype> stagingOffsets(spans.size() + 1, 0);
+    for (int i = 0; i < spans.size(); ++i) {
+        int firstTriangle = spans[i].first * 64;
+        int endTriangle = qMin(spans[i].end * 64, faceCount);
+        stagingOffsets[i + 1] = stagingOffsets[i] + qsizetype(endTriangle - firstTriangle) * 3;
+    }
+    
+    QVector<unsigned int> staging(stagingOffsets.last());
+    unsigned int* stagingData = staging.data();
+    const unsigned int* source = m_sourceIndices.constData();
+    Parallel::parallelFor(spans.size(), 4, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            int firstTriangle = spans[i].first * 64;
+            int endTriangle = qMin(spans[i].end * 64, faceCount);
+            unsigned int* out = stagingData + stagingOffsets[i];
+            for (int t = firstTriangle; t < endTriangle; ++t, out += 3) {
+                const unsigned int* triangle = source + qsizetype(t) * 3;
+                bool hide = (newWords[t >> 6] >> (t & 63)) & 1u;
+                out[0] = triangle[0];
+                out[1] = hide ? triangle[0] : triangle[1];
+                out[2] = hide ? triangle[0] : triangle[2];
+            }
+        }
+    });
+    
+    // VAO의 인덱스 버퍼 바인딩을 건드리지 않도록 복사용 타깃으로 올림
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer.bufferId());
+    for (int i = 0; i < spans.size(); ++i) {
+        glBufferSubData(GL_COPY_WRITE_BUFFER,
+                        GLintptr(spans[i].first) * 64 * 3 * sizeof(unsigned int),
+                        GLsizeiptr(stagingOffsets[i + 1] - stagingOffsets[i]) * sizeof(unsigned int),
+                        stagingData + stagingOffsets[i]);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    
+    m_hiddenFaces = hidden;
+    m_hiddenFaceCount = hidden.count();
+    updateVisibleFaces();
+    ++m_visibilityRevision;
+    return true;
+}
+
+bool Mesh::setHiddenVertices(const SelectionSet& hidden)
+{
+    if (hidden.size() != m_vertexCount) return false;
+    
+    // 점은 정점 버퍼를 그대로 두고 보이는 정점 구간만 그림 (gl_VertexID = 정점 번호 유지)
+    m_hiddenVertices = hidden;
+    m_hiddenVertexCount = hidden.count();
+    updateVisiblePoints();
+    ++m_visibilityRevision;
+    return true;
+}
+
+void Mesh::updateVisibleFaces()
+{
+    m_visibleClusters = m_clusters;
+    m_visibleFaces.clear();
+    
+    if (m_hiddenFaceCount > 0) {
+        const quint64* hidden = m_hiddenFaces.constData();
+        MeshCluster* clusters = m_visibleClusters.data();
+        Parallel::parallelFor(m_visibleClusters.size(), 256, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype c = begin; c < end; ++c) {
+                MeshCluster& cluster = clusters[c];
+                int first = cluster.firstIndex / 3;
+                int last = first + cluster.indexCount / 3;
+                int firstVisible = findBit(hidden, first, last, false);
+                int lastVisible = findLastBit(hidden, first, last, false);
+                cluster.firstIndex = firstVisible * 3;
+                cluster.indexCount = firstVisible < last ? (lastVisible + 1 - firstVisible) * 3 : 0;
+            }
+        });
+    }
+    
+    // 클러스터는 인덱스 버퍼 순서대로이므로 이어지는 구간이 합쳐짐
+    if (m_visibleClusters.isEmpty()) {
+        m_visibleFaces.append(0, m_indexCount);
+    }
+    for (const MeshCluster& cluster : m_visibleClusters) {
+        m_visibleFaces.append(cluster.firstIndex, cluster.indexCount);
+    }
+}
+
+void Mesh::updateVisiblePoints()
+{
+    m_visiblePoints.clear();
+    if (m_hiddenVertexCount == 0) {
+        m_visiblePoints.append(0, m_vertexCount);
+        return;
+    }
+    
+    // 조각마다 보이는 구간을 찾고 순서대로 이어 붙임 (조각 경계에서 끊긴 구간은 append가 합침)
+    const quint64* hidden = m_hiddenVertices.constData();
+    QVector<MeshDrawRanges> chunkRanges(Parallel::chunkCount(m_vertexCount, VisibilityGrain * 64));
+    Parallel::forEachChunk(m_vertexCount, VisibilityGrain * 64, [&](int chunk, qsizetype begin, qsizetype end) {
+        MeshDrawRanges& ranges = chunkRanges[chunk];
+        int i = int(begin);
+        while (i < end) {
+            int start = findBit(hidden, i, int(end), false);
+            if (start >= end) break;
+            int stop = findBit(hidden, start, int(end), true);
+            ranges.append(start, stop - start);
+            i = stop;
+        }
+    });
+    
+    for (const MeshDrawRanges& ranges : chunkRanges) {
+        for (int i = 0; i < ranges.size(); ++i) {
+            m_visiblePoints.append(ranges.first[i], ranges.count[i]);
+        }
+    }
+}
+
 void Mesh::setTransform(const QMatrix4x4& transform)
 {
     m_transform = transform;
@@ -92,9 +601,9 @@ void Mesh::initializeBuffers()
     m_vao.create();
     m_vao.bind();
 
-    // Vertex Buffer 생성
+    // Vertex Buffer 생성 (스컬프트 편집으로 일부 구간이 자주 다시 올라감)
     m_vertexBuffer.create();
-    m_vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_vertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
 
     // Index Buffer 생성
     m_indexBuffer.create();
@@ -109,15 +618,14 @@ void Mesh::initializeBuffers()
     m_vao.release();
 }
 
-void Mesh::uploadData(const PLYLoader& loader)
+void Mesh::prepareData(const PLYLoader& loader, MeshData& data)
 {
     const QVector<PLYVertex>& vertices = loader.getVertices();
     const QVector<PLYFace>& faces = loader.getFaces();
 
-    m_vertexCount = vertices.size();
-
     // Vertex 데이터 준비
-    QVector<VertexData> vertexData;
+    QVector<VertexData>& vertexData = data.vertices;
+    vertexData.clear();
     vertexData.reserve(vertices.size());
 
     for (const auto& vertex : vertices) {
@@ -130,7 +638,8 @@ void Mesh::uploadData(const PLYLoader& loader)
     }
 
     // Index 데이터 준비 (삼각형으로 변환)
-    QVector<unsigned int> indices;
+    QVector<unsigned int>& indices = data.indices;
+    indices.clear();
     indices.reserve(faces.size() * 3);
 
     for (const auto& face : faces) {
@@ -144,38 +653,163 @@ void Mesh::uploadData(const PLYLoader& loader)
         }
     }
 
-    m_indexCount = indices.size();
+    // 컬링을 위해 삼각형을 공간 클러스터 순서로 재배치
+    buildClusters(vertexData, indices, data.clusters, data.components);
+}
 
-    // VAO 바인딩
-    m_vao.bind();
+void Mesh::setupVertexAttributes(QOpenGLFunctions* f)
+{
+    f->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), 
+                             reinterpret_cast<const void*>(offsetof(VertexData, position)));
+    f->glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), 
+                             reinterpret_cast<const void*>(offsetof(VertexData, normal)));
+    f->glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), 
+                             reinterpret_cast<const void*>(offsetof(VertexData, color)));
+    f->glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), 
+                             reinterpret_cast<const void*>(offsetof(VertexData, texCoord)));
+}
 
-    // Vertex buffer 업로드
-    m_vertexBuffer.bind();
-    m_vertexBuffer.allocate(vertexData.constData(), vertexData.size() * sizeof(VertexData));
+void Mesh::buildClusters(const QVector<VertexData>& vertices, QVector<unsigned int>& indices,
+                         QVector<MeshCluster>& clusters, std::shared_ptr<const MeshComponents>& components)
+{
+    clusters.clear();
+    components.reset();
+
+    int triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // 바운딩 박스
+    QVector3D boxMin = vertices[indices[0]].position;
+    QVector3D boxMax = boxMin;
+    for (unsigned int index : indices) {
+        const QVector3D& p = vertices[index].position;
+        boxMin = QVector3D(qMin(boxMin.x(), p.x()), qMin(boxMin.y(), p.y()), qMin(boxMin.z(), p.z()));
+        boxMax = QVector3D(qMax(boxMax.x(), p.x()), qMax(boxMax.y(), p.y()), qMax(boxMax.z(), p.z()));
+    }
 
-    // Vertex attributes 설정
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), 
-                         reinterpret_cast<const void*>(offsetof(VertexData, position)));
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), 
-                         reinterpret_cast<const void*>(offsetof(VertexData, normal)));
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), 
-                         reinterpret_cast<const void*>(offsetof(VertexData, color)));
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), 
-                         reinterpret_cast<const void*>(offsetof(VertexData, texCoord)));
+    // 셀당 평균 ClusterTriangles개가 되도록 균일 격자 크기 결정
+    int cellsPerAxis = qBound(1, int(std::cbrt(double(triangleCount) / ClusterTriangles)), 64);
+    QVector3D extent = boxMax - boxMin;
+    QVector3D cellScale(extent.x() > 0.0f ? cellsPerAxis / extent.x() : 0.0f,
+                        extent.y() > 0.0f ? cellsPerAxis / extent.y() : 0.0f,
+                        extent.z() > 0.0f ? cellsPerAxis / extent.z() : 0.0f);
+
+    auto cellOf = [&](int triangle) {
+        QVector3D centroid = (vertices[indices[triangle * 3]].position
+                            + vertices[indices[triangle * 3 + 1]].position
+                            + vertices[indices[triangle * 3 + 2]].position) / 3.0f;
+        QVector3D local = (centroid - boxMin) * cellScale;
+        int x = qBound(0, int(local.x()), cellsPerAxis - 1);
+        int y = qBound(0, int(local.y()), cellsPerAxis - 1);
+        int z = qBound(0, int(local.z()), cellsPerAxis - 1);
+        return (z * cellsPerAxis + y) * cellsPerAxis + x;
+    };
+
+    // 연결 성분이 다른 삼각형은 한 클러스터에 넣지 않음 (떨어진 조각을 감싸는 큰 경계 구를 피함)
+    // 작은 성분(잡음 조각)끼리는 셀 안에서 함께 묶어 클러스터가 지나치게 잘게 나뉘지 않도록 함
+    // 성분 구축은 삼각형 수에 비례하는 병렬 union-find 한 번으로 아래 정렬과 비슷한 비용. 큰 성분이 생길 수 없는
+    // 작은 메시는 구하지 않고, 성분이 하나뿐이거나 큰 성분이 없으면 그룹 키를 빼서 정렬 자릿수를 셀 번호만큼으로 줄임
+    // 구한 성분은 정렬 뒤 삼각형 순서로 옮겨 데이터에 남김 (성분 분석/작은 성분 지우기가 다시 구하지 않도록)
+    QVector<int> triangleGroups;    // 삼각형 → 그룹 (큰 성분마다 1부터 순서대로, 작은 성분은 0)
+    int groupCount = 0;
+    std::shared_ptr<MeshComponents> built;
+    if (triangleCount >= ComponentClusterTriangles) {
+        built = std::make_shared<MeshComponents>();
+        if (!built->build(vertices, indices)) {
+            built.reset();
+        } else if (built->getComponentCount() > 1) {
+            QVector<int> componentGroups(built->getComponentCount(), 0);
+            for (int c = 0; c < componentGroups.size(); ++c) {
+                if (built->getComponent(c).triangleCount >= ComponentClusterTriangles) {
+                    componentGroups[c] = ++groupCount;
+                }
+            }
+            if (groupCount > 0) {
+                triangleGroups.resize(triangleCount);
+                const int* triangleComponents = built->getTriangleComponents().constData();
+                const int* componentGroupData = componentGroups.constData();
+                int* groupData = triangleGroups.data();
+                Parallel::parallelFor(triangleCount, ClusterGrain, [&](qsizetype begin, qsizetype end) {
+                    for (qsizetype t = begin; t < end; ++t) {
+                        groupData[t] = componentGroupData[triangleComponents[t]];
+                    }
+                });
+            }
+        }
+    }
+    int groupBits = 0;
+    while (groupBits < 31 && (groupCount >> groupBits) != 0) ++groupBits;
+
+    // (셀, 그룹) 키로 안정 정렬 (같은 키 안에서는 원래 삼각형 순서)
+    int cellCount = cellsPerAxis * cellsPerAxis * cellsPerAxis;
+    int cellBits = 1;
+    while ((cellCount - 1) >> cellBits) ++cellBits;
+    QVector<quint64> keys(triangleCount);
+    QVector<int> order(triangleCount);
+    quint64* keyData = keys.data();
+    int* orderData = order.data();
+    const bool grouped = !triangleGroups.isEmpty();
+    const int* groupData = triangleGroups.constData();
+    Parallel::parallelFor(triangleCount, ClusterGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype t = begin; t < end; ++t) {
+            const quint64 group = grouped ? quint64(groupData[t]) : 0;
+            keyData[t] = quint64(cellOf(int(t))) << groupBits | group;
+            orderData[t] = int(t);
+        }
+    });
+    Parallel::sortByKey(keys, order, cellBits + groupBits, ClusterGrain);
+
+    QVector<unsigned int> sorted(indices.size());
+    unsigned int* sortedData = sorted.data();
+    orderData = order.data();
+    Parallel::parallelFor(triangleCount, ClusterGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            const int t = orderData[i];
+            sortedData[i * 3] = indices[t * 3];
+            sortedData[i * 3 + 1] = indices[t * 3 + 1];
+            sortedData[i * 3 + 2] = indices[t * 3 + 2];
+        }
+    });
+    indices.swap(sorted);
+    if (built) {
+        built->reorderTriangles(order);
+        components = built;
+    }
 
-    // Index buffer 업로드
-    m_indexBuffer.bind();
-    m_indexBuffer.allocate(indices.constData(), indices.size() * sizeof(unsigned int));
+    // 같은 키 구간마다 클러스터 생성 (너무 큰 구간은 분할)
+    keyData = keys.data();
+    int runStart = 0;
+    for (int t = 1; t <= triangleCount; ++t) {
+        if (t < triangleCount && keyData[t] == keyData[runStart]) continue;
+
+        for (int first = runStart; first < t; first += ClusterTriangles * 4) {
+            int last = qMin(first + ClusterTriangles * 4, t);
+
+            QVector3D clusterMin = vertices[indices[first * 3]].position;
+            QVector3D clusterMax = clusterMin;
+            for (int i = first * 3; i < last * 3; ++i) {
+                const QVector3D& p = vertices[indices[i]].position;
+                clusterMin = QVector3D(qMin(clusterMin.x(), p.x()), qMin(clusterMin.y(), p.y()), qMin(clusterMin.z(), p.z()));
+                clusterMax = QVector3D(qMax(clusterMax.x(), p.x()), qMax(clusterMax.y(), p.y()), qMax(clusterMax.z(), p.z()));
+            }
 
-    m_vao.release();
+            MeshCluster cluster;
+            cluster.firstIndex = first * 3;
+            cluster.indexCount = (last - first) * 3;
+            cluster.center = (clusterMin + clusterMax) * 0.5f;
+            cluster.radius = (clusterMax - clusterMin).length() * 0.5f;
+            clusters.append(cluster);
+        }
+        runStart = t;
+    }
 }
 
-void Mesh::calculateBoundingBox(const PLYLoader& loader)
+void Mesh::calculateBoundingBox(const PLYLoader& loader, MeshData& data)
 {
-    loader.calculateBoundingBox(m_boundingBoxMin, m_boundingBoxMax);
+    loader.calculateBoundingBox(data.boundingBoxMin, data.boundingBoxMax);
     
     // 바운딩 반지름 계산
-    QVector3D center = getCenter();
+    QVector3D center = (data.boundingBoxMin + data.boundingBoxMax) * 0.5f;
     float maxDistance = 0.0f;
     
     const QVector<PLYVertex>& vertices = loader.getVertices();
@@ -184,7 +818,7 @@ void Mesh::calculateBoundingBox(const PLYLoader& loader)
         maxDistance = qMax(maxDistance, distance);
     }
     
-    m_boundingRadius = maxDistance;
+    data.boundingRadius = maxDistance;
 }
 
 void Mesh::cleanup()
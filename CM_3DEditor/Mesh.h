@@ -8,7 +8,50 @@
 #include <QVector2D>
 #include <QColor>
 #include <QMatrix4x4>
+#include <memory>
 #include "PLYLoader.h"
+#include "SelectionSet.h"
+
+class MeshComponents;
+
+// GPU 버텍스 레이아웃 (attribute 0~3)
+struct VertexData {
+    QVector3D position;
+    QVector3D normal;
+    QVector3D color;
+    QVector2D texCoord;
+};
+
+// 컬링 단위: 인덱스 버퍼의 연속 구간과 경계 구
+struct MeshCluster {
+    int firstIndex;
+    int indexCount;
+    QVector3D center;
+    float radius;
+};
+
+// glMultiDraw* 인자 형태의 드로우 구간 목록
+struct MeshDrawRanges {
+    QVector<GLint> first;           // 정점 번호 또는 인덱스 위치
+    QVector<GLsizei> count;
+    QVector<const void*> offset;    // first의 인덱스 버퍼 바이트 오프셋 (인덱스 구간에서만 사용)
+
+    int size() const { return count.size(); }
+    bool isEmpty() const { return count.isEmpty(); }
+    void clear();
+    void append(int start, int length);     // 바로 앞 구간과 이어지면 합침
+};
+
+// GL 없이 준비되는 메시 데이터 (작업 스레드에서 로드 가능)
+struct MeshData {
+    QVector<VertexData> vertices;
+    QVector<unsigned int> indices;      // 클러스터 순서로 정렬된 삼각형
+    QVector<MeshCluster> clusters;
+    QVector3D boundingBoxMin;
+    QVector3D boundingBoxMax;
+    float boundingRadius = 0.0f;
+    std::shared_ptr<const MeshComponents> components;   // 클러스터링에서 구한 연결 성분 (작은 메시는 없음)
+};
 
 class Mesh : protected QOpenGLFunctions
 {
@@ -16,10 +59,22 @@ public:
     Mesh();
     ~Mesh();
 
-    // 메시 로드 및 설정
+    // 메시 로드 및 설정 (loadFromPLY = loadData + upload)
     bool loadFromPLY(const QString& filename);
     void setTransform(const QMatrix4x4& transform);
     
+    // 파일 파싱/삼각형화/클러스터링 (GL 호출 없음, 스레드 안전)
+    static bool loadData(const QString& filename, MeshData& data);
+    
+    // ASCII PLY로 저장 (loadData로 다시 읽을 수 있는 속성 순서, GL 호출 없음)
+    static bool saveData(const QString& filename, const MeshData& data);
+    
+    // 정점/삼각형만 채운 데이터(메시 처리 결과 등)의 클러스터링과 경계 계산 (GL 호출 없음, 스레드 안전)
+    static void completeData(MeshData& data);
+    
+    // 준비된 데이터를 GPU로 업로드 (현재 컨텍스트 필요)
+    bool upload(const MeshData& data);
+    
     // 렌더링
     void render();
     void renderWireframe();
@@ -29,6 +84,57 @@ public:
     int getVertexCount() const { return m_vertexCount; }
     int getIndexCount() const { return m_indexCount; }
     bool hasData() const { return m_vertexCount > 0; }
+    GLuint getVertexArrayId() const { return m_vao.objectId(); }
+    GLuint getVertexBufferId() const { return m_vertexBuffer.bufferId(); }
+    GLuint getIndexBufferId() const { return m_indexBuffer.bufferId(); }
+    
+    // 데이터가 다시 업로드될 때마다 증가 (외부 캐시 무효화용)
+    int getRevision() const { return m_revision; }
+    
+    // CPU 쪽 정점/원본 인덱스 (MeshData와 암시적 공유)
+    const QVector<VertexData>& getVertices() const { return m_vertices; }
+    const QVector<unsigned int>& getIndices() const { return m_sourceIndices; }
+    
+    // 정점 편집: editVertices()로 고친 뒤 바뀐 정점(오름차순)과 삼각형으로 updateVertices() 호출
+    // 바뀐 정점을 가까운 것끼리 묶은 바이트 구간만 glBufferSubData로 올리고 닿은 클러스터 경계를 갱신
+    // (현재 컨텍스트 필요)
+    VertexData* editVertices() { return m_vertices.data(); }
+    bool updateVertices(const QVector<int>& vertices, const QVector<int>& triangles);
+    
+    // 정점 내용이 바뀔 때마다 증가. 직전 갱신에서 올린 정점 구간은 getUpdatedVertexRanges()
+    int getVertexRevision() const { return m_vertexRevision; }
+    const MeshDrawRanges& getUpdatedVertexRanges() const { return m_updatedVertices; }
+    
+    // 위상 편집: 삼각형(오름차순)의 정점을 indices(인덱스 버퍼 배치 전체)에서 가져와 그 자리만 다시 올림
+    // 면 번호는 그대로이고 숨김 상태를 따름 (현재 컨텍스트 필요)
+    bool updateTriangles(const unsigned int* indices, const QVector<int>& triangles);
+    
+    // 공간적으로 묶인 삼각형 클러스터 (인덱스 버퍼는 클러스터 순서로 정렬됨)
+    const QVector<MeshCluster>& getClusters() const { return m_clusters; }
+    
+    // 면/정점 숨김 (비트가 설정된 원소를 그리지 않음, 현재 컨텍스트 필요). 크기가 다르면 false
+    // 면은 인덱스 버퍼의 자리를 유지해 면 번호가 바뀌지 않음. 숨긴 삼각형은 퇴화 삼각형으로 바꾸고
+    // 이전 상태와 달라진 구간만 다시 올림
+    bool setHiddenFaces(const SelectionSet& hidden);
+    bool setHiddenVertices(const SelectionSet& hidden);
+    const SelectionSet& getHiddenFaces() const { return m_hiddenFaces; }
+    const SelectionSet& getHiddenVertices() const { return m_hiddenVertices; }
+    int getHiddenFaceCount() const { return m_hiddenFaceCount; }
+    int getHiddenVertexCount() const { return m_hiddenVertexCount; }
+    
+    // 그릴 구간 (숨긴 원소가 없으면 전체 한 구간)
+    // 면은 클러스터마다 처음/마지막으로 보이는 삼각형 사이로 줄인 뒤 이어지는 것끼리 합친 인덱스 구간
+    const MeshDrawRanges& getVisibleFaceRanges() const { return m_visibleFaces; }
+    const MeshDrawRanges& getVisiblePointRanges() const { return m_visiblePoints; }
+    
+    // getClusters()와 같은 순서로 구간만 보이는 삼각형까지 줄인 클러스터 (모두 숨으면 indexCount 0)
+    const QVector<MeshCluster>& getVisibleClusters() const { return m_visibleClusters; }
+    
+    // 숨김이나 삼각형이 바뀌어 인덱스 버퍼 내용이 달라질 때마다 증가
+    int getVisibilityRevision() const { return m_visibilityRevision; }
+    
+    // VertexData 레이아웃으로 현재 바인딩된 버퍼의 attribute 설정
+    static void setupVertexAttributes(QOpenGLFunctions* f);
     
     // 바운딩 박스
     void getBoundingBox(QVector3D& min, QVector3D& max) const;
@@ -46,6 +152,24 @@ private:
     // 메시 데이터
     int m_vertexCount;
     int m_indexCount;
+    int m_revision;
+    QVector<MeshCluster> m_clusters;
+    
+    // CPU 쪽 사본 (MeshData와 공유, 편집할 때만 분리됨)
+    QVector<VertexData> m_vertices;
+    QVector<unsigned int> m_sourceIndices;
+    int m_vertexRevision;
+    MeshDrawRanges m_updatedVertices;
+    
+    // 숨김
+    SelectionSet m_hiddenFaces;
+    SelectionSet m_hiddenVertices;
+    int m_hiddenFaceCount;
+    int m_hiddenVertexCount;
+    QVector<MeshCluster> m_visibleClusters;
+    MeshDrawRanges m_visibleFaces;
+    MeshDrawRanges m_visiblePoints;
+    int m_visibilityRevision;
     
     // 변환 행렬
     QMatrix4x4 m_transform;
@@ -57,8 +181,13 @@ private:
     
     // 초기화 함수들
     void initializeBuffers();
-    void uploadData(const PLYLoader& loader);
-    void calculateBoundingBox(const PLYLoader& loader);
+    void updateClusterBounds(const QVector<int>& triangles);
+    static void prepareData(const PLYLoader& loader, MeshData& data);
+    static void calculateBoundingBox(const PLYLoader& loader, MeshData& data);
+    static void buildClusters(const QVector<VertexData>& vertices, QVector<unsigned int>& indices,
+                              QVector<MeshCluster>& clusters, std::shared_ptr<const MeshComponents>& components);
+    void updateVisibleFaces();
+    void updateVisiblePoints();
     
     // 버퍼 정리
     void cleanup();
@@ -0,0 +1,279 @@
+#include "MeshComponents.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <cfloat>
+#include <memory>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 14;
+
+    // 경로 반감: 지나가며 조부모로 이음. 부모는 항상 자기보다 작은 번호이고 줄어들기만 하므로
+    // 다른 스레드가 읽은 값이 오래되었어도 조상을 가리킴
+    inline int findRoot(std::atomic_int* parents, int x)
+    {
+        for (;;) {
+            int parent = parents[x].load(std::memory_order_relaxed);
+            if (parent == x) return x;
+            const int grandparent = parents[parent].load(std::memory_order_relaxed);
+            if (parent != grandparent) {
+                parents[x].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+            }
+            x = grandparent;
+        }
+    }
+
+    // 큰 번호의 루트를 작은 번호의 루트 아래로 이음 (그 사이 다른 스레드가 먼저 이었으면 다시 찾음)
+    inline void unite(std::atomic_int* parents, int a, int b)
+    {
+        for (;;) {
+            a = findRoot(parents, a);
+            b = findRoot(parents, b);
+            if (a == b) return;
+            if (a < b) qSwap(a, b);
+            int expected = a;
+            if (parents[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) return;
+        }
+    }
+
+    // 성분 경계 상자 일부 (조각 경계에 걸친 성분)
+    struct PartialBounds {
+        int component = -1;
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+    };
+}
+
+MeshComponents::MeshComponents()
+{
+}
+
+void MeshComponents::clear()
+{
+    m_components.clear();
+    m_triangleComponents.clear();
+    m_vertexComponents.clear();
+    m_starts.clear();
+    m_triangles.clear();
+}
+
+bool MeshComponents::build(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                           const std::atomic_bool* cancel, std::atomic_int* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+    clear();
+    auto setProgress = [progress](int percent) {
+        if (progress) progress->store(percent, std::memory_order_relaxed);
+    };
+    setProgress(0);
+
+    const int vertexCount = vertices.size();
+    const int triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) return false;
+
+    // 삼각형의 세 정점을 합침
+    std::unique_ptr<std::atomic_int[]> parents(new std::atomic_int[vertexCount]);
+    std::atomic_int* parentData = parents.get();
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            parentData[v].store(int(v), std::memory_order_relaxed);
+        }
+    });
+    const unsigned int* indexData = indices.constData();
+    Parallel::parallelFor(triangleCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype t = begin; t < end; ++t) {
+            const int a = int(indexData[t * 3]);
+            unite(parentData, a, int(indexData[t * 3 + 1]));
+            unite(parentData, a, int(indexData[t * 3 + 2]));
+        }
+    });
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+    setProgress(30);
+
+    // 삼각형을 루트(성분의 가장 작은 정점 번호) 순서로 안정 정렬 → 성분마다 연속 구간, 구간 안은 삼각형 번호 순
+    QVector<quint32> keys(triangleCount);
+    QVector<int> triangles(triangleCount);
+    quint32* keyData = keys.data();
+    int* triangleData = triangles.data();
+    Parallel::parallelFor(triangleCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype t = begin; t < end; ++t) {
+            keyData[t] = quint32(findRoot(parentData, int(indexData[t * 3])));
+            triangleData[t] = int(t);
+        }
+    });
+    int keyBits = 1;
+    while (keyBits < 31 && (quint32(vertexCount - 1) >> keyBits) != 0) ++keyBits;
+    if (!Parallel::sortByKey(keys, triangles, keyBits, ParallelGrain, cancel)) return false;
+    setProgress(60);
+
+    // 구간 시작 수를 조각별로 세어 누적 → 성분 번호와 구간 시작을 씀
+    const int chunks = Parallel::chunkCount(triangleCount, ParallelGrain);
+    QVector<int> chunkStarts(chunks + 1, 0);
+    keyData = keys.data();
+    Parallel::forEachChunk(triangleCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int starts = 0;
+        for (qsizetype i = begin; i < end; ++i) {
+            if (i == 0 || keyData[i] != keyData[i - 1]) ++starts;
+        }
+        chunkStarts[chunk + 1] = starts;
+    });
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        chunkStarts[chunk + 1] += chunkStarts[chunk];
+    }
+    const int componentCount = chunkStarts[chunks];
+
+    m_starts.resize(componentCount + 1);
+    m_starts[componentCount] = triangleCount;
+    m_triangleComponents.resize(triangleCount);
+    QVector<int> labels(triangleCount);
+    QVector<int> rootComponents(vertexCount, -1);
+    int* startData = m_starts.data();
+    int* componentData = m_triangleComponents.data();
+    int* labelData = labels.data();
+    int* rootComponentData = rootComponents.data();
+    triangleData = triangles.data();
+    Parallel::forEachChunk(triangleCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int component = chunkStarts[chunk] - 1;
+        for (qsizetype i = begin; i < end; ++i) {
+            if (i == 0 || keyData[i] != keyData[i - 1]) {
+                startData[++component] = int(i);
+                rootComponentData[keyData[i]] = component;
+            }
+            labelData[i] = component;
+            componentData[triangleData[i]] = component;
+        }
+    });
+    keys.clear();
+
+    // 정점 → 성분 (삼각형에 쓰이지 않은 정점은 자기 자신이 루트이고 성분이 없음)
+    m_vertexComponents.resize(vertexCount);
+    int* vertexComponentData = m_vertexComponents.data();
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            vertexComponentData[v] = rootComponentData[findRoot(parentData, int(v))];
+        }
+    });
+    parents.reset();
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+    setProgress(80);
+
+    // 삼각형 수와 경계 상자. 조각 안에 다 든 성분은 바로 쓰고, 조각 경계에 걸친 성분만 모아서 합침
+    m_components.resize(componentCount);
+    MeshComponent* components = m_components.data();
+    Parallel::parallelFor(componentCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype c = begin; c < end; ++c) {
+            components[c].triangleCount = startData[c + 1] - startData[c];
+            components[c].boundsMin = QVector3D(FLT_MAX, FLT_MAX, FLT_MAX);
+            components[c].boundsMax = QVector3D(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        }
+    });
+
+    QVector<PartialBounds> partials(chunks * 2);
+    Parallel::forEachChunk(triangleCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        qsizetype i = begin;
+        while (i < end) {
+            const int component = labelData[i];
+            const qsizetype runEnd = qMin<qsizetype>(end, startData[component + 1]);
+            const int t = triangleData[i];
+            QVector3D boxMin = vertices[indexData[t * 3]].position;
+            QVector3D boxMax = boxMin;
+            for (; i < runEnd; ++i) {
+                const int triangle = triangleData[i];
+                for (int corner = 0; corner < 3; ++corner) {
+                    const QVector3D& p = vertices[indexData[triangle * 3 + corner]].position;
+                    boxMin = QVector3D(qMin(boxMin.x(), p.x()), qMin(boxMin.y(), p.y()), qMin(boxMin.z(), p.z()));
+                    boxMax = QVector3D(qMax(boxMax.x(), p.x()), qMax(boxMax.y(), p.y()), qMax(boxMax.z(), p.z()));
+                }
+            }
+
+            if (startData[component] >= begin && startData[component + 1] <= end) {
+                components[component].boundsMin = boxMin;
+                components[component].boundsMax = boxMax;
+            } else {
+                // 조각의 첫 성분은 앞 조각에서, 마지막 성분은 뒤 조각으로 이어짐
+                PartialBounds& partial = partials[chunk * 2 + (startData[component] < begin ? 0 : 1)];
+                partial.component = component;
+                partial.boundsMin = boxMin;
+                partial.boundsMax = boxMax;
+            }
+        }
+    });
+    for (const PartialBounds& partial : partials) {
+        if (partial.component < 0) continue;
+        MeshComponent& component = components[partial.component];
+        const QVector3D& a = partial.boundsMin;
+        const QVector3D& b = partial.boundsMax;
+        component.boundsMin = QVector3D(qMin(component.boundsMin.x(), a.x()), qMin(component.boundsMin.y(), a.y()),
+                                        qMin(component.boundsMin.z(), a.z()));
+        component.boundsMax = QVector3D(qMax(component.boundsMax.x(), b.x()), qMax(component.boundsMax.y(), b.y()),
+                                        qMax(component.boundsMax.z(), b.z()));
+    }
+
+    m_triangles.swap(triangles);
+    setProgress(100);
+
+    qDebug() << "Connected components:" << componentCount << "for" << triangleCount << "triangles in"
+             << timer.elapsed() << "ms";
+    return true;
+}
+
+bool MeshComponents::reorderTriangles(const QVector<int>& order)
+{
+    const int triangleCount = m_triangleComponents.size();
+    if (order.size() != triangleCount) return false;
+
+    QVector<int> triangleComponents(triangleCount);
+    QVector<quint32> keys(triangleCount);
+    QVector<int> triangles(triangleCount);
+    const int* source = m_triangleComponents.constData();
+    int* componentData = triangleComponents.data();
+    quint32* keyData = keys.data();
+    int* triangleData = triangles.data();
+    Parallel::parallelFor(triangleCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            componentData[i] = source[order[i]];
+            keyData[i] = quint32(componentData[i]);
+            triangleData[i] = int(i);
+        }
+    });
+
+    // 성분별 구간은 크기가 그대로이므로 성분 번호로 안정 정렬만 다시 함 (구간 안은 새 삼각형 번호 순)
+    const int componentCount = m_components.size();
+    int keyBits = 1;
+    while (keyBits < 31 && (quint32(qMax(1, componentCount) - 1) >> keyBits) != 0) ++keyBits;
+    if (!Parallel::sortByKey(keys, triangles, keyBits, ParallelGrain)) return false;
+
+    m_triangleComponents.swap(triangleComponents);
+    m_triangles.swap(triangles);
+    return true;
+}
+
+bool MeshComponents::reorderVertices(const QVector<int>& order)
+{
+    const int vertexCount = m_vertexComponents.size();
+    if (order.size() != vertexCount) return false;
+
+    QVector<int> vertexComponents(vertexCount);
+    const int* source = m_vertexComponents.constData();
+    int* componentData = vertexComponents.data();
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            componentData[i] = source[order[i]];
+        }
+    });
+    m_vertexComponents.swap(vertexComponents);
+    return true;
+}
+
+int MeshComponents::getLargestComponent() const
+{
+    int largest = -1;
+    for (int c = 0; c < m_components.size(); ++c) {
+        if (largest < 0 || m_components[c].triangleCount > m_components[largest].triangleCount) {
+            largest = c;
+        }
+    }
+    return largest;
+}
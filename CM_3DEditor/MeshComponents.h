@@ -0,0 +1,59 @@
+#ifndef MESHCOMPONENTS_H
+#define MESHCOMPONENTS_H
+
+#include <QVector>
+#include <QVector3D>
+#include <atomic>
+#include "Mesh.h"
+
+// 연결 성분 하나 (정점을 공유하는 삼각형끼리 연결)
+struct MeshComponent {
+    int triangleCount = 0;
+    QVector3D boundsMin;
+    QVector3D boundsMax;
+};
+
+// 삼각형 메시의 연결 성분 (병렬 union-find)
+// 삼각형마다 세 정점을 잠금 없는 union-find(CAS 연결 + 경로 반감)로 합치고, 루트는 항상 작은 정점 번호라
+// 성분 번호는 성분의 가장 작은 정점 번호 순서로 매겨짐. 삼각형을 성분 순서로 기수 정렬해 성분별 구간,
+// 삼각형 수, 경계 상자를 구하므로 비용은 삼각형 수에 비례하고 결과는 스레드 수와 관계없음
+class MeshComponents
+{
+public:
+    MeshComponents();
+
+    // 정점/인덱스로 구축 (GL 호출 없음, 스레드 안전). 삼각형이 없거나 cancel이 설정되면 false
+    // progress에는 0~100 진행률을 씀
+    bool build(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+               const std::atomic_bool* cancel = nullptr, std::atomic_int* progress = nullptr);
+    void clear();
+
+    // 삼각형/정점 재배치를 따라 번호를 옮김 (order[새 번호] = 이전 번호, 성분 번호와 경계는 그대로)
+    bool reorderTriangles(const QVector<int>& order);
+    bool reorderVertices(const QVector<int>& order);
+
+    int getComponentCount() const { return m_components.size(); }
+    const MeshComponent& getComponent(int component) const { return m_components[component]; }
+    const QVector<MeshComponent>& getComponents() const { return m_components; }
+
+    // 삼각형 → 성분 번호
+    const QVector<int>& getTriangleComponents() const { return m_triangleComponents; }
+
+    // 정점 → 성분 번호 (삼각형에 쓰이지 않은 정점은 -1)
+    const QVector<int>& getVertexComponents() const { return m_vertexComponents; }
+
+    // 성분의 삼각형 번호 (오름차순, getComponent().triangleCount개)
+    const int* getComponentTriangles(int component) const { return m_triangles.constData() + m_starts[component]; }
+
+    // 삼각형이 가장 많은 성분 (같으면 번호가 작은 것, 없으면 -1)
+    int getLargestComponent() const;
+
+private:
+    QVector<MeshComponent> m_components;
+    QVector<int> m_triangleComponents;
+    QVector<int> m_vertexComponents;
+    QVector<int> m_starts;          // 성분 → m_triangles 구간 시작 (성분 수 + 1)
+    QVector<int> m_triangles;       // 성분 순서로 모은 삼각형 번호
+};
+
+#endif // MESHCOMPONENTS_H
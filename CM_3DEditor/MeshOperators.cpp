@@ -0,0 +1,991 @@
+#include "MeshOperators.h"
+#include "HalfEdgeMesh.h"
+#include "KdTree.h"
+#include "MeshComponents.h"
+#include "Parallel.h"
+#include "VoxelGrid.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QtMath>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 14;
+
+    inline bool isCancelled(const std::atomic_bool* cancel)
+    {
+        return cancel && cancel->load(std::memory_order_relaxed);
+    }
+
+    inline void setProgress(std::atomic_int* progress, int percent)
+    {
+        if (progress) progress->store(percent, std::memory_order_relaxed);
+    }
+
+    // 법선 방향 전파에 쓰는 점마다의 이웃 수 (자기 자신 제외)
+    const int OrientNeighbors = 8;
+
+    // 법선 추정을 나누어 진행률을 알리는 묶음 수
+    const int NormalBatches = 16;
+
+    // 대칭 3x3 행렬 (c00, c01, c02, c11, c12, c22)의 가장 작은 고윳값에 대한 단위 고유벡터
+    // 고윳값은 삼각함수 닫힌 형식으로, 벡터는 (C - λI)의 두 행 외적 중 가장 긴 것으로 구함
+    bool smallestEigenvector(const double c[6], QVector3D& vector)
+    {
+        const double p1 = c[1] * c[1] + c[2] * c[2] + c[4] * c[4];
+        const double q = (c[0] + c[3] + c[5]) / 3.0;
+        const double d0 = c[0] - q;
+        const double d1 = c[3] - q;
+        const double d2 = c[5] - q;
+        const double p2 = d0 * d0 + d1 * d1 + d2 * d2 + 2.0 * p1;
+        if (p2 <= 0.0) return false;    // 모든 방향으로 같음 (점이 한 곳에 겹침)
+
+        // r = det((C - qI) / p) / 2, 가장 작은 고윳값 = q + 2p cos(acos(r) / 3 + 2π/3)
+        const double p = std::sqrt(p2 / 6.0);
+        const double b00 = d0 / p, b11 = d1 / p, b22 = d2 / p;
+        const double b01 = c[1] / p, b02 = c[2] / p, b12 = c[4] / p;
+        const double r = qBound(-1.0, (b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02)
+                                       + b02 * (b01 * b12 - b11 * b02)) / 2.0, 1.0);
+        const double lambda = q + 2.0 * p * std::cos(std::acos(r) / 3.0 + 2.0 * M_PI / 3.0);
+
+        const double rows[3][3] = {
+            { c[0] - lambda, c[1], c[2] },
+            { c[1], c[3] - lambda, c[4] },
+            { c[2], c[4], c[5] - lambda }
+        };
+        double best[3] = { 0.0, 0.0, 0.0 };
+        double bestLength = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            const double* a = rows[i];
+            const double* b = rows[(i + 1) % 3];
+            const double cross[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+            const double length = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+            if (length > bestLength) {
+                bestLength = length;
+                std::copy(cross, cross + 3, best);
+            }
+        }
+        if (bestLength <= 0.0) return false;
+
+        const double scale = 1.0 / std::sqrt(bestLength);
+        vector = QVector3D(float(best[0] * scale), float(best[1] * scale), float(best[2] * scale));
+        return true;
+    }
+
+    // 셀 좌표를 period로 나눈 나머지(period³개 위상)로 셀을 묶음. 위상 안에서는 셀 번호 순서
+    void groupCellsByPhase(const VoxelGrid& grid, int period, QVector<int>& phaseStarts, QVector<int>& phaseCells)
+    {
+        const int cellCount = grid.getCellCount();
+        const int phaseCount = period * period * period;
+        QVector<int> cellPhases(cellCount);
+        int* phaseData = cellPhases.data();
+        Parallel::parallelFor(cellCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype cell = begin; cell < end; ++cell) {
+                int x, y, z;
+                grid.getCellCoordinates(int(cell), x, y, z);
+                phaseData[cell] = ((x % period) * period + y % period) * period + z % period;
+            }
+        });
+
+        phaseStarts.fill(0, phaseCount + 1);
+        for (int cell = 0; cell < cellCount; ++cell) {
+            ++phaseStarts[phaseData[cell] + 1];
+        }
+        for (int phase = 0; phase < phaseCount; ++phase) {
+            phaseStarts[phase + 1] += phaseStarts[phase];
+        }
+        phaseCells.resize(cellCount);
+        QVector<int> cursors = phaseStarts;
+        for (int cell = 0; cell < cellCount; ++cell) {
+            phaseCells[cursors[phaseData[cell]]++] = cell;
+        }
+    }
+
+    // 셀/표본마다 만든 점을 대표 점(원래 정점 번호) 순서로 모음 (결과가 원래 점 순서를 따름)
+    void gatherByRepresentative(int vertexCount, const QVector<int>& representatives,
+                                const QVector<VertexData>& reduced, QVector<VertexData>& result)
+    {
+        QVector<int> reducedIndices(vertexCount, -1);
+        int* reducedIndexData = reducedIndices.data();
+        Parallel::parallelFor(representatives.size(), ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype i = begin; i < end; ++i) {
+                if (representatives[i] >= 0) reducedIndexData[representatives[i]] = int(i);
+            }
+        });
+
+        // 조각별 개수 + 누적으로 쓰기 위치를 정해 병렬로 압축
+        const int chunks = Parallel::chunkCount(vertexCount, ParallelGrain);
+        QVector<int> chunkOffsets(chunks + 1, 0);
+        Parallel::forEachChunk(vertexCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+            int count = 0;
+            for (qsizetype v = begin; v < end; ++v) {
+                if (reducedIndexData[v] >= 0) ++count;
+            }
+            chunkOffsets[chunk + 1] = count;
+        });
+        for (int chunk = 0; chunk < chunks; ++chunk) {
+            chunkOffsets[chunk + 1] += chunkOffsets[chunk];
+        }
+
+        result.resize(chunkOffsets[chunks]);
+        VertexData* resultData = result.data();
+        Parallel::forEachChunk(vertexCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+            int offset = chunkOffsets[chunk];
+            for (qsizetype v = begin; v < end; ++v) {
+                if (reducedIndexData[v] >= 0) resultData[offset++] = reduced[reducedIndexData[v]];
+            }
+        });
+    }
+
+    // Loop 세분화 한 단계: 기존 정점은 이웃으로 다시 가중하고(even), 변마다 새 정점을 만든 뒤(odd)
+    // 삼각형 하나를 네 개로 나눔. 새 정점 번호는 기존 정점 뒤에 변 번호 순서로 붙음
+    bool subdivideOnce(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                       QVector<VertexData>& outVertices, QVector<unsigned int>& outIndices,
+                       const std::atomic_bool* cancel)
+    {
+        HalfEdgeMesh topology;
+        if (!topology.build(indices, vertices.size(), cancel)) return false;
+
+        const int vertexCount = vertices.size();
+        const int faceCount = topology.getFaceCount();
+        const int halfEdgeCount = topology.getHalfEdgeCount();
+
+        // 1) 변 번호: 경계 반변이거나 짝보다 번호가 작은 반변이 변을 대표
+        //    조각마다 대표 수를 센 뒤 누적해 번호를 매기고, 나머지 반변은 짝의 번호를 따름
+        auto isRepresentative = [&topology](int h) {
+            const int t = topology.twin(h);
+            return t < 0 || h < t;
+        };
+        const int chunks = Parallel::chunkCount(halfEdgeCount, ParallelGrain);
+        QVector<int> chunkOffsets(chunks + 1, 0);
+        Parallel::forEachChunk(halfEdgeCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+            int count = 0;
+            for (qsizetype h = begin; h < end; ++h) {
+                if (isRepresentative(int(h))) ++count;
+            }
+            chunkOffsets[chunk + 1] = count;
+        });
+        for (int c = 0; c < chunks; ++c) {
+            chunkOffsets[c + 1] += chunkOffsets[c];
+        }
+        const int edgeCount = chunkOffsets[chunks];
+
+        QVector<int> edges(halfEdgeCount);
+        int* edgeData = edges.data();
+        Parallel::forEachChunk(halfEdgeCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+            int e = chunkOffsets[chunk];
+            for (qsizetype h = begin; h < end; ++h) {
+                if (isRepresentative(int(h))) edgeData[h] = e++;
+            }
+        });
+        Parallel::parallelFor(halfEdgeCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype h = begin; h < end; ++h) {
+                if (!isRepresentative(int(h))) edgeData[h] = edgeData[topology.twin(int(h))];
+            }
+        });
+        if (isCancelled(cancel)) return false;
+
+        // 2) 기존 정점: 내부는 (1 - nβ)v + βΣ이웃, 경계는 양옆 경계 이웃만으로 3/4 v + 1/8 (b0 + b1)
+        outVertices.resize(vertexCount + edgeCount);
+        VertexData* out = outVertices.data();
+        const VertexData* in = vertices.constData();
+        Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype v = begin; v < end; ++v) {
+                out[v] = in[v];
+                const int first = topology.outgoing(int(v));
+                if (first < 0) continue;
+
+                if (topology.isBoundaryVertex(int(v))) {
+                    int last = first;
+                    topology.forEachOutgoing(int(v), [&last](int h) { last = h; });
+                    const QVector3D& b0 = in[topology.target(first)].position;
+                    const QVector3D& b1 = in[topology.origin(HalfEdgeMesh::prev(last))].position;
+                    out[v].position = in[v].position * 0.75f + (b0 + b1) * 0.125f;
+                } else {
+                    QVector3D sum;
+                    int valence = 0;
+                    topology.forEachOutgoing(int(v), [&](int h) {
+                        sum += in[topology.target(h)].position;
+                        ++valence;
+                    });
+                    const float beta = valence == 3 ? 3.0f / 16.0f : 3.0f / (8.0f * valence);
+                    out[v].position = in[v].position * (1.0f - valence * beta) + sum * beta;
+                }
+            }
+        });
+
+        // 3) 변 정점: 내부는 3/8 (a + b) + 1/8 (c + d), 경계는 중점. 색과 텍스처 좌표는 양 끝의 평균
+        Parallel::parallelFor(halfEdgeCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype h = begin; h < end; ++h) {
+                if (!isRepresentative(int(h))) continue;
+
+                const VertexData& a = in[topology.origin(int(h))];
+                const VertexData& b = in[topology.target(int(h))];
+                VertexData& vertex = out[vertexCount + edgeData[h]];
+                vertex.normal = (a.normal + b.normal).normalized();
+                vertex.color = (a.color + b.color) * 0.5f;
+                vertex.texCoord = (a.texCoord + b.texCoord) * 0.5f;
+
+                const int t = topology.twin(int(h));
+                if (t < 0) {
+                    vertex.position = (a.position + b.position) * 0.5f;
+                } else {
+                    const QVector3D& c = in[topology.origin(HalfEdgeMesh::prev(int(h)))].position;
+                    const QVector3D& d = in[topology.origin(HalfEdgeMesh::prev(t))].position;
+                    vertex.position = (a.position + b.position) * 0.375f + (c + d) * 0.125f;
+                }
+            }
+        });
+        if (isCancelled(cancel)) return false;
+
+        // 4) 면 f (a, b, c) → 모서리 셋과 가운데 하나. 면마다 12개 인덱스를 자기 자리에 씀
+        outIndices.resize(qsizetype(faceCount) * 12);
+        unsigned int* outIndexData = outIndices.data();
+        Parallel::parallelFor(faceCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype f = begin; f < end; ++f) {
+                const int h = int(f) * 3;
+                const unsigned int a = topology.origin(h);
+                const unsigned int b = topology.origin(h + 1);
+                const unsigned int c = topology.origin(h + 2);
+                const unsigned int ab = vertexCount + edgeData[h];
+                const unsigned int bc = vertexCount + edgeData[h + 1];
+                const unsigned int ca = vertexCount + edgeData[h + 2];
+                unsigned int* o = outIndexData + f * 12;
+                o[0] = a;   o[1] = ab;  o[2] = ca;
+                o[3] = ab;  o[4] = b;   o[5] = bc;
+                o[6] = ca;  o[7] = bc;  o[8] = c;
+                o[9] = ab;  o[10] = bc; o[11] = ca;
+            }
+        });
+        return !isCancelled(cancel);
+    }
+}
+
+void MeshOperators::buildVertexAdjacency(const QVector<unsigned int>& indices, int vertexCount,
+                                         QVector<int>& start, QVector<int>& neighbors, QVector<bool>* boundary)
+{
+    const int triangleCount = indices.size() / 3;
+    const unsigned int* indexData = indices.constData();
+
+    // 삼각형 모서리마다 다른 두 정점을 이웃으로 (중복 포함) 채움
+    QVector<int> rawStart(vertexCount + 1, 0);
+    for (int i = 0; i < triangleCount * 3; ++i) {
+        rawStart[indexData[i] + 1] += 2;
+    }
+    for (int v = 0; v < vertexCount; ++v) {
+        rawStart[v + 1] += rawStart[v];
+    }
+
+    QVector<int> raw(rawStart[vertexCount]);
+    QVector<int> cursor = rawStart;
+    for (int t = 0; t < triangleCount; ++t) {
+        const unsigned int* triangle = indexData + qsizetype(t) * 3;
+        for (int corner = 0; corner < 3; ++corner) {
+            int& slot = cursor[triangle[corner]];
+            raw[slot++] = int(triangle[(corner + 1) % 3]);
+            raw[slot++] = int(triangle[(corner + 2) % 3]);
+        }
+    }
+
+    // 정점마다 정렬해 중복을 지움. 다양체에서 내부 변은 양쪽 면에서 두 번, 경계 변은 한 번만 나옴
+    if (boundary) {
+        boundary->fill(false, vertexCount);
+    }
+    bool* boundaryData = boundary ? boundary->data() : nullptr;
+    int* rawData = raw.data();
+    QVector<int> counts(vertexCount + 1, 0);
+    int* countData = counts.data();
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            int* first = rawData + rawStart[v];
+            int* last = rawData + rawStart[v + 1];
+            std::sort(first, last);
+
+            int unique = 0;
+            for (int* run = first; run < last;) {
+                int* runEnd = run + 1;
+                while (runEnd < last && *runEnd == *run) ++runEnd;
+                if (*run != int(v)) {
+                    if (runEnd - run == 1 && boundaryData) boundaryData[v] = true;
+                    first[unique++] = *run;
+                }
+                run = runEnd;
+            }
+            countData[v + 1] = unique;
+        }
+    });
+
+    for (int v = 0; v < vertexCount; ++v) {
+        countData[v + 1] += countData[v];
+    }
+    neighbors.resize(countData[vertexCount]);
+    int* neighborData = neighbors.data();
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            std::copy(rawData + rawStart[v], rawData + rawStart[v] + (countData[v + 1] - countData[v]),
+                      neighborData + countData[v]);
+        }
+    });
+    start.swap(counts);
+}
+
+bool MeshOperators::hasNormals(const QVector<VertexData>& vertices)
+{
+    for (const VertexData& vertex : vertices) {
+        if (!vertex.normal.isNull()) return true;
+    }
+    return false;
+}
+
+bool MeshOperators::estimatePointNormals(QVector<VertexData>& vertices, int neighbors,
+                                         const std::atomic_bool* cancel, std::atomic_int* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const int vertexCount = vertices.size();
+    const int k = qBound(3, neighbors, int(KdTree::MaxNeighbors));
+    if (vertexCount < 3) return false;
+    setProgress(progress, 0);
+
+    KdTree tree;
+    if (!tree.build(vertices, cancel)) return false;
+    setProgress(progress, 15);
+
+    // 1) 이웃 공분산의 가장 작은 고유벡터. 트리 순서로 돌아 가까운 점의 질의가 같은 리프를 연달아 읽음
+    //    결과는 따로 모았다가 끝까지 진행했을 때만 씀
+    const VertexData* vertexData = vertices.constData();
+    const int* order = tree.getOrder().constData();
+    QVector<QVector3D> normals(vertexCount);
+    QVector<int> graph(qsizetype(vertexCount) * OrientNeighbors, -1);
+    QVector3D* normalData = normals.data();
+    int* graphData = graph.data();
+    for (int batch = 0; batch < NormalBatches; ++batch) {
+        const qsizetype batchBegin = qsizetype(vertexCount) * batch / NormalBatches;
+        const qsizetype batchEnd = qsizetype(vertexCount) * (batch + 1) / NormalBatches;
+        Parallel::parallelFor(batchEnd - batchBegin, 1024, [&](qsizetype begin, qsizetype end) {
+            int found[KdTree::MaxNeighbors];
+            float distances[KdTree::MaxNeighbors];
+            for (qsizetype i = batchBegin + begin; i < batchBegin + end; ++i) {
+                const int v = order[i];
+                const int count = tree.findNearest(vertexData[v].position, k, found, distances);
+
+                // 평균을 뺀 공분산 (double로 누적해 먼 좌표에서도 정밀도 유지)
+                double mean[3] = { 0.0, 0.0, 0.0 };
+                for (int n = 0; n < count; ++n) {
+                    const QVector3D& p = vertexData[found[n]].position;
+                    mean[0] += p.x();
+                    mean[1] += p.y();
+                    mean[2] += p.z();
+                }
+                for (double& m : mean) m /= qMax(count, 1);
+
+                double covariance[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+                for (int n = 0; n < count; ++n) {
+                    const QVector3D& p = vertexData[found[n]].position;
+                    const double x = p.x() - mean[0];
+                    const double y = p.y() - mean[1];
+                    const double z = p.z() - mean[2];
+                    covariance[0] += x * x;
+                    covariance[1] += x * y;
+                    covariance[2] += x * z;
+                    covariance[3] += y * y;
+                    covariance[4] += y * z;
+                    covariance[5] += z * z;
+                }
+
+                QVector3D normal(0.0f, 0.0f, 1.0f);
+                if (count >= 3) {
+                    smallestEigenvector(covariance, normal);
+                }
+                normalData[v] = normal;
+
+                int* adjacent = graphData + qsizetype(v) * OrientNeighbors;
+                for (int n = 0, m = 0; n < count && m < OrientNeighbors; ++n) {
+                    if (found[n] != v) adjacent[m++] = found[n];
+                }
+            }
+        });
+        if (isCancelled(cancel)) return false;
+        setProgress(progress, 15 + 60 * (batch + 1) / NormalBatches);
+    }
+    const qint64 estimateTime = timer.elapsed();
+
+    // 2) 방향 맞추기: 이웃 그래프에서 |n_i·n_j|가 큰 변부터 펼치며(Prim) 부모와 반대면 뒤집음
+    double sum[3] = { 0.0, 0.0, 0.0 };
+    for (int v = 0; v < vertexCount; ++v) {
+        sum[0] += vertexData[v].position.x();
+        sum[1] += vertexData[v].position.y();
+        sum[2] += vertexData[v].position.z();
+    }
+    const QVector3D centroid(float(sum[0] / vertexCount), float(sum[1] / vertexCount), float(sum[2] / vertexCount));
+
+    struct Candidate {
+        float confidence;
+        int vertex;
+        int parent;
+
+        bool operator<(const Candidate& other) const { return confidence < other.confidence; }
+    };
+    std::priority_queue<Candidate> queue;
+    QVector<quint8> visited(vertexCount, 0);
+    int processed = 0;
+
+    auto pushNeighbors = [&](int v) {
+        const int* adjacent = graphData + qsizetype(v) * OrientNeighbors;
+        for (int n = 0; n < OrientNeighbors && adjacent[n] >= 0; ++n) {
+            const int u = adjacent[n];
+            if (!visited[u]) {
+                queue.push({ std::fabs(QVector3D::dotProduct(normalData[v], normalData[u])), u, v });
+            }
+        }
+    };
+    auto grow = [&](int seed) {
+        visited[seed] = 1;
+        pushNeighbors(seed);
+        while (!queue.empty()) {
+            const Candidate candidate = queue.top();
+            queue.pop();
+            if (visited[candidate.vertex]) continue;
+
+            visited[candidate.vertex] = 1;
+            if (QVector3D::dotProduct(normalData[candidate.vertex], normalData[candidate.parent]) < 0.0f) {
+                normalData[candidate.vertex] = -normalData[candidate.vertex];
+            }
+            pushNeighbors(candidate.vertex);
+
+            if (++processed % 65536 == 0) {
+                if (isCancelled(cancel)) return false;
+                setProgress(progress, 75 + int(25LL * processed / vertexCount));
+            }
+        }
+        return true;
+    };
+
+    // 첫 성분은 중심에서 가장 먼 점(바깥을 향하는 것이 확실한 점)에서 시작
+    int farthest = 0;
+    for (int v = 1; v < vertexCount; ++v) {
+        if ((vertexData[v].position - centroid).lengthSquared()
+            > (vertexData[farthest].position - centroid).lengthSquared()) {
+            farthest = v;
+        }
+    }
+    for (int i = -1; i < vertexCount; ++i) {
+        const int seed = i < 0 ? farthest : i;
+        if (visited[seed]) continue;
+
+        // 이미 방향이 정해진 이웃이 있으면 그쪽에 맞추고, 없으면 중심에서 바깥쪽으로
+        const int* adjacent = graphData + qsizetype(seed) * OrientNeighbors;
+        int reference = -1;
+        for (int n = 0; n < OrientNeighbors && adjacent[n] >= 0 && reference < 0; ++n) {
+            if (visited[adjacent[n]]) reference = adjacent[n];
+        }
+        const float facing = reference >= 0
+                           ? QVector3D::dotProduct(normalData[seed], normalData[reference])
+                           : QVector3D::dotProduct(normalData[seed], vertexData[seed].position - centroid);
+        if (facing < 0.0f) {
+            normalData[seed] = -normalData[seed];
+        }
+        if (!grow(seed)) return false;
+    }
+
+    VertexData* outData = vertices.data();
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            outData[v].normal = normalData[v];
+        }
+    });
+    setProgress(progress, 100);
+
+    qDebug() << "Point normals estimated:" << vertexCount << "points, k =" << k << "in" << estimateTime
+             << "ms, oriented in" << timer.elapsed() - estimateTime << "ms";
+    return true;
+}
+
+void MeshOperators::computeNormals(QVector<VertexData>& vertices, const QVector<unsigned int>& indices)
+{
+    const int vertexCount = vertices.size();
+    const int triangleCount = indices.size() / 3;
+    const unsigned int* indexData = indices.constData();
+    VertexData* vertexData = vertices.data();
+
+    // 면 법선(크기 = 면적 x 2)은 삼각형마다, 정점은 자기 삼각형 목록에서 모아 더함 (쓰기가 겹치지 않음)
+    QVector<QVector3D> faceNormals(triangleCount);
+    QVector3D* faceData = faceNormals.data();
+    Parallel::parallelFor(triangleCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype t = begin; t < end; ++t) {
+            const unsigned int* triangle = indexData + t * 3;
+            const QVector3D& p0 = vertexData[triangle[0]].position;
+            faceData[t] = QVector3D::crossProduct(vertexData[triangle[1]].position - p0,
+                                                  vertexData[triangle[2]].position - p0);
+        }
+    });
+
+    QVector<int> start(vertexCount + 1, 0);
+    for (int i = 0; i < triangleCount * 3; ++i) {
+        ++start[indexData[i] + 1];
+    }
+    for (int v = 0; v < vertexCount; ++v) {
+        start[v + 1] += start[v];
+    }
+    QVector<int> adjacency(triangleCount * 3);
+    QVector<int> cursor = start;
+    for (int i = 0; i < triangleCount * 3; ++i) {
+        adjacency[cursor[indexData[i]]++] = i / 3;
+    }
+
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            if (start[v] == start[v + 1]) continue;
+            QVector3D normal;
+            for (int a = start[v]; a < start[v + 1]; ++a) {
+                normal += faceData[adjacency[a]];
+            }
+            vertexData[v].normal = normal.normalized();
+        }
+    });
+}
+
+bool MeshOperators::smooth(QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                           const SmoothSettings& settings, const std::atomic_bool* cancel, std::atomic_int* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const int vertexCount = vertices.size();
+    if (vertexCount == 0 || indices.size() < 3 || settings.iterations <= 0) return false;
+    setProgress(progress, 0);
+
+    QVector<int> start;
+    QVector<int> neighbors;
+    QVector<bool> boundary;
+    buildVertexAdjacency(indices, vertexCount, start, neighbors, settings.fixBoundary ? &boundary : nullptr);
+    if (isCancelled(cancel)) return false;
+    setProgress(progress, 10);
+
+    // 두 위치 배열을 번갈아 읽고 씀 (Jacobi 방식)
+    QVector<QVector3D> current(vertexCount);
+    QVector<QVector3D> next(vertexCount);
+    const VertexData* vertexData = vertices.constData();
+    QVector3D* currentData = current.data();
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            currentData[v] = vertexData[v].position;
+        }
+    });
+
+    const int* startData = start.constData();
+    const int* neighborData = neighbors.constData();
+    const bool* fixed = settings.fixBoundary ? boundary.constData() : nullptr;
+    const bool taubin = settings.method == SmoothSettings::Taubin;
+    const int passes = settings.iterations * (taubin ? 2 : 1);
+    for (int pass = 0; pass < passes; ++pass) {
+        // Taubin은 λ(수축)와 μ(팽창)를 번갈아 적용
+        const float factor = taubin && pass % 2 == 1 ? settings.mu : settings.lambda;
+        const QVector3D* source = current.constData();
+        QVector3D* target = next.data();
+        Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype v = begin; v < end; ++v) {
+                const int first = startData[v];
+                const int last = startData[v + 1];
+                if (first == last || (fixed && fixed[v])) {
+                    target[v] = source[v];
+                    continue;
+                }
+                QVector3D sum;
+                for (int a = first; a < last; ++a) {
+                    sum += source[neighborData[a]];
+                }
+                target[v] = source[v] + (sum / float(last - first) - source[v]) * factor;
+            }
+        });
+        current.swap(next);
+
+        if (isCancelled(cancel)) return false;
+        setProgress(progress, 10 + 80 * (pass + 1) / passes);
+    }
+
+    // 끝까지 진행했을 때만 결과를 씀
+    VertexData* outData = vertices.data();
+    currentData = current.data();
+    Parallel::parallelFor(vertexCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            outData[v].position = currentData[v];
+        }
+    });
+    computeNormals(vertices, indices);
+    setProgress(progress, 100);
+
+    qDebug() << "Mesh smoothed:" << (taubin ? "Taubin" : "Laplacian") << settings.iterations << "iterations,"
+             << vertexCount << "vertices in" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool MeshOperators::subdivideLoop(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                                  int levels, MeshData& result, const std::atomic_bool* cancel,
+                                  std::atomic_int* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (vertices.isEmpty() || indices.size() < 3 || levels <= 0 || levels > 8) return false;
+
+    // 단계마다 삼각형이 4배, 정점은 대략 변 수만큼 늘어남 (32비트 인덱스 안에서만)
+    const qint64 finalIndexCount = qint64(indices.size() / 3) * 3 << (2 * levels);
+    if (finalIndexCount > std::numeric_limits<int>::max()) {
+        qDebug() << "Subdivision would exceed index limit:" << finalIndexCount << "indices";
+        return false;
+    }
+    setProgress(progress, 0);
+
+    QVector<VertexData> currentVertices = vertices;
+    QVector<unsigned int> currentIndices = indices;
+    currentIndices.resize(indices.size() / 3 * 3);
+    for (int level = 0; level < levels; ++level) {
+        QVector<VertexData> nextVertices;
+        QVector<unsigned int> nextIndices;
+        if (!subdivideOnce(currentVertices, currentIndices, nextVertices, nextIndices, cancel)) return false;
+        currentVertices.swap(nextVertices);
+        currentIndices.swap(nextIndices);
+        setProgress(progress, 90 * (level + 1) / levels);
+    }
+
+    computeNormals(currentVertices, currentIndices);
+    if (isCancelled(cancel)) return false;
+
+    result = MeshData();
+    result.vertices.swap(currentVertices);
+    result.indices.swap(currentIndices);
+    Mesh::completeData(result);
+    setProgress(progress, 100);
+
+    qDebug() << "Loop subdivision:" << levels << "levels," << result.vertices.size() << "vertices,"
+             << result.indices.size() / 3 << "triangles in" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool MeshOperators::downsample(const QVector<VertexData>& vertices, const DownsampleSettings& settings,
+                               MeshData& result, const std::atomic_bool* cancel, std::atomic_int* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const int vertexCount = vertices.size();
+    if (vertexCount == 0 || !(settings.spacing > 0.0f)) return false;
+    setProgress(progress, 0);
+
+    // 포아송 디스크는 한 변이 간격인 셀로, 셀에 든 표본과 이웃 셀(±1)의 표본만 비교하면 됨
+    const bool poisson = settings.method == DownsampleSettings::PoissonDisk;
+    VoxelGrid grid;
+    if (!grid.build(vertices, settings.spacing, cancel)) return false;
+    setProgress(progress, 30);
+
+    const int cellCount = grid.getCellCount();
+    const int cellGrain = 256;
+    const VertexData* vertexData = vertices.constData();
+    QVector<VertexData> reduced;        // 셀(복셀) 또는 표본(포아송 디스크)마다 한 점
+    QVector<int> representatives;       // 그 점의 출력 순서를 정하는 원래 정점 번호
+
+    if (!poisson) {
+        // 셀마다 평균 (위치는 double로 합함), 가장 가까운 점 방식은 위치/법선만 원래 점으로
+        const bool nearest = settings.method == DownsampleSettings::VoxelNearest;
+        reduced.resize(cellCount);
+        representatives.resize(cellCount);
+        VertexData* reducedData = reduced.data();
+        int* representativeData = representatives.data();
+        Parallel::parallelFor(cellCount, cellGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype cell = begin; cell < end; ++cell) {
+                const int* points = grid.getCellPoints(int(cell));
+                const int count = grid.getCellPointCount(int(cell));
+                double sum[3] = { 0.0, 0.0, 0.0 };
+                QVector3D normal;
+                QVector3D color;
+                QVector2D texCoord;
+                for (int j = 0; j < count; ++j) {
+                    const VertexData& vertex = vertexData[points[j]];
+                    sum[0] += vertex.position.x();
+                    sum[1] += vertex.position.y();
+                    sum[2] += vertex.position.z();
+                    normal += vertex.normal;
+                    color += vertex.color;
+                    texCoord += vertex.texCoord;
+                }
+
+                VertexData& out = reducedData[cell];
+                out.position = QVector3D(float(sum[0] / count), float(sum[1] / count), float(sum[2] / count));
+                out.normal = normal.normalized();
+                out.color = color / float(count);
+                out.texCoord = texCoord / float(count);
+
+                int representative = points[0];
+                if (nearest) {
+                    float bestDistance = std::numeric_limits<float>::max();
+                    for (int j = 0; j < count; ++j) {
+                        const float distance = (vertexData[points[j]].position - out.position).lengthSquared();
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            representative = points[j];
+                        }
+                    }
+                    out.position = vertexData[representative].position;
+                    out.normal = vertexData[representative].normal;
+                }
+                representativeData[cell] = representative;
+            }
+        });
+        if (isCancelled(cancel)) return false;
+        setProgress(progress, 90);
+    } else {
+        // 2칸 주기 위상(8개)으로 나누면 같은 위상의 셀 사이에 간격 이상의 빈 셀이 있어 동시에 골라도 간격이 지켜짐
+        // 위상 순서로, 셀 안에서는 원래 번호 순서로 이웃과 이 셀의 표본에서 간격 이상 떨어진 점을 표본으로
+        // 반 변 정육면체 하나에 표본이 하나뿐이므로 셀의 표본은 8개 이하이고, 셀 구간 앞쪽에 모아 둠
+        QVector<int> phaseStarts;
+        QVector<int> phaseCells;
+        groupCellsByPhase(grid, 2, phaseStarts, phaseCells);
+
+        const float minDistanceSquared = settings.spacing * settings.spacing;
+        QVector<int> cellSamples(vertexCount);
+        QVector<quint8> sampleCounts(cellCount, 0);
+        int* cellSampleData = cellSamples.data();
+        quint8* sampleCountData = sampleCounts.data();
+        for (int phase = 0; phase < 8; ++phase) {
+            const int phaseBegin = phaseStarts[phase];
+            Parallel::parallelFor(phaseStarts[phase + 1] - phaseBegin, cellGrain, [&](qsizetype begin, qsizetype end) {
+                QVarLengthArray<QVector3D, 256> nearby;
+                for (qsizetype i = begin; i < end; ++i) {
+                    const int cell = phaseCells[phaseBegin + i];
+                    int x, y, z;
+                    grid.getCellCoordinates(cell, x, y, z);
+                    nearby.clear();
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        for (int dy = -1; dy <= 1; ++dy) {
+                            for (int dz = -1; dz <= 1; ++dz) {
+                                const int neighbor = grid.findCell(x + dx, y + dy, z + dz);
+                                if (neighbor < 0) continue;
+                                const int* samples = cellSampleData + grid.getCellOffset(neighbor);
+                                for (int k = 0; k < sampleCountData[neighbor]; ++k) {
+                                    nearby.append(vertexData[samples[k]].position);
+                                }
+                            }
+                        }
+                    }
+
+                    const int* points = grid.getCellPoints(cell);
+                    const int count = grid.getCellPointCount(cell);
+                    int* samples = cellSampleData + grid.getCellOffset(cell);
+                    int sampleCount = 0;
+                    for (int j = 0; j < count && sampleCount < 8; ++j) {
+                        const QVector3D& position = vertexData[points[j]].position;
+                        bool accepted = true;
+                        for (const QVector3D& sample : nearby) {
+                            if ((sample - position).lengthSquared() < minDistanceSquared) {
+                                accepted = false;
+                                break;
+                            }
+                        }
+                        if (accepted) {
+                            samples[sampleCount++] = points[j];
+                            nearby.append(position);
+                        }
+                    }
+                    sampleCountData[cell] = quint8(sampleCount);
+                }
+            });
+            if (isCancelled(cancel)) return false;
+            setProgress(progress, 30 + 30 * (phase + 1) / 8);
+        }
+
+        // 표본 번호는 셀 순서로 누적
+        QVector<int> sampleBases(cellCount + 1);
+        sampleBases[0] = 0;
+        for (int cell = 0; cell < cellCount; ++cell) {
+            sampleBases[cell + 1] = sampleBases[cell] + sampleCountData[cell];
+        }
+        const int sampleTotal = sampleBases[cellCount];
+        reduced.resize(sampleTotal);
+        representatives.resize(sampleTotal);
+        VertexData* reducedData = reduced.data();
+        int* representativeData = representatives.data();
+        Parallel::parallelFor(cellCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype cell = begin; cell < end; ++cell) {
+                const int* samples = cellSampleData + grid.getCellOffset(int(cell));
+                for (int k = 0; k < sampleCountData[cell]; ++k) {
+                    representativeData[sampleBases[cell] + k] = samples[k];
+                }
+            }
+        });
+
+        // 모든 점은 간격 안(이웃 셀)에 표본이 있으므로 가장 가까운 표본에 속하고, 그 표본에 색/텍스처 좌표를 더함
+        // 3칸 주기 위상(27개)으로 나누면 같은 위상의 셀끼리는 ±1 이웃이 겹치지 않아 더하는 표본이 겹치지 않음
+        groupCellsByPhase(grid, 3, phaseStarts, phaseCells);
+        QVector<QVector3D> colorSums(sampleTotal);
+        QVector<QVector2D> texCoordSums(sampleTotal);
+        QVector<int> ownedCounts(sampleTotal, 0);
+        QVector3D* colorData = colorSums.data();
+        QVector2D* texCoordData = texCoordSums.data();
+        int* ownedData = ownedCounts.data();
+        for (int phase = 0; phase < 27; ++phase) {
+            const int phaseBegin = phaseStarts[phase];
+            Parallel::parallelFor(phaseStarts[phase + 1] - phaseBegin, cellGrain, [&](qsizetype begin, qsizetype end) {
+                QVarLengthArray<int, 256> nearby;
+                for (qsizetype i = begin; i < end; ++i) {
+                    const int cell = phaseCells[phaseBegin + i];
+                    int x, y, z;
+                    grid.getCellCoordinates(cell, x, y, z);
+                    nearby.clear();
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        for (int dy = -1; dy <= 1; ++dy) {
+                            for (int dz = -1; dz <= 1; ++dz) {
+                                const int neighbor = grid.findCell(x + dx, y + dy, z + dz);
+                                if (neighbor < 0) continue;
+                                for (int sample = sampleBases[neighbor]; sample < sampleBases[neighbor + 1]; ++sample) {
+                                    nearby.append(sample);
+                                }
+                            }
+                        }
+                    }
+
+                    const int* points = grid.getCellPoints(cell);
+                    const int count = grid.getCellPointCount(cell);
+                    for (int j = 0; j < count; ++j) {
+                        const VertexData& vertex = vertexData[points[j]];
+                        float bestDistance = std::numeric_limits<float>::max();
+                        int owner = -1;
+                        for (int sample : nearby) {
+                            const float distance = (vertexData[representativeData[sample]].position - vertex.position).lengthSquared();
+                            if (distance < bestDistance) {
+                                bestDistance = distance;
+                                owner = sample;
+                            }
+                        }
+                        if (owner < 0) continue;
+                        colorData[owner] += vertex.color;
+                        texCoordData[owner] += vertex.texCoord;
+                        ++ownedData[owner];
+                    }
+                }
+            });
+            if (isCancelled(cancel)) return false;
+            setProgress(progress, 60 + 30 * (phase + 1) / 27);
+        }
+
+        // 위치와 법선은 표본 점 그대로
+        Parallel::parallelFor(sampleTotal, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype sample = begin; sample < end; ++sample) {
+                VertexData& out = reducedData[sample];
+                out = vertexData[representativeData[sample]];
+                if (ownedData[sample] > 0) {
+                    out.color = colorData[sample] / float(ownedData[sample]);
+                    out.texCoord = texCoordData[sample] / float(ownedData[sample]);
+                }
+            }
+        });
+    }
+
+    result = MeshData();
+    gatherByRepresentative(vertexCount, representatives, reduced, result.vertices);
+    Mesh::completeData(result);
+    setProgress(progress, 100);
+
+    qDebug() << "Downsampled" << vertexCount << "points to" << result.vertices.size() << "in" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool MeshOperators::removeSmallComponents(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                                          const MeshComponents& components, int minTriangles, MeshData& result,
+                                          const std::atomic_bool* cancel, std::atomic_int* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+    setProgress(progress, 0);
+    if (components.getTriangleComponents().size() != indices.size() / 3
+        || components.getVertexComponents().size() != vertices.size()) {
+        return false;
+    }
+
+    // 성분마다 남길지 (남는 삼각형이 없으면 메시를 비우지 않고 실패)
+    const int componentCount = components.getComponentCount();
+    QVector<unsigned char> keep(componentCount);
+    int keptComponents = 0;
+    for (int c = 0; c < componentCount; ++c) {
+        keep[c] = components.getComponent(c).triangleCount >= minTriangles;
+        keptComponents += keep[c];
+    }
+    if (keptComponents == 0) {
+        qDebug() << "No component has" << minTriangles << "or more triangles";
+        return false;
+    }
+
+    // 남는 정점/삼각형을 원래 순서대로 압축 (조각별 개수 + 누적). 면에 쓰이지 않은 정점도 지움
+    const int vertexCount = vertices.size();
+    const int triangleCount = indices.size() / 3;
+    const QVector<int>& vertexComponents = components.getVertexComponents();
+    const QVector<int>& triangleComponents = components.getTriangleComponents();
+    auto keepVertex = [&](qsizetype v) { return vertexComponents[v] >= 0 && keep[vertexComponents[v]]; };
+    auto keepTriangle = [&](qsizetype t) { return keep[triangleComponents[t]] != 0; };
+
+    const int vertexChunks = Parallel::chunkCount(vertexCount, ParallelGrain);
+    QVector<int> vertexOffsets(vertexChunks + 1, 0);
+    Parallel::forEachChunk(vertexCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int count = 0;
+        for (qsizetype v = begin; v < end; ++v) {
+            if (keepVertex(v)) ++count;
+        }
+        vertexOffsets[chunk + 1] = count;
+    });
+    for (int chunk = 0; chunk < vertexChunks; ++chunk) {
+        vertexOffsets[chunk + 1] += vertexOffsets[chunk];
+    }
+
+    const int triangleChunks = Parallel::chunkCount(triangleCount, ParallelGrain);
+    QVector<int> triangleOffsets(triangleChunks + 1, 0);
+    Parallel::forEachChunk(triangleCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int count = 0;
+        for (qsizetype t = begin; t < end; ++t) {
+            if (keepTriangle(t)) ++count;
+        }
+        triangleOffsets[chunk + 1] = count;
+    });
+    for (int chunk = 0; chunk < triangleChunks; ++chunk) {
+        triangleOffsets[chunk + 1] += triangleOffsets[chunk];
+    }
+    if (isCancelled(cancel)) return false;
+
+    result = MeshData();
+    result.vertices.resize(vertexOffsets[vertexChunks]);
+    result.indices.resize(triangleOffsets[triangleChunks] * 3);
+    QVector<int> newIndex(vertexCount, -1);
+    VertexData* vertexData = result.vertices.data();
+    int* newIndexData = newIndex.data();
+    Parallel::forEachChunk(vertexCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int offset = vertexOffsets[chunk];
+        for (qsizetype v = begin; v < end; ++v) {
+            if (!keepVertex(v)) continue;
+            newIndexData[v] = offset;
+            vertexData[offset++] = vertices[v];
+        }
+    });
+    unsigned int* indexData = result.indices.data();
+    Parallel::forEachChunk(triangleCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int offset = triangleOffsets[chunk];
+        for (qsizetype t = begin; t < end; ++t) {
+            if (!keepTriangle(t)) continue;
+            for (int corner = 0; corner < 3; ++corner) {
+                indexData[offset * 3 + corner] = unsigned(newIndexData[indices[t * 3 + corner]]);
+            }
+            ++offset;
+        }
+    });
+    setProgress(progress, 80);
+
+    Mesh::completeData(result);
+    setProgress(progress, 100);
+
+    qDebug() << "Kept" << keptComponents << "of" << componentCount << "components," << result.indices.size() / 3
+             << "of" << triangleCount << "triangles in" << timer.elapsed() << "ms";
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef MESHOPERATORS_H
+#define MESHOPERATORS_H
+
+#include <QVector>
+#include <atomic>
+#include "Mesh.h"
+
+class MeshComponents;
+
+// 스무딩 설정
+struct SmoothSettings {
+    enum Method {
+        Laplacian,      // 이웃 평균 쪽으로 λ만큼 당김 (반복할수록 부피가 줄어듦)
+        Taubin          // λ로 당긴 뒤 μ(음수)로 되밀어 줄어듦을 상쇄
+    };
+
+    Method method = Taubin;
+    int iterations = 10;
+    float lambda = 0.5f;
+    float mu = -0.53f;
+    bool fixBoundary = true;    // 열린 경계의 정점은 움직이지 않음
+};
+
+// 점군 줄이기 설정
+struct DownsampleSettings {
+    enum Method {
+        VoxelCentroid,  // 셀마다 점들의 평균 한 점
+        VoxelNearest,   // 셀마다 평균에 가장 가까운 원래 점 (색은 셀 평균)
+        PoissonDisk     // 두 점 사이가 spacing 이상이 되도록 원래 점을 고름 (색은 가까운 점들의 평균)
+    };
+
+    Method method = VoxelCentroid;
+    float spacing = 0.0f;       // 복셀 한 변 또는 최소 간격
+};
+
+// 메시 전체에 적용하는 처리 연산자 (GL 호출 없음, 스레드 안전)
+// 정점 → 이웃 정점 인접 목록(CSR) 위에서 정점/변/면마다 독립적인 커널을 조각 병렬로 돌림
+// cancel이 설정되면 중단하고 false (입력은 그대로), progress에는 0~100 진행률을 씀
+class MeshOperators
+{
+public:
+    // 정점 위치를 고르게 하고 법선을 다시 계산 (위상은 그대로)
+    // 반복마다 이전 위치 배열만 읽고 새 배열에 쓰므로 정점 순서와 스레드 수에 관계없이 결과가 같음
+    static bool smooth(QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                       const SmoothSettings& settings, const std::atomic_bool* cancel = nullptr,
+                       std::atomic_int* progress = nullptr);
+
+    // Loop 세분화를 levels번 적용 (삼각형 수 4^levels배). result는 클러스터링까지 끝난 새 메시
+    // 반변 구조로 변을 한 번씩 번호 매겨 새 정점을 만들고, 비다양체 변은 경계처럼 나눔
+    static bool subdivideLoop(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices, int levels,
+                              MeshData& result, const std::atomic_bool* cancel = nullptr,
+                              std::atomic_int* progress = nullptr);
+
+    // 면이 없는 점군의 법선 추정: k-최근접 이웃(KD-트리)의 공분산에서 가장 작은 고유벡터를 법선으로 삼고,
+    // 이웃 그래프를 따라 신뢰도(|n_i·n_j|)가 높은 쪽부터 방향을 전파해 뒤집힘을 맞춤 (최소 신장 트리 근사)
+    // 각 연결 성분의 시작점은 점군 중심에서 바깥을 향함. 위치와 다른 속성은 그대로
+    static constexpr int DefaultNormalNeighbors = 16;
+    static bool estimatePointNormals(QVector<VertexData>& vertices, int neighbors = DefaultNormalNeighbors,
+                                     const std::atomic_bool* cancel = nullptr, std::atomic_int* progress = nullptr);
+
+    // 면이 없는 점군을 줄여 새 점군을 만듦 (result는 정점만 있고 원래 순서를 따름)
+    // 병렬 공간 해시(VoxelGrid)로 복셀은 셀마다 한 점을 만들고, 포아송 디스크는 셀을 위상으로 나눠
+    // (같은 위상의 셀끼리는 서로의 이웃이 아님) 셀마다 병렬로 표본을 고름. 스레드 수와 관계없이 같은 결과
+    static bool downsample(const QVector<VertexData>& vertices, const DownsampleSettings& settings,
+                           MeshData& result, const std::atomic_bool* cancel = nullptr,
+                           std::atomic_int* progress = nullptr);
+
+    // 삼각형이 minTriangles개 미만인 연결 성분(떠 있는 잡음 조각 등)을 지운 새 메시 (result는 클러스터링까지 끝남)
+    // components는 같은 정점/인덱스로 구축된 것 (기준을 고를 때 구한 성분을 다시 씀)
+    // 남는 정점/삼각형은 원래 순서를 따르고, 면에 쓰이지 않던 정점도 지움. 남는 성분이 없으면 false
+    static bool removeSmallComponents(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                                      const MeshComponents& components, int minTriangles, MeshData& result,
+                                      const std::atomic_bool* cancel = nullptr, std::atomic_int* progress = nullptr);
+
+    // 길이가 0이 아닌 법선이 하나라도 있는지 (법선 속성이 없는 점군 판별)
+    static bool hasNormals(const QVector<VertexData>& vertices);
+
+    // 면적 가중 면 법선의 합으로 정점 법선 계산
+    static void computeNormals(QVector<VertexData>& vertices, const QVector<unsigned int>& indices);
+
+    // 정점 → 이웃 정점 CSR (정점마다 중복 없이 오름차순)
+    // boundary가 있으면 한 면에만 속한 변이 닿은 정점(열린 경계)을 표시
+    static void buildVertexAdjacency(const QVector<unsigned int>& indices, int vertexCount,
+                                     QVector<int>& start, QVector<int>& neighbors,
+                                     QVector<bool>* boundary = nullptr);
+};
+
+#endif // MESHOPERATORS_H
@@ -0,0 +1,377 @@
+#include "MeshSlicer.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDebug>
+#include <cfloat>
+#include <cstdio>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 14;
+
+    // 버킷 수 상한과 삼각형 하나를 넣는 최대 버킷 수 (넘으면 긴 삼각형 버킷으로)
+    const int MaxBuckets = 1 << 20;
+    const int MaxSpanBuckets = 4;
+
+    // 잘린 모서리 (작은 정점 번호가 상위 32비트)
+    inline quint64 edgeKey(unsigned int a, unsigned int b)
+    {
+        return a < b ? quint64(a) << 32 | b : quint64(b) << 32 | a;
+    }
+
+    inline int bitsFor(quint32 value)
+    {
+        int bits = 1;
+        while (bits < 32 && (value >> bits) != 0) ++bits;
+        return bits;
+    }
+}
+
+MeshSlicer::MeshSlicer()
+    : m_minOffset(0.0f)
+    , m_maxOffset(0.0f)
+    , m_bucketScale(0.0f)
+    , m_bucketCount(0)
+{
+}
+
+void MeshSlicer::clear()
+{
+    m_normal = QVector3D();
+    m_minOffset = 0.0f;
+    m_maxOffset = 0.0f;
+    m_bucketScale = 0.0f;
+    m_bucketCount = 0;
+    m_distances.clear();
+    m_starts.clear();
+    m_triangles.clear();
+}
+
+int MeshSlicer::getBucket(float distance) const
+{
+    // 범위 밖 거리도 정수 변환 전에 자름
+    const float bucket = (distance - m_minOffset) * m_bucketScale;
+    if (!(bucket > 0.0f)) return 0;
+    if (bucket >= float(m_bucketCount - 1)) return m_bucketCount - 1;
+    return int(bucket);
+}
+
+bool MeshSlicer::build(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                       const QVector3D& normal, const std::atomic_bool* cancel)
+{
+    QElapsedTimer timer;
+    timer.start();
+    clear();
+
+    const int vertexCount = vertices.size();
+    const int triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0 || normal.isNull()) return false;
+    const QVector3D direction = normal.normalized();
+
+    // 정점 거리와 범위 (조각별 최소/최대를 모아 합침)
+    QVector<float> distances(vertexCount);
+    float* distanceData = distances.data();
+    const VertexData* vertexData = vertices.constData();
+    const int vertexChunks = Parallel::chunkCount(vertexCount, ParallelGrain);
+    QVector<float> chunkMin(vertexChunks);
+    QVector<float> chunkMax(vertexChunks);
+    Parallel::forEachChunk(vertexCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        float low = FLT_MAX;
+        float high = -FLT_MAX;
+        for (qsizetype v = begin; v < end; ++v) {
+            const float distance = QVector3D::dotProduct(direction, vertexData[v].position);
+            distanceData[v] = distance;
+            low = qMin(low, distance);
+            high = qMax(high, distance);
+        }
+        chunkMin[chunk] = low;
+        chunkMax[chunk] = high;
+    });
+    float minOffset = chunkMin[0];
+    float maxOffset = chunkMax[0];
+    for (int chunk = 1; chunk < vertexChunks; ++chunk) {
+        minOffset = qMin(minOffset, chunkMin[chunk]);
+        maxOffset = qMax(maxOffset, chunkMax[chunk]);
+    }
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    // 버킷 폭은 평균 삼각형 두께의 두 배 → 삼각형은 대개 한두 버킷, 버킷에는 단면 근처 삼각형만
+    const unsigned int* indexData = indices.constData();
+    const int chunks = Parallel::chunkCount(triangleCount, ParallelGrain);
+    QVector<double> chunkExtents(chunks, 0.0);
+    Parallel::forEachChunk(triangleCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        double extent = 0.0;
+        for (qsizetype t = begin; t < end; ++t) {
+            const float a = distanceData[indexData[t * 3]];
+            const float b = distanceData[indexData[t * 3 + 1]];
+            const float c = distanceData[indexData[t * 3 + 2]];
+            extent += qMax(a, qMax(b, c)) - qMin(a, qMin(b, c));
+        }
+        chunkExtents[chunk] = extent;
+    });
+    double extent = 0.0;
+    for (double chunkExtent : chunkExtents) {
+        extent += chunkExtent;
+    }
+    extent /= triangleCount;
+
+    const float range = maxOffset - minOffset;
+    int bucketCount = 1;
+    if (range > 0.0f) {
+        const double buckets = extent > 0.0 ? range / (2.0 * extent) : double(triangleCount);
+        bucketCount = int(qBound(1.0, buckets, double(qMin(MaxBuckets, triangleCount))));
+    }
+    m_minOffset = minOffset;
+    m_maxOffset = maxOffset;
+    m_bucketCount = bucketCount;
+    m_bucketScale = range > 0.0f ? float(bucketCount) / range : 0.0f;
+
+    // 삼각형이 걸치는 버킷 구간 (너무 길면 긴 삼각형 버킷 하나)
+    auto bucketSpan = [&](qsizetype t, int& first, int& last) {
+        const float a = distanceData[indexData[t * 3]];
+        const float b = distanceData[indexData[t * 3 + 1]];
+        const float c = distanceData[indexData[t * 3 + 2]];
+        first = getBucket(qMin(a, qMin(b, c)));
+        last = getBucket(qMax(a, qMax(b, c)));
+        if (last - first >= MaxSpanBuckets) {
+            first = last = bucketCount;
+        }
+    };
+
+    // (버킷, 삼각형) 쌍 수를 조각별로 세어 누적 → 쌍을 씀
+    QVector<int> chunkStarts(chunks + 1, 0);
+    Parallel::forEachChunk(triangleCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int entries = 0;
+        for (qsizetype t = begin; t < end; ++t) {
+            int first, last;
+            bucketSpan(t, first, last);
+            entries += last - first + 1;
+        }
+        chunkStarts[chunk + 1] = entries;
+    });
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        chunkStarts[chunk + 1] += chunkStarts[chunk];
+    }
+    const int entryCount = chunkStarts[chunks];
+
+    QVector<quint32> keys(entryCount);
+    QVector<int> triangles(entryCount);
+    quint32* keyData = keys.data();
+    int* triangleData = triangles.data();
+    Parallel::forEachChunk(triangleCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int entry = chunkStarts[chunk];
+        for (qsizetype t = begin; t < end; ++t) {
+            int first, last;
+            bucketSpan(t, first, last);
+            for (int bucket = first; bucket <= last; ++bucket) {
+                keyData[entry] = quint32(bucket);
+                triangleData[entry] = int(t);
+                ++entry;
+            }
+        }
+    });
+
+    // 같은 버킷 안은 삼각형 번호 순
+    if (!Parallel::sortByKey(keys, triangles, bitsFor(quint32(bucketCount)), ParallelGrain, cancel)) {
+        clear();
+        return false;
+    }
+
+    // 버킷 경계마다 그 사이 (빈 버킷 포함) 구간 시작을 씀
+    QVector<int> starts(bucketCount + 2);
+    int* startData = starts.data();
+    const quint32* sortedKeys = keys.constData();
+    Parallel::parallelFor(entryCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            const int previous = i == 0 ? -1 : int(sortedKeys[i - 1]);
+            for (int bucket = previous + 1; bucket <= int(sortedKeys[i]); ++bucket) {
+                startData[bucket] = int(i);
+            }
+        }
+    });
+    for (int bucket = int(sortedKeys[entryCount - 1]) + 1; bucket <= bucketCount + 1; ++bucket) {
+        startData[bucket] = entryCount;
+    }
+
+    m_normal = direction;
+    m_distances.swap(distances);
+    m_starts.swap(starts);
+    m_triangles.swap(triangles);
+
+    qDebug() << "Slice index:" << bucketCount << "buckets," << entryCount << "entries for" << triangleCount
+             << "triangles in" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool MeshSlicer::slice(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices, float offset,
+                       QVector<SlicePolyline>& polylines) const
+{
+    polylines.clear();
+    if (!isBuilt() || vertices.size() != m_distances.size()) return false;
+    if (offset < m_minOffset || offset > m_maxOffset) return true;
+
+    // 오프셋의 버킷 뒤에 긴 삼각형 버킷을 이어 붙인 후보 목록
+    const int bucket = getBucket(offset);
+    const int* bucketTriangles = m_triangles.constData();
+    const int nearBegin = m_starts[bucket];
+    const int nearCount = m_starts[bucket + 1] - nearBegin;
+    const int longBegin = m_starts[m_bucketCount];
+    const int candidateCount = nearCount + m_starts[m_bucketCount + 1] - longBegin;
+    auto candidate = [&](qsizetype i) {
+        return i < nearCount ? bucketTriangles[nearBegin + i] : bucketTriangles[longBegin + i - nearCount];
+    };
+
+    // 평면 위(거리 0)는 양쪽 중 위로 봄 → 잘린 모서리는 항상 부호가 다른 두 정점 사이
+    const float* distances = m_distances.constData();
+    const unsigned int* indexData = indices.constData();
+    const VertexData* vertexData = vertices.constData();
+    auto crosses = [&](int t) {
+        const unsigned int a = indexData[t * 3];
+        const unsigned int b = indexData[t * 3 + 1];
+        const unsigned int c = indexData[t * 3 + 2];
+        if (a == b || b == c || a == c) return false;
+        const int above = (distances[a] >= offset) + (distances[b] >= offset) + (distances[c] >= offset);
+        return above == 1 || above == 2;
+    };
+
+    // 교차 삼각형 수를 조각별로 세어 누적 → 선분 끝점마다 모서리 키와 점을 씀
+    const int chunks = Parallel::chunkCount(candidateCount, ParallelGrain);
+    QVector<int> chunkStarts(chunks + 1, 0);
+    Parallel::forEachChunk(candidateCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int segments = 0;
+        for (qsizetype i = begin; i < end; ++i) {
+            segments += crosses(candidate(i));
+        }
+        chunkStarts[chunk + 1] = segments;
+    });
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        chunkStarts[chunk + 1] += chunkStarts[chunk];
+    }
+    const int segmentCount = chunkStarts[chunks];
+    if (segmentCount == 0) return true;
+
+    // 모서리 위 점은 작은 정점 번호부터 보간 → 이웃 삼각형에서도 같은 점
+    const int endpointCount = segmentCount * 2;
+    QVector<quint64> keys(endpointCount);
+    QVector<QVector3D> points(endpointCount);
+    QVector<int> endpoints(endpointCount);
+    quint64* keyData = keys.data();
+    QVector3D* pointData = points.data();
+    int* endpointData = endpoints.data();
+    Parallel::forEachChunk(candidateCount, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int endpoint = chunkStarts[chunk] * 2;
+        for (qsizetype i = begin; i < end; ++i) {
+            const int t = candidate(i);
+            if (!crosses(t)) continue;
+            for (int corner = 0; corner < 3; ++corner) {
+                unsigned int u = indexData[t * 3 + corner];
+                unsigned int v = indexData[t * 3 + (corner + 1) % 3];
+                if ((distances[u] >= offset) == (distances[v] >= offset)) continue;
+                if (u > v) qSwap(u, v);
+                const float du = distances[u] - offset;
+                const float dv = distances[v] - offset;
+                const QVector3D& p = vertexData[u].position;
+                keyData[endpoint] = edgeKey(u, v);
+                pointData[endpoint] = p + (vertexData[v].position - p) * (du / (du - dv));
+                endpointData[endpoint] = endpoint;
+                ++endpoint;
+            }
+        }
+    });
+
+    // 같은 모서리의 끝점끼리 짝 (다양체가 아닌 모서리는 정렬 순서대로 둘씩)
+    const int keyBits = 32 + bitsFor(quint32(vertices.size() - 1));
+    if (!Parallel::sortByKey(keys, endpoints, keyBits, ParallelGrain)) return false;
+    QVector<int> links(endpointCount, -1);
+    keyData = keys.data();
+    endpointData = endpoints.data();
+    for (int i = 0; i + 1 < endpointCount; ) {
+        if (keyData[i] == keyData[i + 1]) {
+            links[endpointData[i]] = endpointData[i + 1];
+            links[endpointData[i + 1]] = endpointData[i];
+            i += 2;
+        } else {
+            ++i;
+        }
+    }
+
+    // 선분 s의 끝점은 2s, 2s+1. 들어온 끝점의 반대쪽으로 나가 이웃 선분으로 이어 감
+    QVector<bool> used(segmentCount, false);
+    auto walk = [&](int start) {
+        SlicePolyline polyline;
+        polyline.points.append(points[start]);
+        int current = start;
+        for (;;) {
+            used[current >> 1] = true;
+            const int exit = current ^ 1;
+            const int next = links[exit];
+            if (next == start) {
+                polyline.closed = true;
+                break;
+            }
+            polyline.points.append(points[exit]);
+            if (next < 0 || used[next >> 1]) break;
+            current = next;
+        }
+        polylines.append(polyline);
+    };
+
+    // 경계에서 끝나는 열린 선을 먼저, 남은 선분은 닫힌 선
+    for (int endpoint = 0; endpoint < endpointCount; ++endpoint) {
+        if (links[endpoint] < 0 && !used[endpoint >> 1]) walk(endpoint);
+    }
+    for (int segment = 0; segment < segmentCount; ++segment) {
+        if (!used[segment]) walk(segment * 2);
+    }
+    return true;
+}
+
+bool MeshSlicer::saveContours(const QString& filename, const QVector<SlicePolyline>& polylines)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Failed to open contour file for writing:" << filename;
+        return false;
+    }
+
+    // 닫힌 선은 마지막 점에서 첫 점으로 가는 모서리를 더함
+    auto edgeCount = [](const SlicePolyline& polyline) {
+        const int points = polyline.points.size();
+        return polyline.closed && points > 2 ? points : qMax(0, points - 1);
+    };
+    int vertexCount = 0;
+    int edges = 0;
+    for (const SlicePolyline& polyline : polylines) {
+        vertexCount += polyline.points.size();
+        edges += edgeCount(polyline);
+    }
+
+    QByteArray data = "ply\nformat ascii 1.0\ncomment CM_3DEditor cross-section\n";
+    data += "element vertex " + QByteArray::number(vertexCount) + "\n";
+    data += "property float x\nproperty float y\nproperty float z\n";
+    data += "element edge " + QByteArray::number(edges) + "\n";
+    data += "property int vertex1\nproperty int vertex2\nend_header\n";
+
+    char line[96];
+    for (const SlicePolyline& polyline : polylines) {
+        for (const QVector3D& p : polyline.points) {
+            data.append(line, std::snprintf(line, sizeof(line), "%.9g %.9g %.9g\n", p.x(), p.y(), p.z()));
+        }
+    }
+    int first = 0;
+    for (const SlicePolyline& polyline : polylines) {
+        const int points = polyline.points.size();
+        const int count = edgeCount(polyline);
+        for (int i = 0; i < count; ++i) {
+            data.append(line, std::snprintf(line, sizeof(line), "%d %d\n", first + i, first + (i + 1) % points));
+        }
+        first += points;
+    }
+
+    if (file.write(data) != data.size()) {
+        qDebug() << "Failed to write contour file:" << filename;
+        return false;
+    }
+    return true;
+}
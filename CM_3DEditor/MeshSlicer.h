@@ -0,0 +1,59 @@
+#ifndef MESHSLICER_H
+#define MESHSLICER_H
+
+#include <QVector>
+#include <QVector3D>
+#include <QString>
+#include <atomic>
+#include "Mesh.h"
+
+// 단면 윤곽선 하나 (closed면 마지막 점이 첫 점으로 이어짐)
+struct SlicePolyline {
+    QVector<QVector3D> points;
+    bool closed = false;
+};
+
+// 평면 방향 하나에 대한 메시 단면 (구간 버킷 + 병렬 교차)
+// 정점마다 법선 방향 거리를 구해 두고, 삼각형의 [최소, 최대] 거리 구간을 겹치는 버킷마다 넣어 버킷 순서로
+// 기수 정렬함 (버킷 폭은 평균 삼각형 두께의 두 배, 버킷을 많이 걸치는 긴 삼각형은 따로 모아 항상 검사).
+// 오프셋을 옮길 때는 그 버킷의 삼각형만 병렬로 평면과 교차시키고, 선분 끝점을 잘린 모서리(작은 정점 번호,
+// 큰 정점 번호)로 정렬해 이웃 선분을 이으므로 비용은 단면 근처 삼각형 수에 비례하고 감기 방향과 관계없음
+class MeshSlicer
+{
+public:
+    MeshSlicer();
+
+    // 평면 법선 방향으로 구축 (GL 호출 없음, 스레드 안전). 삼각형이 없거나 법선이 0이거나 cancel이 설정되면 false
+    bool build(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices, const QVector3D& normal,
+               const std::atomic_bool* cancel = nullptr);
+    void clear();
+
+    bool isBuilt() const { return !m_starts.isEmpty(); }
+    const QVector3D& getNormal() const { return m_normal; }
+
+    // 정점들의 법선 방향 거리 범위 (이 밖의 오프셋은 단면이 없음)
+    float getMinOffset() const { return m_minOffset; }
+    float getMaxOffset() const { return m_maxOffset; }
+
+    // 평면 dot(normal, p) = offset과의 단면 (build와 같은 정점/인덱스여야 함, 아니면 false)
+    // 열린 선은 메시 경계에서 끝나는 단면
+    bool slice(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices, float offset,
+               QVector<SlicePolyline>& polylines) const;
+
+    // 윤곽선을 ASCII PLY (vertex + edge 요소)로 저장
+    static bool saveContours(const QString& filename, const QVector<SlicePolyline>& polylines);
+
+private:
+    QVector3D m_normal;
+    float m_minOffset;
+    float m_maxOffset;
+    float m_bucketScale;            // 거리 → 버킷 번호
+    int m_bucketCount;              // 마지막 버킷(m_bucketCount번)은 긴 삼각형
+    QVector<float> m_distances;     // 정점 → 법선 방향 거리
+    QVector<int> m_starts;          // 버킷 → m_triangles 구간 시작 (버킷 수 + 2)
+    QVector<int> m_triangles;       // 버킷 순서로 모은 삼각형 번호
+
+    int getBucket(float distance) const;
+};
+
+#endif // MESHSLICER_H
@@ -0,0 +1,461 @@
+#include "MultiDrawBatch.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include "GLStateCache.h"
+#include "UniformBuffer.h"
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_4_3_Core>
+#include <QOpenGLVersionFunctionsFactory>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+    // glMultiDrawElementsIndirect 명령 하나의 크기
+    const int DrawCommandSize = 5 * sizeof(quint32);
+
+    // 아레나 초기 크기
+    const int InitialArenaVertices = 65536;
+    const int InitialArenaIndices = 196608;
+
+    // 컬링 컴퓨트 쉐이더의 단계 (쉐이더 상수와 일치)
+    const quint32 CullFrustum = 0;
+    const quint32 CullPrepass = 1;
+    const quint32 CullOcclusion = 2;
+
+    // frustumTriangles, drawnTriangles
+    const int CounterSize = 2 * sizeof(quint32);
+}
+
+MultiDrawBatch::MultiDrawBatch()
+    : m_triangleCount(0)
+    , m_objectsDirty(false)
+    , m_visibilityDirty(false)
+    , m_objectBuffer(0)
+    , m_commandBuffer(0)
+    , m_drawIdBuffer(0)
+    , m_visibilityBuffer(0)
+    , m_counterBuffer(0)
+    , m_bufferCapacity(0)
+    , m_readbackIndex(0)
+    , m_cullStats{ 0, 0, 0 }
+    , m_occlusionCulling(false)
+    , m_cullShader(nullptr)
+    , m_gl43(nullptr)
+{
+    for (int i = 0; i < MaxFramesInFlight; ++i) {
+        m_readbackBuffers[i] = 0;
+        m_readbackFences[i] = nullptr;
+    }
+}
+
+MultiDrawBatch::~MultiDrawBatch()
+{
+    destroy();
+}
+
+bool MultiDrawBatch::isSupported()
+{
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context || context->isOpenGLES()) return false;
+
+    if (context->format().version() < qMakePair(4, 3)) return false;
+
+    return QOpenGLVersionFunctionsFactory::get<QOpenGLFunctions_4_3_Core>(context) != nullptr;
+}
+
+bool MultiDrawBatch::initialize()
+{
+    if (isInitialized()) return true;
+    if (!isSupported()) return false;
+
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    m_gl43 = QOpenGLVersionFunctionsFactory::get<QOpenGLFunctions_4_3_Core>(context);
+    if (!m_gl43 || !m_gl43->initializeOpenGLFunctions()) {
+        m_gl43 = nullptr;
+        return false;
+    }
+    initializeOpenGLFunctions();
+
+    m_cullShader = Shader::createCullingShader();
+    if (!m_cullShader) {
+        qDebug() << "Failed to create culling compute shader; multi-draw path disabled";
+        return false;
+    }
+
+    glGenBuffers(1, &m_objectBuffer);
+    glGenBuffers(1, &m_commandBuffer);
+    glGenBuffers(1, &m_drawIdBuffer);
+    glGenBuffers(1, &m_visibilityBuffer);
+    glGenBuffers(1, &m_counterBuffer);
+    glGenBuffers(MaxFramesInFlight, m_readbackBuffers);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_counterBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, CounterSize, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    for (int i = 0; i < MaxFramesInFlight; ++i) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_readbackBuffers[i]);
+        glBufferData(GL_COPY_WRITE_BUFFER, CounterSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    m_arena.create(InitialArenaVertices, InitialArenaIndices);
+    ensureCapacity(256);
+
+    return true;
+}
+
+void MultiDrawBatch::destroy()
+{
+    if (QOpenGLContext::currentContext()) {
+        if (m_objectBuffer) glDeleteBuffers(1, &m_objectBuffer);
+        if (m_commandBuffer) glDeleteBuffers(1, &m_commandBuffer);
+        if (m_drawIdBuffer) glDeleteBuffers(1, &m_drawIdBuffer);
+        if (m_visibilityBuffer) glDeleteBuffers(1, &m_visibilityBuffer);
+        if (m_counterBuffer) glDeleteBuffers(1, &m_counterBuffer);
+
+        for (int i = 0; i < MaxFramesInFlight; ++i) {
+            if (m_readbackBuffers[i]) glDeleteBuffers(1, &m_readbackBuffers[i]);
+            if (m_readbackFences[i]) glDeleteSync(m_readbackFences[i]);
+        }
+    }
+
+    m_objectBuffer = 0;
+    m_commandBuffer = 0;
+    m_drawIdBuffer = 0;
+    m_visibilityBuffer = 0;
+    m_counterBuffer = 0;
+    m_bufferCapacity = 0;
+
+    for (int i = 0; i < MaxFramesInFlight; ++i) {
+        m_readbackBuffers[i] = 0;
+        m_readbackFences[i] = nullptr;
+    }
+    m_readbackIndex = 0;
+    m_cullStats = { 0, 0, 0 };
+
+    m_depthPyramid.destroy();
+
+    delete m_cullShader;
+    m_cullShader = nullptr;
+    m_gl43 = nullptr;
+
+    m_arena.destroy();
+    m_entries.clear();
+    m_objects.clear();
+    m_triangleCount = 0;
+}
+
+void MultiDrawBatch::clear()
+{
+    m_arena.clear();
+    m_entries.clear();
+    m_objects.clear();
+    m_triangleCount = 0;
+    m_objectsDirty = true;
+    m_visibilityDirty = true;
+    m_cullStats = { 0, 0, 0 };
+}
+
+bool MultiDrawBatch::addMesh(Mesh* mesh, const QMatrix4x4& model)
+{
+    if (!isInitialized() || !mesh || !mesh->hasData()) return false;
+
+    GeometryArena::Allocation allocation;
+    if (!m_arena.append(mesh, allocation)) {
+        return false;
+    }
+
+    Entry entry;
+    entry.mesh = mesh;
+    entry.revision = mesh->getRevision();
+    entry.visibilityRevision = mesh->getVisibilityRevision();
+    entry.vertexRevision = mesh->getVertexRevision();
+    entry.allocation = allocation;
+    entry.firstObject = m_objects.size();
+    entry.objectCount = mesh->getClusters().size();
+
+    // 클러스터마다 하나의 오브젝트 (같은 모델 행렬 공유). 숨긴 삼각형만 있는 앞뒤 구간은 제외
+    for (const MeshCluster& cluster : mesh->getVisibleClusters()) {
+        ObjectData object;
+        UniformBuffer::writeMatrix(object.model, model);
+        UniformBuffer::writeNormalMatrix(object.normalMatrix, model);
+        object.boundingSphere[0] = cluster.center.x();
+        object.boundingSphere[1] = cluster.center.y();
+        object.boundingSphere[2] = cluster.center.z();
+        object.boundingSphere[3] = cluster.radius;
+        object.drawRange[0] = quint32(allocation.firstIndex + cluster.firstIndex);
+        object.drawRange[1] = quint32(cluster.indexCount);
+        object.drawRange[2] = quint32(allocation.baseVertex);
+        object.drawRange[3] = 0;
+        m_objects.append(object);
+    }
+
+    m_entries.append(entry);
+    m_triangleCount += mesh->getIndexCount() / 3;
+    m_objectsDirty = true;
+    m_visibilityDirty = true;
+    return true;
+}
+
+bool MultiDrawBatch::containsMesh(const Mesh* mesh) const
+{
+    // 다시 로드된 메시는 리비전이 달라지므로 포함되지 않은 것으로 취급
+    for (const Entry& entry : m_entries) {
+        if (entry.mesh == mesh && entry.revision == mesh->getRevision()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MultiDrawBatch::setMeshTransform(const Mesh* mesh, const QMatrix4x4& model)
+{
+    for (const Entry& entry : m_entries) {
+        if (entry.mesh != mesh || entry.objectCount == 0) continue;
+
+        // 변경이 없으면 업로드 생략
+        if (std::memcmp(m_objects[entry.firstObject].model, model.constData(), 16 * sizeof(float)) == 0) {
+            continue;
+        }
+
+        for (int i = entry.firstObject; i < entry.firstObject + entry.objectCount; ++i) {
+            UniformBuffer::writeMatrix(m_objects[i].model, model);
+            UniformBuffer::writeNormalMatrix(m_objects[i].normalMatrix, model);
+        }
+        m_objectsDirty = true;
+    }
+}
+
+void MultiDrawBatch::updateMesh(const Mesh* mesh)
+{
+    for (Entry& entry : m_entries) {
+        if (entry.mesh != mesh) continue;
+
+        bool visibilityChanged = entry.visibilityRevision != mesh->getVisibilityRevision();
+        bool verticesChanged = entry.vertexRevision != mesh->getVertexRevision();
+        if (!visibilityChanged && !verticesChanged) continue;
+
+        // 숨긴 삼각형은 메시 버퍼에서 퇴화 삼각형으로 바뀌어 있으므로 GPU 간 복사로 반영
+        if (visibilityChanged && m_arena.copyIndices(mesh, entry.allocation)) {
+            entry.visibilityRevision = mesh->getVisibilityRevision();
+        }
+
+        // 직전 한 번의 편집만 놓쳤으면 그 구간만, 더 놓쳤으면 전체 복사
+        if (verticesChanged) {
+            bool consecutive = entry.vertexRevision + 1 == mesh->getVertexRevision();
+            if (m_arena.copyVertices(mesh, entry.allocation, consecutive ? &mesh->getUpdatedVertexRanges() : nullptr)) {
+                entry.vertexRevision = mesh->getVertexRevision();
+            }
+        }
+
+        const QVector<MeshCluster>& clusters = mesh->getVisibleClusters();
+        for (int i = 0; i < entry.objectCount && i < clusters.size(); ++i) {
+            ObjectData& object = m_objects[entry.firstObject + i];
+            object.boundingSphere[0] = clusters[i].center.x();
+            object.boundingSphere[1] = clusters[i].center.y();
+            object.boundingSphere[2] = clusters[i].center.z();
+            object.boundingSphere[3] = clusters[i].radius;
+            object.drawRange[0] = quint32(entry.allocation.firstIndex + clusters[i].firstIndex);
+            object.drawRange[1] = quint32(clusters[i].indexCount);
+        }
+        m_objectsDirty = true;
+    }
+}
+
+void MultiDrawBatch::setOcclusionCullingEnabled(bool enabled)
+{
+    m_occlusionCulling = enabled;
+}
+
+void MultiDrawBatch::cull(const QVector4D frustumPlanes[6], const QMatrix4x4& viewProjection)
+{
+    if (!isInitialized() || m_objects.isEmpty()) return;
+
+    readCounters();
+
+    if (m_occlusionCulling && !m_depthPyramid.create()) {
+        qDebug() << "Occlusion culling disabled";
+        m_occlusionCulling = false;
+    }
+
+    for (int i = 0; i < 6; ++i) {
+        m_frustumPlanes[i] = frustumPlanes[i];
+    }
+    m_viewProjection = viewProjection;
+
+    if (m_objectsDirty) {
+        uploadObjects();
+    }
+
+    // 오브젝트 구성이 바뀌면 이전 가시성은 의미 없음 (첫 프레임은 2단계에서 모두 검사)
+    if (m_visibilityDirty) {
+        QVector<quint32> zeros(m_objects.size(), 0);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_visibilityBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, GLsizeiptr(zeros.size()) * sizeof(quint32), zeros.constData());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        m_visibilityDirty = false;
+    }
+
+    const quint32 counters[2] = { 0, 0 };
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_counterBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, CounterSize, counters);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    m_cullShader->bind();
+    dispatchCull(m_occlusionCulling ? CullPrepass : CullFrustum);
+    m_cullShader->release();
+}
+
+void MultiDrawBatch::draw(GLStateCache& state)
+{
+    if (!isInitialized() || m_objects.isEmpty()) return;
+
+    // 통계용 삼각형 수는 가장 최근에 읽은 카운터 값
+    qint64 triangles = m_cullStats.totalTriangles > 0 ? m_cullStats.drawnTriangles : m_triangleCount;
+
+    state.bindVertexArray(m_arena.getVertexArrayId());
+    drawCommands(state, triangles);
+
+    if (m_occlusionCulling) {
+        GLuint program = state.getProgram();
+
+        // 1단계에서 그린 깊이로 피라미드 생성
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        if (m_depthPyramid.build(viewport[2], viewport[3])) {
+            state.useProgram(m_cullShader->programId());
+
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, m_depthPyramid.getTextureId());
+            dispatchCull(CullOcclusion);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            // 2단계: 새로 드러난 클러스터만 그림
+            state.useProgram(program);
+            drawCommands(state, 0);
+        }
+    }
+
+    copyCounters();
+}
+
+void MultiDrawBatch::dispatchCull(quint32 phase)
+{
+    m_cullShader->setUniformValueArray(m_cullShader->getUniformLocation("frustumPlanes"), m_frustumPlanes, 6);
+    m_cullShader->setUniformValue(m_cullShader->getUniformLocation("objectCount"), GLuint(m_objects.size()));
+    m_cullShader->setUniformValue(m_cullShader->getUniformLocation("cullPhase"), GLuint(phase));
+
+    if (phase == CullOcclusion) {
+        m_cullShader->setUniformValue(m_cullShader->getUniformLocation("cullViewProjection"), m_viewProjection);
+        glUniform2i(m_cullShader->getUniformLocation("hiZSize"), m_depthPyramid.getWidth(), m_depthPyramid.getHeight());
+        m_cullShader->setUniformValue(m_cullShader->getUniformLocation("hiZLevels"), m_depthPyramid.getLevelCount());
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ObjectStorageBinding, m_objectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CommandStorageBinding, m_commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VisibilityStorageBinding, m_visibilityBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CounterStorageBinding, m_counterBuffer);
+
+    glDispatchCompute((m_objects.size() + 63) / 64, 1, 1);
+
+    // 간접 명령과 SSBO 쓰기가 드로우 전에 보이도록
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void MultiDrawBatch::drawCommands(GLStateCache& state, qint64 triangleCount)
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ObjectStorageBinding, m_objectBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+
+    m_gl43->glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, m_objects.size(), 0);
+    state.recordDraw(GL_TRIANGLES, triangleCount * 3);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void MultiDrawBatch::copyCounters()
+{
+    // 아직 읽지 않은 슬롯이면 이번 프레임은 건너뜀 (대기하지 않음)
+    int slot = m_readbackIndex;
+    if (m_readbackFences[slot]) return;
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, m_counterBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_readbackBuffers[slot]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, CounterSize);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    m_readbackFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_readbackIndex = (slot + 1) % MaxFramesInFlight;
+}
+
+void MultiDrawBatch::readCounters()
+{
+    // 오래된 슬롯부터 확인해 가장 최근 결과가 남도록
+    for (int i = 0; i < MaxFramesInFlight; ++i) {
+        int slot = (m_readbackIndex + i) % MaxFramesInFlight;
+        GLsync fence = m_readbackFences[slot];
+        if (!fence) continue;
+
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) continue;
+
+        glDeleteSync(fence);
+        m_readbackFences[slot] = nullptr;
+
+        glBindBuffer(GL_COPY_READ_BUFFER, m_readbackBuffers[slot]);
+        const quint32* counters = static_cast<const quint32*>(
+            glMapBufferRange(GL_COPY_READ_BUFFER, 0, CounterSize, GL_MAP_READ_BIT));
+        if (counters) {
+            m_cullStats.totalTriangles = m_triangleCount;
+            m_cullStats.frustumTriangles = counters[0];
+            m_cullStats.drawnTriangles = counters[1];
+            glUnmapBuffer(GL_COPY_READ_BUFFER);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+}
+
+void MultiDrawBatch::ensureCapacity(int objectCount)
+{
+    if (objectCount <= m_bufferCapacity) return;
+
+    int capacity = qMax(objectCount, m_bufferCapacity * 2);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, GLsizeiptr(capacity) * sizeof(ObjectData), nullptr, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_commandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, GLsizeiptr(capacity) * DrawCommandSize, nullptr, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_visibilityBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, GLsizeiptr(capacity) * sizeof(quint32), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    m_visibilityDirty = true;
+
+    // 드로우 ID 버퍼: 0, 1, 2, ... (baseInstance로 인덱싱됨)
+    QVector<quint32> drawIds(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        drawIds[i] = quint32(i);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, m_drawIdBuffer);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(capacity) * sizeof(quint32), drawIds.constData(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_arena.setDrawIdBuffer(m_drawIdBuffer);
+    m_bufferCapacity = capacity;
+}
+
+void MultiDrawBatch::uploadObjects()
+{
+    ensureCapacity(m_objects.size());
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_objectBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, GLsizeiptr(m_objects.size()) * sizeof(ObjectData), m_objects.constData());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    m_objectsDirty = false;
+}
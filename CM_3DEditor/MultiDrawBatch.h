@@ -0,0 +1,139 @@
+#ifndef MULTIDRAWBATCH_H
+#define MULTIDRAWBATCH_H
+
+#include <QOpenGLExtraFunctions>
+#include <QMatrix4x4>
+#include <QVector4D>
+#include <QVector>
+#include "GeometryArena.h"
+#include "DepthPyramid.h"
+
+class Mesh;
+class Shader;
+class GLStateCache;
+class QOpenGLFunctions_4_3_Core;
+
+// SSBO 바인딩 포인트 (쉐이더 소스의 binding과 일치)
+enum StorageBlockBinding {
+    ObjectStorageBinding = 2,
+    CommandStorageBinding = 3,
+    VisibilityStorageBinding = 4,
+    CounterStorageBinding = 5
+};
+
+// 여러 메시의 클러스터를 공유 아레나에 모아 glMultiDrawElementsIndirect 한 번으로 그리는 배치
+// 컴퓨트 쉐이더가 절두체 컬링 결과로 간접 명령 버퍼를 직접 채우므로 CPU 비용은 오브젝트 수와 무관
+//
+// 가림 컬링을 켜면 두 단계로 그림
+//   1) 이전 프레임에 보였던 클러스터를 먼저 그림
+//   2) 그 깊이로 Hi-Z 피라미드를 만들고, 나머지 클러스터를 현재 카메라 행렬로 검사해 새로 보이는 것만 그림
+// 가시성은 다음 프레임의 1단계 입력이 됨
+class MultiDrawBatch : protected QOpenGLExtraFunctions
+{
+public:
+    static constexpr int MaxFramesInFlight = 3;
+
+    // std430 레이아웃: 쉐이더의 ObjectData와 동일
+    struct ObjectData {
+        float model[16];
+        float normalMatrix[16];
+        float boundingSphere[4];
+        quint32 drawRange[4];   // firstIndex, indexCount, baseVertex, 예약
+    };
+
+    // 컬링 결과 (GPU 카운터를 비동기로 읽으므로 몇 프레임 늦음)
+    struct CullStats {
+        qint64 totalTriangles;
+        qint64 frustumTriangles;    // 절두체 안
+        qint64 drawnTriangles;      // 가림 컬링 후 실제로 그린 수
+
+        float getCulledFraction() const {
+            return totalTriangles > 0 ? 1.0f - float(drawnTriangles) / float(totalTriangles) : 0.0f;
+        }
+        float getOccludedFraction() const {
+            return totalTriangles > 0 ? float(frustumTriangles - drawnTriangles) / float(totalTriangles) : 0.0f;
+        }
+    };
+
+    MultiDrawBatch();
+    ~MultiDrawBatch();
+
+    // GL 4.3 (컴퓨트, SSBO, 간접 멀티 드로우) 지원 여부
+    static bool isSupported();
+
+    bool initialize();
+    void destroy();
+    bool isInitialized() const { return m_cullShader != nullptr; }
+
+    // 메시 관리 (메시의 클러스터 하나가 오브젝트 하나)
+    void clear();
+    bool addMesh(Mesh* mesh, const QMatrix4x4& model);
+    bool containsMesh(const Mesh* mesh) const;
+    void setMeshTransform(const Mesh* mesh, const QMatrix4x4& model);
+
+    // 메시의 숨김/정점이 바뀌었으면 아레나 내용과 클러스터 드로우 구간/경계 구를 갱신
+    void updateMesh(const Mesh* mesh);
+
+    // Hi-Z 가림 컬링 (채워진 삼각형을 그릴 때만 의미 있음)
+    void setOcclusionCullingEnabled(bool enabled);
+    bool isOcclusionCullingEnabled() const { return m_occlusionCulling; }
+
+    // 프레임 처리
+    // cull()은 첫 단계 명령을 만들고, draw()는 가림 컬링이 켜져 있으면 두 번째 단계까지 수행
+    void cull(const QVector4D frustumPlanes[6], const QMatrix4x4& viewProjection);
+    void draw(GLStateCache& state);
+
+    int getObjectCount() const { return m_objects.size(); }
+    qint64 getTriangleCount() const { return m_triangleCount; }
+    const CullStats& getCullStats() const { return m_cullStats; }
+
+private:
+    struct Entry {
+        const Mesh* mesh;
+        int revision;
+        int visibilityRevision;
+        int vertexRevision;
+        GeometryArena::Allocation allocation;
+        int firstObject;
+        int objectCount;
+    };
+
+    GeometryArena m_arena;
+    QVector<Entry> m_entries;
+    QVector<ObjectData> m_objects;
+    qint64 m_triangleCount;
+    bool m_objectsDirty;
+    bool m_visibilityDirty;
+
+    // GPU 버퍼
+    GLuint m_objectBuffer;
+    GLuint m_commandBuffer;
+    GLuint m_drawIdBuffer;
+    GLuint m_visibilityBuffer;
+    GLuint m_counterBuffer;
+    int m_bufferCapacity;
+
+    // 카운터 읽기용 링 (fence가 지난 것만 매핑)
+    GLuint m_readbackBuffers[MaxFramesInFlight];
+    GLsync m_readbackFences[MaxFramesInFlight];
+    int m_readbackIndex;
+    CullStats m_cullStats;
+
+    // 가림 컬링
+    DepthPyramid m_depthPyramid;
+    bool m_occlusionCulling;
+    QVector4D m_frustumPlanes[6];
+    QMatrix4x4 m_viewProjection;
+
+    Shader* m_cullShader;
+    QOpenGLFunctions_4_3_Core* m_gl43;
+
+    void ensureCapacity(int objectCount);
+    void uploadObjects();
+    void dispatchCull(quint32 phase);
+    void drawCommands(GLStateCache& state, qint64 triangleCount);
+    void copyCounters();
+    void readCounters();
+};
+
+#endif // MULTIDRAWBATCH_H
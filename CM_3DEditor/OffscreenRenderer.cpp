@@ -0,0 +1,118 @@
+#include "OffscreenRenderer.h"
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QOpenGLFramebufferObject>
+#include <QSurfaceFormat>
+#include <QDebug>
+
+OffscreenRenderer::OffscreenRenderer()
+    : m_context(nullptr)
+    , m_surface(nullptr)
+    , m_framebuffer(nullptr)
+    , m_renderer(nullptr)
+{
+}
+
+OffscreenRenderer::~OffscreenRenderer()
+{
+    cleanup();
+}
+
+bool OffscreenRenderer::initialize(const QSize& size, int samples)
+{
+    if (isInitialized()) return true;
+
+    // main.cpp에서 지정한 기본 형식(3.3 Core) 사용
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+
+    m_surface = new QOffscreenSurface();
+    m_surface->setFormat(format);
+    m_surface->create();
+
+    m_context = new QOpenGLContext();
+    m_context->setFormat(format);
+    if (!m_context->create() || !m_context->makeCurrent(m_surface)) {
+        qDebug() << "Failed to create offscreen OpenGL context";
+        cleanup();
+        return false;
+    }
+
+    qDebug() << "Offscreen context:" << reinterpret_cast<const char*>(m_context->functions()->glGetString(GL_RENDERER))
+             << reinterpret_cast<const char*>(m_context->functions()->glGetString(GL_VERSION));
+
+    // 위젯과 같은 D24S8 깊이/스텐실 (Hi-Z 깊이 복사 형식과 일치)
+    QOpenGLFramebufferObjectFormat framebufferFormat;
+    framebufferFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    framebufferFormat.setSamples(samples);
+    m_framebuffer = new QOpenGLFramebufferObject(size, framebufferFormat);
+    if (!m_framebuffer->isValid()) {
+        qDebug() << "Failed to create offscreen framebuffer" << size;
+        cleanup();
+        return false;
+    }
+
+    m_size = size;
+    m_camera.setAspectRatio(float(size.width()) / float(size.height()));
+
+    m_framebuffer->bind();
+    m_renderer = new Renderer();
+    m_renderer->initialize();
+    m_renderer->setCamera(&m_camera);
+    m_renderer->resize(size.width(), size.height());
+
+    return true;
+}
+
+void OffscreenRenderer::cleanup()
+{
+    // GL 리소스는 컨텍스트가 활성화된 상태에서 해제
+    if (m_context && m_surface && m_context->makeCurrent(m_surface)) {
+        delete m_renderer;
+        delete m_framebuffer;
+        m_context->doneCurrent();
+    }
+    m_renderer = nullptr;
+    m_framebuffer = nullptr;
+
+    delete m_context;
+    delete m_surface;
+    m_context = nullptr;
+    m_surface = nullptr;
+}
+
+bool OffscreenRenderer::makeCurrent()
+{
+    return m_context && m_context->makeCurrent(m_surface);
+}
+
+void OffscreenRenderer::doneCurrent()
+{
+    if (m_context) {
+        m_context->doneCurrent();
+    }
+}
+
+QImage OffscreenRenderer::render(Mesh* mesh, const QMatrix4x4& model)
+{
+    if (!isInitialized() || !mesh || !mesh->hasData()) return QImage();
+
+    m_framebuffer->bind();
+    m_renderer->setMesh(mesh);
+    m_renderer->setModelMatrix(model);
+    m_renderer->render();
+
+    // 멀티샘플이면 내부적으로 resolve 후 읽음
+    return m_framebuffer->toImage();
+}
+
+bool OffscreenRenderer::draw(Mesh* mesh, const QMatrix4x4& model)
+{
+    if (!isInitialized() || !mesh || !mesh->hasData()) return false;
+
+    m_framebuffer->bind();
+    m_renderer->setMesh(mesh);
+    m_renderer->setModelMatrix(model);
+    m_renderer->render();
+    m_context->functions()->glFinish();
+    return true;
+}
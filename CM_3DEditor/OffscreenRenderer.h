@@ -0,0 +1,48 @@
+#ifndef OFFSCREENRENDERER_H
+#define OFFSCREENRENDERER_H
+
+#include <QSize>
+#include <QImage>
+#include "Renderer.h"
+#include "Camera.h"
+
+class QOpenGLContext;
+class QOffscreenSurface;
+class QOpenGLFramebufferObject;
+
+// 창 없이 Renderer를 사용하는 오프스크린 렌더러
+// QOffscreenSurface + 전용 컨텍스트에서 프레임버퍼 객체로 그린 뒤 이미지로 읽음
+class OffscreenRenderer
+{
+public:
+    OffscreenRenderer();
+    ~OffscreenRenderer();
+
+    bool initialize(const QSize& size, int samples = 4);
+    void cleanup();
+    bool isInitialized() const { return m_renderer != nullptr; }
+
+    // 메시 생성/업로드 전에 컨텍스트를 활성화해야 함
+    bool makeCurrent();
+    void doneCurrent();
+
+    Renderer* getRenderer() { return m_renderer; }
+    Camera* getCamera() { return &m_camera; }
+    QSize getSize() const { return m_size; }
+
+    // 현재 카메라로 메시를 그려 이미지로 반환 (컨텍스트가 활성화되어 있어야 함)
+    QImage render(Mesh* mesh, const QMatrix4x4& model = QMatrix4x4());
+
+    // 읽지 않고 그리기만 한 뒤 GPU가 끝날 때까지 기다림 (프레임 시간 측정용)
+    bool draw(Mesh* mesh, const QMatrix4x4& model = QMatrix4x4());
+
+private:
+    QOpenGLContext* m_context;
+    QOffscreenSurface* m_surface;
+    QOpenGLFramebufferObject* m_framebuffer;
+    Renderer* m_renderer;
+    Camera m_camera;
+    QSize m_size;
+};
+
+#endif // OFFSCREENRENDERER_H
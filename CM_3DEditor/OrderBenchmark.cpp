@@ -0,0 +1,201 @@
+#include "OrderBenchmark.h"
+#include "OffscreenRenderer.h"
+#include "Parallel.h"
+#include "KdTree.h"
+#include "VoxelGrid.h"
+#include "Bvh.h"
+#include "MeshOperators.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDebug>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 12;
+
+    // 정점마다 찾는 이웃 수 (법선 추정 기본값과 같음)
+    const int NearestCount = MeshOperators::DefaultNormalNeighbors;
+
+    // 렌더링 측정 전 버리는 프레임 (쉐이더 준비, 드라이버 지연 업로드)
+    const int WarmupFrames = 5;
+
+    // 질의 반경과 격자 셀 크기 (모델 반지름 비율, 다운샘플 기본값과 같음)
+    const float QueryScale = 0.01f;
+
+    // 회차마다 prepare(측정 제외) 후 work 시간을 재어 가장 빠른 값
+    template<typename Prepare, typename Work>
+    double bestOf(int repeats, Prepare prepare, Work work)
+    {
+        double best = -1.0;
+        for (int r = 0; r < qMax(1, repeats); ++r) {
+            prepare();
+            QElapsedTimer timer;
+            timer.start();
+            work();
+            const double ms = timer.nsecsElapsed() / 1.0e6;
+            if (best < 0.0 || ms < best) best = ms;
+        }
+        return best;
+    }
+
+    template<typename Work>
+    double bestOf(int repeats, Work work)
+    {
+        return bestOf(repeats, []() {}, work);
+    }
+
+    QString formatMs(double ms)
+    {
+        return ms < 0.0 ? QString("%1").arg("-", 10) : QString("%1").arg(ms, 10, 'f', 2);
+    }
+}
+
+OrderBenchmark::OrderBenchmark(const Options& options)
+    : m_options(options)
+{
+}
+
+int OrderBenchmark::run()
+{
+    MeshData loaded;
+    if (!Mesh::loadData(m_options.input, loaded)) {
+        qWarning() << "Cannot load" << m_options.input;
+        return 1;
+    }
+    const bool mesh = !loaded.indices.isEmpty();
+    qInfo().noquote() << QString("%1: %2 vertices, %3 triangles, %4 threads")
+                             .arg(QFileInfo(m_options.input).fileName())
+                             .arg(loaded.vertices.size())
+                             .arg(loaded.indices.size() / 3)
+                             .arg(QThreadPool::globalInstance()->maxThreadCount());
+
+    OffscreenRenderer offscreen;
+    if (m_options.frames > 0 && !offscreen.initialize(m_options.size)) {
+        return 1;
+    }
+
+    QVector<Result> results;
+    const SpatialOrder::Curve curves[] = { SpatialOrder::FileOrder, SpatialOrder::Morton, SpatialOrder::Hilbert };
+    for (SpatialOrder::Curve curve : curves) {
+        Result result;
+        result.curve = curve;
+
+        // 곡선 계산과 재배치를 한 번에 측정 (로드 시 추가되는 시간). 복사는 측정 전에 끝냄
+        MeshData data = loaded;
+        if (curve != SpatialOrder::FileOrder) {
+            result.reorderMs = bestOf(m_options.repeats, [&]() {
+                data = loaded;
+                data.vertices.detach();
+                data.indices.detach();
+            }, [&]() {
+                QVector<int> order;
+                if (SpatialOrder::computeOrder(data.vertices, curve, order)) {
+                    SpatialOrder::apply(data, order);
+                }
+            });
+        }
+
+        measureQueries(data, result);
+
+        if (m_options.frames > 0) {
+            offscreen.makeCurrent();
+            Mesh* gpuMesh = new Mesh();
+            if (gpuMesh->upload(data)) {
+                offscreen.getRenderer()->setRenderMode(mesh ? Renderer::Solid : Renderer::Points);
+                offscreen.getCamera()->applyPreset("iso", (data.boundingBoxMin + data.boundingBoxMax) * 0.5f,
+                                                   data.boundingRadius);
+                for (int frame = 0; frame < WarmupFrames; ++frame) {
+                    offscreen.draw(gpuMesh);
+                }
+                QElapsedTimer timer;
+                timer.start();
+                for (int frame = 0; frame < m_options.frames; ++frame) {
+                    offscreen.draw(gpuMesh);
+                }
+                result.frameMs = timer.nsecsElapsed() / 1.0e6 / m_options.frames;
+            }
+            delete gpuMesh;
+            offscreen.doneCurrent();
+        }
+
+        results.append(result);
+        qInfo().noquote() << "Measured" << SpatialOrder::getCurveName(curve) << "order";
+    }
+
+    printResults(results, mesh);
+    return 0;
+}
+
+void OrderBenchmark::measureQueries(const MeshData& data, Result& result) const
+{
+    const QVector<VertexData>& vertices = data.vertices;
+    const int count = vertices.size();
+    const float queryRadius = data.boundingRadius * QueryScale;
+
+    // k-최근접 이웃: 정점 순서대로 질의하므로 연속한 질의가 같은 노드를 다시 읽는지가 드러남
+    KdTree tree;
+    result.kdBuildMs = bestOf(m_options.repeats, [&]() { tree.build(vertices); });
+    QVector<int> nearest(count);
+    int* nearestData = nearest.data();
+    result.nearestMs = bestOf(m_options.repeats, [&]() {
+        Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            int neighbors[NearestCount];
+            float distances[NearestCount];
+            for (qsizetype i = begin; i < end; ++i) {
+                const int found = tree.findNearest(vertices[i].position, NearestCount, neighbors, distances);
+                nearestData[i] = found > 0 ? neighbors[found - 1] : -1;
+            }
+        });
+    });
+
+    VoxelGrid grid;
+    result.voxelMs = bestOf(m_options.repeats, [&]() { grid.build(vertices, queryRadius); });
+
+    if (data.indices.isEmpty()) return;
+
+    // 정점마다 최근접 표면점 (스냅 질의와 같은 경로)
+    Bvh bvh;
+    result.bvhBuildMs = bestOf(m_options.repeats, [&]() { bvh.build(vertices, data.indices); });
+    QVector<float> distances(count);
+    float* distanceData = distances.data();
+    result.closestMs = bestOf(m_options.repeats, [&]() {
+        Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype i = begin; i < end; ++i) {
+                BvhClosestPoint closest;
+                bvh.closestPoint(vertices[i].position, closest, queryRadius);
+                distanceData[i] = closest.distance;
+            }
+        });
+    });
+
+    // 면 → 정점 흩어 쓰기 (인덱스가 가리키는 정점이 가까울수록 유리)
+    QVector<VertexData> normals;
+    result.normalsMs = bestOf(m_options.repeats, [&]() {
+        normals = vertices;
+        normals.detach();
+    }, [&]() {
+        MeshOperators::computeNormals(normals, data.indices);
+    });
+}
+
+void OrderBenchmark::printResults(const QVector<Result>& results, bool mesh)
+{
+    QString header = QString("%1").arg("order", -8) + QString("%1%2%3%4")
+                         .arg("reorder", 10).arg("kd build", 10).arg(QString("knn %1").arg(NearestCount), 10).arg("voxel", 10);
+    if (mesh) {
+        header += QString("%1%2%3").arg("bvh build", 10).arg("closest", 10).arg("normals", 10);
+    }
+    header += QString("%1").arg("frame", 10);
+    qInfo().noquote() << header << "(ms)";
+
+    for (const Result& result : results) {
+        QString line = QString("%1").arg(SpatialOrder::getCurveName(result.curve), -8)
+                       + formatMs(result.reorderMs) + formatMs(result.kdBuildMs)
+                       + formatMs(result.nearestMs) + formatMs(result.voxelMs);
+        if (mesh) {
+            line += formatMs(result.bvhBuildMs) + formatMs(result.closestMs) + formatMs(result.normalsMs);
+        }
+        line += formatMs(result.frameMs);
+        qInfo().noquote() << line;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef ORDERBENCHMARK_H
+#define ORDERBENCHMARK_H
+
+#include <QString>
+#include <QSize>
+#include <QVector>
+#include "SpatialOrder.h"
+
+// 정점 순서(파일/Morton/Hilbert)에 따른 공간 질의와 렌더링 시간 비교
+// 파일 하나를 한 번 로드한 뒤 순서마다 같은 작업을 정점 순서대로 실행하고 표로 출력
+class OrderBenchmark
+{
+public:
+    struct Options {
+        QString input;
+        QSize size = QSize(1024, 768);     // 렌더링 프레임 크기
+        int frames = 100;                   // 순서마다 그릴 프레임 수 (0이면 렌더링 생략)
+        int repeats = 3;                    // CPU 측정은 가장 빠른 회차를 씀
+    };
+
+    explicit OrderBenchmark(const Options& options);
+
+    // 종료 코드 반환 (0: 성공)
+    int run();
+
+private:
+    // 순서 하나의 측정값 (ms, 해당 없으면 음수)
+    struct Result {
+        SpatialOrder::Curve curve;
+        double reorderMs = -1.0;
+        double kdBuildMs = -1.0;
+        double nearestMs = -1.0;
+        double voxelMs = -1.0;
+        double bvhBuildMs = -1.0;
+        double closestMs = -1.0;
+        double normalsMs = -1.0;
+        double frameMs = -1.0;
+    };
+
+    Options m_options;
+
+    void measureQueries(const MeshData& data, Result& result) const;
+    static void printResults(const QVector<Result>& results, bool mesh);
+};
+
+#endif // ORDERBENCHMARK_H
@@ -0,0 +1,132 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <QThreadPool>
+#include <QFuture>
+#include <QVector>
+#include <QtConcurrent>
+#include <atomic>
+
+// 전역 스레드 풀을 이용한 간단한 데이터 병렬 루프
+// 호출 스레드가 첫 조각을 직접 처리하고, 작업 스레드 안에서 중첩 호출해도
+// 아직 시작되지 않은 조각은 기다리는 스레드가 가져가 실행하므로 교착되지 않음
+namespace Parallel {
+
+// count개 항목을 grainSize 이상씩 나눌 때의 조각 수 (조각별 누적 버퍼 크기용)
+inline int chunkCount(qsizetype count, qsizetype grainSize)
+{
+    if (count <= 0) return 0;
+    const qsizetype grain = qMax<qsizetype>(grainSize, 1);
+    const qsizetype maxChunks = qsizetype(qMax(1, QThreadPool::globalInstance()->maxThreadCount())) * 4;
+    return int(qBound<qsizetype>(1, (count + grain - 1) / grain, maxChunks));
+}
+
+// function(chunk, begin, end): 조각 번호(0..chunkCount-1)와 [begin, end) 범위
+template <typename Function>
+void forEachChunk(qsizetype count, qsizetype grainSize, Function function)
+{
+    const int chunks = chunkCount(count, grainSize);
+    if (chunks == 0) return;
+    if (chunks == 1) {
+        function(0, qsizetype(0), count);
+        return;
+    }
+
+    auto boundary = [count, chunks](int chunk) { return count * chunk / chunks; };
+
+    QVector<QFuture<void>> futures;
+    futures.reserve(chunks - 1);
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        futures.append(QtConcurrent::run(QThreadPool::globalInstance(), [&function, &boundary, chunk]() {
+            function(chunk, boundary(chunk), boundary(chunk + 1));
+        }));
+    }
+    function(0, qsizetype(0), boundary(1));
+
+    for (QFuture<void>& future : futures) {
+        future.waitForFinished();
+    }
+}
+
+// function(begin, end): [begin, end) 범위 처리
+template <typename Function>
+void parallelFor(qsizetype count, qsizetype grainSize, Function function)
+{
+    forEachChunk(count, grainSize, [&function](int, qsizetype begin, qsizetype end) {
+        function(begin, end);
+    });
+}
+
+// keys를 오름차순으로 안정 정렬하며 values도 같이 옮김 (키는 keyBits 이하의 부호 없는 정수)
+// 11비트 자리마다 조각별 개수 → (자리 값, 조각) 순서 누적 → 같은 조각 경계로 분배하는 LSD 기수 정렬이라
+// 비용은 원소 수에 비례하고 결과는 스레드 수와 관계없음. 모든 키가 같은 값을 갖는 자리는 건너뜀
+// cancel이 설정되면 중단하고 false (keys/values 순서는 정해지지 않음)
+template <typename Key>
+bool sortByKey(QVector<Key>& keys, QVector<int>& values, int keyBits, qsizetype grainSize,
+               const std::atomic_bool* cancel = nullptr)
+{
+    const int digitBits = 11;
+    const int digitCount = 1 << digitBits;
+    const qsizetype count = keys.size();
+    const int chunks = chunkCount(count, grainSize);
+    if (chunks == 0) return true;
+
+    // 이미 정렬되어 있으면 (파일에 성분/셀 순서로 저장된 경우 등) 옮기지 않음
+    QVector<int> chunkSorted(chunks, 0);
+    const Key* keyData = keys.constData();
+    forEachChunk(count, grainSize, [&](int chunk, qsizetype begin, qsizetype end) {
+        qsizetype i = qMax<qsizetype>(begin, 1);
+        while (i < end && keyData[i - 1] <= keyData[i]) ++i;
+        chunkSorted[chunk] = i >= end;
+    });
+    if (!chunkSorted.contains(0)) return true;
+
+    QVector<Key> keyBuffer(count);
+    QVector<int> valueBuffer(count);
+    QVector<int> histograms(chunks * digitCount);
+    for (int shift = 0; shift < keyBits; shift += digitBits) {
+        histograms.fill(0);
+        const Key* sourceKeys = keys.constData();
+        const int* sourceValues = values.constData();
+        forEachChunk(count, grainSize, [&](int chunk, qsizetype begin, qsizetype end) {
+            int* histogram = histograms.data() + chunk * digitCount;
+            for (qsizetype i = begin; i < end; ++i) {
+                ++histogram[(sourceKeys[i] >> shift) & (digitCount - 1)];
+            }
+        });
+
+        int offset = 0;
+        bool trivial = false;
+        for (int digit = 0; digit < digitCount && !trivial; ++digit) {
+            int digitTotal = 0;
+            for (int chunk = 0; chunk < chunks; ++chunk) {
+                int& slot = histograms[chunk * digitCount + digit];
+                const int n = slot;
+                slot = offset;
+                offset += n;
+                digitTotal += n;
+            }
+            trivial = digitTotal == count;
+        }
+        if (trivial) continue;
+
+        Key* targetKeys = keyBuffer.data();
+        int* targetValues = valueBuffer.data();
+        forEachChunk(count, grainSize, [&](int chunk, qsizetype begin, qsizetype end) {
+            int* cursor = histograms.data() + chunk * digitCount;
+            for (qsizetype i = begin; i < end; ++i) {
+                const int slot = cursor[(sourceKeys[i] >> shift) & (digitCount - 1)]++;
+                targetKeys[slot] = sourceKeys[i];
+                targetValues[slot] = sourceValues[i];
+            }
+        });
+        keys.swap(keyBuffer);
+        values.swap(valueBuffer);
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+    }
+    return true;
+}
+
+} // namespace Parallel
+
+#endif // PARALLEL_H
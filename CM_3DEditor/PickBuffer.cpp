@@ -0,0 +1,175 @@
+#include "PickBuffer.h"
+#include <QOpenGLContext>
+#include <QDebug>
+#include <climits>
+
+PickBuffer::PickBuffer()
+    : m_framebuffer(0)
+    , m_idTexture(0)
+    , m_depthRenderbuffer(0)
+    , m_previousFramebuffer(0)
+    , m_nextSlot(0)
+    , m_oldestSlot(0)
+{
+}
+
+PickBuffer::~PickBuffer()
+{
+    destroy();
+}
+
+bool PickBuffer::create()
+{
+    if (isCreated()) return true;
+    if (!QOpenGLContext::currentContext()) return false;
+
+    initializeOpenGLFunctions();
+
+    // 오브젝트 ID, 프리미티브 번호
+    glGenTextures(1, &m_idTexture);
+    glBindTexture(GL_TEXTURE_2D, m_idTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, RegionSize, RegionSize, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenRenderbuffers(1, &m_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, RegionSize, RegionSize);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_idTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, GLuint(previousFramebuffer));
+
+    if (!complete) {
+        qDebug() << "Pick framebuffer is incomplete; picking disabled";
+        destroy();
+        return false;
+    }
+
+    const GLsizeiptr slotSize = RegionSize * RegionSize * 2 * sizeof(GLuint);
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        glGenBuffers(1, &m_slots[i].buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_slots[i].buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, slotSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return true;
+}
+
+void PickBuffer::destroy()
+{
+    if (QOpenGLContext::currentContext()) {
+        for (int i = 0; i < ReadbackSlots; ++i) {
+            if (m_slots[i].fence) glDeleteSync(m_slots[i].fence);
+            if (m_slots[i].buffer) glDeleteBuffers(1, &m_slots[i].buffer);
+        }
+        if (m_framebuffer) glDeleteFramebuffers(1, &m_framebuffer);
+        if (m_idTexture) glDeleteTextures(1, &m_idTexture);
+        if (m_depthRenderbuffer) glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+    }
+
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        m_slots[i] = ReadbackSlot();
+    }
+    m_framebuffer = 0;
+    m_idTexture = 0;
+    m_depthRenderbuffer = 0;
+    m_nextSlot = 0;
+    m_oldestSlot = 0;
+}
+
+bool PickBuffer::canBegin() const
+{
+    return isCreated() && !m_slots[m_nextSlot].pending;
+}
+
+bool PickBuffer::hasPending() const
+{
+    return m_slots[m_oldestSlot].pending;
+}
+
+void PickBuffer::begin()
+{
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, RegionSize, RegionSize);
+
+    const GLuint clearId[4] = { 0, 0, 0, 0 };
+    const GLfloat clearDepth = 1.0f;
+    glClearBufferuiv(GL_COLOR, 0, clearId);
+    glClearBufferfv(GL_DEPTH, 0, &clearDepth);
+}
+
+void PickBuffer::end(const PickResult& request)
+{
+    ReadbackSlot& slot = m_slots[m_nextSlot];
+
+    // 25픽셀만 복사하므로 드라이버가 바로 반환 (맵은 fence 이후에)
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, RegionSize, RegionSize, GL_RG_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.pending = true;
+    slot.request = request;
+    m_nextSlot = (m_nextSlot + 1) % ReadbackSlots;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, GLuint(m_previousFramebuffer));
+}
+
+bool PickBuffer::poll(PickResult& result)
+{
+    ReadbackSlot& slot = m_slots[m_oldestSlot];
+    if (!slot.pending) return false;
+
+    // 준비되지 않았으면 기다리지 않음
+    if (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    slot.pending = false;
+    m_oldestSlot = (m_oldestSlot + 1) % ReadbackSlots;
+
+    result = slot.request;
+    result.type = PickResult::None;
+    result.objectId = 0;
+    result.primitive = 0;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const GLuint* ids = static_cast<const GLuint*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, RegionSize * RegionSize * 2 * sizeof(GLuint), GL_MAP_READ_BIT));
+    if (ids) {
+        // 커서(영역 중심)에 가장 가까운 유효 픽셀 선택 (가는 선/작은 점도 잡히도록)
+        const int center = RegionSize / 2;
+        int bestDistance = INT_MAX;
+        for (int y = 0; y < RegionSize; ++y) {
+            for (int x = 0; x < RegionSize; ++x) {
+                const GLuint* id = ids + (y * RegionSize + x) * 2;
+                int distance = (x - center) * (x - center) + (y - center) * (y - center);
+                if (id[0] != 0 && distance < bestDistance) {
+                    bestDistance = distance;
+                    result.objectId = id[0];
+                    result.primitive = id[1];
+                    result.type = slot.request.type;
+                }
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return true;
+}
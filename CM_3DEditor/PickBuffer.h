@@ -0,0 +1,74 @@
+#ifndef PICKBUFFER_H
+#define PICKBUFFER_H
+
+#include <QOpenGLExtraFunctions>
+#include <QPoint>
+
+// 픽킹 결과 (오브젝트 ID 0은 배경)
+struct PickResult {
+    enum Type {
+        None,
+        Face,           // primitive = 삼각형 번호 (메시 인덱스 버퍼 순서)
+        Point           // primitive = 정점 번호
+    };
+
+    Type type = None;
+    quint32 objectId = 0;
+    quint32 primitive = 0;
+    QPoint position;            // 요청한 커서 위치
+    int tag = 0;                // 요청 구분 (호버/클릭 등, 호출자가 정의)
+    int meshRevision = -1;      // 픽킹 시점의 Mesh::getRevision()
+
+    bool isValid() const { return type != None; }
+    bool isSameTarget(const PickResult& other) const {
+        return type == other.type && objectId == other.objectId && primitive == other.primitive;
+    }
+};
+
+// 정수 ID 첨부 버퍼 기반 GPU 픽킹
+// 커서 주변 RegionSize² 픽셀만 그리는 작은 RG32UI(오브젝트, 프리미티브) 프레임버퍼와,
+// 결과를 대기 없이 가져오기 위한 PBO + fence 링으로 구성. 결과는 1~2 프레임 뒤 poll()로 얻음
+class PickBuffer : protected QOpenGLExtraFunctions
+{
+public:
+    static constexpr int RegionSize = 5;
+    static constexpr int ReadbackSlots = 3;
+
+    PickBuffer();
+    ~PickBuffer();
+
+    bool create();
+    void destroy();
+    bool isCreated() const { return m_framebuffer != 0; }
+
+    // 비어 있는 readback 슬롯이 있어야 새 요청 가능 (없으면 요청을 미뤄 합침)
+    bool canBegin() const;
+    bool hasPending() const;
+
+    // 픽 영역 프레임버퍼 바인딩 후 지움 (이전 프레임버퍼 바인딩은 end에서 복원)
+    void begin();
+
+    // 영역을 PBO로 비동기 복사하고 fence 설정
+    void end(const PickResult& request);
+
+    // 끝난 readback을 제출 순서대로 회수 (대기 없음). 결과가 있으면 true
+    bool poll(PickResult& result);
+
+private:
+    struct ReadbackSlot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        bool pending = false;
+        PickResult request;
+    };
+
+    GLuint m_framebuffer;
+    GLuint m_idTexture;
+    GLuint m_depthRenderbuffer;
+    GLint m_previousFramebuffer;
+    ReadbackSlot m_slots[ReadbackSlots];
+    int m_nextSlot;     // 다음에 쓸 슬롯
+    int m_oldestSlot;   // 가장 오래된 대기 슬롯
+};
+
+#endif // PICKBUFFER_H
@@ -0,0 +1,155 @@
+#include "PrimitiveBenchmark.h"
+#include "MeshOperators.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QDebug>
+#include <cmath>
+#include <random>
+
+namespace {
+    // 합성 방 크기 (x, y, z)와 기둥/구
+    const QVector3D RoomSize(10.0f, 8.0f, 3.0f);
+    const QVector3D ColumnBase(3.0f, 4.0f, 0.0f);
+    const float ColumnRadius = 0.3f;
+    const QVector3D SphereCenter(7.0f, 4.0f, 1.0f);
+    const float SphereRadius = 0.5f;
+
+    // 스캔 잡음 (표면 법선 방향 균등 분포)
+    const float RoomNoise = 0.002f;
+
+    const float Pi = 3.14159265f;
+}
+
+PrimitiveBenchmark::PrimitiveBenchmark(const Options& options)
+    : m_options(options)
+{
+}
+
+int PrimitiveBenchmark::run()
+{
+    MeshData data;
+    if (m_options.input.startsWith("room:")) {
+        const int pointCount = m_options.input.mid(5).toInt();
+        if (pointCount <= 0) {
+            qWarning() << "Invalid synthetic room:" << m_options.input;
+            return 2;
+        }
+        generateRoom(pointCount, data);
+    } else if (!Mesh::loadData(m_options.input, data)) {
+        qWarning() << "Cannot load" << m_options.input;
+        return 1;
+    }
+    qInfo().noquote() << QString("%1: %2 points, %3 threads")
+                             .arg(QFileInfo(m_options.input).fileName())
+                             .arg(data.vertices.size())
+                             .arg(QThreadPool::globalInstance()->maxThreadCount());
+
+    // 검출과 같은 조건 (법선이 없으면 먼저 추정, 측정에서 제외)
+    if (!MeshOperators::hasNormals(data.vertices)) {
+        QElapsedTimer timer;
+        timer.start();
+        if (!MeshOperators::estimatePointNormals(data.vertices, MeshOperators::DefaultNormalNeighbors)) {
+            qWarning() << "Cannot estimate normals";
+            return 1;
+        }
+        qInfo().noquote() << QString("Estimated normals in %1 ms (not included)").arg(timer.elapsed());
+    }
+
+    // 메뉴 기본값과 같은 설정으로 세 도형 모두
+    PrimitiveSettings settings;
+    settings.epsilon = data.boundingRadius * m_options.epsilon;
+    settings.minPoints = qBound(3, int(data.vertices.size() / 200), 100000);
+
+    PrimitiveDetector detector;
+    double best = -1.0;
+    for (int r = 0; r < qMax(1, m_options.repeats); ++r) {
+        QElapsedTimer timer;
+        timer.start();
+        if (!detector.detect(data.vertices, settings)) {
+            qWarning() << "Detection failed";
+            return 1;
+        }
+        const double ms = timer.nsecsElapsed() / 1.0e6;
+        if (best < 0.0 || ms < best) best = ms;
+    }
+
+    int counts[3] = { 0, 0, 0 };
+    int labeled = 0;
+    for (const DetectedPrimitive& primitive : detector.getPrimitives()) {
+        ++counts[primitive.type];
+        labeled += primitive.pointCount;
+    }
+    qInfo().noquote() << QString("%1 planes, %2 spheres, %3 cylinders (%4 of %5 points) in %6 ms (best of %7)")
+                             .arg(counts[DetectedPrimitive::Plane])
+                             .arg(counts[DetectedPrimitive::Sphere])
+                             .arg(counts[DetectedPrimitive::Cylinder])
+                             .arg(labeled)
+                             .arg(data.vertices.size())
+                             .arg(best, 0, 'f', 1)
+                             .arg(qMax(1, m_options.repeats));
+    return 0;
+}
+
+void PrimitiveBenchmark::generateRoom(int pointCount, MeshData& data)
+{
+    // 표면마다 넓이에 비례해 점을 뿌림 (바닥, 천장, 벽 4개, 기둥 옆면, 구)
+    const float x = RoomSize.x();
+    const float y = RoomSize.y();
+    const float z = RoomSize.z();
+    const float areas[8] = { x * y, x * y, x * z, x * z, y * z, y * z,
+                             2.0f * Pi * ColumnRadius * z, 4.0f * Pi * SphereRadius * SphereRadius };
+    float totalArea = 0.0f;
+    for (float area : areas) totalArea += area;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> noise(-RoomNoise, RoomNoise);
+
+    data = MeshData();
+    data.vertices.resize(pointCount);
+    for (int i = 0; i < pointCount; ++i) {
+        float pick = unit(random) * totalArea;
+        int surface = 0;
+        while (surface < 7 && pick >= areas[surface]) {
+            pick -= areas[surface];
+            ++surface;
+        }
+
+        const float u = unit(random);
+        const float v = unit(random);
+        QVector3D position;
+        QVector3D normal;
+        switch (surface) {
+            case 0: position = QVector3D(u * x, v * y, 0.0f); normal = QVector3D(0, 0, 1); break;
+            case 1: position = QVector3D(u * x, v * y, z); normal = QVector3D(0, 0, -1); break;
+            case 2: position = QVector3D(u * x, 0.0f, v * z); normal = QVector3D(0, 1, 0); break;
+            case 3: position = QVector3D(u * x, y, v * z); normal = QVector3D(0, -1, 0); break;
+            case 4: position = QVector3D(0.0f, u * y, v * z); normal = QVector3D(1, 0, 0); break;
+            case 5: position = QVector3D(x, u * y, v * z); normal = QVector3D(-1, 0, 0); break;
+            case 6: {
+                const float angle = u * 2.0f * Pi;
+                normal = QVector3D(std::cos(angle), std::sin(angle), 0.0f);
+                position = ColumnBase + normal * ColumnRadius + QVector3D(0.0f, 0.0f, v * z);
+                break;
+            }
+            default: {
+                // 구면 균등 분포 (높이 균등 + 경도 균등)
+                const float height = 2.0f * u - 1.0f;
+                const float ring = std::sqrt(qMax(0.0f, 1.0f - height * height));
+                const float angle = v * 2.0f * Pi;
+                normal = QVector3D(ring * std::cos(angle), ring * std::sin(angle), height);
+                position = SphereCenter + normal * SphereRadius;
+                break;
+            }
+        }
+
+        VertexData& vertex = data.vertices[i];
+        vertex.position = position + normal * noise(random);
+        vertex.normal = normal;
+        vertex.color = QVector3D(0.7f, 0.7f, 0.7f);
+    }
+
+    // 면이 없으므로 경계만 계산됨
+    Mesh::completeData(data);
+}
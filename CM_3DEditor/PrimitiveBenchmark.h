@@ -0,0 +1,31 @@
+#ifndef PRIMITIVEBENCHMARK_H
+#define PRIMITIVEBENCHMARK_H
+
+#include <QString>
+#include "PrimitiveDetector.h"
+
+// 기본 도형 검출 시간 측정
+// PLY 파일 또는 합성 방(room:<점 수>, 벽/바닥/천장 평면 6개 + 기둥 + 구)을 한 번 준비한 뒤 검출을 반복해
+// 가장 빠른 회차와 찾은 도형 수를 출력
+class PrimitiveBenchmark
+{
+public:
+    struct Options {
+        QString input;                  // PLY 파일 또는 room:<점 수>
+        float epsilon = 0.005f;         // 모델 반지름 비율 (메뉴 기본값과 같음)
+        int repeats = 3;
+    };
+
+    explicit PrimitiveBenchmark(const Options& options);
+
+    // 종료 코드 반환 (0: 성공)
+    int run();
+
+private:
+    Options m_options;
+
+    // 합성 방의 점군 (법선 포함, 같은 점 수면 항상 같은 점)
+    static void generateRoom(int pointCount, MeshData& data);
+};
+
+#endif // PRIMITIVEBENCHMARK_H
@@ -0,0 +1,894 @@
+#include "PrimitiveDetector.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QColor>
+#include <QtAlgorithms>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PRIMITIVE_USE_SSE
+#endif
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 14;
+
+    // 표본 색인의 Morton 코드: 축마다 10비트 (깊이 10까지의 팔진 셀)
+    const int SampleAxisBits = 10;
+    const int SampleCodeBits = SampleAxisBits * 3;
+
+    // 연결 검사 격자의 셀 좌표 비트
+    const int ClusterAxisBits = 21;
+
+    // 한 번에 병렬로 만드는 표본 수와 스레드 하나가 맡는 표본 수 (표본마다 후보 최대 3개를 채점)
+    const int HypothesesPerRound = 256;
+    const int HypothesisGrain = 8;
+
+    // 도형 하나를 뽑기까지 만드는 최대 표본 수
+    const int MaxHypotheses = 1 << 15;
+
+    // 후보 점 수를 추정하는 부분 집합 크기와, 상위 후보를 다시 채점하는 더 큰 부분 집합 크기
+    const int ScoreSubset = 8192;
+    const int RefineSubset = ScoreSubset * 16;
+    const int RefineCandidates = 4;
+
+    // 가장 좋은 후보들이 모두 조각나 버려지는 일이 연달아 이만큼 생기면 끝냄
+    const int MaxRejections = 4;
+
+    // 이미 뽑힌 점을 고르면 다시 고르는 횟수
+    const int SampleTries = 8;
+
+    // clusterSpacing을 주지 않았을 때 epsilon의 배수
+    const float ClusterScale = 4.0f;
+
+    // splitmix64
+    inline quint64 mixBits(quint64 x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    struct Random {
+        quint64 state;
+
+        explicit Random(quint64 seed) : state(seed) {}
+        quint32 next() { state = mixBits(state); return quint32(state >> 32); }
+        int below(int n) { return int(quint64(next()) * quint64(n) >> 32); }
+    };
+
+    // 10비트를 3칸 간격으로 벌림 (비트 i → 3i)
+    inline quint32 spreadBits(quint32 value)
+    {
+        quint32 x = value & 0x3ff;
+        x = (x | x << 16) & 0x030000ff;
+        x = (x | x << 8) & 0x0300f00f;
+        x = (x | x << 4) & 0x030c30c3;
+        x = (x | x << 2) & 0x09249249;
+        return x;
+    }
+
+    // 뒤섞은 순서의 점 (SoA). 무작위 순서라 앞부분이 곧 무작위 부분 집합이 됨
+    // 뽑힌 점은 법선을 0으로 만들어 어떤 후보의 인라이어도 되지 않게 하고, 절반 이상이 뽑히면 압축함
+    struct PointArrays {
+        QVector<float> x, y, z;
+        QVector<float> nx, ny, nz;
+        QVector<int> ids;       // 원래 정점 번호
+
+        int size() const { return ids.size(); }
+        bool isLive(int i) const { return nx[i] != 0.0f || ny[i] != 0.0f || nz[i] != 0.0f; }
+
+        void resize(int count)
+        {
+            x.resize(count);
+            y.resize(count);
+            z.resize(count);
+            nx.resize(count);
+            ny.resize(count);
+            nz.resize(count);
+            ids.resize(count);
+        }
+    };
+
+    struct Candidate {
+        DetectedPrimitive::Type type = DetectedPrimitive::Plane;
+        QVector3D point;
+        QVector3D direction;
+        float radius = 0.0f;
+        int score = -1;         // 채점한 부분 집합의 인라이어 수 (-1이면 후보 없음)
+    };
+
+    // 인라이어 판정: 표면까지 거리 < epsilon이고 |점 법선 · 표면 법선| >= cos(각도)
+    // 구/원기둥은 나눗셈 없이 |v · n| >= cos · |v|로 비교하고, 법선이 0인 점은 항상 탈락
+    struct PlaneTest {
+        float a, b, c, d, epsilon, cosAngle;
+#ifdef PRIMITIVE_USE_SSE
+        __m128 va, vb, vc, vd, vEpsilon, vCos;
+#endif
+
+        PlaneTest(const Candidate& candidate, float eps, float cosine)
+            : a(candidate.direction.x()), b(candidate.direction.y()), c(candidate.direction.z())
+            , d(QVector3D::dotProduct(candidate.direction, candidate.point)), epsilon(eps), cosAngle(cosine)
+        {
+#ifdef PRIMITIVE_USE_SSE
+            va = _mm_set1_ps(a);
+            vb = _mm_set1_ps(b);
+            vc = _mm_set1_ps(c);
+            vd = _mm_set1_ps(d);
+            vEpsilon = _mm_set1_ps(epsilon);
+            vCos = _mm_set1_ps(cosAngle);
+#endif
+        }
+
+        bool test(float x, float y, float z, float nx, float ny, float nz) const
+        {
+            return std::fabs(a * x + b * y + c * z - d) < epsilon && std::fabs(a * nx + b * ny + c * nz) >= cosAngle;
+        }
+
+#ifdef PRIMITIVE_USE_SSE
+        __m128 test(__m128 x, __m128 y, __m128 z, __m128 nx, __m128 ny, __m128 nz) const
+        {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            const __m128 distance = _mm_and_ps(_mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(va, x), _mm_mul_ps(vb, y)),
+                                                                     _mm_mul_ps(vc, z)), vd), absMask);
+            const __m128 alignment = _mm_and_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(va, nx), _mm_mul_ps(vb, ny)),
+                                                           _mm_mul_ps(vc, nz)), absMask);
+            return _mm_and_ps(_mm_cmplt_ps(distance, vEpsilon), _mm_cmpge_ps(alignment, vCos));
+        }
+#endif
+    };
+
+    struct SphereTest {
+        float cx, cy, cz, radius, epsilon, cosAngle;
+#ifdef PRIMITIVE_USE_SSE
+        __m128 vcx, vcy, vcz, vRadius, vEpsilon, vCos;
+#endif
+
+        SphereTest(const Candidate& candidate, float eps, float cosine)
+            : cx(candidate.point.x()), cy(candidate.point.y()), cz(candidate.point.z())
+            , radius(candidate.radius), epsilon(eps), cosAngle(cosine)
+        {
+#ifdef PRIMITIVE_USE_SSE
+            vcx = _mm_set1_ps(cx);
+            vcy = _mm_set1_ps(cy);
+            vcz = _mm_set1_ps(cz);
+            vRadius = _mm_set1_ps(radius);
+            vEpsilon = _mm_set1_ps(epsilon);
+            vCos = _mm_set1_ps(cosAngle);
+#endif
+        }
+
+        bool test(float x, float y, float z, float nx, float ny, float nz) const
+        {
+            const float vx = x - cx, vy = y - cy, vz = z - cz;
+            const float length = std::sqrt(vx * vx + vy * vy + vz * vz);
+            return std::fabs(length - radius) < epsilon && std::fabs(vx * nx + vy * ny + vz * nz) >= cosAngle * length;
+        }
+
+#ifdef PRIMITIVE_USE_SSE
+        __m128 test(__m128 x, __m128 y, __m128 z, __m128 nx, __m128 ny, __m128 nz) const
+        {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            const __m128 vx = _mm_sub_ps(x, vcx), vy = _mm_sub_ps(y, vcy), vz = _mm_sub_ps(z, vcz);
+            const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)),
+                                                         _mm_mul_ps(vz, vz)));
+            const __m128 distance = _mm_and_ps(_mm_sub_ps(length, vRadius), absMask);
+            const __m128 alignment = _mm_and_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, nx), _mm_mul_ps(vy, ny)),
+                                                           _mm_mul_ps(vz, nz)), absMask);
+            return _mm_and_ps(_mm_cmplt_ps(distance, vEpsilon), _mm_cmpge_ps(alignment, _mm_mul_ps(vCos, length)));
+        }
+#endif
+    };
+
+    struct CylinderTest {
+        float cx, cy, cz, ax, ay, az, radius, epsilon, cosAngle;
+#ifdef PRIMITIVE_USE_SSE
+        __m128 vcx, vcy, vcz, vax, vay, vaz, vRadius, vEpsilon, vCos;
+#endif
+
+        CylinderTest(const Candidate& candidate, float eps, float cosine)
+            : cx(candidate.point.x()), cy(candidate.point.y()), cz(candidate.point.z())
+            , ax(candidate.direction.x()), ay(candidate.direction.y()), az(candidate.direction.z())
+            , radius(candidate.radius), epsilon(eps), cosAngle(cosine)
+        {
+#ifdef PRIMITIVE_USE_SSE
+            vcx = _mm_set1_ps(cx);
+            vcy = _mm_set1_ps(cy);
+            vcz = _mm_set1_ps(cz);
+            vax = _mm_set1_ps(ax);
+            vay = _mm_set1_ps(ay);
+            vaz = _mm_set1_ps(az);
+            vRadius = _mm_set1_ps(radius);
+            vEpsilon = _mm_set1_ps(epsilon);
+            vCos = _mm_set1_ps(cosAngle);
+#endif
+        }
+
+        // 축에 수직인 성분 w = v - (v·a)a의 길이가 반지름, w · n = v · n - (v·a)(a·n)
+        bool test(float x, float y, float z, float nx, float ny, float nz) const
+        {
+            const float vx = x - cx, vy = y - cy, vz = z - cz;
+            const float h = vx * ax + vy * ay + vz * az;
+            const float wx = vx - h * ax, wy = vy - h * ay, wz = vz - h * az;
+            const float length = std::sqrt(wx * wx + wy * wy + wz * wz);
+            return std::fabs(length - radius) < epsilon && std::fabs(wx * nx + wy * ny + wz * nz) >= cosAngle * length;
+        }
+
+#ifdef PRIMITIVE_USE_SSE
+        __m128 test(__m128 x, __m128 y, __m128 z, __m128 nx, __m128 ny, __m128 nz) const
+        {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            const __m128 vx = _mm_sub_ps(x, vcx), vy = _mm_sub_ps(y, vcy), vz = _mm_sub_ps(z, vcz);
+            const __m128 h = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vax), _mm_mul_ps(vy, vay)), _mm_mul_ps(vz, vaz));
+            const __m128 wx = _mm_sub_ps(vx, _mm_mul_ps(h, vax));
+            const __m128 wy = _mm_sub_ps(vy, _mm_mul_ps(h, vay));
+            const __m128 wz = _mm_sub_ps(vz, _mm_mul_ps(h, vaz));
+            const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, wx), _mm_mul_ps(wy, wy)),
+                                                         _mm_mul_ps(wz, wz)));
+            const __m128 distance = _mm_and_ps(_mm_sub_ps(length, vRadius), absMask);
+            const __m128 alignment = _mm_and_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, nx), _mm_mul_ps(wy, ny)),
+                                                           _mm_mul_ps(wz, nz)), absMask);
+            return _mm_and_ps(_mm_cmplt_ps(distance, vEpsilon), _mm_cmpge_ps(alignment, _mm_mul_ps(vCos, length)));
+        }
+#endif
+    };
+
+    // [begin, end)의 인라이어 수. flags가 있으면 점마다 인라이어면 1, 아니면 0을 씀
+    template<typename Test>
+    int countRange(const Test& test, const PointArrays& points, int begin, int end, quint8* flags)
+    {
+        const float* xs = points.x.constData();
+        const float* ys = points.y.constData();
+        const float* zs = points.z.constData();
+        const float* nxs = points.nx.constData();
+        const float* nys = points.ny.constData();
+        const float* nzs = points.nz.constData();
+
+        int count = 0;
+        int i = begin;
+#ifdef PRIMITIVE_USE_SSE
+        for (; i + 4 <= end; i += 4) {
+            const int mask = _mm_movemask_ps(test.test(_mm_loadu_ps(xs + i), _mm_loadu_ps(ys + i), _mm_loadu_ps(zs + i),
+                                                       _mm_loadu_ps(nxs + i), _mm_loadu_ps(nys + i), _mm_loadu_ps(nzs + i)));
+            count += qPopulationCount(quint32(mask));
+            if (flags) {
+                for (int lane = 0; lane < 4; ++lane) {
+                    flags[i + lane] = quint8((mask >> lane) & 1);
+                }
+            }
+        }
+#endif
+        for (; i < end; ++i) {
+            const bool inlier = test.test(xs[i], ys[i], zs[i], nxs[i], nys[i], nzs[i]);
+            count += inlier;
+            if (flags) flags[i] = quint8(inlier);
+        }
+        return count;
+    }
+
+    int countInliers(const Candidate& candidate, const PointArrays& points, int begin, int end,
+                     float epsilon, float cosAngle, quint8* flags = nullptr)
+    {
+        switch (candidate.type) {
+            case DetectedPrimitive::Sphere:
+                return countRange(SphereTest(candidate, epsilon, cosAngle), points, begin, end, flags);
+            case DetectedPrimitive::Cylinder:
+                return countRange(CylinderTest(candidate, epsilon, cosAngle), points, begin, end, flags);
+            case DetectedPrimitive::Plane:
+            default:
+                return countRange(PlaneTest(candidate, epsilon, cosAngle), points, begin, end, flags);
+        }
+    }
+
+    bool isInlier(const Candidate& candidate, const QVector3D& p, const QVector3D& n, float epsilon, float cosAngle)
+    {
+        switch (candidate.type) {
+            case DetectedPrimitive::Sphere:
+                return SphereTest(candidate, epsilon, cosAngle).test(p.x(), p.y(), p.z(), n.x(), n.y(), n.z());
+            case DetectedPrimitive::Cylinder:
+                return CylinderTest(candidate, epsilon, cosAngle).test(p.x(), p.y(), p.z(), n.x(), n.y(), n.z());
+            case DetectedPrimitive::Plane:
+            default:
+                return PlaneTest(candidate, epsilon, cosAngle).test(p.x(), p.y(), p.z(), n.x(), n.y(), n.z());
+        }
+    }
+
+    // 두 직선 p1 + t·d1, p2 + s·d2에서 가장 가까운 두 점의 중점 (거의 평행하면 false)
+    bool closestMidpoint(const QVector3D& p1, const QVector3D& d1, const QVector3D& p2, const QVector3D& d2,
+                         QVector3D& midpoint)
+    {
+        const QVector3D w = p1 - p2;
+        const float a = QVector3D::dotProduct(d1, d1);
+        const float b = QVector3D::dotProduct(d1, d2);
+        const float c = QVector3D::dotProduct(d2, d2);
+        const float d = QVector3D::dotProduct(d1, w);
+        const float e = QVector3D::dotProduct(d2, w);
+        const float denominator = a * c - b * b;
+        if (denominator < 1e-6f * a * c) return false;
+
+        const float t = (b * e - c * d) / denominator;
+        const float s = (a * e - b * d) / denominator;
+        midpoint = (p1 + t * d1 + p2 + s * d2) * 0.5f;
+        return true;
+    }
+
+    // 표본 세 점(법선은 단위 벡터)으로 후보를 만들고, 세 점이 모두 그 후보의 인라이어인지 확인
+    bool fitPlane(const QVector3D p[3], const QVector3D n[3], float epsilon, float cosAngle, Candidate& candidate)
+    {
+        const QVector3D normal = QVector3D::crossProduct(p[1] - p[0], p[2] - p[0]);
+        if (normal.lengthSquared() <= 0.0f) return false;
+        candidate.type = DetectedPrimitive::Plane;
+        candidate.point = p[0];
+        candidate.direction = normal.normalized();
+        candidate.radius = 0.0f;
+        for (int i = 0; i < 3; ++i) {
+            if (!isInlier(candidate, p[i], n[i], epsilon, cosAngle)) return false;
+        }
+        return true;
+    }
+
+    // 중심은 두 법선 직선이 가장 가까워지는 곳
+    bool fitSphere(const QVector3D p[3], const QVector3D n[3], float epsilon, float cosAngle, float maxRadius,
+                   Candidate& candidate)
+    {
+        QVector3D center;
+        if (!closestMidpoint(p[0], n[0], p[1], n[1], center)) return false;
+        const float radius = ((p[0] - center).length() + (p[1] - center).length()) * 0.5f;
+        if (radius < epsilon * 2.0f || radius > maxRadius) return false;
+        candidate.type = DetectedPrimitive::Sphere;
+        candidate.point = center;
+        candidate.direction = QVector3D();
+        candidate.radius = radius;
+        for (int i = 0; i < 3; ++i) {
+            if (!isInlier(candidate, p[i], n[i], epsilon, cosAngle)) return false;
+        }
+        return true;
+    }
+
+    // 축은 두 법선에 모두 수직이고, 축에 수직인 평면에 투영한 두 법선 직선의 교점이 축 위의 점
+    bool fitCylinder(const QVector3D p[3], const QVector3D n[3], float epsilon, float cosAngle, float maxRadius,
+                     Candidate& candidate)
+    {
+        const QVector3D cross = QVector3D::crossProduct(n[0], n[1]);
+        if (cross.lengthSquared() < 1e-6f) return false;
+        const QVector3D axis = cross.normalized();
+        const QVector3D q0 = p[0] - QVector3D::dotProduct(p[0], axis) * axis;
+        const QVector3D q1 = p[1] - QVector3D::dotProduct(p[1], axis) * axis;
+        QVector3D center;
+        if (!closestMidpoint(q0, n[0], q1, n[1], center)) return false;
+        const float radius = ((q0 - center).length() + (q1 - center).length()) * 0.5f;
+        if (radius < epsilon * 2.0f || radius > maxRadius) return false;
+        candidate.type = DetectedPrimitive::Cylinder;
+        candidate.point = center;
+        candidate.direction = axis;
+        candidate.radius = radius;
+        for (int i = 0; i < 3; ++i) {
+            if (!isInlier(candidate, p[i], n[i], epsilon, cosAngle)) return false;
+        }
+        return true;
+    }
+
+    // 법선이 0이 아닌 점만 남김 (조각별 개수 + 누적으로 순서 유지)
+    void compact(PointArrays& points)
+    {
+        const int count = points.size();
+        const int chunks = Parallel::chunkCount(count, ParallelGrain);
+        QVector<int> offsets(chunks + 1, 0);
+        Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+            int live = 0;
+            for (qsizetype i = begin; i < end; ++i) {
+                if (points.isLive(int(i))) ++live;
+            }
+            offsets[chunk + 1] = live;
+        });
+        for (int chunk = 0; chunk < chunks; ++chunk) {
+            offsets[chunk + 1] += offsets[chunk];
+        }
+
+        PointArrays compacted;
+        compacted.resize(offsets[chunks]);
+        const PointArrays& source = points;
+        float* xs = compacted.x.data();
+        float* ys = compacted.y.data();
+        float* zs = compacted.z.data();
+        float* nxs = compacted.nx.data();
+        float* nys = compacted.ny.data();
+        float* nzs = compacted.nz.data();
+        int* ids = compacted.ids.data();
+        Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+            int offset = offsets[chunk];
+            for (qsizetype i = begin; i < end; ++i) {
+                if (!source.isLive(int(i))) continue;
+                xs[offset] = source.x[i];
+                ys[offset] = source.y[i];
+                zs[offset] = source.z[i];
+                nxs[offset] = source.nx[i];
+                nys[offset] = source.ny[i];
+                nzs[offset] = source.nz[i];
+                ids[offset] = source.ids[i];
+                ++offset;
+            }
+        });
+        points = compacted;
+    }
+
+    int findRoot(QVector<int>& parents, int x)
+    {
+        while (parents[x] != x) {
+            parents[x] = parents[parents[x]];
+            x = parents[x];
+        }
+        return x;
+    }
+
+    // flags가 1인 점 중 한 변 spacing인 셀의 26-이웃으로 이어진 가장 큰 조각만 남기고 그 점 수 반환
+    // 점을 셀 키로 기수 정렬해 셀 목록을 만들고, 셀마다 앞쪽 13개 이웃만 찾아 합침
+    int keepLargestCluster(const PointArrays& points, QVector<quint8>& flags, const QVector3D& origin, float spacing,
+                           const std::atomic_bool* cancel)
+    {
+        const int count = points.size();
+        const int chunks = Parallel::chunkCount(count, ParallelGrain);
+        QVector<int> offsets(chunks + 1, 0);
+        quint8* flagData = flags.data();
+        Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+            int inliers = 0;
+            for (qsizetype i = begin; i < end; ++i) {
+                inliers += flagData[i];
+            }
+            offsets[chunk + 1] = inliers;
+        });
+        for (int chunk = 0; chunk < chunks; ++chunk) {
+            offsets[chunk + 1] += offsets[chunk];
+        }
+        const int inlierCount = offsets[chunks];
+        if (inlierCount == 0) return 0;
+
+        const float scale = 1.0f / spacing;
+        const float maxCell = float((1 << ClusterAxisBits) - 1);
+        QVector<quint64> keys(inlierCount);
+        QVector<int> members(inlierCount);
+        quint64* keyData = keys.data();
+        int* memberData = members.data();
+        Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+            int offset = offsets[chunk];
+            for (qsizetype i = begin; i < end; ++i) {
+                if (!flagData[i]) continue;
+                const quint64 x = quint64(qBound(0.0f, (points.x[i] - origin.x()) * scale, maxCell));
+                const quint64 y = quint64(qBound(0.0f, (points.y[i] - origin.y()) * scale, maxCell));
+                const quint64 z = quint64(qBound(0.0f, (points.z[i] - origin.z()) * scale, maxCell));
+                keyData[offset] = x << (ClusterAxisBits * 2) | y << ClusterAxisBits | z;
+                memberData[offset] = int(i);
+                ++offset;
+            }
+        });
+        if (!Parallel::sortByKey(keys, members, ClusterAxisBits * 3, ParallelGrain, cancel)) return 0;
+
+        // 셀 목록 (키 오름차순)과 셀 → 점 구간
+        QVector<quint64> cellKeys;
+        QVector<int> cellStarts;
+        for (int i = 0; i < inlierCount; ++i) {
+            if (i == 0 || keys[i] != keys[i - 1]) {
+                cellKeys.append(keys[i]);
+                cellStarts.append(i);
+            }
+        }
+        const int cellCount = cellKeys.size();
+        cellStarts.append(inlierCount);
+
+        // 앞쪽 이웃: 같은 줄의 z+1, 그리고 (y+1, x-1 줄의 y-1..y+1, x+1 줄의 y-1..y+1)의 z-1..z+1
+        // 키가 x, y, z 순으로 정렬되어 있으므로 줄마다 z-1 자리를 이분 탐색하고 3칸만 훑음
+        QVector<int> parents(cellCount);
+        for (int c = 0; c < cellCount; ++c) {
+            parents[c] = c;
+        }
+        const quint64 axisMask = (quint64(1) << ClusterAxisBits) - 1;
+        const int rowOffsets[4][2] = { { 0, 1 }, { 1, -1 }, { 1, 0 }, { 1, 1 } };
+        for (int c = 0; c < cellCount; ++c) {
+            const qint64 x = qint64(cellKeys[c] >> (ClusterAxisBits * 2));
+            const qint64 y = qint64((cellKeys[c] >> ClusterAxisBits) & axisMask);
+            const qint64 z = qint64(cellKeys[c] & axisMask);
+            if (c + 1 < cellCount && cellKeys[c + 1] == cellKeys[c] + 1 && z < qint64(axisMask)) {
+                const int a = findRoot(parents, c);
+                const int b = findRoot(parents, c + 1);
+                if (a != b) parents[qMax(a, b)] = qMin(a, b);
+            }
+            for (const auto& row : rowOffsets) {
+                const qint64 nx = x + row[0];
+                const qint64 ny = y + row[1];
+                if (nx > qint64(axisMask) || ny < 0 || ny > qint64(axisMask)) continue;
+                const quint64 rowKey = quint64(nx) << (ClusterAxisBits * 2) | quint64(ny) << ClusterAxisBits;
+                const quint64 first = rowKey | quint64(qMax<qint64>(0, z - 1));
+                const quint64 last = rowKey | quint64(qMin<qint64>(qint64(axisMask), z + 1));
+                auto it = std::lower_bound(cellKeys.constBegin() + c + 1, cellKeys.constEnd(), first);
+                for (; it != cellKeys.constEnd() && *it <= last; ++it) {
+                    const int a = findRoot(parents, c);
+                    const int b = findRoot(parents, int(it - cellKeys.constBegin()));
+                    if (a != b) parents[qMax(a, b)] = qMin(a, b);
+                }
+            }
+        }
+
+        // 조각별 점 수 → 가장 큰 조각 (같으면 앞 셀의 조각)
+        QVector<int> sizes(cellCount, 0);
+        for (int c = 0; c < cellCount; ++c) {
+            parents[c] = findRoot(parents, c);
+            sizes[parents[c]] += cellStarts[c + 1] - cellStarts[c];
+        }
+        const int largest = int(std::max_element(sizes.constBegin(), sizes.constEnd()) - sizes.constBegin());
+
+        const int* cellRoots = parents.constData();
+        const int* cellStartData = cellStarts.constData();
+        Parallel::parallelFor(cellCount, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype c = begin; c < end; ++c) {
+                if (cellRoots[c] == largest) continue;
+                for (int i = cellStartData[c]; i < cellStartData[c + 1]; ++i) {
+                    flagData[memberData[i]] = 0;
+                }
+            }
+        });
+        return sizes[largest];
+    }
+}
+
+PrimitiveDetector::PrimitiveDetector()
+{
+}
+
+void PrimitiveDetector::clear()
+{
+    m_primitives.clear();
+    m_labels.clear();
+}
+
+bool PrimitiveDetector::detect(const QVector<VertexData>& vertices, const PrimitiveSettings& settings,
+                               const std::atomic_bool* cancel, std::atomic_int* progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+    clear();
+    auto isCancelled = [cancel]() { return cancel && cancel->load(std::memory_order_relaxed); };
+    auto setProgress = [progress](int percent) {
+        if (progress) progress->store(percent, std::memory_order_relaxed);
+    };
+    setProgress(0);
+
+    const int count = vertices.size();
+    const int minPoints = qMax(3, settings.minPoints);
+    if (count < minPoints || settings.epsilon <= 0.0f || !(settings.planes || settings.spheres || settings.cylinders)) {
+        return false;
+    }
+    const float epsilon = settings.epsilon;
+    const float cosAngle = std::cos(qDegreesToRadians(qBound(1.0f, settings.normalAngle, 89.0f)));
+
+    // 경계 상자 (조각별 최소/최대를 모아 합침)
+    const int chunks = Parallel::chunkCount(count, ParallelGrain);
+    QVector<QVector3D> chunkMin(chunks);
+    QVector<QVector3D> chunkMax(chunks);
+    Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        QVector3D boxMin = vertices[begin].position;
+        QVector3D boxMax = boxMin;
+        for (qsizetype i = begin + 1; i < end; ++i) {
+            const QVector3D& p = vertices[i].position;
+            boxMin = QVector3D(qMin(boxMin.x(), p.x()), qMin(boxMin.y(), p.y()), qMin(boxMin.z(), p.z()));
+            boxMax = QVector3D(qMax(boxMax.x(), p.x()), qMax(boxMax.y(), p.y()), qMax(boxMax.z(), p.z()));
+        }
+        chunkMin[chunk] = boxMin;
+        chunkMax[chunk] = boxMax;
+    });
+    QVector3D boxMin = chunkMin[0];
+    QVector3D boxMax = chunkMax[0];
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        const QVector3D& a = chunkMin[chunk];
+        const QVector3D& b = chunkMax[chunk];
+        boxMin = QVector3D(qMin(boxMin.x(), a.x()), qMin(boxMin.y(), a.y()), qMin(boxMin.z(), a.z()));
+        boxMax = QVector3D(qMax(boxMax.x(), b.x()), qMax(boxMax.y(), b.y()), qMax(boxMax.z(), b.z()));
+    }
+    const QVector3D extent = boxMax - boxMin;
+    const float longest = qMax(extent.x(), qMax(extent.y(), extent.z()));
+    if (longest <= 0.0f) return false;
+
+    // 모델보다 큰 구/원기둥은 평면과 구별되지 않음
+    const float maxRadius = longest;
+    const float clusterSpacing = qMax(settings.clusterSpacing > 0.0f ? settings.clusterSpacing : epsilon * ClusterScale,
+                                      longest / float((1 << ClusterAxisBits) - 1));
+
+    // 표본 색인: 점을 Morton 코드로 정렬하면 깊이 L의 팔진 셀은 코드 상위 3L비트가 같은 연속 구간
+    // 셀이 연결 간격보다 작아지는 깊이는 쓰지 않음
+    int levelCount = 1;
+    while (levelCount < SampleAxisBits && longest / float(1 << (levelCount + 1)) >= clusterSpacing) {
+        ++levelCount;
+    }
+    const float sampleScale = float((1 << SampleAxisBits) - 1) / longest;
+    auto sampleCode = [&](const QVector3D& position) {
+        const QVector3D cell = (position - boxMin) * sampleScale;
+        const float maxCell = float((1 << SampleAxisBits) - 1);
+        return spreadBits(quint32(qBound(0.0f, cell.x(), maxCell))) << 2
+               | spreadBits(quint32(qBound(0.0f, cell.y(), maxCell))) << 1
+               | spreadBits(quint32(qBound(0.0f, cell.z(), maxCell)));
+    };
+    QVector<quint32> codes(count);
+    QVector<int> sampleOrder(count);
+    quint32* codeData = codes.data();
+    int* sampleOrderData = sampleOrder.data();
+    Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            codeData[i] = sampleCode(vertices[i].position);
+            sampleOrderData[i] = int(i);
+        }
+    });
+    if (!Parallel::sortByKey(codes, sampleOrder, SampleCodeBits, ParallelGrain, cancel)) return false;
+
+    // 점을 난수 키로 정렬해 뒤섞고 SoA로 모음 (법선은 단위 벡터로, 법선이 없는 점은 처음부터 제외)
+    QVector<quint32> shuffleKeys(count);
+    QVector<int> shuffled(count);
+    quint32* shuffleKeyData = shuffleKeys.data();
+    int* shuffledData = shuffled.data();
+    Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            shuffleKeyData[i] = quint32(mixBits(quint64(i)));
+            shuffledData[i] = int(i);
+        }
+    });
+    if (!Parallel::sortByKey(shuffleKeys, shuffled, 32, ParallelGrain, cancel)) return false;
+    shuffleKeys.clear();
+
+    PointArrays points;
+    points.resize(count);
+    {
+        const int* order = shuffled.constData();
+        float* xs = points.x.data();
+        float* ys = points.y.data();
+        float* zs = points.z.data();
+        float* nxs = points.nx.data();
+        float* nys = points.ny.data();
+        float* nzs = points.nz.data();
+        int* ids = points.ids.data();
+        Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype i = begin; i < end; ++i) {
+                const VertexData& vertex = vertices[order[i]];
+                const QVector3D normal = vertex.normal.normalized();
+                xs[i] = vertex.position.x();
+                ys[i] = vertex.position.y();
+                zs[i] = vertex.position.z();
+                nxs[i] = normal.x();
+                nys[i] = normal.y();
+                nzs[i] = normal.z();
+                ids[i] = order[i];
+            }
+        });
+    }
+    shuffled.clear();
+    compact(points);
+    const int liveCount = points.size();
+    int remaining = liveCount;
+    setProgress(5);
+
+    m_labels.fill(-1, count);
+    int* labelData = m_labels.data();
+
+    // 표본 번호 → 후보 (최대 3개). 난수는 표본 번호로 정하므로 어느 스레드가 만들어도 같음
+    const PointArrays& livePoints = points;
+    const quint32* sortedCodes = codes.constData();
+    const int* sortedPoints = sampleOrder.constData();
+    auto makeCandidates = [&](quint64 hypothesis, int subsetEnd, Candidate* out) {
+        const PointArrays& points = livePoints;
+        Random random(mixBits(hypothesis ^ 0x5851f42d4c957f2dULL));
+        QVector3D p[3];
+        QVector3D n[3];
+        int ids[3] = { -1, -1, -1 };
+
+        // 첫 점은 남은 점에서 균일하게 (뒤섞은 배열에서 고름)
+        for (int attempt = 0; attempt < SampleTries && ids[0] < 0; ++attempt) {
+            const int i = random.below(points.size());
+            if (!points.isLive(i)) continue;
+            ids[0] = points.ids[i];
+            p[0] = QVector3D(points.x[i], points.y[i], points.z[i]);
+            n[0] = QVector3D(points.nx[i], points.ny[i], points.nz[i]);
+        }
+        if (ids[0] < 0) return;
+
+        // 나머지 두 점은 첫 점을 포함하는 임의 깊이의 셀에서
+        const int level = 1 + random.below(levelCount);
+        const int shift = SampleCodeBits - 3 * level;
+        const quint32 cellFirst = sampleCode(p[0]) >> shift << shift;
+        const quint32 cellLast = cellFirst + ((1u << shift) - 1);
+        const int begin = int(std::lower_bound(sortedCodes, sortedCodes + count, cellFirst) - sortedCodes);
+        const int end = int(std::upper_bound(sortedCodes + begin, sortedCodes + count, cellLast) - sortedCodes);
+        if (end - begin < 3) return;
+        for (int k = 1; k < 3; ++k) {
+            for (int attempt = 0; attempt < SampleTries && ids[k] < 0; ++attempt) {
+                const int id = sortedPoints[begin + random.below(end - begin)];
+                if (id == ids[0] || id == ids[1] || labelData[id] >= 0) continue;
+                const VertexData& vertex = vertices[id];
+                if (vertex.normal.isNull()) continue;
+                ids[k] = id;
+                p[k] = vertex.position;
+                n[k] = vertex.normal.normalized();
+            }
+            if (ids[k] < 0) return;
+        }
+
+        Candidate candidate;
+        int slot = 0;
+        if (settings.planes && fitPlane(p, n, epsilon, cosAngle, candidate)) {
+            candidate.score = countInliers(candidate, points, 0, subsetEnd, epsilon, cosAngle);
+            out[slot++] = candidate;
+        }
+        if (settings.spheres && fitSphere(p, n, epsilon, cosAngle, maxRadius, candidate)) {
+            candidate.score = countInliers(candidate, points, 0, subsetEnd, epsilon, cosAngle);
+            out[slot++] = candidate;
+        }
+        if (settings.cylinders && fitCylinder(p, n, epsilon, cosAngle, maxRadius, candidate)) {
+            candidate.score = countInliers(candidate, points, 0, subsetEnd, epsilon, cosAngle);
+            out[slot++] = candidate;
+        }
+    };
+
+    // 남은 점 n̂개짜리 도형을 표본 drawn개 동안 한 번도 뽑지 못했을 확률의 여사건
+    // (첫 점이 도형 위에 있고 셀 깊이와 나머지 두 점이 맞을 확률 ≈ n̂ / (남은 점 수 · 깊이 수 · 4))
+    auto foundProbability = [&](double size, int drawn) {
+        const double single = qMin(1.0, size / (double(remaining) * levelCount * 4.0));
+        return 1.0 - std::pow(1.0 - single, double(drawn));
+    };
+
+    quint64 hypothesisIndex = 0;
+    int rejections = 0;
+    QVector<Candidate> pool;
+    QVector<Candidate> roundCandidates(HypothesesPerRound * 3);
+    QVector<quint8> flags;
+    while (m_primitives.size() < settings.maxPrimitives && remaining >= minPoints) {
+        // 앞부분 부분 집합에 남은 점 수 (추정 점 수 = 부분 집합 인라이어 · 남은 점 / 부분 집합의 남은 점)
+        const int subsetEnd = qMin(points.size(), ScoreSubset);
+        int subsetLive = 0;
+        for (int i = 0; i < subsetEnd; ++i) {
+            subsetLive += points.isLive(i);
+        }
+        if (subsetLive == 0) break;
+        const double subsetScale = double(remaining) / subsetLive;
+
+        // 더 큰 도형을 놓쳤을 확률이 충분히 작아질 때까지 표본을 늘림
+        pool.clear();
+        int drawn = 0;
+        int bestScore = 0;
+        bool finished = false;
+        for (;;) {
+            std::fill(roundCandidates.begin(), roundCandidates.end(), Candidate());
+            Candidate* roundData = roundCandidates.data();
+            Parallel::parallelFor(HypothesesPerRound, HypothesisGrain, [&](qsizetype begin, qsizetype end) {
+                for (qsizetype h = begin; h < end; ++h) {
+                    makeCandidates(hypothesisIndex + quint64(h), subsetEnd, roundData + h * 3);
+                }
+            });
+            hypothesisIndex += HypothesesPerRound;
+            drawn += HypothesesPerRound;
+            for (const Candidate& candidate : roundCandidates) {
+                if (candidate.score <= 0) continue;
+                pool.append(candidate);
+                bestScore = qMax(bestScore, candidate.score);
+            }
+            if (isCancelled()) return false;
+
+            const double bestEstimate = bestScore * subsetScale;
+            if (bestEstimate >= minPoints) {
+                if (foundProbability(bestEstimate, drawn) >= settings.probability || drawn >= MaxHypotheses) break;
+            } else if (foundProbability(minPoints, drawn) >= settings.probability || drawn >= MaxHypotheses) {
+                finished = true;
+                break;
+            }
+        }
+        if (finished) break;
+
+        // 상위 후보를 더 큰 부분 집합에서 다시 채점
+        std::stable_sort(pool.begin(), pool.end(), [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+        pool.resize(qMin(int(pool.size()), RefineCandidates));
+        const int refineEnd = qMin(points.size(), RefineSubset);
+        Candidate* poolData = pool.data();
+        Parallel::parallelFor(pool.size(), 1, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype c = begin; c < end; ++c) {
+                poolData[c].score = countInliers(poolData[c], livePoints, 0, refineEnd, epsilon, cosAngle);
+            }
+        });
+        std::stable_sort(pool.begin(), pool.end(), [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+        // 좋은 순서로 전체 점에서 인라이어를 구하고 이어진 가장 큰 조각이 충분히 크면 뽑아냄
+        flags.resize(points.size());
+        quint8* flagData = flags.data();
+        int extracted = 0;
+        for (const Candidate& candidate : pool) {
+            Parallel::parallelFor(points.size(), ParallelGrain, [&](qsizetype begin, qsizetype end) {
+                countInliers(candidate, livePoints, int(begin), int(end), epsilon, cosAngle, flagData);
+            });
+            const int kept = keepLargestCluster(points, flags, boxMin, clusterSpacing, cancel);
+            if (isCancelled()) return false;
+            if (kept < minPoints) continue;
+
+            const int primitive = m_primitives.size();
+            DetectedPrimitive detected;
+            detected.type = candidate.type;
+            detected.point = candidate.point;
+            detected.direction = candidate.direction;
+            detected.radius = candidate.radius;
+            detected.pointCount = kept;
+            m_primitives.append(detected);
+            const int* ids = points.ids.constData();
+            float* nxs = points.nx.data();
+            float* nys = points.ny.data();
+            float* nzs = points.nz.data();
+            Parallel::parallelFor(points.size(), ParallelGrain, [&](qsizetype begin, qsizetype end) {
+                for (qsizetype i = begin; i < end; ++i) {
+                    if (!flagData[i]) continue;
+                    labelData[ids[i]] = primitive;
+                    nxs[i] = nys[i] = nzs[i] = 0.0f;
+                }
+            });
+            extracted = kept;
+            break;
+        }
+
+        if (extracted == 0) {
+            if (++rejections >= MaxRejections) break;
+            continue;
+        }
+        rejections = 0;
+        remaining -= extracted;
+        if (remaining < points.size() / 2) {
+            compact(points);
+        }
+        setProgress(5 + int(90.0 * (liveCount - remaining) / liveCount));
+    }
+
+    int typeCounts[3] = { 0, 0, 0 };
+    for (const DetectedPrimitive& primitive : m_primitives) {
+        ++typeCounts[primitive.type];
+    }
+    setProgress(100);
+    qDebug() << "Detected" << typeCounts[DetectedPrimitive::Plane] << "planes," << typeCounts[DetectedPrimitive::Sphere]
+             << "spheres," << typeCounts[DetectedPrimitive::Cylinder] << "cylinders covering" << liveCount - remaining
+             << "of" << count << "points from" << hypothesisIndex << "samples in" << timer.elapsed() << "ms";
+    return true;
+}
+
+void PrimitiveDetector::applyColors(QVector<VertexData>& vertices) const
+{
+    if (vertices.size() != m_labels.size()) return;
+
+    // 색은 도형마다 한 번만 계산
+    QVector<QVector3D> colors(m_primitives.size() + 1);
+    for (int primitive = -1; primitive < m_primitives.size(); ++primitive) {
+        colors[primitive + 1] = getPrimitiveColor(primitive);
+    }
+    VertexData* vertexData = vertices.data();
+    const int* labelData = m_labels.constData();
+    Parallel::parallelFor(vertices.size(), ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype v = begin; v < end; ++v) {
+            vertexData[v].color = colors[labelData[v] + 1];
+        }
+    });
+}
+
+QVector3D PrimitiveDetector::getPrimitiveColor(int primitive)
+{
+    if (primitive < 0) return QVector3D(0.5f, 0.5f, 0.5f);
+
+    // 황금비 간격의 색상환이라 이웃한 번호끼리 색이 멀어짐
+    const QColor color = QColor::fromHsvF(std::fmod(primitive * 0.618034f, 1.0f), 0.65f, 0.95f);
+    return QVector3D(color.redF(), color.greenF(), color.blueF());
+}
+
+QString PrimitiveDetector::getTypeName(DetectedPrimitive::Type type)
+{
+    switch (type) {
+        case DetectedPrimitive::Sphere:
+            return "sphere";
+        case DetectedPrimitive::Cylinder:
+            return "cylinder";
+        case DetectedPrimitive::Plane:
+        default:
+            return "plane";
+    }
+}
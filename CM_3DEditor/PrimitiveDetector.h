@@ -0,0 +1,74 @@
+#ifndef PRIMITIVEDETECTOR_H
+#define PRIMITIVEDETECTOR_H
+
+#include <QVector>
+#include <QVector3D>
+#include <QString>
+#include <atomic>
+#include "Mesh.h"
+
+// 검출된 기본 도형
+struct DetectedPrimitive {
+    enum Type {
+        Plane,
+        Sphere,
+        Cylinder
+    };
+
+    Type type = Plane;
+    QVector3D point;            // 평면: 평면 위 한 점, 구: 중심, 원기둥: 축 위 한 점
+    QVector3D direction;        // 평면: 단위 법선, 원기둥: 단위 축 방향 (구는 쓰지 않음)
+    float radius = 0.0f;
+    int pointCount = 0;
+};
+
+// 기본 도형 검출 설정
+struct PrimitiveSettings {
+    float epsilon = 0.0f;           // 표면까지 최대 거리
+    float clusterSpacing = 0.0f;    // 인라이어끼리 이보다 멀면 다른 조각 (0이면 epsilon의 4배)
+    float normalAngle = 20.0f;      // 점 법선과 표면 법선의 최대 각도 (도)
+    int minPoints = 100;            // 도형 하나의 최소 점 수
+    int maxPrimitives = 256;
+    float probability = 0.99f;      // minPoints 이상인 더 큰 도형을 놓치지 않았을 확률
+    bool planes = true;
+    bool spheres = true;
+    bool cylinders = true;
+};
+
+// 점군의 평면/구/원기둥 검출 (efficient RANSAC)
+// 점 하나를 고르고 Morton 순서로 정렬한 점 배열에서 그 점을 포함하는 임의 깊이의 팔진 셀 구간에서 두 점을 더
+// 골라(옥트리 국소 표본) 법선과 함께 후보를 만듦. 후보는 스레드마다 병렬로 만들고 뒤섞은 점 배열의 앞부분
+// (무작위 부분 집합)에서 SSE로 4점씩 채점해 점 수를 추정하고, 더 큰 도형을 놓쳤을 확률이 충분히 작아지면
+// 가장 좋은 후보의 인라이어 중 격자로 이어진 가장 큰 조각을 뽑아냄. 난수는 후보 번호로 정하므로
+// 결과는 스레드 수와 관계없음
+class PrimitiveDetector
+{
+public:
+    PrimitiveDetector();
+
+    // 법선이 있는 정점으로 검출 (GL 호출 없음, 스레드 안전)
+    // 점이 minPoints보다 적거나 cancel이 설정되면 false, progress에는 0~100 진행률을 씀
+    bool detect(const QVector<VertexData>& vertices, const PrimitiveSettings& settings,
+                const std::atomic_bool* cancel = nullptr, std::atomic_int* progress = nullptr);
+    void clear();
+
+    int getPrimitiveCount() const { return m_primitives.size(); }
+    const DetectedPrimitive& getPrimitive(int primitive) const { return m_primitives[primitive]; }
+    const QVector<DetectedPrimitive>& getPrimitives() const { return m_primitives; }
+
+    // 정점 → 도형 번호 (어느 도형에도 속하지 않으면 -1)
+    const QVector<int>& getLabels() const { return m_labels; }
+
+    // 정점 색을 속한 도형의 색으로 바꿈 (검출한 정점 배열과 크기가 같아야 함)
+    void applyColors(QVector<VertexData>& vertices) const;
+
+    // 도형 번호의 표시 색 (-1은 회색)
+    static QVector3D getPrimitiveColor(int primitive);
+    static QString getTypeName(DetectedPrimitive::Type type);
+
+private:
+    QVector<DetectedPrimitive> m_primitives;
+    QVector<int> m_labels;
+};
+
+#endif // PRIMITIVEDETECTOR_H
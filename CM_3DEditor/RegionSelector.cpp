@@ -0,0 +1,392 @@
+#include "RegionSelector.h"
+#include "Parallel.h"
+#include <QImage>
+#include <QPainter>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SELECTION_USE_SSE
+#endif
+
+namespace {
+
+// 카메라 평면에 이보다 가까운 점은 화면 밖으로 처리
+const float MinClipW = 1e-6f;
+
+enum Coverage {
+    Outside,
+    Partial,
+    Inside
+};
+
+// 선택 커널이 공유하는 투영/영역 정보
+struct Projection {
+    float row0[4];          // 클립 x
+    float row1[4];          // 클립 y
+    float row3[4];          // 클립 w
+    float ndcMin[2];        // 영역 경계 사각형 (NDC)
+    float ndcMax[2];
+    float viewportWidth;
+    float viewportHeight;
+    QRect bounds;           // 영역 경계 사각형 (픽셀)
+
+    // 올가미: bounds 크기의 마스크와 누적 합 (사각형이면 nullptr)
+    const uchar* mask = nullptr;
+    qsizetype maskStride = 0;
+    const int* coverage = nullptr;
+
+    bool isInsideMask(float ndcX, float ndcY) const {
+        int x = int((ndcX + 1.0f) * 0.5f * viewportWidth) - bounds.left();
+        int y = int((1.0f - ndcY) * 0.5f * viewportHeight) - bounds.top();
+        if (x < 0 || y < 0 || x >= bounds.width() || y >= bounds.height()) return false;
+        return mask[y * maskStride + x] != 0;
+    }
+
+    // 픽셀 사각형 [x0, x1] x [y0, y1] (bounds 기준)이 모두 마스크 안인지
+    bool isCoveredByMask(int x0, int y0, int x1, int y1) const {
+        const int stride = bounds.width() + 1;
+        int sum = coverage[(y1 + 1) * stride + x1 + 1] - coverage[y0 * stride + x1 + 1]
+                - coverage[(y1 + 1) * stride + x0] + coverage[y0 * stride + x0];
+        return sum == (x1 - x0 + 1) * (y1 - y0 + 1);
+    }
+};
+
+Coverage classifyBlock(const QVector3D& boxMin, const QVector3D& boxMax, const Projection& p)
+{
+    float minX = FLT_MAX, minY = FLT_MAX;
+    float maxX = -FLT_MAX, maxY = -FLT_MAX;
+    int behind = 0;
+
+    for (int i = 0; i < 8; ++i) {
+        float x = (i & 1) ? boxMax.x() : boxMin.x();
+        float y = (i & 2) ? boxMax.y() : boxMin.y();
+        float z = (i & 4) ? boxMax.z() : boxMin.z();
+        float w = p.row3[0] * x + p.row3[1] * y + p.row3[2] * z + p.row3[3];
+        if (w <= MinClipW) {
+            ++behind;
+            continue;
+        }
+        float ndcX = (p.row0[0] * x + p.row0[1] * y + p.row0[2] * z + p.row0[3]) / w;
+        float ndcY = (p.row1[0] * x + p.row1[1] * y + p.row1[2] * z + p.row1[3]) / w;
+        minX = qMin(minX, ndcX);
+        maxX = qMax(maxX, ndcX);
+        minY = qMin(minY, ndcY);
+        maxY = qMax(maxY, ndcY);
+    }
+
+    // 모두 카메라 뒤면 밖, 일부만 뒤면 투영 상자를 믿을 수 없으므로 원소별 검사
+    if (behind == 8) return Outside;
+    if (behind > 0) return Partial;
+
+    if (maxX < p.ndcMin[0] || minX > p.ndcMax[0] || maxY < p.ndcMin[1] || minY > p.ndcMax[1]) {
+        return Outside;
+    }
+    if (minX < p.ndcMin[0] || maxX > p.ndcMax[0] || minY < p.ndcMin[1] || maxY > p.ndcMax[1]) {
+        return Partial;
+    }
+    if (!p.mask) return Inside;
+
+    // 올가미: 상자가 덮는 픽셀이 모두 마스크 안이어야 통째로 선택
+    int x0 = qMax(int((minX + 1.0f) * 0.5f * p.viewportWidth) - p.bounds.left(), 0);
+    int x1 = qMin(int((maxX + 1.0f) * 0.5f * p.viewportWidth) - p.bounds.left(), p.bounds.width() - 1);
+    int y0 = qMax(int((1.0f - maxY) * 0.5f * p.viewportHeight) - p.bounds.top(), 0);
+    int y1 = qMin(int((1.0f - minY) * 0.5f * p.viewportHeight) - p.bounds.top(), p.bounds.height() - 1);
+    return p.isCoveredByMask(x0, y0, x1, y1) ? Inside : Partial;
+}
+
+// 원소 하나 검사 (SIMD 나머지/대체 경로)
+inline bool testElement(float x, float y, float z, const Projection& p)
+{
+    float w = p.row3[0] * x + p.row3[1] * y + p.row3[2] * z + p.row3[3];
+    if (w <= MinClipW) return false;
+    float cx = p.row0[0] * x + p.row0[1] * y + p.row0[2] * z + p.row0[3];
+    float cy = p.row1[0] * x + p.row1[1] * y + p.row1[2] * z + p.row1[3];
+    if (cx < p.ndcMin[0] * w || cx > p.ndcMax[0] * w || cy < p.ndcMin[1] * w || cy > p.ndcMax[1] * w) {
+        return false;
+    }
+    return !p.mask || p.isInsideMask(cx / w, cy / w);
+}
+
+// [begin, end) 원소를 검사해 비트 워드를 씀 (begin은 64의 배수)
+void testRange(const float* xs, const float* ys, const float* zs, int begin, int end,
+               const Projection& p, quint64* words)
+{
+#ifdef SELECTION_USE_SSE
+    const __m128 m00 = _mm_set1_ps(p.row0[0]), m01 = _mm_set1_ps(p.row0[1]);
+    const __m128 m02 = _mm_set1_ps(p.row0[2]), m03 = _mm_set1_ps(p.row0[3]);
+    const __m128 m10 = _mm_set1_ps(p.row1[0]), m11 = _mm_set1_ps(p.row1[1]);
+    const __m128 m12 = _mm_set1_ps(p.row1[2]), m13 = _mm_set1_ps(p.row1[3]);
+    const __m128 m30 = _mm_set1_ps(p.row3[0]), m31 = _mm_set1_ps(p.row3[1]);
+    const __m128 m32 = _mm_set1_ps(p.row3[2]), m33 = _mm_set1_ps(p.row3[3]);
+    const __m128 minX = _mm_set1_ps(p.ndcMin[0]), maxX = _mm_set1_ps(p.ndcMax[0]);
+    const __m128 minY = _mm_set1_ps(p.ndcMin[1]), maxY = _mm_set1_ps(p.ndcMax[1]);
+    const __m128 minW = _mm_set1_ps(MinClipW);
+#endif
+
+    for (int wordStart = begin; wordStart < end; wordStart += 64) {
+        const int wordEnd = qMin(wordStart + 64, end);
+        quint64 bits = 0;
+        int i = wordStart;
+
+#ifdef SELECTION_USE_SSE
+        // 4개씩 클립 좌표를 구해 w로 나누지 않고 경계와 비교 (x >= min * w 형태)
+        for (; i + 4 <= wordEnd; i += 4) {
+            const __m128 x = _mm_loadu_ps(xs + i);
+            const __m128 y = _mm_loadu_ps(ys + i);
+            const __m128 z = _mm_loadu_ps(zs + i);
+            const __m128 cx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)),
+                                         _mm_add_ps(_mm_mul_ps(m02, z), m03));
+            const __m128 cy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)),
+                                         _mm_add_ps(_mm_mul_ps(m12, z), m13));
+            const __m128 cw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m30, x), _mm_mul_ps(m31, y)),
+                                         _mm_add_ps(_mm_mul_ps(m32, z), m33));
+
+            __m128 inside = _mm_cmpgt_ps(cw, minW);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(cx, _mm_mul_ps(minX, cw)));
+            inside = _mm_and_ps(inside, _mm_cmple_ps(cx, _mm_mul_ps(maxX, cw)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(cy, _mm_mul_ps(minY, cw)));
+            inside = _mm_and_ps(inside, _mm_cmple_ps(cy, _mm_mul_ps(maxY, cw)));
+
+            int mask = _mm_movemask_ps(inside);
+            if (mask && p.mask) {
+                // 경계 사각형 안에 든 것만 올가미 마스크 조회
+                alignas(16) float clipX[4], clipY[4], clipW[4];
+                _mm_store_ps(clipX, cx);
+                _mm_store_ps(clipY, cy);
+                _mm_store_ps(clipW, cw);
+                for (int lane = 0; lane < 4; ++lane) {
+                    if ((mask & (1 << lane)) && !p.isInsideMask(clipX[lane] / clipW[lane], clipY[lane] / clipW[lane])) {
+                        mask &= ~(1 << lane);
+                    }
+                }
+            }
+            bits |= quint64(mask) << (i - wordStart);
+        }
+#endif
+        for (; i < wordEnd; ++i) {
+            if (testElement(xs[i], ys[i], zs[i], p)) {
+                bits |= quint64(1) << (i - wordStart);
+            }
+        }
+        words[wordStart / 64] = bits;
+    }
+}
+
+// [begin, end) 비트를 모두 설정 (begin은 64의 배수)
+void fillRange(int begin, int end, quint64* words)
+{
+    for (int wordStart = begin; wordStart < end; wordStart += 64) {
+        int bitCount = qMin(64, end - wordStart);
+        words[wordStart / 64] = bitCount == 64 ? ~quint64(0) : (quint64(1) << bitCount) - 1;
+    }
+}
+
+} // namespace
+
+RegionSelector::RegionSelector()
+{
+}
+
+void RegionSelector::clear()
+{
+    m_vertices = ElementSet();
+    m_faces = ElementSet();
+}
+
+bool RegionSelector::build(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+                           const std::atomic_bool* cancel)
+{
+    clear();
+    auto cancelled = [cancel]() { return cancel && cancel->load(std::memory_order_relaxed); };
+
+    // 정점 위치 (SoA)
+    const int vertexCount = vertices.size();
+    m_vertices.count = vertexCount;
+    m_vertices.x.resize(vertexCount);
+    m_vertices.y.resize(vertexCount);
+    m_vertices.z.resize(vertexCount);
+    float* vx = m_vertices.x.data();
+    float* vy = m_vertices.y.data();
+    float* vz = m_vertices.z.data();
+    Parallel::parallelFor(vertexCount, 65536, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            const QVector3D& p = vertices[i].position;
+            vx[i] = p.x();
+            vy[i] = p.y();
+            vz[i] = p.z();
+        }
+    });
+    if (cancelled()) return false;
+    buildBlocks(m_vertices);
+
+    // 면 중심 (인덱스 버퍼 순서 = 클러스터 순서라 블록이 공간적으로 모여 있음)
+    const int faceCount = indices.size() / 3;
+    m_faces.count = faceCount;
+    m_faces.x.resize(faceCount);
+    m_faces.y.resize(faceCount);
+    m_faces.z.resize(faceCount);
+    float* fx = m_faces.x.data();
+    float* fy = m_faces.y.data();
+    float* fz = m_faces.z.data();
+    const unsigned int* indexData = indices.constData();
+    Parallel::parallelFor(faceCount, 65536, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype f = begin; f < end; ++f) {
+            unsigned int a = indexData[f * 3], b = indexData[f * 3 + 1], c = indexData[f * 3 + 2];
+            fx[f] = (vx[a] + vx[b] + vx[c]) / 3.0f;
+            fy[f] = (vy[a] + vy[b] + vy[c]) / 3.0f;
+            fz[f] = (vz[a] + vz[b] + vz[c]) / 3.0f;
+        }
+    });
+    if (cancelled()) {
+        clear();
+        return false;
+    }
+    buildBlocks(m_faces);
+    return true;
+}
+
+void RegionSelector::update(const QVector<VertexData>& meshVertices, const QVector<unsigned int>& indices,
+                            const QVector<int>& vertices, const QVector<int>& triangles)
+{
+    if (m_vertices.count != meshVertices.size() || m_faces.count != indices.size() / 3) return;
+
+    for (int v : vertices) {
+        const QVector3D& p = meshVertices[v].position;
+        m_vertices.x[v] = p.x();
+        m_vertices.y[v] = p.y();
+        m_vertices.z[v] = p.z();
+    }
+    for (int f : triangles) {
+        QVector3D centroid = (meshVertices[indices[f * 3]].position + meshVertices[indices[f * 3 + 1]].position
+                              + meshVertices[indices[f * 3 + 2]].position) / 3.0f;
+        m_faces.x[f] = centroid.x();
+        m_faces.y[f] = centroid.y();
+        m_faces.z[f] = centroid.z();
+    }
+
+    // 오름차순이므로 같은 블록은 이어서 나옴
+    int lastBlock = -1;
+    for (int v : vertices) {
+        if (v / BlockSize == lastBlock) continue;
+        lastBlock = v / BlockSize;
+        computeBlock(m_vertices, lastBlock);
+    }
+    lastBlock = -1;
+    for (int f : triangles) {
+        if (f / BlockSize == lastBlock) continue;
+        lastBlock = f / BlockSize;
+        computeBlock(m_faces, lastBlock);
+    }
+}
+
+void RegionSelector::buildBlocks(ElementSet& set)
+{
+    const int blockCount = (set.count + BlockSize - 1) / BlockSize;
+    set.blocks.resize(blockCount);
+
+    Parallel::parallelFor(blockCount, 16, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype b = begin; b < end; ++b) {
+            computeBlock(set, int(b));
+        }
+    });
+}
+
+void RegionSelector::computeBlock(ElementSet& set, int block)
+{
+    const float* xs = set.x.constData();
+    const float* ys = set.y.constData();
+    const float* zs = set.z.constData();
+    int first = block * BlockSize;
+    int last = qMin(first + BlockSize, set.count);
+    QVector3D boxMin(xs[first], ys[first], zs[first]);
+    QVector3D boxMax = boxMin;
+    for (int i = first + 1; i < last; ++i) {
+        boxMin = QVector3D(qMin(boxMin.x(), xs[i]), qMin(boxMin.y(), ys[i]), qMin(boxMin.z(), zs[i]));
+        boxMax = QVector3D(qMax(boxMax.x(), xs[i]), qMax(boxMax.y(), ys[i]), qMax(boxMax.z(), zs[i]));
+    }
+    set.blocks[block].min = boxMin;
+    set.blocks[block].max = boxMax;
+}
+
+void RegionSelector::select(ElementType type, const QMatrix4x4& modelViewProjection, const QSize& viewport,
+                            const SelectionRegion& region, SelectionSet& result) const
+{
+    const ElementSet& set = elementSet(type);
+    result.resize(set.count);
+    if (set.count == 0 || viewport.isEmpty()) return;
+
+    Projection p;
+    p.bounds = region.boundingRect().intersected(QRect(QPoint(0, 0), viewport));
+    if (p.bounds.isEmpty()) return;
+    if (region.shape == SelectionRegion::Lasso && region.polygon.size() < 3) return;
+
+    for (int column = 0; column < 4; ++column) {
+        p.row0[column] = modelViewProjection(0, column);
+        p.row1[column] = modelViewProjection(1, column);
+        p.row3[column] = modelViewProjection(3, column);
+    }
+    p.viewportWidth = viewport.width();
+    p.viewportHeight = viewport.height();
+    p.ndcMin[0] = 2.0f * p.bounds.left() / viewport.width() - 1.0f;
+    p.ndcMax[0] = 2.0f * (p.bounds.right() + 1) / viewport.width() - 1.0f;
+    p.ndcMin[1] = 1.0f - 2.0f * (p.bounds.bottom() + 1) / viewport.height();
+    p.ndcMax[1] = 1.0f - 2.0f * p.bounds.top() / viewport.height();
+
+    // 올가미는 경계 사각형 크기로 래스터화해 원소마다 다각형 검사를 하지 않음
+    QImage mask;
+    QVector<int> coverage;
+    if (region.shape == SelectionRegion::Lasso) {
+        mask = QImage(p.bounds.size(), QImage::Format_Grayscale8);
+        mask.fill(0);
+        {
+            QPainter painter(&mask);
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(Qt::white);
+            painter.translate(-p.bounds.topLeft());
+            painter.drawPolygon(region.polygon, Qt::OddEvenFill);
+        }
+
+        // 블록이 통째로 안에 드는지 O(1)로 확인하기 위한 누적 합
+        const int stride = mask.width() + 1;
+        coverage.fill(0, stride * (mask.height() + 1));
+        for (int y = 0; y < mask.height(); ++y) {
+            const uchar* line = mask.constScanLine(y);
+            int rowSum = 0;
+            for (int x = 0; x < mask.width(); ++x) {
+                rowSum += line[x] != 0 ? 1 : 0;
+                coverage[(y + 1) * stride + x + 1] = coverage[y * stride + x + 1] + rowSum;
+            }
+        }
+
+        p.mask = mask.constBits();
+        p.maskStride = mask.bytesPerLine();
+        p.coverage = coverage.constData();
+    }
+
+    const float* xs = set.x.constData();
+    const float* ys = set.y.constData();
+    const float* zs = set.z.constData();
+    const Block* blocks = set.blocks.constData();
+    quint64* words = result.data();
+    const int count = set.count;
+
+    // 블록마다 워드 구간이 겹치지 않으므로 잠금 없이 병렬 처리
+    Parallel::parallelFor(set.blocks.size(), 8, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype b = begin; b < end; ++b) {
+            int first = int(b) * BlockSize;
+            int last = qMin(first + BlockSize, count);
+            switch (classifyBlock(blocks[b].min, blocks[b].max, p)) {
+                case Outside:
+                    break;
+                case Inside:
+                    fillRange(first, last, words);
+                    break;
+                case Partial:
+                    testRange(xs, ys, zs, first, last, p, words);
+                    break;
+            }
+        }
+    });
+}
@@ -0,0 +1,80 @@
+#ifndef REGIONSELECTOR_H
+#define REGIONSELECTOR_H
+
+#include <QVector>
+#include <QVector3D>
+#include <QMatrix4x4>
+#include <QPolygon>
+#include <QRect>
+#include <QSize>
+#include <atomic>
+#include "Mesh.h"
+#include "SelectionSet.h"
+
+// 화면 선택 영역 (뷰포트 픽셀 좌표, 왼쪽 위 기준)
+struct SelectionRegion {
+    enum Shape {
+        Rectangle,
+        Lasso           // polygon을 닫힌 다각형으로 처리 (홀짝 규칙)
+    };
+
+    Shape shape = Rectangle;
+    QRect rect;
+    QPolygon polygon;
+
+    QRect boundingRect() const { return shape == Rectangle ? rect.normalized() : polygon.boundingRect(); }
+};
+
+// 사각형/올가미 영역 안으로 투영되는 정점/면(중심)을 찾는 선택 커널
+// 위치를 SoA 배열로 보관하고 BlockSize개씩 경계 상자를 두어, 영역 밖 블록은 건너뛰고
+// 통째로 안에 들어오는 블록은 비트만 채움. 걸치는 블록만 SSE로 4개씩 투영해 검사
+class RegionSelector
+{
+public:
+    enum ElementType {
+        Vertices,
+        Faces
+    };
+
+    static constexpr int BlockSize = 1024;     // 64의 배수 (블록마다 비트셋 워드가 겹치지 않음)
+
+    RegionSelector();
+
+    // 메시 데이터로 구축 (GL 호출 없음, 스레드 안전). cancel이 설정되면 중단하고 false 반환
+    bool build(const QVector<VertexData>& vertices, const QVector<unsigned int>& indices,
+               const std::atomic_bool* cancel = nullptr);
+    void clear();
+
+    // 정점이 움직인 뒤 바뀐 정점 위치/면 중심과 그 블록 경계만 갱신 (vertices, triangles는 오름차순)
+    void update(const QVector<VertexData>& meshVertices, const QVector<unsigned int>& indices,
+                const QVector<int>& vertices, const QVector<int>& triangles);
+
+    int getElementCount(ElementType type) const { return elementSet(type).count; }
+
+    // modelViewProjection: 객체 → 클립 공간. result는 원소 수 크기로 다시 만들어짐
+    void select(ElementType type, const QMatrix4x4& modelViewProjection, const QSize& viewport,
+                const SelectionRegion& region, SelectionSet& result) const;
+
+private:
+    struct Block {
+        QVector3D min;
+        QVector3D max;
+    };
+
+    struct ElementSet {
+        QVector<float> x;
+        QVector<float> y;
+        QVector<float> z;
+        QVector<Block> blocks;
+        int count = 0;
+    };
+
+    ElementSet m_vertices;
+    ElementSet m_faces;     // 면 중심
+
+    const ElementSet& elementSet(ElementType type) const { return type == Faces ? m_faces : m_vertices; }
+    static void buildBlocks(ElementSet& set);
+    static void computeBlock(ElementSet& set, int block);
+};
+
+#endif // REGIONSELECTOR_H
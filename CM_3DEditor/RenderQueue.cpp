@@ -0,0 +1,57 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+
+RenderQueue::RenderQueue()
+{
+}
+
+void RenderQueue::clear()
+{
+    // 용량은 유지하여 프레임마다 재할당하지 않음
+    m_items.resize(0);
+    m_materials.resize(0);
+}
+
+int RenderQueue::addMaterial(const RenderMaterial& material)
+{
+    // 프레임당 재질 수는 적으므로 선형 탐색으로 중복 제거
+    for (int i = 0; i < m_materials.size(); ++i) {
+        if (m_materials[i] == material) {
+            return i;
+        }
+    }
+
+    m_materials.append(material);
+    return m_materials.size() - 1;
+}
+
+void RenderQueue::submit(const RenderItem& item)
+{
+    m_items.append(item);
+}
+
+void RenderQueue::sort()
+{
+    std::stable_sort(m_items.begin(), m_items.end(), [](const RenderItem& a, const RenderItem& b) {
+        return a.sortKey < b.sortKey;
+    });
+}
+
+quint64 RenderQueue::makeSortKey(Pass pass, quint32 program, quint32 material, float viewDepth)
+{
+    // 양수 float는 비트 패턴 그대로 정수 비교 순서가 유지됨
+    float depth = qMax(viewDepth, 0.0f);
+    quint32 depthBits = 0;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+    // 반투명은 뒤에서 앞으로 그려야 하므로 반전
+    if (pass == TransparentPass) {
+        depthBits = ~depthBits;
+    }
+
+    return (quint64(pass & 0xF) << 60)
+         | (quint64(program & 0xFFF) << 48)
+         | (quint64(material & 0xFFFF) << 32)
+         | quint64(depthBits);
+}
@@ -0,0 +1,71 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <QVector>
+#include <QVector3D>
+#include <QtGlobal>
+
+class Mesh;
+class Shader;
+class MultiDrawBatch;
+
+// 재질 파라미터 (프레임마다 RenderQueue에 등록되어 인덱스로 정렬 키에 포함)
+struct RenderMaterial {
+    QVector3D color;
+    float pointSize;
+    float shininess;
+
+    bool operator==(const RenderMaterial& other) const {
+        return color == other.color && pointSize == other.pointSize && shininess == other.shininess;
+    }
+};
+
+// 한 번의 드로우 제출
+struct RenderItem {
+    enum Primitive {
+        Triangles,
+        Lines,
+        Points
+    };
+
+    quint64 sortKey;
+    Shader* shader;
+    Mesh* mesh;
+    MultiDrawBatch* batch;  // 설정되면 mesh 대신 간접 멀티 드로우
+    Primitive primitive;
+    int materialIndex;
+    int objectOffset;   // 오브젝트 UBO 링 버퍼 오프셋
+};
+
+// 정렬 키 기반 렌더 큐
+// 키 구성 (상위 → 하위): pass 4비트 | program 12비트 | material 16비트 | depth 32비트
+class RenderQueue
+{
+public:
+    enum Pass {
+        OpaquePass = 0,
+        WireframePass = 1,
+        TransparentPass = 2
+    };
+
+    RenderQueue();
+
+    void clear();
+    int addMaterial(const RenderMaterial& material);
+    void submit(const RenderItem& item);
+    void sort();
+
+    const QVector<RenderItem>& getItems() const { return m_items; }
+    const RenderMaterial& getMaterial(int index) const { return m_materials[index]; }
+    bool isEmpty() const { return m_items.isEmpty(); }
+
+    // 정렬 키 생성 (불투명은 앞→뒤, 반투명은 뒤→앞)
+    static quint64 makeSortKey(Pass pass, quint32 program, quint32 material, float viewDepth);
+    static Pass getPass(quint64 sortKey) { return static_cast<Pass>(sortKey >> 60); }
+
+private:
+    QVector<RenderItem> m_items;
+    QVector<RenderMaterial> m_materials;
+};
+
+#endif // RENDERQUEUE_H
@@ -1,4 +1,6 @@
 #include "Renderer.h"
+#include "ShaderCache.h"
+#include <QOpenGLContext>
 #include <QDebug>
 
 Renderer::Renderer()
@@ -7,16 +9,26 @@ Renderer::Renderer()
     , m_backgroundColor(50, 50, 50, 255)
     , m_wireframeColor(255, 255, 255, 255)
     , m_pointSize(5.0f)
+    , m_shaderFeatures(Shader::DefaultFeatures)
     , m_lightPosition(5, 5, 5)
     , m_lightColor(255, 255, 255, 255)
     , m_mesh(nullptr)
     , m_camera(nullptr)
-    , m_basicShader(nullptr)
-    , m_phongShader(nullptr)
-    , m_wireframeShader(nullptr)
-    , m_pointShader(nullptr)
     , m_customShader(nullptr)
+    , m_multiDrawEnabled(false)
+    , m_occlusionCullingEnabled(false)
+    , m_regionSelectionFaces(true)
+    , m_regionSelectionDirty(false)
+    , m_regionSelectionVisible(false)
+    , m_selectionBuffer(0)
+    , m_selectionTexture(0)
+    , m_contourDirty(false)
+    , m_contourArray(0)
+    , m_contourBuffer(0)
+    , m_viewportWidth(1)
+    , m_viewportHeight(1)
     , m_initialized(false)
+    , m_firstFrameRendered(false)
 {
     m_modelMatrix.setToIdentity();
 }
@@ -30,33 +42,48 @@ void Renderer::initialize()
 {
     if (m_initialized) return;
 
+    m_startupTimer.start();
     initializeOpenGLFunctions();
     
     // OpenGL 설정
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
-    glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    
+    // 블렌딩 등 패스별 상태는 상태 캐시가 관리 (기본: 블렌딩 꺼짐)
+    m_state.initialize();
+    m_profiler.initialize();
     
     // 쉐이더 설정
     setupShaders();
+    setupUniformBuffers();
     
     m_initialized = true;
-    qDebug() << "Renderer initialized successfully";
+    qDebug() << "Renderer initialized in" << m_startupTimer.elapsed() << "ms";
 }
 
 void Renderer::resize(int width, int height)
 {
     if (!m_initialized) return;
     
-    glViewport(0, 0, width, height);
+    setViewportSize(width, height);
     
     if (m_camera) {
         m_camera->setAspectRatio(float(width) / float(height));
     }
 }
 
+void Renderer::setViewportSize(int width, int height)
+{
+    if (!m_initialized) return;
+    
+    m_viewportWidth = width;
+    m_viewportHeight = height;
+    glViewport(0, 0, width, height);
+}
+
 void Renderer::setRenderMode(RenderMode mode)
 {
     m_renderMode = mode;
@@ -92,6 +119,16 @@ void Renderer::setPointSize(float size)
     m_pointSize = size;
 }
 
+void Renderer::setMultiDrawEnabled(bool enabled)
+{
+    m_multiDrawEnabled = enabled;
+}
+
+void Renderer::setOcclusionCullingEnabled(bool enabled)
+{
+    m_occlusionCullingEnabled = enabled;
+}
+
 void Renderer::setMesh(Mesh* mesh)
 {
     m_mesh = mesh;
@@ -111,8 +148,52 @@ void Renderer::render()
 {
     if (!m_initialized || !m_mesh || !m_camera) return;
 
-    clear();
-    renderMesh();
+    // 배치 동기화와 GPU 컬링은 VAO/프로그램을 직접 바꾸므로 상태 캐시 동기화 전에 수행
+    bool multiDraw = false;
+    {
+        FrameProfiler::Scope scope(&m_profiler, "Culling");
+        multiDraw = prepareMultiDraw();
+    }
+    
+    // 외부(QPainter 오버레이 등)에서 바뀌었을 수 있는 상태를 프레임 시작 시 다시 동기화
+    m_state.reset();
+    m_state.resetStats();
+    glViewport(0, 0, m_viewportWidth, m_viewportHeight);
+    
+    {
+        FrameProfiler::Scope scope(&m_profiler, "Clear");
+        clear();
+    }
+    
+    {
+        FrameProfiler::Scope scope(&m_profiler, "Geometry");
+        m_objectUniforms.beginFrame();
+        updateFrameUniforms();
+        
+        updateClipPlanes();
+        
+        m_queue.clear();
+        submitMesh(m_mesh, m_modelMatrix, multiDraw ? &m_multiDrawBatch : nullptr);
+        executeQueue();
+        drawRegionSelection();
+        drawHighlights();
+        drawContours();
+        
+        // 오버레이(QPainter) 쉐이더는 gl_ClipDistance를 쓰지 않음
+        m_state.setClipDistances(0);
+        m_objectUniforms.endFrame();
+    }
+    
+    // 콜드/웜 스타트 비교용: 초기화부터 첫 프레임 제출까지의 시간
+    if (!m_firstFrameRendered) {
+        m_firstFrameRendered = true;
+        qDebug() << "First frame submitted" << m_startupTimer.elapsed() << "ms after initialization"
+                 << "(shader cache hits:" << ShaderCache::hitCount()
+                 << "misses:" << ShaderCache::missCount() << ")";
+        
+        // 첫 프레임 이후 나머지 변형은 백그라운드에서 준비
+        prewarmShaders();
+    }
 }
 
 void Renderer::clear()
@@ -129,114 +210,664 @@ void Renderer::setCustomShader(Shader* shader)
 
 Shader* Renderer::getCurrentShader() const
 {
+    // 아직 생성되지 않은 변형은 fallback 또는 nullptr
     switch (m_shaderType) {
         case Basic:
-            return m_basicShader;
+            return m_shaderLibrary.findShader(Shader::BasicProgram, getActiveFeatures());
         case Phong:
-            return m_phongShader;
+            return m_shaderLibrary.findShader(Shader::PhongProgram, getActiveFeatures());
         case Custom:
             return m_customShader;
         default:
-            return m_basicShader;
+            return m_shaderLibrary.findShader(Shader::BasicProgram, getActiveFeatures());
     }
 }
 
 void Renderer::setupShaders()
 {
-    // 기본 쉐이더들 생성
-    m_basicShader = Shader::createBasicShader();
-    m_phongShader = Shader::createPhongShader();
-    m_wireframeShader = Shader::createWireframeShader();
-    m_pointShader = Shader::createPointShader();
+    QElapsedTimer timer;
+    timer.start();
+    
+    // 백그라운드 컴파일러 준비 후 첫 프레임에 필요한 쉐이더만 생성
+    m_shaderLibrary.initialize(QOpenGLContext::currentContext());
+    selectShader(getActiveFeatures());
     
-    if (!m_basicShader || !m_phongShader || !m_wireframeShader || !m_pointShader) {
-        qDebug() << "Failed to create shaders";
+    qDebug() << "Initial shaders ready in" << timer.elapsed() << "ms"
+             << "(binary cache" << (ShaderCache::isSupported() ? "enabled" : "unsupported") << ")";
+}
+
+Shader::Program Renderer::selectProgram() const
+{
+    // 렌더 모드에 따른 프로그램 선택
+    switch (m_renderMode) {
+        case Wireframe:
+            return Shader::WireframeProgram;
+        case Points:
+            return Shader::PointProgram;
+        case Solid:
+        default:
+            return m_shaderType == Phong ? Shader::PhongProgram : Shader::BasicProgram;
     }
 }
 
-void Renderer::setupLighting(Shader* shader)
+quint32 Renderer::getActiveFeatures() const
 {
-    if (!shader) return;
+    // 클립 평면이 있을 때만 gl_ClipDistance를 쓰는 변형
+    return m_clipPlanes.isEmpty() ? m_shaderFeatures : m_shaderFeatures | Shader::FeatureClipPlanes;
+}
+
+Shader* Renderer::selectShader(quint32 features)
+{
+    if (m_renderMode == Solid && m_shaderType == Custom) return m_customShader;
+    return m_shaderLibrary.getShader(selectProgram(), features);
+}
+
+void Renderer::prewarmShaders()
+{
+    for (int program = 0; program < Shader::ProgramCount; ++program) {
+        m_shaderLibrary.prewarm(static_cast<Shader::Program>(program), getActiveFeatures());
+    }
+}
+
+void Renderer::setupUniformBuffers()
+{
+    m_frameUniforms.create(sizeof(FrameUniforms), FrameBlockBinding);
     
-    shader->setVec3("lightPos", m_lightPosition);
-    shader->setColor("lightColor", m_lightColor);
+    // 프레임당 오브젝트 수 상한 (초과분은 경고 후 건너뜀)
+    m_objectUniforms.create(sizeof(ObjectUniforms), 4096, ObjectBlockBinding);
+}
+
+void Renderer::updateFrameUniforms()
+{
+    if (!m_camera) return;
     
-    if (m_camera) {
-        shader->setVec3("viewPos", m_camera->getPosition());
-    }
+    // 카메라와 조명은 모든 쉐이더가 FrameBlock으로 공유
+    FrameUniforms frame;
+    UniformBuffer::writeMatrix(frame.view, m_camera->getViewMatrix());
+    UniformBuffer::writeMatrix(frame.projection, m_camera->getProjectionMatrix());
+    UniformBuffer::writeMatrix(frame.viewProjection, m_camera->getViewProjectionMatrix());
+    UniformBuffer::writeVector(frame.viewPos, m_camera->getPosition(), 1.0f);
+    UniformBuffer::writeVector(frame.lightPos, m_lightPosition, 1.0f);
+    UniformBuffer::writeColor(frame.lightColor, m_lightColor);
+    
+    m_frameUniforms.update(&frame, sizeof(frame));
+}
+
+int Renderer::pushObjectUniforms(const QMatrix4x4& model)
+{
+    ObjectUniforms object;
+    UniformBuffer::writeMatrix(object.model, model);
+    UniformBuffer::writeNormalMatrix(object.normalMatrix, model);
+    return m_objectUniforms.push(&object);
 }
 
-void Renderer::setupMatrices(Shader* shader)
+bool Renderer::prepareMultiDraw()
 {
-    if (!shader || !m_camera) return;
+    // 포인트 모드와 사용자 쉐이더는 일반 경로로만 그림
+    if (!m_multiDrawEnabled || !m_mesh || !m_mesh->hasData() || m_renderMode == Points
+        || (m_renderMode == Solid && m_shaderType == Custom)) {
+        return false;
+    }
+    
+    if (!m_multiDrawBatch.isInitialized() && !m_multiDrawBatch.initialize()) {
+        qDebug() << "Indirect multi-draw requires OpenGL 4.3; using regular draw path";
+        m_multiDrawBatch.destroy();
+        m_multiDrawEnabled = false;
+        return false;
+    }
+    
+    // 간접 변형이 준비될 때까지는 일반 경로 (fallback 변형은 SSBO를 읽지 않음)
+    quint32 features = getActiveFeatures() | Shader::FeatureIndirect;
+    if (!m_shaderLibrary.isReady(selectProgram(), features)) {
+        selectShader(features);
+        if (!m_shaderLibrary.isReady(selectProgram(), features)) return false;
+    }
+    
+    // 메시가 바뀌었으면 아레나를 다시 채우고, 아니면 변환만 갱신
+    if (!m_multiDrawBatch.containsMesh(m_mesh)) {
+        m_multiDrawBatch.clear();
+        if (!m_multiDrawBatch.addMesh(m_mesh, m_modelMatrix)) {
+            return false;
+        }
+    } else {
+        m_multiDrawBatch.setMeshTransform(m_mesh, m_modelMatrix);
+        m_multiDrawBatch.updateMesh(m_mesh);
+    }
     
-    shader->setMat4("model", m_modelMatrix);
-    shader->setMat4("view", m_camera->getViewMatrix());
-    shader->setMat4("projection", m_camera->getProjectionMatrix());
+    // 와이어프레임은 깊이가 성기므로 가림 컬링 효과가 없음
+    bool occlusion = m_occlusionCullingEnabled && m_renderMode == Solid;
+    m_multiDrawBatch.setOcclusionCullingEnabled(occlusion);
+    
+    QVector4D planes[6];
+    m_camera->getFrustumPlanes(planes);
+    m_multiDrawBatch.cull(planes, m_camera->getViewProjectionMatrix());
+    
+    if (occlusion && !m_multiDrawBatch.isOcclusionCullingEnabled()) {
+        m_occlusionCullingEnabled = false;
+    }
+    return true;
 }
 
-void Renderer::renderMesh()
+void Renderer::submitMesh(Mesh* mesh, const QMatrix4x4& model, MultiDrawBatch* batch)
 {
-    if (!m_mesh) return;
+    if (!mesh || !mesh->hasData()) return;
 
-    Shader* currentShader = nullptr;
+    Shader* shader = selectShader(batch ? getActiveFeatures() | Shader::FeatureIndirect : getActiveFeatures());
+    if (!shader) return;
+    
+    // 오브젝트 데이터는 제출 시점에 링 버퍼에 기록 (업로드는 실행 직전 한 번)
+    // 간접 드로우는 오브젝트 데이터를 SSBO에서 읽음
+    int objectOffset = 0;
+    if (!batch) {
+        objectOffset = pushObjectUniforms(model);
+        if (objectOffset < 0) return;
+    }
     
-    // 렌더 모드에 따른 쉐이더 선택
+    RenderMaterial material;
+    material.color = QVector3D(m_wireframeColor.redF(), m_wireframeColor.greenF(), m_wireframeColor.blueF());
+    material.pointSize = m_pointSize;
+    material.shininess = 32.0f;
+    
+    RenderItem item;
+    item.shader = shader;
+    item.mesh = mesh;
+    item.batch = batch;
+    item.materialIndex = m_queue.addMaterial(material);
+    item.objectOffset = objectOffset;
+    
+    RenderQueue::Pass pass = RenderQueue::OpaquePass;
     switch (m_renderMode) {
         case Solid:
-            currentShader = getCurrentShader();
+            item.primitive = RenderItem::Triangles;
             break;
         case Wireframe:
-            currentShader = m_wireframeShader;
+            item.primitive = RenderItem::Lines;
+            pass = RenderQueue::WireframePass;
             break;
         case Points:
-            currentShader = m_pointShader;
+        default:
+            item.primitive = RenderItem::Points;
             break;
     }
     
-    if (!currentShader) return;
+    // 카메라 기준 깊이 (앞→뒤 정렬용)
+    QVector3D viewCenter = (m_camera->getViewMatrix() * model).map(mesh->getCenter());
+    item.sortKey = RenderQueue::makeSortKey(pass, shader->programId(), item.materialIndex, -viewCenter.z());
     
-    currentShader->use();
+    m_queue.submit(item);
+}
+
+void Renderer::executeQueue()
+{
+    if (m_queue.isEmpty()) return;
     
-    // 행렬 및 조명 설정
-    setupMatrices(currentShader);
-    setupLighting(currentShader);
+    m_queue.sort();
+    m_objectUniforms.flush();
     
-    // 렌더 모드별 설정
-    switch (m_renderMode) {
-        case Solid:
-            // 추가 쉐이더 설정
-            if (m_shaderType == Phong) {
-                currentShader->setFloat("shininess", 32.0f);
-            }
-            m_mesh->render();
+    GLuint lastProgram = 0;
+    int lastMaterial = -1;
+    bool clipped = false;
+    
+    for (const RenderItem& item : m_queue.getItems()) {
+        // 패스별 상태
+        bool transparent = RenderQueue::getPass(item.sortKey) == RenderQueue::TransparentPass;
+        m_state.setBlend(transparent);
+        m_state.setDepthWrite(!transparent);
+        
+        // 프로그램과 재질이 바뀔 때만 재질 uniform 설정
+        GLuint program = item.shader->programId();
+        m_state.useProgram(program);
+        if (program != lastProgram) {
+            // 잘린 단면으로 안쪽 면이 보이도록 뒷면도 그림
+            clipped = applyClipPlanes(item.shader);
+            m_state.setCullFace(!clipped);
+        }
+        if (program != lastProgram || item.materialIndex != lastMaterial) {
+            applyMaterial(item.shader, item.primitive, m_queue.getMaterial(item.materialIndex));
+            lastProgram = program;
+            lastMaterial = item.materialIndex;
+        }
+        
+        if (item.batch) {
+            m_state.setPolygonMode(item.primitive == RenderItem::Lines ? GL_LINE : GL_FILL);
+            item.batch->draw(m_state);
+            continue;
+        }
+        
+        m_state.bindUniformRange(m_objectUniforms.getBindingPoint(), m_objectUniforms.getBufferId(),
+                                 item.objectOffset, m_objectUniforms.getBlockSize());
+        m_state.bindVertexArray(item.mesh->getVertexArrayId());
+        
+        switch (item.primitive) {
+            case RenderItem::Triangles:
+                m_state.setPolygonMode(GL_FILL);
+                drawVisibleFaces(item.mesh);
+                break;
+            case RenderItem::Lines:
+                m_state.setPolygonMode(GL_LINE);
+                drawVisibleFaces(item.mesh);
+                break;
+            case RenderItem::Points:
+                m_state.setPolygonMode(GL_FILL);
+                drawVisiblePoints(item.mesh);
+                break;
+        }
+    }
+    
+    if (clipped) {
+        m_state.setCullFace(true);
+    }
+}
+
+void Renderer::drawVisibleFaces(const Mesh* mesh)
+{
+    // 숨긴 면이 없으면 전체 한 구간
+    const MeshDrawRanges& ranges = mesh->getVisibleFaceRanges();
+    m_state.multiDrawElements(GL_TRIANGLES, ranges.count.constData(), ranges.offset.constData(), ranges.size());
+}
+
+void Renderer::drawVisiblePoints(const Mesh* mesh)
+{
+    const MeshDrawRanges& ranges = mesh->getVisiblePointRanges();
+    m_state.multiDrawArrays(GL_POINTS, ranges.first.constData(), ranges.count.constData(), ranges.size());
+}
+
+void Renderer::applyMaterial(Shader* shader, RenderItem::Primitive primitive, const RenderMaterial& material)
+{
+    switch (primitive) {
+        case RenderItem::Triangles:
+            shader->setFloat("shininess", material.shininess);
             break;
-            
-        case Wireframe:
-            currentShader->setVec3("wireframeColor", 
-                QVector3D(m_wireframeColor.redF(), m_wireframeColor.greenF(), m_wireframeColor.blueF()));
-            m_mesh->renderWireframe();
+        case RenderItem::Lines:
+            shader->setVec3("wireframeColor", material.color);
             break;
-            
-        case Points:
-            currentShader->setFloat("pointSize", m_pointSize);
-            m_mesh->renderPoints();
+        case RenderItem::Points:
+            shader->setFloat("pointSize", material.pointSize);
             break;
     }
+}
+
+bool Renderer::pick(const QPoint& position, int tag)
+{
+    if (!m_initialized || !m_mesh || !m_mesh->hasData() || !m_camera) return false;
+    if (!m_pickBuffer.isCreated() && !m_pickBuffer.create()) return false;
+    if (!m_pickBuffer.canBegin()) return false;
+    
+    Shader* shader = m_shaderLibrary.getShader(Shader::PickProgram, getActiveFeatures() & ~Shader::FeatureIndirect);
+    if (!shader) return false;
     
-    currentShader->release();
+    // 커서 주변 RegionSize 픽셀만 덮는 부분 절두체 (픽셀 크기는 화면과 같음)
+    const double pixelWidth = 2.0 / m_viewportWidth;
+    const double pixelHeight = 2.0 / m_viewportHeight;
+    const double centerX = -1.0 + (position.x() + 0.5) * pixelWidth;
+    const double centerY = 1.0 - (position.y() + 0.5) * pixelHeight;
+    const double halfWidth = PickBuffer::RegionSize * pixelWidth * 0.5;
+    const double halfHeight = PickBuffer::RegionSize * pixelHeight * 0.5;
+    
+    Camera pickCamera = *m_camera;
+    pickCamera.setProjectionWindow(QRectF(centerX - halfWidth, centerY - halfHeight, halfWidth * 2.0, halfHeight * 2.0));
+    
+    // 프레임 uniform은 다음 render()에서 다시 채워지므로 픽 카메라로 덮어써도 됨
+    Camera* camera = m_camera;
+    m_camera = &pickCamera;
+    updateFrameUniforms();
+    m_camera = camera;
+    
+    m_state.reset();
+    m_pickBuffer.begin();
+    
+    m_objectUniforms.beginFrame();
+    int objectOffset = pushObjectUniforms(m_modelMatrix);
+    m_objectUniforms.flush();
+    
+    bool points = m_renderMode == Points;
+    if (objectOffset >= 0) {
+        m_state.useProgram(shader->programId());
+        m_state.bindUniformRange(m_objectUniforms.getBindingPoint(), m_objectUniforms.getBufferId(),
+                                 objectOffset, m_objectUniforms.getBlockSize());
+        m_state.bindVertexArray(m_mesh->getVertexArrayId());
+        m_state.setPolygonMode(GL_FILL);
+        
+        // 잘려 나간 부분은 고르지 않고, 단면 안쪽 면은 고름
+        updateClipPlanes();
+        const bool clipped = applyClipPlanes(shader);
+        m_state.setCullFace(!clipped);
+        
+        // 메시가 하나뿐이므로 오브젝트 ID는 1 (0은 배경)
+        shader->setInt("objectId", 1);
+        shader->setBool("pickPoints", points);
+        shader->setFloat("pointSize", m_pointSize);
+        drawPickGeometry(shader, pickCamera.getViewProjectionMatrix() * m_modelMatrix, points);
+        
+        m_state.setClipDistances(0);
+        m_state.setCullFace(true);
+    }
+    m_objectUniforms.endFrame();
+    
+    PickResult request;
+    request.type = points ? PickResult::Point : PickResult::Face;
+    request.position = position;
+    request.tag = tag;
+    request.meshRevision = m_mesh->getRevision();
+    m_pickBuffer.end(request);
+    
+    glViewport(0, 0, m_viewportWidth, m_viewportHeight);
+    return true;
+}
+
+bool Renderer::pollPick(PickResult& result)
+{
+    return m_pickBuffer.isCreated() && m_pickBuffer.poll(result);
+}
+
+void Renderer::drawPickGeometry(Shader* shader, const QMatrix4x4& viewProjection, bool points)
+{
+    const GLenum mode = points ? GL_POINTS : GL_TRIANGLES;
+    const QVector<MeshCluster>& clusters = m_mesh->getVisibleClusters();
+    
+    // 클러스터가 없거나 (포인트 클라우드 등) 숨긴 정점이 있으면 보이는 정점 구간 전체를 그림
+    if (clusters.isEmpty() || (points && m_mesh->getHiddenVertexCount() > 0)) {
+        shader->setInt("primitiveBase", 0);
+        if (points) {
+            drawVisiblePoints(m_mesh);
+        } else {
+            m_state.drawElements(GL_TRIANGLES, m_mesh->getIndexCount());
+        }
+        return;
+    }
+    
+    // 픽 절두체는 몇 픽셀 폭이므로 대부분의 클러스터가 CPU에서 걸러짐
+    // 인덱스 버퍼에서 이어지는 클러스터는 한 번의 드로우로 합침
+    QVector4D planes[6];
+    Camera::extractFrustumPlanes(viewProjection, planes);
+    
+    int rangeStart = -1;
+    int rangeEnd = -1;
+    auto flushRange = [&]() {
+        if (rangeStart < 0) return;
+        shader->setInt("primitiveBase", rangeStart / 3);
+        m_state.drawElements(mode, rangeEnd - rangeStart, GL_UNSIGNED_INT,
+                             reinterpret_cast<const void*>(qintptr(rangeStart) * sizeof(unsigned int)));
+        rangeStart = -1;
+    };
+    
+    for (const MeshCluster& cluster : clusters) {
+        bool visible = cluster.indexCount > 0;
+        for (int i = 0; i < 6 && visible; ++i) {
+            visible = QVector3D::dotProduct(planes[i].toVector3D(), cluster.center) + planes[i].w() >= -cluster.radius;
+        }
+        if (!visible) continue;
+        
+        if (rangeStart >= 0 && cluster.firstIndex == rangeEnd) {
+            rangeEnd += cluster.indexCount;
+        } else {
+            flushRange();
+            rangeStart = cluster.firstIndex;
+            rangeEnd = cluster.firstIndex + cluster.indexCount;
+        }
+    }
+    flushRange();
+}
+
+void Renderer::drawHighlights()
+{
+    if (!m_hoverHighlight.isValid() && !m_selectionHighlight.isValid()) return;
+    
+    Shader* shader = m_shaderLibrary.getShader(Shader::WireframeProgram, getActiveFeatures() & ~Shader::FeatureIndirect);
+    if (!shader) return;
+    
+    // 선택이 호버보다 위에 그려지도록 나중에
+    drawHighlight(shader, m_hoverHighlight, QColor(255, 170, 0));
+    drawHighlight(shader, m_selectionHighlight, QColor(0, 200, 255));
+}
+
+void Renderer::drawHighlight(Shader* shader, const PickResult& result, const QColor& color)
+{
+    if (!result.isValid() || result.meshRevision != m_mesh->getRevision()) return;
+    
+    // 강조는 대상 프리미티브 하나만 다시 그림
+    const bool point = result.type == PickResult::Point;
+    if (point && result.primitive >= quint32(m_mesh->getVertexCount())) return;
+    if (!point && (result.primitive + 1) * 3 > quint32(m_mesh->getIndexCount())) return;
+    
+    int objectOffset = pushObjectUniforms(m_modelMatrix);
+    if (objectOffset < 0) return;
+    m_objectUniforms.flush();
+    
+    m_state.useProgram(shader->programId());
+    m_state.bindUniformRange(m_objectUniforms.getBindingPoint(), m_objectUniforms.getBufferId(),
+                             objectOffset, m_objectUniforms.getBlockSize());
+    m_state.bindVertexArray(m_mesh->getVertexArrayId());
+    m_state.setPolygonMode(GL_FILL);
+    applyClipPlanes(shader);
+    shader->setVec3("wireframeColor", QVector3D(color.redF(), color.greenF(), color.blueF()));
+    
+    if (point) {
+        // 점은 가려져도 보이도록 깊이 검사 없이 조금 크게
+        shader->setFloat("pointSize", m_pointSize + 4.0f);
+        m_state.setDepthTest(false);
+        m_state.drawArrays(GL_POINTS, GLint(result.primitive), 1);
+        m_state.setDepthTest(true);
+    } else {
+        // 같은 깊이의 원래 면보다 앞에 오도록 폴리곤 오프셋
+        m_state.setCullFace(false);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(-1.0f, -1.0f);
+        m_state.drawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT,
+                             reinterpret_cast<const void*>(qintptr(result.primitive) * 3 * sizeof(unsigned int)));
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        m_state.setCullFace(true);
+    }
+}
+
+void Renderer::setRegionSelection(const SelectionSet& selection, bool faces)
+{
+    // 워드 배열은 암시적 공유라 복사 비용 없음
+    m_regionSelection = selection;
+    m_regionSelectionFaces = faces;
+    m_regionSelectionVisible = selection.hasAny();
+    m_regionSelectionDirty = true;
+}
+
+void Renderer::drawRegionSelection()
+{
+    if (!m_regionSelectionVisible) return;
+    
+    const bool faces = m_regionSelectionFaces;
+    const int elementCount = faces ? m_mesh->getIndexCount() / 3 : m_mesh->getVertexCount();
+    if (m_regionSelection.size() != elementCount) return;
+    
+    Shader* shader = m_shaderLibrary.getShader(Shader::SelectionProgram, getActiveFeatures() & ~Shader::FeatureIndirect);
+    if (!shader) return;
+    
+    if (!m_selectionTexture) {
+        glGenBuffers(1, &m_selectionBuffer);
+        glGenTextures(1, &m_selectionTexture);
+        m_regionSelectionDirty = true;
+    }
+    
+    // 선택이 바뀐 경우에만 다시 올림 (1억 원소 = 12.5 MB)
+    if (m_regionSelectionDirty) {
+        m_regionSelectionDirty = false;
+        
+        GLint maxTexels = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+        const qsizetype texels = qsizetype(m_regionSelection.getWordCount()) * 2;
+        if (texels > maxTexels) {
+            qDebug() << "Selection bitset exceeds texture buffer limit; highlight disabled";
+            m_regionSelectionVisible = false;
+            return;
+        }
+        
+        glBindBuffer(GL_TEXTURE_BUFFER, m_selectionBuffer);
+        glBufferData(GL_TEXTURE_BUFFER, texels * sizeof(GLuint), m_regionSelection.constData(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        
+        glBindTexture(GL_TEXTURE_BUFFER, m_selectionTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_selectionBuffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+    
+    int objectOffset = pushObjectUniforms(m_modelMatrix);
+    if (objectOffset < 0) return;
+    m_objectUniforms.flush();
+    
+    m_state.useProgram(shader->programId());
+    m_state.bindUniformRange(m_objectUniforms.getBindingPoint(), m_objectUniforms.getBufferId(),
+                             objectOffset, m_objectUniforms.getBlockSize());
+    m_state.bindVertexArray(m_mesh->getVertexArrayId());
+    m_state.setPolygonMode(GL_FILL);
+    applyClipPlanes(shader);
+    
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, m_selectionTexture);
+    shader->setInt("selectionBits", 1);
+    shader->setInt("primitiveBase", 0);
+    shader->setBool("selectPoints", !faces);
+    shader->setVec3("selectionColor", QVector3D(1.0f, 0.45f, 0.1f));
+    
+    // 선택되지 않은 원소는 프래그먼트에서 버려지므로 전체를 한 번 더 그림
+    if (faces) {
+        m_state.setCullFace(false);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(-1.0f, -1.0f);
+        // gl_PrimitiveID가 면 번호가 되도록 한 번에 그림 (숨긴 면은 퇴화 삼각형)
+        m_state.drawElements(GL_TRIANGLES, m_mesh->getIndexCount());
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        m_state.setCullFace(true);
+    } else {
+        shader->setFloat("pointSize", m_pointSize + 2.0f);
+        m_state.setDepthTest(false);
+        drawVisiblePoints(m_mesh);
+        m_state.setDepthTest(true);
+    }
+    
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void Renderer::setClipPlanes(const QVector<QVector4D>& planes)
+{
+    m_clipPlanes = planes.mid(0, Shader::MaxClipPlanes);
+}
+
+void Renderer::updateClipPlanes()
+{
+    // 평면은 점과 반대로 역전치 행렬로 옮김 (모델 행렬에 회전/스케일이 있어도 같은 면을 자름)
+    if (m_clipPlanes.isEmpty()) return;
+    
+    const QMatrix4x4 planeMatrix = m_modelMatrix.inverted().transposed();
+    for (int i = 0; i < m_clipPlanes.size(); ++i) {
+        m_worldClipPlanes[i] = planeMatrix * m_clipPlanes[i];
+    }
+}
+
+bool Renderer::applyClipPlanes(Shader* shader)
+{
+    // fallback 변형과 사용자 쉐이더는 gl_ClipDistance를 쓰지 않으므로 클립 거리를 끔
+    if (m_clipPlanes.isEmpty() || !(shader->getFeatures() & Shader::FeatureClipPlanes)) {
+        m_state.setClipDistances(0);
+        return false;
+    }
+    
+    shader->setInt("clipPlaneCount", m_clipPlanes.size());
+    for (int i = 0; i < m_clipPlanes.size(); ++i) {
+        shader->setVec4(QString("clipPlanes[%1]").arg(i), m_worldClipPlanes[i]);
+    }
+    m_state.setClipDistances(m_clipPlanes.size());
+    return true;
+}
+
+void Renderer::setContours(const QVector<SlicePolyline>& polylines)
+{
+    m_contourPoints.clear();
+    for (int kind = 0; kind < 2; ++kind) {
+        m_contourFirsts[kind].clear();
+        m_contourCounts[kind].clear();
+    }
+    
+    // 모든 선을 한 버퍼에 이어 담고 종류별로 한 번의 multi-draw
+    for (const SlicePolyline& polyline : polylines) {
+        if (polyline.points.size() < 2) continue;
+        const int kind = polyline.closed ? 1 : 0;
+        m_contourFirsts[kind].append(m_contourPoints.size());
+        m_contourCounts[kind].append(polyline.points.size());
+        m_contourPoints += polyline.points;
+    }
+    m_contourDirty = true;
+}
+
+void Renderer::drawContours()
+{
+    if (m_contourPoints.isEmpty()) return;
+    
+    // 윤곽선은 클립 평면 위에 있으므로 자르지 않음
+    Shader* shader = m_shaderLibrary.getShader(Shader::WireframeProgram,
+                                               m_shaderFeatures & ~(Shader::FeatureIndirect | Shader::FeatureClipPlanes));
+    if (!shader) return;
+    
+    if (!m_contourArray) {
+        glGenVertexArrays(1, &m_contourArray);
+        glGenBuffers(1, &m_contourBuffer);
+        m_state.bindVertexArray(m_contourArray);
+        glBindBuffer(GL_ARRAY_BUFFER, m_contourBuffer);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(QVector3D), nullptr);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        m_contourDirty = true;
+    }
+    
+    if (m_contourDirty) {
+        m_contourDirty = false;
+        glBindBuffer(GL_ARRAY_BUFFER, m_contourBuffer);
+        glBufferData(GL_ARRAY_BUFFER, m_contourPoints.size() * sizeof(QVector3D), m_contourPoints.constData(),
+                     GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    
+    int objectOffset = pushObjectUniforms(m_modelMatrix);
+    if (objectOffset < 0) return;
+    m_objectUniforms.flush();
+    
+    m_state.useProgram(shader->programId());
+    m_state.bindUniformRange(m_objectUniforms.getBindingPoint(), m_objectUniforms.getBufferId(),
+                             objectOffset, m_objectUniforms.getBlockSize());
+    m_state.bindVertexArray(m_contourArray);
+    m_state.setPolygonMode(GL_FILL);
+    m_state.setClipDistances(0);
+    shader->setVec3("wireframeColor", QVector3D(1.0f, 0.85f, 0.1f));
+    
+    // 잘린 면과 같은 깊이라 깊이 검사 없이 위에 그림
+    m_state.setDepthTest(false);
+    m_state.multiDrawArrays(GL_LINE_STRIP, m_contourFirsts[0].constData(), m_contourCounts[0].constData(),
+                            m_contourCounts[0].size());
+    m_state.multiDrawArrays(GL_LINE_LOOP, m_contourFirsts[1].constData(), m_contourCounts[1].constData(),
+                            m_contourCounts[1].size());
+    m_state.setDepthTest(true);
 }
 
 void Renderer::cleanup()
 {
-    delete m_basicShader;
-    delete m_phongShader;
-    delete m_wireframeShader;
-    delete m_pointShader;
+    m_frameUniforms.destroy();
+    m_objectUniforms.destroy();
+    m_multiDrawBatch.destroy();
+    m_profiler.destroy();
+    m_pickBuffer.destroy();
+    
+    if (m_selectionTexture && QOpenGLContext::currentContext()) {
+        glDeleteTextures(1, &m_selectionTexture);
+        glDeleteBuffers(1, &m_selectionBuffer);
+    }
+    m_selectionTexture = 0;
+    m_selectionBuffer = 0;
+    
+    if (m_contourArray && QOpenGLContext::currentContext()) {
+        glDeleteVertexArrays(1, &m_contourArray);
+        glDeleteBuffers(1, &m_contourBuffer);
+    }
+    m_contourArray = 0;
+    m_contourBuffer = 0;
     
-    m_basicShader = nullptr;
-    m_phongShader = nullptr;
-    m_wireframeShader = nullptr;
-    m_pointShader = nullptr;
+    m_shaderLibrary.cleanup();
     m_customShader = nullptr;
 }
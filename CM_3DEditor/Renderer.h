@@ -1,16 +1,28 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
-#include <QOpenGLFunctions>
+#include <QOpenGLExtraFunctions>
 #include <QOpenGLWidget>
 #include <QMatrix4x4>
 #include <QVector3D>
+#include <QVector4D>
 #include <QColor>
+#include <QElapsedTimer>
 #include "Mesh.h"
 #include "Camera.h"
 #include "Shader.h"
+#include "ShaderLibrary.h"
+#include "UniformBuffer.h"
+#include "UniformRingBuffer.h"
+#include "GLStateCache.h"
+#include "RenderQueue.h"
+#include "MultiDrawBatch.h"
+#include "FrameProfiler.h"
+#include "PickBuffer.h"
+#include "SelectionSet.h"
+#include "MeshSlicer.h"
 
-class Renderer : protected QOpenGLFunctions
+class Renderer : protected QOpenGLExtraFunctions
 {
 public:
     enum RenderMode {
@@ -32,21 +44,39 @@ public:
     void initialize();
     void resize(int width, int height);
     
+    // 카메라 종횡비는 그대로 두고 뷰포트만 변경 (오프스크린 타일 렌더링용)
+    void setViewportSize(int width, int height);
+    int getViewportWidth() const { return m_viewportWidth; }
+    int getViewportHeight() const { return m_viewportHeight; }
+    
     // 렌더링 설정
     void setRenderMode(RenderMode mode);
+    RenderMode getRenderMode() const { return m_renderMode; }
     void setShaderType(ShaderType type);
     void setBackgroundColor(const QColor& color);
     void setLightPosition(const QVector3D& position);
     void setLightColor(const QColor& color);
     void setWireframeColor(const QColor& color);
     void setPointSize(float size);
+    quint32 getShaderFeatures() const { return m_shaderFeatures; }
+    
+    // 간접 멀티 드로우 경로 (GL 4.3 이상에서만 동작, 미지원 시 일반 경로 사용)
+    void setMultiDrawEnabled(bool enabled);
+    bool isMultiDrawEnabled() const { return m_multiDrawEnabled; }
+    
+    // Hi-Z 가림 컬링 (간접 멀티 드로우 + Solid 모드에서만 적용)
+    void setOcclusionCullingEnabled(bool enabled);
+    bool isOcclusionCullingEnabled() const { return m_occlusionCullingEnabled; }
+    const MultiDrawBatch::CullStats& getCullStats() const { return m_multiDrawBatch.getCullStats(); }
     
     // 메시 관리
     void setMesh(Mesh* mesh);
     void setModelMatrix(const QMatrix4x4& matrix);
+    const QMatrix4x4& getModelMatrix() const { return m_modelMatrix; }
     
     // 카메라 설정
     void setCamera(Camera* camera);
+    Camera* getCamera() const { return m_camera; }
     
     // 렌더링
     void render();
@@ -55,6 +85,35 @@ public:
     // 쉐이더 관리
     void setCustomShader(Shader* shader);
     Shader* getCurrentShader() const;
+    ShaderLibrary* getShaderLibrary() { return &m_shaderLibrary; }
+    
+    // 마지막 프레임의 드로우 콜 / 상태 변경 통계
+    const GLStateCache::Stats& getFrameStats() const { return m_state.getStats(); }
+    
+    // 패스별 CPU/GPU 시간 (프레임 경계는 호출자가 beginFrame/endFrame으로 지정)
+    FrameProfiler* getProfiler() { return &m_profiler; }
+    
+    // GPU 픽킹 (화면을 다시 그리지 않고 커서 주변만 ID 버퍼에 그림, 결과는 pollPick으로 비동기 수신)
+    // position은 뷰포트 좌표 (왼쪽 위 기준). readback 슬롯이 모두 사용 중이면 false
+    bool pick(const QPoint& position, int tag);
+    bool pollPick(PickResult& result);
+    bool hasPendingPicks() const { return m_pickBuffer.hasPending(); }
+    
+    // 호버/선택 강조 (메시가 다시 업로드되면 무시됨)
+    void setHoverHighlight(const PickResult& result) { m_hoverHighlight = result; }
+    void setSelectionHighlight(const PickResult& result) { m_selectionHighlight = result; }
+    
+    // 영역 선택 강조 (비트셋을 텍스처 버퍼로 올려 선택된 면/정점만 단색으로 다시 그림)
+    // 크기가 현재 메시의 면/정점 수와 다르면 무시됨. 업로드는 다음 render()에서
+    void setRegionSelection(const SelectionSet& selection, bool faces);
+    
+    // 클립 평면 (모델 공간 (n, d), dot(n, p) + d >= 0인 쪽만 그림, 최대 Shader::MaxClipPlanes개)
+    // 기본 쉐이더는 FeatureClipPlanes 변형으로 바뀌고, 변형이 준비되기 전과 사용자 쉐이더는 자르지 않음
+    void setClipPlanes(const QVector<QVector4D>& planes);
+    const QVector<QVector4D>& getClipPlanes() const { return m_clipPlanes; }
+    
+    // 단면 윤곽선 (모델 공간, 자르지 않고 메시 위에 그림). 업로드는 다음 render()에서
+    void setContours(const QVector<SlicePolyline>& polylines);
 
 private:
     // 렌더링 상태
@@ -63,6 +122,7 @@ private:
     QColor m_backgroundColor;
     QColor m_wireframeColor;
     float m_pointSize;
+    quint32 m_shaderFeatures;
     
     // 조명 설정
     QVector3D m_lightPosition;
@@ -73,21 +133,82 @@ private:
     Camera* m_camera;
     QMatrix4x4 m_modelMatrix;
     
-    // 쉐이더들
-    Shader* m_basicShader;
-    Shader* m_phongShader;
-    Shader* m_wireframeShader;
-    Shader* m_pointShader;
+    // 기본 쉐이더 변형 (첫 프레임 이후 백그라운드에서 미리 컴파일)
+    ShaderLibrary m_shaderLibrary;
     Shader* m_customShader;
     
+    // 공유 uniform 버퍼 (카메라/조명은 프레임당 1회, 오브젝트별 데이터는 링 버퍼)
+    UniformBuffer m_frameUniforms;
+    UniformRingBuffer m_objectUniforms;
+    
+    // 렌더 큐와 GL 상태 캐시
+    RenderQueue m_queue;
+    GLStateCache m_state;
+    
+    // 클러스터 단위 GPU 컬링 + 간접 멀티 드로우
+    MultiDrawBatch m_multiDrawBatch;
+    bool m_multiDrawEnabled;
+    bool m_occlusionCullingEnabled;
+    
+    // 프로파일링
+    FrameProfiler m_profiler;
+    
+    // 픽킹과 강조
+    PickBuffer m_pickBuffer;
+    PickResult m_hoverHighlight;
+    PickResult m_selectionHighlight;
+    
+    // 영역 선택 (텍스처 버퍼는 처음 사용할 때 생성)
+    SelectionSet m_regionSelection;
+    bool m_regionSelectionFaces;
+    bool m_regionSelectionDirty;
+    bool m_regionSelectionVisible;
+    GLuint m_selectionBuffer;
+    GLuint m_selectionTexture;
+    
+    // 클립 평면 (월드 공간 평면은 프레임마다 모델 행렬로 변환)
+    QVector<QVector4D> m_clipPlanes;
+    QVector4D m_worldClipPlanes[Shader::MaxClipPlanes];
+    
+    // 단면 윤곽선 (열린 선은 line strip, 닫힌 선은 line loop, 버퍼는 처음 사용할 때 생성)
+    QVector<QVector3D> m_contourPoints;
+    QVector<GLint> m_contourFirsts[2];
+    QVector<GLsizei> m_contourCounts[2];
+    bool m_contourDirty;
+    GLuint m_contourArray;
+    GLuint m_contourBuffer;
+    
     // OpenGL 상태
+    int m_viewportWidth;
+    int m_viewportHeight;
     bool m_initialized;
     
+    // 시작 시간 측정 (초기화 → 첫 프레임)
+    QElapsedTimer m_startupTimer;
+    bool m_firstFrameRendered;
+    
     // 헬퍼 함수들
     void setupShaders();
-    void setupLighting(Shader* shader);
-    void setupMatrices(Shader* shader);
-    void renderMesh();
+    Shader::Program selectProgram() const;
+    quint32 getActiveFeatures() const;
+    Shader* selectShader(quint32 features);
+    void prewarmShaders();
+    void setupUniformBuffers();
+    void updateFrameUniforms();
+    int pushObjectUniforms(const QMatrix4x4& model);
+    void submitMesh(Mesh* mesh, const QMatrix4x4& model, MultiDrawBatch* batch = nullptr);
+    bool prepareMultiDraw();
+    void executeQueue();
+    void applyMaterial(Shader* shader, RenderItem::Primitive primitive, const RenderMaterial& material);
+    void drawPickGeometry(Shader* shader, const QMatrix4x4& viewProjection, bool points);
+    void drawHighlights();
+    void drawHighlight(Shader* shader, const PickResult& result, const QColor& color);
+    void drawRegionSelection();
+    void updateClipPlanes();
+    bool applyClipPlanes(Shader* shader);
+    void drawContours();
+    void drawVisibleFaces(const Mesh* mesh);
+    void drawVisiblePoints(const Mesh* mesh);
     void cleanup();
 };
 
@@ -0,0 +1,246 @@
+#include "SculptBrush.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+    // 한 번 찍을 때 최대 이동량 (반지름 대비)
+    const float DabDepth = 0.1f;
+
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 4096;
+
+    // 중심에서 멀어질수록 부드럽게 0이 되는 감쇠 (t = 거리 / 반지름)
+    inline float falloff(float distanceSquared, float radiusSquared)
+    {
+        float t = distanceSquared / radiusSquared;
+        if (t >= 1.0f) return 0.0f;
+        float s = 1.0f - t;
+        return s * s;
+    }
+}
+
+SculptBrush::SculptBrush() : m_stamp(0)
+{
+}
+
+bool SculptBrush::build(const QVector<unsigned int>& indices, int vertexCount, const std::atomic_bool* cancel)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_vertexTriangleStart.clear();
+    m_vertexTriangles.clear();
+
+    const int triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) return false;
+
+    // 정점별 삼각형 수 → 누적 → 채우기 (CSR)
+    QVector<int> start(vertexCount + 1, 0);
+    const unsigned int* indexData = indices.constData();
+    for (int i = 0; i < triangleCount * 3; ++i) {
+        ++start[indexData[i] + 1];
+    }
+    for (int v = 0; v < vertexCount; ++v) {
+        start[v + 1] += start[v];
+    }
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    QVector<int> adjacency(triangleCount * 3);
+    QVector<int> cursor = start;
+    for (int t = 0; t < triangleCount; ++t) {
+        adjacency[cursor[indexData[t * 3]]++] = t;
+        adjacency[cursor[indexData[t * 3 + 1]]++] = t;
+        adjacency[cursor[indexData[t * 3 + 2]]++] = t;
+    }
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    m_vertexTriangleStart.swap(start);
+    m_vertexTriangles.swap(adjacency);
+    m_vertexStamp.fill(0, vertexCount);
+    m_triangleStamp.fill(0, triangleCount);
+    m_stamp = 0;
+
+    qDebug() << "Sculpt adjacency built:" << vertexCount << "vertices," << triangleCount << "triangles in"
+             << timer.elapsed() << "ms";
+    return true;
+}
+
+quint32 SculptBrush::nextStamp()
+{
+    // 세대 번호가 한 바퀴 돌면 표시를 한 번 지움
+    if (++m_stamp == 0) {
+        m_vertexStamp.fill(0);
+        m_triangleStamp.fill(0);
+        m_stamp = 1;
+    }
+    return m_stamp;
+}
+
+bool SculptBrush::apply(VertexData* vertices, const unsigned int* indices, const QVector3D& center, quint32 hitTriangle,
+                        const BrushSettings& settings, BrushResult& result)
+{
+    result.movedVertices.clear();
+    result.vertices.clear();
+    result.triangles.clear();
+    result.previousPositions.clear();
+    result.previousNormals.clear();
+    if (isEmpty() || int(hitTriangle) >= m_triangleStamp.size() || settings.radius <= 0.0f) return false;
+
+    const int* adjacencyStart = m_vertexTriangleStart.constData();
+    const int* adjacency = m_vertexTriangles.constData();
+    const float radiusSquared = settings.radius * settings.radius;
+
+    // 1) 맞은 삼각형에서 시작해 반지름 안의 연결된 정점을 너비 우선으로 모음
+    //    (반지름 밖으로 나간 면을 건너 다시 들어오는 영역은 포함하지 않음)
+    quint32 stamp = nextStamp();
+    m_region.clear();
+    for (int corner = 0; corner < 3; ++corner) {
+        int v = int(indices[hitTriangle * 3 + corner]);
+        if (m_vertexStamp[v] != stamp) {
+            m_vertexStamp[v] = stamp;
+            m_region.append(v);
+        }
+    }
+    for (int i = 0; i < m_region.size(); ++i) {
+        int v = m_region[i];
+        for (int a = adjacencyStart[v]; a < adjacencyStart[v + 1]; ++a) {
+            const unsigned int* triangle = indices + qsizetype(adjacency[a]) * 3;
+            for (int corner = 0; corner < 3; ++corner) {
+                int n = int(triangle[corner]);
+                if (m_vertexStamp[n] == stamp) continue;
+                if ((vertices[n].position - center).lengthSquared() > radiusSquared) continue;
+                m_vertexStamp[n] = stamp;
+                m_region.append(n);
+            }
+        }
+    }
+
+    // 2) 감쇠 가중치 (맞은 삼각형의 꼭짓점이 반지름 밖이면 가중치 0)
+    const int regionSize = m_region.size();
+    m_weights.resize(regionSize);
+    m_targets.resize(regionSize);
+    const int* region = m_region.constData();
+    float* weights = m_weights.data();
+    QVector3D* targets = m_targets.data();
+
+    QVector3D brushNormal;
+    for (int i = 0; i < regionSize; ++i) {
+        const VertexData& vertex = vertices[region[i]];
+        weights[i] = falloff((vertex.position - center).lengthSquared(), radiusSquared) * settings.strength;
+        brushNormal += vertex.normal * weights[i];
+    }
+    brushNormal.normalize();
+
+    // 3) 새 위치 계산 (모두 계산한 뒤 쓰므로 Smooth가 이미 옮긴 이웃을 읽지 않음)
+    const float depth = settings.radius * DabDepth * (settings.invert ? -1.0f : 1.0f);
+    Parallel::parallelFor(regionSize, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            const int v = region[i];
+            const QVector3D& position = vertices[v].position;
+            switch (settings.mode) {
+                case BrushSettings::Draw:
+                    targets[i] = position + brushNormal * (depth * weights[i]);
+                    break;
+                case BrushSettings::Inflate:
+                    targets[i] = position + vertices[v].normal * (depth * weights[i]);
+                    break;
+                case BrushSettings::Smooth: {
+                    // 인접 삼각형의 다른 두 정점 평균 (공유 변은 두 번 세어 가중치가 됨)
+                    QVector3D sum;
+                    int count = 0;
+                    for (int a = adjacencyStart[v]; a < adjacencyStart[v + 1]; ++a) {
+                        const unsigned int* triangle = indices + qsizetype(adjacency[a]) * 3;
+                        for (int corner = 0; corner < 3; ++corner) {
+                            if (int(triangle[corner]) == v) continue;
+                            sum += vertices[triangle[corner]].position;
+                            ++count;
+                        }
+                    }
+                    targets[i] = count > 0 ? position + (sum / float(count) - position) * weights[i] : position;
+                    break;
+                }
+            }
+        }
+    });
+
+    for (int i = 0; i < regionSize; ++i) {
+        if (weights[i] > 0.0f) {
+            result.movedVertices.append(region[i]);
+        }
+    }
+    if (result.movedVertices.isEmpty()) return false;
+
+    // 4) 움직일 정점에 닿은 삼각형과, 그 삼각형의 정점(= 한 고리 이웃)이 법선 갱신 대상
+    //    (연결 관계만 보므로 쓰기 전에 모아 두고 원래 값을 남김)
+    stamp = nextStamp();
+    for (int v : result.movedVertices) {
+        for (int a = adjacencyStart[v]; a < adjacencyStart[v + 1]; ++a) {
+            int t = adjacency[a];
+            if (m_triangleStamp[t] == stamp) continue;
+            m_triangleStamp[t] = stamp;
+            result.triangles.append(t);
+            for (int corner = 0; corner < 3; ++corner) {
+                int n = int(indices[qsizetype(t) * 3 + corner]);
+                if (m_vertexStamp[n] == stamp) continue;
+                m_vertexStamp[n] = stamp;
+                result.vertices.append(n);
+            }
+        }
+    }
+
+    // 업로드 구간 병합과 이진 탐색을 위해 정렬
+    std::sort(result.movedVertices.begin(), result.movedVertices.end());
+    std::sort(result.vertices.begin(), result.vertices.end());
+    std::sort(result.triangles.begin(), result.triangles.end());
+
+    result.previousPositions.resize(result.vertices.size());
+    result.previousNormals.resize(result.vertices.size());
+    for (int i = 0; i < result.vertices.size(); ++i) {
+        const VertexData& vertex = vertices[result.vertices[i]];
+        result.previousPositions[i] = vertex.position;
+        result.previousNormals[i] = vertex.normal;
+    }
+
+    for (int i = 0; i < regionSize; ++i) {
+        if (weights[i] > 0.0f) {
+            vertices[region[i]].position = targets[i];
+        }
+    }
+
+    // 5) 면적 가중 면 법선의 합으로 정점 법선 재계산
+    const int* normalVertices = result.vertices.constData();
+    Parallel::parallelFor(result.vertices.size(), ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            const int v = normalVertices[i];
+            QVector3D normal;
+            for (int a = adjacencyStart[v]; a < adjacencyStart[v + 1]; ++a) {
+                const unsigned int* triangle = indices + qsizetype(adjacency[a]) * 3;
+                const QVector3D& p0 = vertices[triangle[0]].position;
+                normal += QVector3D::crossProduct(vertices[triangle[1]].position - p0,
+                                                  vertices[triangle[2]].position - p0);
+            }
+            vertices[v].normal = normal.normalized();
+        }
+    });
+    return true;
+}
+
+void SculptBrush::collectTriangles(const QVector<int>& vertices, QVector<int>& triangles)
+{
+    triangles.clear();
+    if (isEmpty()) return;
+
+    const quint32 stamp = nextStamp();
+    for (int v : vertices) {
+        if (v < 0 || v + 1 >= m_vertexTriangleStart.size()) continue;
+        for (int a = m_vertexTriangleStart[v]; a < m_vertexTriangleStart[v + 1]; ++a) {
+            int t = m_vertexTriangles[a];
+            if (m_triangleStamp[t] == stamp) continue;
+            m_triangleStamp[t] = stamp;
+            triangles.append(t);
+        }
+    }
+    std::sort(triangles.begin(), triangles.end());
+}
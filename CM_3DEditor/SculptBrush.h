@@ -0,0 +1,73 @@
+#ifndef SCULPTBRUSH_H
+#define SCULPTBRUSH_H
+
+#include <QVector>
+#include <QVector3D>
+#include <atomic>
+#include "Mesh.h"
+
+// 브러시 설정 (반지름은 객체 공간 단위)
+struct BrushSettings {
+    enum Mode {
+        Draw,           // 브러시 영역의 평균 법선 방향으로 밀어냄
+        Inflate,        // 정점마다 자기 법선 방향으로 부풀림
+        Smooth          // 이웃 평균 위치로 당김
+    };
+
+    Mode mode = Draw;
+    float radius = 0.05f;
+    float strength = 0.5f;      // 0~1
+    bool invert = false;        // Draw/Inflate 방향 반전
+};
+
+// 브러시를 한 번 찍었을 때(dab) 바뀐 원소 (모두 오름차순)
+struct BrushResult {
+    QVector<int> movedVertices;     // 위치가 바뀐 정점
+    QVector<int> vertices;          // 위치나 법선이 바뀐 정점 (movedVertices + 한 고리 이웃)
+    QVector<int> triangles;         // 모양이 바뀐 삼각형
+    
+    // vertices와 같은 순서의 적용 전 값 (되돌리기 기록용)
+    QVector<QVector3D> previousPositions;
+    QVector<QVector3D> previousNormals;
+
+    bool isEmpty() const { return movedVertices.isEmpty(); }
+};
+
+// 메시 정점을 반지름 안에서 변형하는 스컬프트 브러시
+// 정점 → 삼각형 인접 목록(CSR)으로 맞은 삼각형에서부터 반지름 안의 정점만 훑어 모으므로
+// 공간 색인을 유지할 필요가 없고, 비용은 메시 크기가 아니라 브러시가 덮는 정점 수에 비례
+class SculptBrush
+{
+public:
+    SculptBrush();
+
+    // 인접 목록 구축 (GL 호출 없음, 스레드 안전). cancel이 설정되면 중단하고 false 반환
+    bool build(const QVector<unsigned int>& indices, int vertexCount, const std::atomic_bool* cancel = nullptr);
+    bool isEmpty() const { return m_vertexTriangleStart.isEmpty(); }
+
+    // center(hitTriangle 위의 점)를 중심으로 브러시 적용
+    // 움직인 정점과 그 한 고리 이웃의 법선만 다시 계산. 바뀐 것이 없으면 false
+    bool apply(VertexData* vertices, const unsigned int* indices, const QVector3D& center, quint32 hitTriangle,
+               const BrushSettings& settings, BrushResult& result);
+    
+    // 정점(오름차순)에 닿은 삼각형을 오름차순으로 모음
+    void collectTriangles(const QVector<int>& vertices, QVector<int>& triangles);
+
+private:
+    QVector<int> m_vertexTriangleStart;     // 정점 수 + 1
+    QVector<int> m_vertexTriangles;
+
+    // 방문 표시 (적용마다 세대를 올려 배열을 지우지 않음)
+    QVector<quint32> m_vertexStamp;
+    QVector<quint32> m_triangleStamp;
+    quint32 m_stamp;
+
+    // 적용마다 다시 쓰는 작업 버퍼
+    QVector<int> m_region;
+    QVector<float> m_weights;
+    QVector<QVector3D> m_targets;
+
+    quint32 nextStamp();
+};
+
+#endif // SCULPTBRUSH_H
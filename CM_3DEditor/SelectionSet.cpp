@@ -0,0 +1,132 @@
+#include "SelectionSet.h"
+#include "Parallel.h"
+#include <QtAlgorithms>
+#include <atomic>
+
+namespace {
+    // 이보다 작은 집합은 한 스레드로 처리 (워드 수)
+    const qsizetype ParallelWords = 1 << 15;
+}
+
+SelectionSet::SelectionSet() : m_size(0)
+{
+}
+
+SelectionSet::SelectionSet(int size) : m_size(0)
+{
+    resize(size);
+}
+
+void SelectionSet::resize(int size)
+{
+    m_size = qMax(size, 0);
+    m_words.fill(0, (m_size + 63) / 64);
+}
+
+void SelectionSet::clear()
+{
+    m_words.fill(0);
+}
+
+void SelectionSet::fill()
+{
+    m_words.fill(~quint64(0));
+    clearTail();
+}
+
+int SelectionSet::count() const
+{
+    const quint64* words = m_words.constData();
+    std::atomic<qint64> total(0);
+    Parallel::parallelFor(m_words.size(), ParallelWords, [&](qsizetype begin, qsizetype end) {
+        qint64 sum = 0;
+        for (qsizetype i = begin; i < end; ++i) {
+            sum += qPopulationCount(words[i]);
+        }
+        total += sum;
+    });
+    return int(total.load());
+}
+
+bool SelectionSet::hasAny() const
+{
+    for (quint64 word : m_words) {
+        if (word) return true;
+    }
+    return false;
+}
+
+bool SelectionSet::unite(const SelectionSet& other)
+{
+    if (other.m_size != m_size) return false;
+
+    quint64* words = m_words.data();
+    const quint64* source = other.m_words.constData();
+    Parallel::parallelFor(m_words.size(), ParallelWords, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            words[i] |= source[i];
+        }
+    });
+    return true;
+}
+
+bool SelectionSet::intersect(const SelectionSet& other)
+{
+    if (other.m_size != m_size) return false;
+
+    quint64* words = m_words.data();
+    const quint64* source = other.m_words.constData();
+    Parallel::parallelFor(m_words.size(), ParallelWords, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            words[i] &= source[i];
+        }
+    });
+    return true;
+}
+
+bool SelectionSet::subtract(const SelectionSet& other)
+{
+    if (other.m_size != m_size) return false;
+
+    quint64* words = m_words.data();
+    const quint64* source = other.m_words.constData();
+    Parallel::parallelFor(m_words.size(), ParallelWords, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            words[i] &= ~source[i];
+        }
+    });
+    return true;
+}
+
+void SelectionSet::invert()
+{
+    quint64* words = m_words.data();
+    Parallel::parallelFor(m_words.size(), ParallelWords, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            words[i] = ~words[i];
+        }
+    });
+    clearTail();
+}
+
+QVector<int> SelectionSet::toIndices() const
+{
+    QVector<int> indices;
+    indices.reserve(count());
+    for (int w = 0; w < m_words.size(); ++w) {
+        quint64 word = m_words[w];
+        while (word) {
+            indices.append(w * 64 + qCountTrailingZeroBits(word));
+            word &= word - 1;
+        }
+    }
+    return indices;
+}
+
+void SelectionSet::clearTail()
+{
+    // 크기를 넘는 비트는 count()/hasAny()에 잡히지 않도록 항상 0
+    if (m_size % 64 != 0 && !m_words.isEmpty()) {
+        m_words.last() &= (quint64(1) << (m_size % 64)) - 1;
+    }
+}
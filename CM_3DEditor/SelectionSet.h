@@ -0,0 +1,49 @@
+#ifndef SELECTIONSET_H
+#define SELECTIONSET_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 원소(정점/면)별 선택 여부를 64비트 워드에 담는 비트셋
+// 집합 연산은 워드 단위로 처리하고, 큰 집합은 스레드 풀로 나누어 처리
+class SelectionSet
+{
+public:
+    SelectionSet();
+    explicit SelectionSet(int size);
+
+    // 크기를 바꾸고 모두 해제
+    void resize(int size);
+    int size() const { return m_size; }
+
+    bool test(int index) const { return (m_words[index >> 6] >> (index & 63)) & 1u; }
+    void set(int index) { m_words[index >> 6] |= quint64(1) << (index & 63); }
+    void reset(int index) { m_words[index >> 6] &= ~(quint64(1) << (index & 63)); }
+
+    void clear();           // 모두 해제 (크기 유지)
+    void fill();            // 모두 선택
+    int count() const;      // 선택된 원소 수
+    bool hasAny() const;
+
+    // 같은 크기의 집합끼리만 연산 (크기가 다르면 무시하고 false)
+    bool unite(const SelectionSet& other);
+    bool intersect(const SelectionSet& other);
+    bool subtract(const SelectionSet& other);
+    void invert();
+
+    // 워드 배열 (원소 i는 워드 i/64의 i%64번째 비트, 마지막 워드의 남는 비트는 항상 0)
+    int getWordCount() const { return m_words.size(); }
+    quint64* data() { return m_words.data(); }
+    const quint64* constData() const { return m_words.constData(); }
+
+    // 선택된 원소 번호 목록 (오름차순)
+    QVector<int> toIndices() const;
+
+private:
+    QVector<quint64> m_words;
+    int m_size;
+
+    void clearTail();
+};
+
+#endif // SELECTIONSET_H
@@ -0,0 +1,332 @@
+#include "SequenceExporter.h"
+#include "Renderer.h"
+#include <QtConcurrent>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QDebug>
+#include <cstring>
+
+SequenceExporter::SequenceExporter(QObject* parent)
+    : QObject(parent)
+    , m_active(false)
+    , m_cancelled(false)
+    , m_nextFrame(0)
+    , m_submittedCount(0)
+    , m_failedCount(0)
+    , m_framebuffer(nullptr)
+    , m_resolveFramebuffer(nullptr)
+    , m_nextSlot(0)
+    , m_maxQueuedEncodes(2)
+    , m_encodedCount(0)
+{
+    connect(&m_finishWatcher, &QFutureWatcher<int>::finished, this, [this]() {
+        m_failedCount += m_finishWatcher.result();
+        m_encodedCount = m_submittedCount;
+        m_active = false;
+
+        qDebug() << "Exported" << m_submittedCount - m_failedCount << "of" << m_options.frameCount
+                 << "frames to" << m_options.directory;
+        emit progress(m_encodedCount, m_options.frameCount);
+        emit finished(m_options.directory, !m_cancelled && m_failedCount == 0);
+    });
+}
+
+SequenceExporter::~SequenceExporter()
+{
+    m_pool.waitForDone();
+    releaseResources();
+}
+
+bool SequenceExporter::begin(Renderer* renderer, const Options& options)
+{
+    if (m_active || !renderer || !renderer->getCamera()) return false;
+    if (!QOpenGLContext::currentContext()) return false;
+    if (options.size.isEmpty() || options.frameCount <= 0) return false;
+
+    if (options.pathType == Keyframes && options.path.getKeyframeCount() < 2) {
+        qDebug() << "Camera path export needs at least two keyframes";
+        return false;
+    }
+    if (!QDir().mkpath(options.directory)) {
+        qDebug() << "Cannot create export directory:" << options.directory;
+        return false;
+    }
+
+    initializeOpenGLFunctions();
+
+    GLint maxRenderbufferSize = 0;
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbufferSize);
+    if (options.size.width() > maxRenderbufferSize || options.size.height() > maxRenderbufferSize) {
+        qDebug() << "Export size" << options.size << "exceeds the renderbuffer limit" << maxRenderbufferSize;
+        return false;
+    }
+
+    QOpenGLFramebufferObjectFormat framebufferFormat;
+    framebufferFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    framebufferFormat.setSamples(options.samples);
+    m_framebuffer = new QOpenGLFramebufferObject(options.size, framebufferFormat);
+    m_resolveFramebuffer = new QOpenGLFramebufferObject(options.size);
+    if (!m_framebuffer->isValid() || !m_resolveFramebuffer->isValid()) {
+        qDebug() << "Failed to create export framebuffer" << options.size;
+        releaseResources();
+        return false;
+    }
+
+    GLsizeiptr slotSize = GLsizeiptr(options.size.width()) * options.size.height() * 4;
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        glGenBuffers(1, &m_slots[i].buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_slots[i].buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, slotSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_options = options;
+    m_startCamera = *renderer->getCamera();
+    m_startCamera.setAspectRatio(float(options.size.width()) / float(options.size.height()));
+    m_camera = m_startCamera;
+    m_modelMatrix = renderer->getModelMatrix();
+
+    // 인코딩 대기 프레임은 작업 스레드 수의 두 배까지만 (그 이상이면 렌더링을 멈춤)
+    m_pool.setMaxThreadCount(options.threads > 0 ? options.threads : QThread::idealThreadCount());
+    m_maxQueuedEncodes = qMax(2, m_pool.maxThreadCount() * 2);
+
+    m_nextFrame = 0;
+    m_submittedCount = 0;
+    m_encodedCount = 0;
+    m_failedCount = 0;
+    m_nextSlot = 0;
+    m_cancelled = false;
+    m_encodes.clear();
+    m_active = true;
+
+    qDebug() << "Exporting" << options.frameCount << "frames of" << options.size << "to" << options.directory;
+    return true;
+}
+
+bool SequenceExporter::step(Renderer* renderer, int timeBudgetMs)
+{
+    if (!m_active || !m_framebuffer) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 끝난 readback을 제출 순서대로 대기 없이 회수
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        if (!retire(m_slots[(m_nextSlot + i) % ReadbackSlots], false)) break;
+    }
+
+    if (m_nextFrame < m_options.frameCount && !m_cancelled) {
+        Camera* previousCamera = renderer->getCamera();
+        QMatrix4x4 previousModel = renderer->getModelMatrix();
+        int previousWidth = renderer->getViewportWidth();
+        int previousHeight = renderer->getViewportHeight();
+
+        renderer->setCamera(&m_camera);
+        renderer->setModelMatrix(m_modelMatrix);
+        renderer->setViewportSize(m_options.size.width(), m_options.size.height());
+
+        while (m_nextFrame < m_options.frameCount) {
+            // 링이 가득 차면 가장 오래된 readback을 기다림 (인코딩 큐가 가득 차 있으면 그것도 기다림)
+            ReadbackSlot& slot = m_slots[m_nextSlot];
+            retire(slot, true);
+
+            updateCamera(m_nextFrame);
+            renderFrame(renderer, m_nextFrame);
+            readFrame(slot, m_nextFrame);
+            ++m_nextFrame;
+            m_nextSlot = (m_nextSlot + 1) % ReadbackSlots;
+
+            if (timer.elapsed() >= timeBudgetMs) break;
+        }
+
+        renderer->setCamera(previousCamera);
+        renderer->setModelMatrix(previousModel);
+        renderer->setViewportSize(previousWidth, previousHeight);
+    }
+
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        if (m_slots[i].frame >= 0) return true;
+    }
+    if (m_nextFrame < m_options.frameCount && !m_cancelled) return true;
+
+    // 모든 프레임을 넘겼으면 GL 리소스를 놓고 남은 인코딩 완료를 기다림
+    releaseResources();
+    startFinish();
+    return false;
+}
+
+void SequenceExporter::cancel()
+{
+    // 다음 step()에서 진행 중인 readback만 회수하고 마무리
+    if (m_active) {
+        m_cancelled = true;
+    }
+}
+
+QString SequenceExporter::getFramePath(int frame) const
+{
+    QString name = QString("frame_%1.%2").arg(frame, 4, 10, QChar('0')).arg(m_options.format);
+    return QDir(m_options.directory).filePath(name);
+}
+
+void SequenceExporter::updateCamera(int frame)
+{
+    if (m_options.pathType == Turntable) {
+        // 마지막 프레임이 첫 프레임과 겹치지 않도록 360/N 간격
+        CameraPath::orbit(m_startCamera, 360.0f * float(frame) / float(m_options.frameCount), m_camera);
+    } else {
+        float t = m_options.frameCount > 1 ? float(frame) / float(m_options.frameCount - 1) : 0.0f;
+        m_options.path.evaluate(t, m_camera);
+    }
+}
+
+void SequenceExporter::renderFrame(Renderer* renderer, int frame)
+{
+    Q_UNUSED(frame);
+
+    m_framebuffer->bind();
+    renderer->render();
+
+    // 멀티샘플 해결
+    QOpenGLFramebufferObject::blitFramebuffer(m_resolveFramebuffer, m_framebuffer);
+}
+
+void SequenceExporter::readFrame(ReadbackSlot& slot, int frame)
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_resolveFramebuffer->handle());
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, m_options.size.width(), m_options.size.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = frame;
+}
+
+bool SequenceExporter::retire(ReadbackSlot& slot, bool wait)
+{
+    if (slot.frame < 0) return true;
+
+    // 인코딩 큐가 가득 찼으면 회수를 미룸 (렌더링도 링이 빌 때까지 멈춤)
+    collectEncodes(false);
+    if (m_encodes.size() >= m_maxQueuedEncodes) {
+        if (!wait) return false;
+        collectEncodes(true);
+    }
+
+    GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        if (!wait) return false;
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    const int frame = slot.frame;
+    const int width = m_options.size.width();
+    const int height = m_options.size.height();
+    const int rowBytes = width * 4;
+
+    // 매핑 중 복사하면서 GL의 아래쪽 기준 행을 뒤집음
+    QImage image(m_options.size, QImage::Format_RGBA8888);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const uchar* mapped = static_cast<const uchar*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(rowBytes) * height, GL_MAP_READ_BIT));
+    if (mapped && !image.isNull()) {
+        for (int row = 0; row < height; ++row) {
+            std::memcpy(image.scanLine(row), mapped + qsizetype(height - 1 - row) * rowBytes, rowBytes);
+        }
+    } else {
+        qDebug() << "Failed to read back export frame" << frame;
+        image = QImage();
+    }
+    if (mapped) {
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.frame = -1;
+
+    if (image.isNull()) {
+        ++m_failedCount;
+        return true;
+    }
+
+    // 압축은 작업 스레드에서 병렬로 (이미지는 이동해 복사 없이 넘김)
+    QString path = getFramePath(frame);
+    QByteArray format = m_options.format.toLatin1();
+    m_encodes.append(QtConcurrent::run(&m_pool, [image = std::move(image), path, format]() mutable {
+        // 화면과 같이 불투명으로 저장 (블렌딩으로 알파가 1보다 작아질 수 있음)
+        for (int row = 0; row < image.height(); ++row) {
+            uchar* line = image.scanLine(row);
+            for (int x = 3; x < image.width() * 4; x += 4) {
+                line[x] = 255;
+            }
+        }
+        bool saved = image.save(path, format.constData());
+        if (!saved) {
+            qDebug() << "Failed to encode frame:" << path;
+        }
+        return saved;
+    }));
+    ++m_submittedCount;
+    return true;
+}
+
+void SequenceExporter::collectEncodes(bool waitOldest)
+{
+    if (waitOldest && !m_encodes.isEmpty()) {
+        m_encodes.first().waitForFinished();
+    }
+
+    int previousCount = m_encodedCount;
+    while (!m_encodes.isEmpty() && m_encodes.first().isFinished()) {
+        if (!m_encodes.first().result()) {
+            ++m_failedCount;
+        }
+        m_encodes.removeFirst();
+        ++m_encodedCount;
+    }
+
+    if (m_encodedCount != previousCount) {
+        emit progress(m_encodedCount, m_options.frameCount);
+    }
+}
+
+void SequenceExporter::startFinish()
+{
+    QVector<QFuture<bool>> encodes = m_encodes;
+    m_encodes.clear();
+
+    // 남은 인코딩보다 나중에 제출되므로 이 작업이 시작될 때는 모두 실행 중이거나 끝난 상태
+    m_finishWatcher.setFuture(QtConcurrent::run(&m_pool, [encodes]() {
+        int failed = 0;
+        for (const QFuture<bool>& encode : encodes) {
+            if (!encode.result()) {
+                ++failed;
+            }
+        }
+        return failed;
+    }));
+}
+
+void SequenceExporter::releaseResources()
+{
+    if (QOpenGLContext::currentContext()) {
+        for (int i = 0; i < ReadbackSlots; ++i) {
+            if (m_slots[i].fence) glDeleteSync(m_slots[i].fence);
+            if (m_slots[i].buffer) glDeleteBuffers(1, &m_slots[i].buffer);
+        }
+    }
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        m_slots[i] = ReadbackSlot();
+    }
+
+    delete m_framebuffer;
+    delete m_resolveFramebuffer;
+    m_framebuffer = nullptr;
+    m_resolveFramebuffer = nullptr;
+}
@@ -0,0 +1,105 @@
+#ifndef SEQUENCEEXPORTER_H
+#define SEQUENCEEXPORTER_H
+
+#include <QObject>
+#include <QOpenGLExtraFunctions>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QSize>
+#include <QVector>
+#include "Camera.h"
+#include "CameraPath.h"
+
+class Renderer;
+class QOpenGLFramebufferObject;
+
+// 턴테이블 또는 키프레임 카메라 경로를 따라 N 프레임을 오프스크린으로 렌더링해 이미지 시퀀스로 저장
+// 렌더링 → PBO 비동기 readback → 스레드 풀 인코딩이 겹쳐서 진행되며,
+// 인코딩 대기 프레임 수가 한도를 넘으면 readback 회수를 미뤄 렌더링이 따라서 멈춤 (메모리 제한)
+class SequenceExporter : public QObject, protected QOpenGLExtraFunctions
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ReadbackSlots = 3;
+
+    enum PathType {
+        Turntable,          // 현재 시점에서 타깃을 중심으로 360도 회전
+        Keyframes           // CameraPath 키프레임 보간
+    };
+
+    struct Options {
+        QString directory;
+        QString format = "png";
+        QSize size = QSize(1920, 1080);
+        int frameCount = 120;
+        PathType pathType = Turntable;
+        CameraPath path;
+        int samples = 4;
+        int threads = 0;            // 0이면 코어 수
+    };
+
+    explicit SequenceExporter(QObject* parent = nullptr);
+    ~SequenceExporter();
+
+    // 내보내기 시작 (GL 컨텍스트가 활성화되어 있어야 함). 시작 시점의 카메라/모델 행렬 기준
+    bool begin(Renderer* renderer, const Options& options);
+
+    // 시간 예산 안에서 프레임을 그리고 끝난 readback을 인코딩으로 넘김 (GL 컨텍스트 필요)
+    // GL 작업이 남아 있으면 true
+    bool step(Renderer* renderer, int timeBudgetMs);
+
+    // 남은 프레임 렌더링 중단 (다음 step()에서 정리). 이미 넘긴 프레임은 저장됨
+    void cancel();
+
+    bool isActive() const { return m_active; }
+    int getFrameCount() const { return m_options.frameCount; }
+
+    // 프레임 번호의 출력 경로 (<directory>/frame_0000.png)
+    QString getFramePath(int frame) const;
+
+signals:
+    void progress(int encodedFrames, int totalFrames);
+    void finished(const QString& directory, bool success);
+
+private:
+    struct ReadbackSlot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        int frame = -1;             // 읽는 중인 프레임 (-1이면 비어 있음)
+    };
+
+    bool m_active;
+    bool m_cancelled;
+    Options m_options;
+    Camera m_startCamera;
+    Camera m_camera;
+    QMatrix4x4 m_modelMatrix;
+
+    int m_nextFrame;
+    int m_submittedCount;
+    int m_failedCount;
+
+    // GL 리소스 (내보내기 동안만 존재)
+    QOpenGLFramebufferObject* m_framebuffer;
+    QOpenGLFramebufferObject* m_resolveFramebuffer;
+    ReadbackSlot m_slots[ReadbackSlots];
+    int m_nextSlot;
+
+    // 인코딩 큐 (제출 순서)
+    QThreadPool m_pool;
+    QVector<QFuture<bool>> m_encodes;
+    int m_maxQueuedEncodes;
+    int m_encodedCount;
+    QFutureWatcher<int> m_finishWatcher;
+
+    void updateCamera(int frame);
+    void renderFrame(Renderer* renderer, int frame);
+    void readFrame(ReadbackSlot& slot, int frame);
+    bool retire(ReadbackSlot& slot, bool wait);
+    void collectEncodes(bool waitOldest);
+    void startFinish();
+    void releaseResources();
+};
+
+#endif // SEQUENCEEXPORTER_H
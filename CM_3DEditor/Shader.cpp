@@ -1,9 +1,14 @@
 #include "Shader.h"
+#include "UniformBuffer.h"
+#include "ShaderCache.h"
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
 #include <QFile>
 #include <QTextStream>
 #include <QDebug>
 
 Shader::Shader()
+    : m_features(0)
 {
 }
 
@@ -27,6 +32,15 @@ bool Shader::loadFromSource(const QString& vertexSource, const QString& fragment
 {
     // 기존 쉐이더 정리
     removeAllShaders();
+    m_uniformLocations.clear();
+    
+    // 디스크 캐시에 링크된 바이너리가 있으면 컴파일/링크 생략
+    QByteArray cacheKey = ShaderCache::makeKey(vertexSource, fragmentSource);
+    if (ShaderCache::load(this, cacheKey)) {
+        bindUniformBlock("FrameBlock", FrameBlockBinding);
+        bindUniformBlock("ObjectBlock", ObjectBlockBinding);
+        return true;
+    }
     
     // 버텍스 쉐이더 컴파일
     if (!compileShader(QOpenGLShader::Vertex, vertexSource)) {
@@ -40,12 +54,53 @@ bool Shader::loadFromSource(const QString& vertexSource, const QString& fragment
         return false;
     }
     
+    // 바이너리를 나중에 가져올 수 있도록 링크 전에 힌트 설정
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (context && ShaderCache::isEnabled()) {
+        context->extraFunctions()->glProgramParameteri(programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    
     // 쉐이더 프로그램 링크
     if (!link()) {
         qDebug() << "Failed to link shader program:" << log();
         return false;
     }
     
+    ShaderCache::store(this, cacheKey);
+    
+    // 공유 uniform block 연결
+    bindUniformBlock("FrameBlock", FrameBlockBinding);
+    bindUniformBlock("ObjectBlock", ObjectBlockBinding);
+    
+    return true;
+}
+
+bool Shader::loadComputeFromSource(const QString& computeSource)
+{
+    removeAllShaders();
+    m_uniformLocations.clear();
+    
+    QByteArray cacheKey = ShaderCache::makeKey(computeSource, QString());
+    if (ShaderCache::load(this, cacheKey)) {
+        return true;
+    }
+    
+    if (!compileShader(QOpenGLShader::Compute, computeSource)) {
+        qDebug() << "Failed to compile compute shader";
+        return false;
+    }
+    
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (context && ShaderCache::isEnabled()) {
+        context->extraFunctions()->glProgramParameteri(programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    
+    if (!link()) {
+        qDebug() << "Failed to link compute program:" << log();
+        return false;
+    }
+    
+    ShaderCache::store(this, cacheKey);
     return true;
 }
 
@@ -56,50 +111,75 @@ void Shader::use()
 
 void Shader::release()
 {
-    release();
+    QOpenGLShaderProgram::release();
 }
 
 void Shader::setBool(const QString& name, bool value)
 {
-    setUniformValue(name.toStdString().c_str(), value);
+    setUniformValue(getUniformLocation(name), value);
 }
 
 void Shader::setInt(const QString& name, int value)
 {
-    setUniformValue(name.toStdString().c_str(), value);
+    setUniformValue(getUniformLocation(name), value);
 }
 
 void Shader::setFloat(const QString& name, float value)
 {
-    setUniformValue(name.toStdString().c_str(), value);
+    setUniformValue(getUniformLocation(name), value);
 }
 
 void Shader::setVec2(const QString& name, const QVector2D& value)
 {
-    setUniformValue(name.toStdString().c_str(), value);
+    setUniformValue(getUniformLocation(name), value);
 }
 
 void Shader::setVec3(const QString& name, const QVector3D& value)
 {
-    setUniformValue(name.toStdString().c_str(), value);
+    setUniformValue(getUniformLocation(name), value);
 }
 
 void Shader::setVec4(const QString& name, const QVector4D& value)
 {
-    setUniformValue(name.toStdString().c_str(), value);
+    setUniformValue(getUniformLocation(name), value);
 }
 
 void Shader::setMat4(const QString& name, const QMatrix4x4& value)
 {
-    setUniformValue(name.toStdString().c_str(), value);
+    setUniformValue(getUniformLocation(name), value);
 }
 
 void Shader::setColor(const QString& name, const QColor& value)
 {
-    setUniformValue(name.toStdString().c_str(), 
+    setUniformValue(getUniformLocation(name), 
                    QVector3D(value.redF(), value.greenF(), value.blueF()));
 }
 
+int Shader::getUniformLocation(const QString& name)
+{
+    auto it = m_uniformLocations.constFind(name);
+    if (it != m_uniformLocations.constEnd()) {
+        return it.value();
+    }
+    
+    // 존재하지 않는 uniform(-1)도 캐시하여 반복 조회를 피함
+    int location = uniformLocation(name);
+    m_uniformLocations.insert(name, location);
+    return location;
+}
+
+void Shader::bindUniformBlock(const char* blockName, GLuint bindingPoint)
+{
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context || !isLinked()) return;
+    
+    QOpenGLExtraFunctions* f = context->extraFunctions();
+    GLuint blockIndex = f->glGetUniformBlockIndex(programId(), blockName);
+    if (blockIndex != GL_INVALID_INDEX) {
+        f->glUniformBlockBinding(programId(), blockIndex, bindingPoint);
+    }
+}
+
 bool Shader::compileShader(QOpenGLShader::ShaderType type, const QString& source)
 {
     QOpenGLShader* shader = new QOpenGLShader(type, this);
@@ -135,256 +215,454 @@ QString Shader::readFile(const QString& filename)
 
 Shader* Shader::createBasicShader()
 {
-    Shader* shader = new Shader();
-    if (!shader->loadFromSource(getBasicVertexShaderSource(), getBasicFragmentShaderSource())) {
-        delete shader;
-        return nullptr;
-    }
-    return shader;
+    return createVariant(BasicProgram, DefaultFeatures);
 }
 
 Shader* Shader::createPhongShader()
+{
+    return createVariant(PhongProgram, DefaultFeatures);
+}
+
+Shader* Shader::createWireframeShader()
+{
+    return createVariant(WireframeProgram, DefaultFeatures);
+}
+
+Shader* Shader::createPointShader()
+{
+    return createVariant(PointProgram, DefaultFeatures);
+}
+
+Shader* Shader::createCullingShader()
 {
     Shader* shader = new Shader();
-    if (!shader->loadFromSource(getPhongVertexShaderSource(), getPhongFragmentShaderSource())) {
+    if (!shader->loadComputeFromSource(getCullingComputeShaderSource())) {
         delete shader;
         return nullptr;
     }
     return shader;
 }
 
-Shader* Shader::createWireframeShader()
+Shader* Shader::createDepthReduceShader()
 {
     Shader* shader = new Shader();
-    if (!shader->loadFromSource(getWireframeVertexShaderSource(), getWireframeFragmentShaderSource())) {
+    if (!shader->loadComputeFromSource(getDepthReduceComputeShaderSource())) {
         delete shader;
         return nullptr;
     }
     return shader;
 }
 
-Shader* Shader::createPointShader()
+Shader* Shader::createVariant(Program program, quint32 features)
 {
     Shader* shader = new Shader();
-    if (!shader->loadFromSource(getPointVertexShaderSource(), getPointFragmentShaderSource())) {
+    if (!shader->loadFromSource(getVariantVertexSource(program, features),
+                                getVariantFragmentSource(program, features))) {
         delete shader;
         return nullptr;
     }
+    shader->m_features = features;
     return shader;
 }
 
-QString Shader::getBasicVertexShaderSource()
+QString Shader::getVariantVertexSource(Program program, quint32 features)
 {
-    return R"(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;
-layout (location = 3) in vec2 aTexCoord;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-out vec3 FragPos;
-out vec3 Normal;
-out vec3 Color;
-out vec2 TexCoord;
-
-void main()
-{
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
-    Color = aColor;
-    TexCoord = aTexCoord;
-    
-    gl_Position = projection * view * vec4(FragPos, 1.0);
-}
-)";
+    return getVariantHeader(program, features) + getVertexShaderSource();
 }
 
-QString Shader::getBasicFragmentShaderSource()
+QString Shader::getVariantFragmentSource(Program program, quint32 features)
 {
-    return R"(
-#version 330 core
-out vec4 FragColor;
-
-in vec3 FragPos;
-in vec3 Normal;
-in vec3 Color;
-in vec2 TexCoord;
-
-uniform vec3 lightPos;
-uniform vec3 lightColor;
-uniform vec3 viewPos;
+    return getVariantHeader(program, features) + getFragmentShaderSource();
+}
 
-void main()
+QString Shader::getVariantHeader(Program program, quint32 features)
 {
-    // Ambient
-    float ambientStrength = 0.1;
-    vec3 ambient = ambientStrength * lightColor;
+    // #version은 반드시 첫 줄이어야 하므로 define은 그 뒤에 삽입
+    QString header = (features & FeatureIndirect) ? "#version 430 core\n" : "#version 330 core\n";
     
-    // Diffuse
-    vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
+    switch (program) {
+        case BasicProgram:
+            header += "#define PROGRAM_BASIC\n";
+            break;
+        case PhongProgram:
+            header += "#define PROGRAM_PHONG\n";
+            break;
+        case WireframeProgram:
+            header += "#define PROGRAM_WIREFRAME\n";
+            break;
+        case PointProgram:
+            header += "#define PROGRAM_POINT\n";
+            break;
+        case PickProgram:
+            header += "#define PROGRAM_PICK\n";
+            break;
+        case SelectionProgram:
+            header += "#define PROGRAM_SELECTION\n";
+            break;
+        default:
+            break;
+    }
     
-    // Specular
-    float specularStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-    vec3 specular = specularStrength * spec * lightColor;
+    if (features & FeatureVertexColor) header += "#define FEATURE_VERTEX_COLOR\n";
+    if (features & FeatureClipPlanes) header += "#define FEATURE_CLIP_PLANES\n";
+    if (features & FeatureIndirect) header += "#define FEATURE_INDIRECT\n";
+    header += QString("#define MAX_CLIP_PLANES %1\n").arg(MaxClipPlanes);
     
-    vec3 result = (ambient + diffuse + specular) * Color;
-    FragColor = vec4(result, 1.0);
+    header += getUniformBlockSource();
+    if (features & FeatureIndirect) {
+        header += getObjectStorageSource();
+    }
+    return header;
 }
+
+QString Shader::getUniformBlockSource()
+{
+    // 모든 기본 쉐이더가 공유하는 uniform block (UniformBuffer.h의 구조체와 레이아웃 일치)
+    return R"(
+layout (std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+};
+
+layout (std140) uniform ObjectBlock {
+    mat4 model;
+    mat4 normalMatrix;
+};
 )";
 }
 
-QString Shader::getPhongVertexShaderSource()
+QString Shader::getVertexShaderSource()
 {
     return R"(
-#version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aColor;
 layout (location = 3) in vec2 aTexCoord;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#ifdef FEATURE_INDIRECT
+layout (location = 8) in uint aDrawId;
+#endif
+
+uniform vec3 baseColor = vec3(0.5);
+#if defined(PROGRAM_POINT) || defined(PROGRAM_PICK) || defined(PROGRAM_WIREFRAME) || defined(PROGRAM_SELECTION)
+uniform float pointSize = 1.0;
+#endif
+#ifdef FEATURE_CLIP_PLANES
+uniform vec4 clipPlanes[MAX_CLIP_PLANES];
+uniform int clipPlaneCount;
+out float gl_ClipDistance[MAX_CLIP_PLANES];
+#endif
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec3 Color;
 out vec2 TexCoord;
+#if defined(PROGRAM_PICK) || defined(PROGRAM_SELECTION)
+flat out uint VertexId;
+#endif
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+#if defined(FEATURE_INDIRECT)
+    // 드로우 ID(baseInstance)로 오브젝트 데이터 조회
+    mat4 modelMatrix = objects[aDrawId].model;
+    mat3 normalMat = mat3(objects[aDrawId].normalMatrix);
+#else
+    mat4 modelMatrix = model;
+    mat3 normalMat = mat3(normalMatrix);
+#endif
+
+    vec4 worldPos = modelMatrix * vec4(aPos, 1.0);
+    FragPos = worldPos.xyz;
+    // 법선 행렬은 CPU에서 미리 계산 (버텍스마다 inverse 하지 않음)
+    Normal = normalMat * aNormal;
+#ifdef FEATURE_VERTEX_COLOR
     Color = aColor;
+#else
+    Color = baseColor;
+#endif
     TexCoord = aTexCoord;
-    
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+
+#ifdef FEATURE_CLIP_PLANES
+    for (int i = 0; i < MAX_CLIP_PLANES; ++i) {
+        gl_ClipDistance[i] = i < clipPlaneCount ? dot(clipPlanes[i], worldPos) : 1.0;
+    }
+#endif
+
+    gl_Position = viewProjection * worldPos;
+#if defined(PROGRAM_POINT) || defined(PROGRAM_PICK) || defined(PROGRAM_WIREFRAME) || defined(PROGRAM_SELECTION)
+    gl_PointSize = pointSize;
+#endif
+#if defined(PROGRAM_PICK) || defined(PROGRAM_SELECTION)
+    // glDrawElements에서는 인덱스 값 = 정점 번호
+    VertexId = uint(gl_VertexID);
+#endif
 }
 )";
 }
 
-QString Shader::getPhongFragmentShaderSource()
+QString Shader::getObjectStorageSource()
 {
+    // MultiDrawBatch::ObjectData와 레이아웃 일치 (std430)
     return R"(
-#version 330 core
-out vec4 FragColor;
+struct ObjectData {
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 boundingSphere;
+    uvec4 drawRange;    // firstIndex, indexCount, baseVertex, 예약
+};
+
+layout (std430, binding = 2) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+};
+)";
+}
 
-in vec3 FragPos;
-in vec3 Normal;
-in vec3 Color;
-in vec2 TexCoord;
+QString Shader::getCullingComputeShaderSource()
+{
+    return QString("#version 430 core\n") + getObjectStorageSource() + R"(
+layout (local_size_x = 64) in;
+
+// glMultiDrawElementsIndirect 명령 (20바이트, std430에서 조밀하게 배치됨)
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 3) writeonly buffer CommandBuffer {
+    DrawCommand commands[];
+};
+
+// 오브젝트별 이전 프레임 가시성 (1 = 보였음)
+layout (std430, binding = 4) buffer VisibilityBuffer {
+    uint visibility[];
+};
+
+// x: 절두체 안 삼각형 수, y: 그려진 삼각형 수
+layout (std430, binding = 5) buffer CounterBuffer {
+    uint frustumTriangles;
+    uint drawnTriangles;
+};
+
+// 0: 절두체 컬링만, 1: 이전 프레임에 보인 오브젝트, 2: 나머지를 Hi-Z로 검사
+const uint CullFrustum = 0u;
+const uint CullPrepass = 1u;
+const uint CullOcclusion = 2u;
+
+uniform vec4 frustumPlanes[6];
+uniform uint objectCount;
+uniform uint cullPhase;
+
+// 깊이 피라미드 (레벨 0 = 화면의 절반 해상도, 텍셀 값 = 덮는 영역의 최대 깊이)
+uniform mat4 cullViewProjection;
+uniform sampler2D hiZ;
+uniform ivec2 hiZSize;      // 원본 깊이 버퍼 해상도
+uniform int hiZLevels;
+
+bool isOccluded(vec3 center, float radius)
+{
+    // 경계 구를 감싸는 상자의 8개 꼭짓점을 투영해 화면 사각형과 가장 가까운 깊이를 구함
+    vec3 ndcMin = vec3(1.0);
+    vec3 ndcMax = vec3(-1.0);
+    for (int i = 0; i < 8; ++i) {
+        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0,
+                                             (i & 2) != 0 ? 1.0 : -1.0,
+                                             (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = cullViewProjection * vec4(corner, 1.0);
+        if (clip.w <= 1e-5) return false;   // 카메라 평면을 가로지르면 보이는 것으로 처리
+        vec3 ndc = clip.xyz / clip.w;
+        ndcMin = min(ndcMin, ndc);
+        ndcMax = max(ndcMax, ndc);
+    }
 
-uniform vec3 lightPos;
-uniform vec3 lightColor;
-uniform vec3 viewPos;
-uniform float shininess;
+    vec2 screenMin = clamp(ndcMin.xy * 0.5 + 0.5, 0.0, 1.0) * vec2(hiZSize);
+    vec2 screenMax = clamp(ndcMax.xy * 0.5 + 0.5, 0.0, 1.0) * vec2(hiZSize);
+    float nearestDepth = ndcMin.z * 0.5 + 0.5;
 
-void main()
-{
-    // Ambient
-    float ambientStrength = 0.2;
-    vec3 ambient = ambientStrength * lightColor;
-    
-    // Diffuse
-    vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
-    
-    // Specular
-    float specularStrength = 0.8;
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
-    vec3 specular = specularStrength * spec * lightColor;
-    
-    vec3 result = (ambient + diffuse + specular) * Color;
-    FragColor = vec4(result, 1.0);
-}
-)";
-}
+    // 사각형이 한 축에 최대 2텍셀만 걸치는 레벨 선택
+    vec2 extent = (screenMax - screenMin) * 0.5;
+    int level = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, hiZLevels - 1);
 
-QString Shader::getWireframeVertexShaderSource()
-{
-    return R"(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;
-layout (location = 3) in vec2 aTexCoord;
+    ivec2 levelSize = textureSize(hiZ, level);
+    ivec2 lo = min(ivec2(screenMin) >> (level + 1), levelSize - 1);
+    ivec2 hi = min(ivec2(screenMax) >> (level + 1), levelSize - 1);
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+    float farthestDepth = 0.0;
+    for (int y = lo.y; y <= hi.y; ++y) {
+        for (int x = lo.x; x <= hi.x; ++x) {
+            farthestDepth = max(farthestDepth, texelFetch(hiZ, ivec2(x, y), level).r);
+        }
+    }
+
+    return nearestDepth > farthestDepth;
+}
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    uint id = gl_GlobalInvocationID.x;
+    if (id >= objectCount) return;
+
+    ObjectData object = objects[id];
+
+    // 월드 공간 경계 구
+    vec3 center = (object.model * vec4(object.boundingSphere.xyz, 1.0)).xyz;
+    float scale = max(length(object.model[0].xyz), max(length(object.model[1].xyz), length(object.model[2].xyz)));
+    float radius = object.boundingSphere.w * scale;
+
+    // 삼각형이 모두 숨겨진 클러스터는 절두체 밖과 같이 처리
+    bool inFrustum = object.drawRange.y > 0u;
+    for (int i = 0; i < 6; ++i) {
+        if (dot(frustumPlanes[i].xyz, center) + frustumPlanes[i].w < -radius) {
+            inFrustum = false;
+        }
+    }
+
+    uint triangles = object.drawRange.y / 3u;
+    bool draw = inFrustum;
+
+    if (cullPhase == CullPrepass) {
+        // 이전 프레임에 보였던 오브젝트가 이번 프레임의 가림체
+        draw = inFrustum && visibility[id] != 0u;
+    } else if (cullPhase == CullOcclusion) {
+        // 현재 카메라 행렬로 검사하므로 카메라가 움직여도 튀지 않음
+        bool visible = inFrustum && !isOccluded(center, radius);
+        draw = visible && visibility[id] == 0u;   // 프리패스에서 이미 그린 것은 제외
+        visibility[id] = visible ? 1u : 0u;
+    }
+
+    if (inFrustum && cullPhase != CullPrepass) atomicAdd(frustumTriangles, triangles);
+    if (draw) atomicAdd(drawnTriangles, triangles);
+
+    // 컬링된 오브젝트는 instanceCount 0으로 남겨 GPU가 건너뜀
+    commands[id].count = object.drawRange.y;
+    commands[id].instanceCount = draw ? 1u : 0u;
+    commands[id].firstIndex = object.drawRange.x;
+    commands[id].baseVertex = int(object.drawRange.z);
+    commands[id].baseInstance = id;
 }
 )";
 }
 
-QString Shader::getWireframeFragmentShaderSource()
+QString Shader::getDepthReduceComputeShaderSource()
 {
-    return R"(
-#version 330 core
-out vec4 FragColor;
+    // 2x2 최대값 축소 (홀수 크기면 마지막 행/열이 남는 텍셀까지 포함해 보수적으로 유지)
+    return R"(#version 430 core
+layout (local_size_x = 8, local_size_y = 8) in;
 
-uniform vec3 wireframeColor;
+uniform sampler2D sourceDepth;
+uniform int sourceLevel;
+layout (r32f, binding = 0) writeonly uniform image2D destDepth;
 
-void main()
+float fetchDepth(ivec2 coord, ivec2 sourceSize)
 {
-    FragColor = vec4(wireframeColor, 1.0);
-}
-)";
+    return texelFetch(sourceDepth, min(coord, sourceSize - 1), sourceLevel).r;
 }
 
-QString Shader::getPointVertexShaderSource()
+void main()
 {
-    return R"(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;
-layout (location = 3) in vec2 aTexCoord;
+    ivec2 dest = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 destSize = imageSize(destDepth);
+    if (any(greaterThanEqual(dest, destSize))) return;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform float pointSize;
+    ivec2 sourceSize = textureSize(sourceDepth, sourceLevel);
+    ivec2 source = dest * 2;
 
-out vec3 Color;
+    float depth = max(max(fetchDepth(source, sourceSize), fetchDepth(source + ivec2(1, 0), sourceSize)),
+                      max(fetchDepth(source + ivec2(0, 1), sourceSize), fetchDepth(source + ivec2(1, 1), sourceSize)));
 
-void main()
-{
-    Color = aColor;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    gl_PointSize = pointSize;
+    bool extraX = (sourceSize.x & 1) != 0 && dest.x == destSize.x - 1;
+    bool extraY = (sourceSize.y & 1) != 0 && dest.y == destSize.y - 1;
+    if (extraX) {
+        depth = max(depth, max(fetchDepth(source + ivec2(2, 0), sourceSize), fetchDepth(source + ivec2(2, 1), sourceSize)));
+    }
+    if (extraY) {
+        depth = max(depth, max(fetchDepth(source + ivec2(0, 2), sourceSize), fetchDepth(source + ivec2(1, 2), sourceSize)));
+    }
+    if (extraX && extraY) {
+        depth = max(depth, fetchDepth(source + ivec2(2, 2), sourceSize));
+    }
+
+    imageStore(destDepth, dest, vec4(depth));
 }
 )";
 }
 
-QString Shader::getPointFragmentShaderSource()
+QString Shader::getFragmentShaderSource()
 {
     return R"(
-#version 330 core
+#ifdef PROGRAM_PICK
+out uvec2 PickId;
+#else
 out vec4 FragColor;
+#endif
+#if defined(PROGRAM_PICK) || defined(PROGRAM_SELECTION)
+flat in uint VertexId;
+#endif
 
+in vec3 FragPos;
+in vec3 Normal;
 in vec3 Color;
+in vec2 TexCoord;
+
+#if defined(PROGRAM_WIREFRAME)
+uniform vec3 wireframeColor;
+#elif defined(PROGRAM_PHONG)
+uniform float shininess;
+const float ambientStrength = 0.2;
+const float specularStrength = 0.8;
+#elif defined(PROGRAM_BASIC)
+const float shininess = 32.0;
+const float ambientStrength = 0.1;
+const float specularStrength = 0.5;
+#elif defined(PROGRAM_PICK)
+uniform int objectId;
+uniform int primitiveBase;      // 드로우 시작 삼각형 번호 (gl_PrimitiveID는 드로우마다 0부터)
+uniform bool pickPoints;
+#elif defined(PROGRAM_SELECTION)
+uniform usamplerBuffer selectionBits;   // 원소 i = 텍셀 i/32의 i%32번째 비트
+uniform int primitiveBase;
+uniform bool selectPoints;
+uniform vec3 selectionColor;
+#endif
 
 void main()
 {
+#if defined(PROGRAM_PICK)
+    PickId = uvec2(uint(objectId), pickPoints ? VertexId : uint(primitiveBase + gl_PrimitiveID));
+#elif defined(PROGRAM_SELECTION)
+    uint id = selectPoints ? VertexId : uint(primitiveBase + gl_PrimitiveID);
+    uint bits = texelFetch(selectionBits, int(id >> 5u)).r;
+    if ((bits & (1u << (id & 31u))) == 0u) discard;
+    FragColor = vec4(selectionColor, 1.0);
+#elif defined(PROGRAM_WIREFRAME)
+    FragColor = vec4(wireframeColor, 1.0);
+#elif defined(PROGRAM_POINT)
     FragColor = vec4(Color, 1.0);
+#else
+    // Ambient
+    vec3 ambient = ambientStrength * lightColor.rgb;
+    
+    // Diffuse
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor.rgb;
+    
+    // Specular
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    vec3 specular = specularStrength * spec * lightColor.rgb;
+    
+    vec3 result = (ambient + diffuse + specular) * Color;
+    FragColor = vec4(result, 1.0);
+#endif
 }
 )";
 }
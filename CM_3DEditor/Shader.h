@@ -8,16 +8,39 @@
 #include <QVector3D>
 #include <QVector2D>
 #include <QColor>
+#include <QHash>
 
 class Shader : public QOpenGLShaderProgram
 {
 public:
+    // 기본 쉐이더 프로그램 종류 (하나의 소스에서 define으로 분기)
+    enum Program {
+        BasicProgram,
+        PhongProgram,
+        WireframeProgram,
+        PointProgram,
+        PickProgram,        // 정수 ID 출력 (오브젝트, 삼각형/정점 번호)
+        SelectionProgram,   // 비트셋 텍스처 버퍼에서 선택된 삼각형/정점만 단색으로 출력
+        ProgramCount
+    };
+
+    // 컴파일 타임 기능 비트 (각 비트가 #define FEATURE_*로 변환됨)
+    enum Feature {
+        FeatureVertexColor = 0x1,
+        FeatureClipPlanes  = 0x2,
+        FeatureIndirect    = 0x4    // 오브젝트 데이터를 SSBO에서 드로우 ID로 읽음 (GL 4.3)
+    };
+
+    static constexpr quint32 DefaultFeatures = FeatureVertexColor;
+    static constexpr int MaxClipPlanes = 4;
+
     Shader();
     ~Shader();
 
     // 쉐이더 로드 및 컴파일
     bool loadFromFiles(const QString& vertexFile, const QString& fragmentFile);
     bool loadFromSource(const QString& vertexSource, const QString& fragmentSource);
+    bool loadComputeFromSource(const QString& computeSource);
     
     // 쉐이더 사용
     void use();
@@ -33,26 +56,47 @@ public:
     void setMat4(const QString& name, const QMatrix4x4& value);
     void setColor(const QString& name, const QColor& value);
     
+    // 변형을 만들 때 쓴 기능 비트 (변형이 아닌 쉐이더는 0)
+    quint32 getFeatures() const { return m_features; }
+    
+    // Uniform 위치 캐시 (링크 시 초기화)
+    int getUniformLocation(const QString& name);
+    
+    // Uniform block을 바인딩 포인트에 연결 (쉐이더에 block이 없으면 무시)
+    void bindUniformBlock(const char* blockName, GLuint bindingPoint);
+    
     // 기본 쉐이더들
     static Shader* createBasicShader();
     static Shader* createPhongShader();
     static Shader* createWireframeShader();
     static Shader* createPointShader();
+    
+    // 컴퓨트 쉐이더 (GL 4.3)
+    static Shader* createCullingShader();
+    static Shader* createDepthReduceShader();
+    
+    // 쉐이더 변형 (permutation)
+    static Shader* createVariant(Program program, quint32 features);
+    static QString getVariantVertexSource(Program program, quint32 features);
+    static QString getVariantFragmentSource(Program program, quint32 features);
 
 private:
+    // 이름 → uniform 위치 캐시
+    QHash<QString, int> m_uniformLocations;
+    quint32 m_features;
+    
     // 쉐이더 컴파일 헬퍼
     bool compileShader(QOpenGLShader::ShaderType type, const QString& source);
     QString readFile(const QString& filename);
     
-    // 기본 쉐이더 소스 코드
-    static QString getBasicVertexShaderSource();
-    static QString getBasicFragmentShaderSource();
-    static QString getPhongVertexShaderSource();
-    static QString getPhongFragmentShaderSource();
-    static QString getWireframeVertexShaderSource();
-    static QString getWireframeFragmentShaderSource();
-    static QString getPointVertexShaderSource();
-    static QString getPointFragmentShaderSource();
+    // 기본 쉐이더 소스 코드 (모든 변형이 공유)
+    static QString getVariantHeader(Program program, quint32 features);
+    static QString getUniformBlockSource();
+    static QString getVertexShaderSource();
+    static QString getFragmentShaderSource();
+    static QString getObjectStorageSource();
+    static QString getCullingComputeShaderSource();
+    static QString getDepthReduceComputeShaderSource();
 };
 
 #endif // SHADER_H
@@ -0,0 +1,161 @@
+#include "ShaderCache.h"
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+#include <atomic>
+
+namespace {
+    // 파일 헤더 (포맷 변경 시 버전 증가)
+    const quint32 CacheMagic = 0x434D5342; // "CMSB"
+    const quint32 CacheVersion = 1;
+
+    std::atomic<bool> s_enabled(true);
+    std::atomic<int> s_hits(0);
+    std::atomic<int> s_misses(0);
+}
+
+bool ShaderCache::isSupported()
+{
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) return false;
+
+    GLint formatCount = 0;
+    context->extraFunctions()->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    return formatCount > 0;
+}
+
+QByteArray ShaderCache::makeKey(const QString& vertexSource, const QString& fragmentSource)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    // 드라이버가 바뀌면 바이너리는 무효이므로 드라이버 정보를 키에 포함
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (context) {
+        QOpenGLFunctions* f = context->functions();
+        hash.addData(reinterpret_cast<const char*>(f->glGetString(GL_VENDOR)));
+        hash.addData(reinterpret_cast<const char*>(f->glGetString(GL_RENDERER)));
+        hash.addData(reinterpret_cast<const char*>(f->glGetString(GL_VERSION)));
+    }
+
+    hash.addData(vertexSource.toUtf8());
+    hash.addData(QByteArrayLiteral("\0"));
+    hash.addData(fragmentSource.toUtf8());
+
+    return hash.result().toHex();
+}
+
+bool ShaderCache::load(QOpenGLShaderProgram* program, const QByteArray& key)
+{
+    if (!isEnabled() || !program || !isSupported()) return false;
+
+    QFile file(cacheFilePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        ++s_misses;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0, version = 0, binaryFormat = 0;
+    QByteArray binary;
+    stream >> magic >> version >> binaryFormat >> binary;
+    file.close();
+
+    if (stream.status() != QDataStream::Ok || magic != CacheMagic || version != CacheVersion || binary.isEmpty()) {
+        QFile::remove(cacheFilePath(key));
+        ++s_misses;
+        return false;
+    }
+
+    if (!program->programId() && !program->create()) {
+        return false;
+    }
+
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+    f->glProgramBinary(program->programId(), binaryFormat, binary.constData(), binary.size());
+
+    GLint linked = 0;
+    f->glGetProgramiv(program->programId(), GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // 드라이버 업데이트 등으로 거부된 바이너리는 삭제 후 재컴파일
+        QFile::remove(cacheFilePath(key));
+        ++s_misses;
+        return false;
+    }
+
+    // 쉐이더 없이 link()를 호출하면 QOpenGLShaderProgram이 이미 링크된 상태를 인식함
+    if (!program->link()) {
+        ++s_misses;
+        return false;
+    }
+
+    ++s_hits;
+    return true;
+}
+
+bool ShaderCache::store(QOpenGLShaderProgram* program, const QByteArray& key)
+{
+    if (!isEnabled() || !program || !program->isLinked() || !isSupported()) return false;
+
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+
+    GLint length = 0;
+    f->glGetProgramiv(program->programId(), GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return false;
+
+    QByteArray binary(length, Qt::Uninitialized);
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    f->glGetProgramBinary(program->programId(), length, &written, &binaryFormat, binary.data());
+    if (written <= 0) return false;
+    binary.resize(written);
+
+    QDir().mkpath(cacheDirectory());
+
+    // 중간에 실패해도 손상된 파일이 남지 않도록 QSaveFile 사용
+    QSaveFile file(cacheFilePath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Failed to write shader cache:" << file.fileName();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << CacheMagic << CacheVersion << quint32(binaryFormat) << binary;
+    return file.commit();
+}
+
+QString ShaderCache::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/shaders";
+}
+
+void ShaderCache::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+bool ShaderCache::isEnabled()
+{
+    return s_enabled;
+}
+
+int ShaderCache::hitCount()
+{
+    return s_hits;
+}
+
+int ShaderCache::missCount()
+{
+    return s_misses;
+}
+
+QString ShaderCache::cacheFilePath(const QByteArray& key)
+{
+    return cacheDirectory() + "/" + QString::fromLatin1(key) + ".bin";
+}
@@ -0,0 +1,37 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <QString>
+#include <QByteArray>
+
+class QOpenGLShaderProgram;
+
+// 링크된 쉐이더 프로그램 바이너리의 디스크 캐시
+// 키: 드라이버 정보(GL_VENDOR/GL_RENDERER/GL_VERSION) + 쉐이더 소스 해시
+class ShaderCache
+{
+public:
+    // 캐시 사용 가능 여부 (드라이버가 바이너리 포맷을 하나 이상 지원해야 함)
+    static bool isSupported();
+
+    // 캐시 키 생성 (현재 컨텍스트 필요)
+    static QByteArray makeKey(const QString& vertexSource, const QString& fragmentSource);
+
+    // 캐시에서 프로그램 복원 / 링크된 프로그램 저장
+    static bool load(QOpenGLShaderProgram* program, const QByteArray& key);
+    static bool store(QOpenGLShaderProgram* program, const QByteArray& key);
+
+    // 캐시 디렉토리
+    static QString cacheDirectory();
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    // 통계
+    static int hitCount();
+    static int missCount();
+
+private:
+    static QString cacheFilePath(const QByteArray& key);
+};
+
+#endif // SHADERCACHE_H
@@ -0,0 +1,196 @@
+#include "ShaderLibrary.h"
+#include "ShaderCache.h"
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QDebug>
+
+ShaderLibrary::ShaderLibrary(QObject* parent)
+    : QObject(parent)
+    , m_worker(nullptr)
+    , m_workerContext(nullptr)
+    , m_workerSurface(nullptr)
+{
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+    cleanup();
+}
+
+void ShaderLibrary::initialize(QOpenGLContext* context)
+{
+    if (!context || m_workerContext) return;
+
+    // 백그라운드 컴파일 결과는 프로그램 바이너리로 전달되므로 바이너리 캐시가 필요
+    if (!ShaderCache::isEnabled() || !ShaderCache::isSupported()) {
+        qDebug() << "Program binaries unavailable; shader variants will compile on demand";
+        return;
+    }
+
+    m_workerSurface = new QOffscreenSurface();
+    m_workerSurface->setFormat(context->format());
+    m_workerSurface->create();
+
+    m_workerContext = new QOpenGLContext();
+    m_workerContext->setFormat(context->format());
+    m_workerContext->setShareContext(context);
+    if (!m_workerContext->create()) {
+        qDebug() << "Failed to create shader compiler context; shader variants will compile on demand";
+        delete m_workerContext;
+        delete m_workerSurface;
+        m_workerContext = nullptr;
+        m_workerSurface = nullptr;
+        return;
+    }
+
+    m_worker = new QObject();
+    m_worker->moveToThread(&m_thread);
+    m_workerContext->moveToThread(&m_thread);
+    m_thread.setObjectName("ShaderCompiler");
+    m_thread.start(QThread::LowPriority);
+}
+
+void ShaderLibrary::cleanup()
+{
+    if (m_thread.isRunning()) {
+        // 컨텍스트를 GUI 스레드로 되돌린 뒤 종료 (대기 중인 컴파일은 먼저 처리됨)
+        QOpenGLContext* context = m_workerContext;
+        QThread* mainThread = thread();
+        QMetaObject::invokeMethod(m_worker, [context, mainThread]() {
+            context->moveToThread(mainThread);
+        }, Qt::BlockingQueuedConnection);
+
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    delete m_worker;
+    delete m_workerContext;
+    delete m_workerSurface;
+    m_worker = nullptr;
+    m_workerContext = nullptr;
+    m_workerSurface = nullptr;
+
+    qDeleteAll(m_variants);
+    m_variants.clear();
+    m_pending.clear();
+    m_compiled.clear();
+    m_failed.clear();
+}
+
+Shader* ShaderLibrary::getShader(Shader::Program program, quint32 features)
+{
+    quint32 key = makeVariantKey(program, features);
+
+    Shader* shader = m_variants.value(key, nullptr);
+    if (shader) return shader;
+
+    if (m_failed.contains(key)) {
+        return getFallback(program);
+    }
+
+    // 기본 변형, 백그라운드에서 준비 완료된 변형(캐시 적중), 비동기 불가 시에는 즉시 생성
+    if (features == Shader::DefaultFeatures || m_compiled.contains(key) || !isAsyncAvailable()) {
+        m_compiled.remove(key);
+        shader = createNow(key, program, features);
+        return shader ? shader : getFallback(program);
+    }
+
+    prewarm(program, features);
+    return getFallback(program);
+}
+
+Shader* ShaderLibrary::findShader(Shader::Program program, quint32 features) const
+{
+    Shader* shader = m_variants.value(makeVariantKey(program, features), nullptr);
+    if (shader) return shader;
+
+    return m_variants.value(makeVariantKey(program, Shader::DefaultFeatures), nullptr);
+}
+
+bool ShaderLibrary::isReady(Shader::Program program, quint32 features) const
+{
+    // fallback이 아닌 정확한 변형이 생성되어 있는지
+    return m_variants.contains(makeVariantKey(program, features));
+}
+
+void ShaderLibrary::prewarm(Shader::Program program, quint32 features)
+{
+    quint32 key = makeVariantKey(program, features);
+    if (!isAsyncAvailable() || m_variants.contains(key) || m_pending.contains(key)
+        || m_compiled.contains(key) || m_failed.contains(key)) {
+        return;
+    }
+
+    m_pending.insert(key);
+
+    QString vertexSource = Shader::getVariantVertexSource(program, features);
+    QString fragmentSource = Shader::getVariantFragmentSource(program, features);
+    QOpenGLContext* context = m_workerContext;
+    QOffscreenSurface* surface = m_workerSurface;
+
+    QMetaObject::invokeMethod(m_worker, [this, context, surface, key, vertexSource, fragmentSource]() {
+        bool success = false;
+        if (context->makeCurrent(surface)) {
+            // 컴파일 및 링크 후 바이너리 캐시에 저장
+            {
+                Shader shader;
+                success = shader.loadFromSource(vertexSource, fragmentSource);
+            }
+            context->doneCurrent();
+        }
+
+        QMetaObject::invokeMethod(this, [this, key, success]() {
+            onVariantCompiled(key, success);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+quint32 ShaderLibrary::makeVariantKey(Shader::Program program, quint32 features)
+{
+    return (quint32(program) << 16) | (features & 0xFFFF);
+}
+
+void ShaderLibrary::onVariantCompiled(quint32 key, bool success)
+{
+    m_pending.remove(key);
+
+    if (success) {
+        // GUI 컨텍스트에서 다음 getShader 호출 시 캐시로부터 가져옴
+        m_compiled.insert(key);
+    } else {
+        qDebug() << "Background compilation failed for shader variant" << Qt::hex << key;
+        m_failed.insert(key);
+    }
+
+    emit variantReady();
+}
+
+Shader* ShaderLibrary::createNow(quint32 key, Shader::Program program, quint32 features)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Shader* shader = Shader::createVariant(program, features);
+    if (!shader) {
+        m_failed.insert(key);
+        qDebug() << "Failed to create shader variant" << Qt::hex << key;
+        return nullptr;
+    }
+
+    m_variants.insert(key, shader);
+    qDebug() << "Shader variant" << Qt::hex << key << Qt::dec << "ready in" << timer.nsecsElapsed() / 1000000.0 << "ms";
+    return shader;
+}
+
+Shader* ShaderLibrary::getFallback(Shader::Program program)
+{
+    quint32 key = makeVariantKey(program, Shader::DefaultFeatures);
+
+    Shader* shader = m_variants.value(key, nullptr);
+    if (shader || m_failed.contains(key)) return shader;
+
+    return createNow(key, program, Shader::DefaultFeatures);
+}
@@ -0,0 +1,64 @@
+#ifndef SHADERLIBRARY_H
+#define SHADERLIBRARY_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include "Shader.h"
+
+class QOpenGLContext;
+class QOffscreenSurface;
+
+// 쉐이더 변형 관리
+// 요청된 변형이 아직 준비되지 않았으면 fallback(기본 기능 변형)을 반환하고,
+// 공유 컨텍스트를 가진 백그라운드 스레드에서 컴파일한 뒤 바이너리 캐시를 통해 가져옴
+class ShaderLibrary : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ShaderLibrary(QObject* parent = nullptr);
+    ~ShaderLibrary();
+
+    // 현재 컨텍스트와 공유하는 백그라운드 컴파일러 준비
+    void initialize(QOpenGLContext* context);
+    void cleanup();
+
+    // 변형 가져오기 (현재 컨텍스트 필요)
+    Shader* getShader(Shader::Program program, quint32 features);
+    Shader* findShader(Shader::Program program, quint32 features) const;
+    bool isReady(Shader::Program program, quint32 features) const;
+
+    // 비동기 미리 컴파일
+    void prewarm(Shader::Program program, quint32 features);
+    bool hasPendingVariants() const { return !m_pending.isEmpty(); }
+    bool isAsyncAvailable() const { return m_workerContext != nullptr; }
+
+    static quint32 makeVariantKey(Shader::Program program, quint32 features);
+
+signals:
+    // 비동기 변형이 준비됨 (다시 그리기 필요)
+    void variantReady();
+
+private slots:
+    void onVariantCompiled(quint32 key, bool success);
+
+private:
+    // 준비된 변형들
+    QHash<quint32, Shader*> m_variants;
+    QSet<quint32> m_pending;
+    QSet<quint32> m_compiled;
+    QSet<quint32> m_failed;
+
+    // 백그라운드 컴파일러
+    QThread m_thread;
+    QObject* m_worker;
+    QOpenGLContext* m_workerContext;
+    QOffscreenSurface* m_workerSurface;
+
+    Shader* createNow(quint32 key, Shader::Program program, quint32 features);
+    Shader* getFallback(Shader::Program program);
+};
+
+#endif // SHADERLIBRARY_H
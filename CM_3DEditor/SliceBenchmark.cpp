@@ -0,0 +1,139 @@
+#include "SliceBenchmark.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 14;
+
+    // 합성 토러스 (큰 반지름, 관 반지름)
+    const float TorusRadius = 1.0f;
+    const float TubeRadius = 0.35f;
+
+    const float Pi = 3.14159265f;
+
+    QString formatMs(double ms)
+    {
+        return QString("%1").arg(ms, 10, 'f', 2);
+    }
+}
+
+SliceBenchmark::SliceBenchmark(const Options& options)
+    : m_options(options)
+{
+}
+
+int SliceBenchmark::run()
+{
+    MeshData data;
+    if (m_options.input.startsWith("torus:")) {
+        const int triangleCount = m_options.input.mid(6).toInt();
+        if (triangleCount < 8) {
+            qWarning() << "Invalid synthetic torus:" << m_options.input;
+            return 2;
+        }
+        generateTorus(triangleCount, data);
+    } else if (!Mesh::loadData(m_options.input, data)) {
+        qWarning() << "Cannot load" << m_options.input;
+        return 1;
+    }
+    if (data.indices.isEmpty()) {
+        qWarning() << "Slicing needs a triangle mesh:" << m_options.input;
+        return 1;
+    }
+    qInfo().noquote() << QString("%1: %2 vertices, %3 triangles, %4 threads")
+                             .arg(QFileInfo(m_options.input).fileName())
+                             .arg(data.vertices.size())
+                             .arg(data.indices.size() / 3)
+                             .arg(QThreadPool::globalInstance()->maxThreadCount());
+
+    const int steps = qMax(1, m_options.steps);
+    qInfo().noquote() << QString("%1").arg("axis", -6) + QString("%1%2%3%4%5")
+                             .arg("build", 10).arg("slice min", 10).arg("slice avg", 10).arg("slice max", 10)
+                             .arg("lines", 10) << "(ms)";
+
+    const char* names[] = { "x", "y", "z" };
+    const QVector3D normals[] = { QVector3D(1, 0, 0), QVector3D(0, 1, 0), QVector3D(0, 0, 1) };
+    for (int axis = 0; axis < 3; ++axis) {
+        MeshSlicer slicer;
+        double buildMs = -1.0;
+        for (int r = 0; r < qMax(1, m_options.repeats); ++r) {
+            QElapsedTimer timer;
+            timer.start();
+            if (!slicer.build(data.vertices, data.indices, normals[axis])) {
+                qWarning() << "Build failed along" << names[axis];
+                return 1;
+            }
+            const double ms = timer.nsecsElapsed() / 1.0e6;
+            if (buildMs < 0.0 || ms < buildMs) buildMs = ms;
+        }
+
+        // 범위 끝은 단면이 비므로 칸의 가운데에서 구함 (슬라이더를 옮길 때와 같은 호출)
+        double minMs = -1.0;
+        double maxMs = 0.0;
+        double totalMs = 0.0;
+        qint64 lineCount = 0;
+        QVector<SlicePolyline> polylines;
+        const float range = slicer.getMaxOffset() - slicer.getMinOffset();
+        for (int step = 0; step < steps; ++step) {
+            const float offset = slicer.getMinOffset() + range * (step + 0.5f) / steps;
+            QElapsedTimer timer;
+            timer.start();
+            slicer.slice(data.vertices, data.indices, offset, polylines);
+            const double ms = timer.nsecsElapsed() / 1.0e6;
+            minMs = minMs < 0.0 ? ms : qMin(minMs, ms);
+            maxMs = qMax(maxMs, ms);
+            totalMs += ms;
+            lineCount += polylines.size();
+        }
+
+        qInfo().noquote() << QString("%1").arg(names[axis], -6) + formatMs(buildMs) + formatMs(minMs)
+                                 + formatMs(totalMs / steps) + formatMs(maxMs)
+                                 + QString("%1").arg(double(lineCount) / steps, 10, 'f', 1);
+    }
+    return 0;
+}
+
+void SliceBenchmark::generateTorus(int triangleCount, MeshData& data)
+{
+    // 관 둘레 칸 수 : 큰 원 둘레 칸 수 = 1 : 3 (칸마다 삼각형 2개)
+    const int tube = qMax(3, int(std::sqrt(triangleCount / 6.0)));
+    const int ring = qMax(3, triangleCount / (tube * 2));
+    const int vertexCount = ring * tube;
+
+    data = MeshData();
+    data.vertices.resize(vertexCount);
+    data.indices.resize(ring * tube * 6);
+    VertexData* vertexData = data.vertices.data();
+    unsigned int* indexData = data.indices.data();
+    Parallel::parallelFor(ring, qMax(1, ParallelGrain / tube), [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            const float u = 2.0f * Pi * i / ring;
+            const QVector3D axis(std::cos(u), std::sin(u), 0.0f);
+            const int next = int(i + 1) % ring;
+            for (int j = 0; j < tube; ++j) {
+                const float v = 2.0f * Pi * j / tube;
+                const QVector3D normal = axis * std::cos(v) + QVector3D(0.0f, 0.0f, std::sin(v));
+                VertexData& vertex = vertexData[i * tube + j];
+                vertex.position = axis * TorusRadius + normal * TubeRadius;
+                vertex.normal = normal;
+                vertex.color = QVector3D(0.7f, 0.7f, 0.7f);
+
+                const unsigned int a = unsigned(i * tube + j);
+                const unsigned int b = unsigned(i * tube + (j + 1) % tube);
+                const unsigned int c = unsigned(next * tube + j);
+                const unsigned int d = unsigned(next * tube + (j + 1) % tube);
+                unsigned int* quad = indexData + (i * tube + j) * 6;
+                quad[0] = a; quad[1] = c; quad[2] = b;
+                quad[3] = b; quad[4] = c; quad[5] = d;
+            }
+        }
+    });
+
+    // 로드와 같이 클러스터 순서로 정렬하고 경계 계산
+    Mesh::completeData(data);
+}
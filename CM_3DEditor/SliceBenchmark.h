@@ -0,0 +1,31 @@
+#ifndef SLICEBENCHMARK_H
+#define SLICEBENCHMARK_H
+
+#include <QString>
+#include "MeshSlicer.h"
+
+// 단면 색인 구축과 단면 계산 시간 측정
+// PLY 메시 또는 합성 토러스(torus:<삼각형 수>)를 한 번 준비한 뒤 X/Y/Z 방향마다 구축하고,
+// 거리 범위를 고르게 나눈 위치에서 단면을 구해 최소/평균/최대 시간을 표로 출력
+class SliceBenchmark
+{
+public:
+    struct Options {
+        QString input;                  // PLY 메시 또는 torus:<삼각형 수>
+        int steps = 100;                // 방향마다 단면을 구할 위치 수
+        int repeats = 3;                // 구축은 가장 빠른 회차를 씀
+    };
+
+    explicit SliceBenchmark(const Options& options);
+
+    // 종료 코드 반환 (0: 성공)
+    int run();
+
+private:
+    Options m_options;
+
+    // 합성 토러스 메시 (같은 삼각형 수면 항상 같은 메시)
+    static void generateTorus(int triangleCount, MeshData& data);
+};
+
+#endif // SLICEBENCHMARK_H
@@ -0,0 +1,198 @@
+#include "SpatialOrder.h"
+#include "Parallel.h"
+#include "MeshComponents.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 14;
+
+    const int AxisBits = 21;
+    const int CodeBits = AxisBits * 3;
+
+    // 21비트를 3칸 간격으로 벌림 (비트 i → 3i)
+    inline quint64 spreadBits(quint32 value)
+    {
+        quint64 x = value & 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffffULL;
+        x = (x | x << 16) & 0x1f0000ff0000ffULL;
+        x = (x | x << 8) & 0x100f00f00f00f00fULL;
+        x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+        x = (x | x << 2) & 0x1249249249249249ULL;
+        return x;
+    }
+
+    // 첫 축이 가장 높은 비트
+    inline quint64 interleave(quint32 a, quint32 b, quint32 c)
+    {
+        return spreadBits(a) << 2 | spreadBits(b) << 1 | spreadBits(c);
+    }
+
+    // Skilling의 축 → 전치 Hilbert 변환 (Hilbert 곡선 색인을 세 축에 비트별로 나눠 담음)
+    inline quint64 hilbertCode(quint32 x, quint32 y, quint32 z)
+    {
+        quint32 axes[3] = { x, y, z };
+        // 높은 비트부터 축을 뒤집거나(비트 1) 첫 축과 맞바꿈(비트 0) (하위 비트 좌표계를 상위 셀 방향에 맞춤)
+        // 무작위 점에서는 분기 예측이 절반쯤 빗나가므로 마스크로 두 경우를 함께 계산
+        for (int bit = AxisBits - 1; bit > 0; --bit) {
+            const quint32 p = (1u << bit) - 1;
+            for (int i = 0; i < 3; ++i) {
+                const quint32 invert = 0u - ((axes[i] >> bit) & 1u);
+                const quint32 t = (axes[0] ^ axes[i]) & p & ~invert;
+                axes[0] ^= (p & invert) ^ t;
+                axes[i] ^= t;
+            }
+        }
+
+        // 그레이 부호화
+        axes[1] ^= axes[0];
+        axes[2] ^= axes[1];
+        quint32 t = 0;
+        for (int bit = AxisBits - 1; bit > 0; --bit) {
+            t ^= ((1u << bit) - 1) & (0u - ((axes[2] >> bit) & 1u));
+        }
+        for (quint32& axis : axes) {
+            axis ^= t;
+        }
+        return interleave(axes[0], axes[1], axes[2]);
+    }
+}
+
+QString SpatialOrder::getCurveName(Curve curve)
+{
+    switch (curve) {
+        case Morton:
+            return "morton";
+        case Hilbert:
+            return "hilbert";
+        case FileOrder:
+        default:
+            return "file";
+    }
+}
+
+bool SpatialOrder::computeOrder(const QVector<VertexData>& vertices, Curve curve, QVector<int>& order,
+                                const std::atomic_bool* cancel)
+{
+    QElapsedTimer timer;
+    timer.start();
+    order.clear();
+
+    const int count = vertices.size();
+    if (curve == FileOrder || count == 0) return false;
+
+    // 경계 상자 (조각별 최소/최대를 모아 합침)
+    const int chunks = Parallel::chunkCount(count, ParallelGrain);
+    QVector<QVector3D> chunkMin(chunks, vertices.first().position);
+    QVector<QVector3D> chunkMax(chunks, vertices.first().position);
+    Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        QVector3D boxMin = vertices[begin].position;
+        QVector3D boxMax = boxMin;
+        for (qsizetype i = begin + 1; i < end; ++i) {
+            const QVector3D& p = vertices[i].position;
+            boxMin = QVector3D(qMin(boxMin.x(), p.x()), qMin(boxMin.y(), p.y()), qMin(boxMin.z(), p.z()));
+            boxMax = QVector3D(qMax(boxMax.x(), p.x()), qMax(boxMax.y(), p.y()), qMax(boxMax.z(), p.z()));
+        }
+        chunkMin[chunk] = boxMin;
+        chunkMax[chunk] = boxMax;
+    });
+    QVector3D boxMin = chunkMin[0];
+    QVector3D boxMax = chunkMax[0];
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        const QVector3D& a = chunkMin[chunk];
+        const QVector3D& b = chunkMax[chunk];
+        boxMin = QVector3D(qMin(boxMin.x(), a.x()), qMin(boxMin.y(), a.y()), qMin(boxMin.z(), a.z()));
+        boxMax = QVector3D(qMax(boxMax.x(), b.x()), qMax(boxMax.y(), b.y()), qMax(boxMax.z(), b.z()));
+    }
+
+    // 가장 긴 축을 기준으로 같은 배율로 양자화 (셀이 정육면체여야 곡선의 지역성이 유지됨)
+    const QVector3D extent = boxMax - boxMin;
+    const float longest = qMax(extent.x(), qMax(extent.y(), extent.z()));
+    const float scale = longest > 0.0f ? float((1 << AxisBits) - 1) / longest : 0.0f;
+
+    QVector<quint64> keys(count);
+    QVector<int> values(count);
+    quint64* keyData = keys.data();
+    int* valueData = values.data();
+    const bool hilbert = curve == Hilbert;
+    Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            const QVector3D cell = (vertices[i].position - boxMin) * scale;
+            const quint32 x = quint32(qBound(0.0f, cell.x(), float((1 << AxisBits) - 1)));
+            const quint32 y = quint32(qBound(0.0f, cell.y(), float((1 << AxisBits) - 1)));
+            const quint32 z = quint32(qBound(0.0f, cell.z(), float((1 << AxisBits) - 1)));
+            keyData[i] = hilbert ? hilbertCode(x, y, z) : interleave(x, y, z);
+            valueData[i] = int(i);
+        }
+    });
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    // 같은 코드는 원래 순서 유지
+    if (!Parallel::sortByKey(keys, values, CodeBits, ParallelGrain, cancel)) return false;
+
+    order.swap(values);
+    qDebug() << "Spatial order" << getCurveName(curve) << "for" << count << "vertices in" << timer.elapsed() << "ms";
+    return true;
+}
+
+void SpatialOrder::apply(MeshData& data, const QVector<int>& order)
+{
+    const int count = data.vertices.size();
+    if (order.size() != count) return;
+
+    QVector<VertexData> vertices(count);
+    QVector<int> newIndex(count);
+    VertexData* vertexData = vertices.data();
+    int* newIndexData = newIndex.data();
+    const VertexData* source = data.vertices.constData();
+    Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            vertexData[i] = source[order[i]];
+            newIndexData[order[i]] = int(i);
+        }
+    });
+
+    unsigned int* indexData = data.indices.data();
+    Parallel::parallelFor(data.indices.size(), ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            indexData[i] = unsigned(newIndexData[indexData[i]]);
+        }
+    });
+    data.vertices.swap(vertices);
+
+    // 로드할 때 구한 연결 성분도 새 정점 번호로 (공유 중일 수 있으므로 사본을 고침)
+    if (data.components) {
+        std::shared_ptr<MeshComponents> components = std::make_shared<MeshComponents>(*data.components);
+        if (components->reorderVertices(order)) {
+            data.components = components;
+        } else {
+            data.components.reset();
+        }
+    }
+}
+
+void SpatialOrder::restore(MeshData& data, const QVector<int>& order)
+{
+    const int count = data.vertices.size();
+    if (order.size() != count) return;
+
+    QVector<VertexData> vertices(count);
+    VertexData* vertexData = vertices.data();
+    const VertexData* source = data.vertices.constData();
+    Parallel::parallelFor(count, ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            vertexData[order[i]] = source[i];
+        }
+    });
+
+    unsigned int* indexData = data.indices.data();
+    Parallel::parallelFor(data.indices.size(), ParallelGrain, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) {
+            indexData[i] = unsigned(order[indexData[i]]);
+        }
+    });
+    data.vertices.swap(vertices);
+    data.components.reset();
+}
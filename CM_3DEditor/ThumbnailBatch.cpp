@@ -0,0 +1,200 @@
+#include "ThumbnailBatch.h"
+#include "OffscreenRenderer.h"
+#include "Mesh.h"
+#include "Camera.h"
+#include <QtConcurrent>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+    // 작업 스레드에서 준비된 메시
+    struct LoadResult {
+        bool success = false;
+        MeshData data;
+    };
+}
+
+ThumbnailBatch::ThumbnailBatch(const Options& options)
+    : m_options(options)
+{
+    if (m_options.presets.isEmpty()) {
+        m_options.presets << "iso";
+    }
+    if (m_options.threads > 0) {
+        m_pool.setMaxThreadCount(m_options.threads);
+    }
+}
+
+int ThumbnailBatch::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (const QString& preset : m_options.presets) {
+        if (!Camera::getPresetNames().contains(preset.toLower())) {
+            qWarning() << "Unknown camera preset:" << preset << "(available:" << Camera::getPresetNames().join(", ") << ")";
+            return 2;
+        }
+    }
+
+    if (!QDir().mkpath(m_options.outputDirectory)) {
+        qWarning() << "Cannot create output directory:" << m_options.outputDirectory;
+        return 2;
+    }
+
+    int upToDateCount = 0;
+    QVector<Job> jobs = collectJobs(upToDateCount);
+    qInfo() << jobs.size() << "files to render," << upToDateCount << "already up to date";
+    if (jobs.isEmpty()) return 0;
+
+    OffscreenRenderer offscreen;
+    if (!offscreen.initialize(m_options.size)) {
+        return 1;
+    }
+
+    // 로드는 풀에서 미리 진행하되, 메모리를 제한하기 위해 일정 개수만 앞서 나감
+    const int loadAhead = qMax(2, m_pool.maxThreadCount() * 2);
+    QVector<QFuture<LoadResult>> loads(jobs.size());
+    auto startLoad = [&](int index) {
+        QString input = jobs[index].input;
+        loads[index] = QtConcurrent::run(&m_pool, [input]() {
+            LoadResult result;
+            result.success = Mesh::loadData(input, result.data);
+            return result;
+        });
+    };
+    for (int i = 0; i < qMin(loadAhead, jobs.size()); ++i) {
+        startLoad(i);
+    }
+
+    QVector<QFuture<bool>> encodes;
+    int failedCount = 0;
+
+    offscreen.makeCurrent();
+    Mesh* mesh = new Mesh();
+
+    for (int i = 0; i < jobs.size(); ++i) {
+        const Job& job = jobs[i];
+
+        LoadResult loaded = loads[i].result();
+        loads[i] = QFuture<LoadResult>();   // 결과 메모리 해제
+        if (i + loadAhead < jobs.size()) {
+            startLoad(i + loadAhead);
+        }
+
+        if (!loaded.success || !mesh->upload(loaded.data)) {
+            qWarning() << "Skipping" << job.input;
+            failedCount += job.outputs.size();
+            continue;
+        }
+
+        // 하위 폴더 입력은 출력 폴더에도 같은 구조로 저장
+        QDir().mkpath(QFileInfo(job.outputs.first()).path());
+
+        QVector3D center = (loaded.data.boundingBoxMin + loaded.data.boundingBoxMax) * 0.5f;
+        for (int p = 0; p < job.presets.size(); ++p) {
+            offscreen.getCamera()->applyPreset(job.presets[p], center, loaded.data.boundingRadius);
+            QImage image = offscreen.render(mesh);
+
+            // 인코딩은 로드보다 우선 처리해 이미지가 쌓이지 않도록 함
+            QString output = job.outputs[p];
+            QByteArray format = m_options.format.toLatin1();
+            encodes.append(QtConcurrent::task([image, output, format]() {
+                    return !image.isNull() && image.save(output, format.constData());
+                })
+                .withPriority(1)
+                .onThreadPool(m_pool)
+                .spawn());
+        }
+
+        qInfo().noquote() << QString("[%1/%2] %3").arg(i + 1).arg(jobs.size()).arg(job.input);
+    }
+
+    delete mesh;
+    offscreen.doneCurrent();
+
+    int writtenCount = 0;
+    for (QFuture<bool>& encode : encodes) {
+        if (encode.result()) {
+            ++writtenCount;
+        } else {
+            ++failedCount;
+        }
+    }
+
+    qInfo() << "Wrote" << writtenCount << "images in" << timer.elapsed() << "ms," << failedCount << "failed";
+    return failedCount > 0 ? 1 : 0;
+}
+
+QVector<ThumbnailBatch::Input> ThumbnailBatch::collectInputs() const
+{
+    QVector<Input> files;
+    for (const QString& input : m_options.inputs) {
+        QFileInfo info(input);
+        if (info.isDir()) {
+            QDir root(input);
+            QDirIterator it(input, QStringList() << "*.ply", QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                QString path = it.next();
+                QString relative = root.relativeFilePath(path);
+                files.append({ path, relative.left(relative.size() - QFileInfo(path).suffix().size() - 1) });
+            }
+        } else if (info.isFile()) {
+            files.append({ info.filePath(), info.completeBaseName() });
+        } else {
+            qWarning() << "Input not found:" << input;
+        }
+    }
+    return files;
+}
+
+QVector<ThumbnailBatch::Job> ThumbnailBatch::collectJobs(int& upToDateCount) const
+{
+    QVector<Job> jobs;
+    QSet<QString> names;
+    upToDateCount = 0;
+
+    for (const Input& input : collectInputs()) {
+        // 서로 다른 입력에서 같은 출력 이름이 나오면 앞의 것만 생성 (덮어쓰거나 최신으로 잘못 판단하지 않도록)
+        if (names.contains(input.name)) {
+            qWarning() << "Skipping" << input.path << "(output name already used by another input:" << input.name << ")";
+            continue;
+        }
+        names.insert(input.name);
+
+        Job job;
+        job.input = input.path;
+
+        // 입력보다 새로운 출력이 있는 프리셋은 건너뜀
+        for (const QString& preset : m_options.presets) {
+            QString output = getOutputPath(input.name, preset);
+            if (!m_options.force && isUpToDate(input.path, output)) continue;
+
+            job.presets << preset;
+            job.outputs << output;
+        }
+
+        if (job.outputs.isEmpty()) {
+            ++upToDateCount;
+        } else {
+            jobs.append(job);
+        }
+    }
+    return jobs;
+}
+
+QString ThumbnailBatch::getOutputPath(const QString& name, const QString& preset) const
+{
+    QString file = QString("%1_%2.%3").arg(name, preset.toLower(), m_options.format);
+    return QDir(m_options.outputDirectory).filePath(file);
+}
+
+bool ThumbnailBatch::isUpToDate(const QString& input, const QString& output)
+{
+    QFileInfo outputInfo(output);
+    return outputInfo.exists() && outputInfo.lastModified() >= QFileInfo(input).lastModified();
+}
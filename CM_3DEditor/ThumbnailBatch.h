@@ -0,0 +1,53 @@
+#ifndef THUMBNAILBATCH_H
+#define THUMBNAILBATCH_H
+
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QVector>
+#include <QThreadPool>
+
+// 여러 PLY 파일의 썸네일을 오프스크린으로 생성하는 배치 작업
+// 로드(파싱/클러스터링)와 이미지 인코딩은 스레드 풀에서, GL 렌더링은 호출 스레드에서 수행
+class ThumbnailBatch
+{
+public:
+    struct Options {
+        QStringList inputs;             // PLY 파일 또는 디렉터리 (하위 폴더 포함)
+        QString outputDirectory;
+        QStringList presets;            // Camera 시점 프리셋 이름
+        QSize size = QSize(256, 256);
+        QString format = "png";
+        bool force = false;             // 최신 출력도 다시 생성
+        int threads = 0;                // 0이면 코어 수
+    };
+
+    explicit ThumbnailBatch(const Options& options);
+
+    // 종료 코드 반환 (0: 모두 성공)
+    int run();
+
+private:
+    // 입력 파일과 출력 이름 (디렉터리 입력은 그 폴더 기준 상대 경로라 하위 폴더의 같은 파일명이 겹치지 않음)
+    struct Input {
+        QString path;
+        QString name;
+    };
+
+    // 파일 하나에서 다시 생성해야 하는 출력들
+    struct Job {
+        QString input;
+        QStringList presets;
+        QStringList outputs;
+    };
+
+    Options m_options;
+    QThreadPool m_pool;
+
+    QVector<Input> collectInputs() const;
+    QVector<Job> collectJobs(int& upToDateCount) const;
+    QString getOutputPath(const QString& name, const QString& preset) const;
+    static bool isUpToDate(const QString& input, const QString& output);
+};
+
+#endif // THUMBNAILBATCH_H
@@ -0,0 +1,320 @@
+#include "TiledScreenshot.h"
+#include "Renderer.h"
+#include <QtConcurrent>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <cstring>
+
+TiledScreenshot::TiledScreenshot(QObject* parent)
+    : QObject(parent)
+    , m_active(false)
+    , m_failed(false)
+    , m_nextTile(0)
+    , m_retiredCount(0)
+    , m_framebuffer(nullptr)
+    , m_resolveFramebuffer(nullptr)
+    , m_nextSlot(0)
+    , m_imageBits(nullptr)
+    , m_bytesPerLine(0)
+{
+    connect(&m_encodeWatcher, &QFutureWatcher<bool>::finished, this, [this]() {
+        bool success = m_encodeWatcher.result();
+        m_active = false;
+        emit finished(m_filename, success);
+    });
+}
+
+TiledScreenshot::~TiledScreenshot()
+{
+    // 작업 스레드가 타일 정보와 이미지를 참조하므로 먼저 끝날 때까지 대기
+    m_pool.waitForDone();
+    releaseResources();
+}
+
+bool TiledScreenshot::begin(Renderer* renderer, const QSize& imageSize, const QString& filename,
+                            int tileSize, int samples)
+{
+    if (m_active || !renderer || !renderer->getCamera() || imageSize.isEmpty()) return false;
+    if (!QOpenGLContext::currentContext()) return false;
+
+    initializeOpenGLFunctions();
+
+    // 타일 크기는 렌더버퍼/뷰포트 한계 이내
+    GLint maxRenderbufferSize = 0;
+    GLint maxViewportDims[2] = { 0, 0 };
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbufferSize);
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewportDims);
+    int limit = qMin(tileSize, qMin(int(maxRenderbufferSize), qMin(int(maxViewportDims[0]), int(maxViewportDims[1]))));
+    m_tileSize = QSize(qMin(limit, imageSize.width()), qMin(limit, imageSize.height()));
+
+    m_image = QImage(imageSize, QImage::Format_RGBA8888);
+    if (m_image.isNull()) {
+        qDebug() << "Cannot allocate screenshot image" << imageSize;
+        return false;
+    }
+    // 작업 스레드가 직접 쓰므로 미리 분리된 버퍼 포인터를 얻어 둠
+    m_imageBits = m_image.bits();
+    m_bytesPerLine = m_image.bytesPerLine();
+
+    QOpenGLFramebufferObjectFormat framebufferFormat;
+    framebufferFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    framebufferFormat.setSamples(samples);
+    m_framebuffer = new QOpenGLFramebufferObject(m_tileSize, framebufferFormat);
+    m_resolveFramebuffer = new QOpenGLFramebufferObject(m_tileSize);
+    if (!m_framebuffer->isValid() || !m_resolveFramebuffer->isValid()) {
+        qDebug() << "Failed to create screenshot tile framebuffer" << m_tileSize;
+        releaseResources();
+        m_image = QImage();
+        return false;
+    }
+
+    GLsizeiptr slotSize = GLsizeiptr(m_tileSize.width()) * m_tileSize.height() * 4;
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        glGenBuffers(1, &m_slots[i].buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_slots[i].buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, slotSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // 화면에 보이는 시점을 고정하고 종횡비만 출력 크기에 맞춤
+    m_camera = *renderer->getCamera();
+    m_camera.setAspectRatio(float(imageSize.width()) / float(imageSize.height()));
+    m_modelMatrix = renderer->getModelMatrix();
+
+    m_filename = filename;
+    m_imageSize = imageSize;
+    buildTiles();
+    m_nextTile = 0;
+    m_retiredCount = 0;
+    m_nextSlot = 0;
+    m_failed = false;
+    m_stitches.clear();
+    m_active = true;
+
+    qDebug() << "Capturing" << imageSize << "screenshot in" << m_tiles.size() << "tiles of" << m_tileSize;
+    return true;
+}
+
+bool TiledScreenshot::step(Renderer* renderer, int timeBudgetMs)
+{
+    if (!m_active || !m_framebuffer) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 끝난 readback을 제출 순서대로 대기 없이 회수
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        if (!retire(m_slots[(m_nextSlot + i) % ReadbackSlots], false)) break;
+    }
+
+    if (m_nextTile < m_tiles.size()) {
+        Camera* previousCamera = renderer->getCamera();
+        QMatrix4x4 previousModel = renderer->getModelMatrix();
+        int previousWidth = renderer->getViewportWidth();
+        int previousHeight = renderer->getViewportHeight();
+
+        renderer->setCamera(&m_camera);
+        renderer->setModelMatrix(m_modelMatrix);
+        renderer->setViewportSize(m_tileSize.width(), m_tileSize.height());
+
+        while (m_nextTile < m_tiles.size()) {
+            // 링이 가득 찼으면 가장 오래된 readback만 기다림
+            ReadbackSlot& slot = m_slots[m_nextSlot];
+            retire(slot, true);
+
+            renderTile(renderer, m_nextTile);
+            readTile(slot, m_nextTile);
+            ++m_nextTile;
+            m_nextSlot = (m_nextSlot + 1) % ReadbackSlots;
+
+            if (timer.elapsed() >= timeBudgetMs) break;
+        }
+
+        renderer->setCamera(previousCamera);
+        renderer->setModelMatrix(previousModel);
+        renderer->setViewportSize(previousWidth, previousHeight);
+    }
+
+    // 모든 타일을 회수하면 GL 리소스를 놓고 인코딩 시작
+    if (m_retiredCount < m_tiles.size()) return true;
+
+    releaseResources();
+    startEncode();
+    return false;
+}
+
+void TiledScreenshot::cancel()
+{
+    if (!m_active || m_encodeWatcher.isRunning()) return;
+
+    m_pool.waitForDone();
+    releaseResources();
+    m_image = QImage();
+    m_imageBits = nullptr;
+    m_stitches.clear();
+    m_active = false;
+    emit finished(m_filename, false);
+}
+
+void TiledScreenshot::buildTiles()
+{
+    m_tiles.clear();
+
+    const int width = m_imageSize.width();
+    const int height = m_imageSize.height();
+    const int tileWidth = m_tileSize.width();
+    const int tileHeight = m_tileSize.height();
+
+    for (int y = 0; y < height; y += tileHeight) {
+        for (int x = 0; x < width; x += tileWidth) {
+            Tile tile;
+            tile.imageRect = QRect(x, y, qMin(tileWidth, width - x), qMin(tileHeight, height - y));
+
+            // 가장자리 타일도 같은 픽셀 크기를 유지하도록 창은 이미지 밖까지 확장하고, 필요한 영역만 읽음
+            double left = -1.0 + 2.0 * x / width;
+            double right = -1.0 + 2.0 * (x + tileWidth) / width;
+            double top = 1.0 - 2.0 * y / height;
+            double bottom = 1.0 - 2.0 * (y + tileHeight) / height;
+            tile.window = QRectF(left, bottom, right - left, top - bottom);
+
+            m_tiles.append(tile);
+        }
+    }
+}
+
+void TiledScreenshot::renderTile(Renderer* renderer, int index)
+{
+    m_camera.setProjectionWindow(m_tiles[index].window);
+
+    m_framebuffer->bind();
+    renderer->render();
+
+    // 멀티샘플 해결
+    QOpenGLFramebufferObject::blitFramebuffer(m_resolveFramebuffer, m_framebuffer);
+}
+
+void TiledScreenshot::readTile(ReadbackSlot& slot, int index)
+{
+    const QRect& rect = m_tiles[index].imageRect;
+
+    // GL 행은 아래쪽 기준이므로 타일의 위쪽 rect.height()행만 PBO로 복사 (비동기)
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_resolveFramebuffer->handle());
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, m_tileSize.height() - rect.height(), rect.width(), rect.height(),
+                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.tile = index;
+}
+
+bool TiledScreenshot::retire(ReadbackSlot& slot, bool wait)
+{
+    if (slot.tile < 0) return true;
+
+    GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        if (!wait) return false;
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    const int index = slot.tile;
+    const QRect& rect = m_tiles[index].imageRect;
+    const int size = rect.width() * rect.height() * 4;
+
+    // 매핑은 GL 스레드에서만 가능하므로 복사만 하고 뒤집기/배치는 작업 스레드에서
+    QByteArray pixels;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (mapped) {
+        pixels = QByteArray(static_cast<const char*>(mapped), size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        qDebug() << "Failed to map screenshot readback buffer for tile" << index;
+        m_failed = true;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.tile = -1;
+    ++m_retiredCount;
+
+    if (!pixels.isEmpty()) {
+        m_stitches.append(QtConcurrent::run(&m_pool, [this, index, pixels]() {
+            stitch(index, pixels);
+        }));
+    }
+
+    emit progress(m_retiredCount, m_tiles.size());
+    return true;
+}
+
+void TiledScreenshot::stitch(int index, const QByteArray& pixels) const
+{
+    const QRect& rect = m_tiles[index].imageRect;
+    const int rowBytes = rect.width() * 4;
+    const uchar* source = reinterpret_cast<const uchar*>(pixels.constData());
+
+    // 타일마다 이미지의 서로 다른 영역을 쓰므로 잠금 없이 병렬 복사
+    for (int row = 0; row < rect.height(); ++row) {
+        const uchar* sourceRow = source + qsizetype(rect.height() - 1 - row) * rowBytes;
+        uchar* destRow = m_imageBits + qsizetype(rect.top() + row) * m_bytesPerLine + rect.left() * 4;
+        std::memcpy(destRow, sourceRow, rowBytes);
+
+        // 화면과 같이 불투명으로 저장 (블렌딩으로 알파가 1보다 작아질 수 있음)
+        for (int x = 3; x < rowBytes; x += 4) {
+            destRow[x] = 255;
+        }
+    }
+}
+
+void TiledScreenshot::startEncode()
+{
+    QImage image = m_image;
+    QString filename = m_filename;
+    QVector<QFuture<void>> stitches = m_stitches;
+    bool failed = m_failed;
+
+    // 이미지 소유권을 인코딩 작업으로 넘김 (공유 사본이 없어야 복사 없이 저장)
+    m_image = QImage();
+    m_imageBits = nullptr;
+    m_stitches.clear();
+
+    // 복사 작업이 같은 풀에 먼저 제출되었으므로 이 작업이 시작될 때는 모두 실행 중이거나 끝난 상태
+    m_encodeWatcher.setFuture(QtConcurrent::run(&m_pool, [image, filename, stitches, failed]() {
+        for (const QFuture<void>& stitch : stitches) {
+            stitch.waitForFinished();
+        }
+        if (failed) return false;
+
+        bool saved = image.save(filename);
+        if (!saved) {
+            qDebug() << "Failed to encode screenshot:" << filename;
+        }
+        return saved;
+    }));
+}
+
+void TiledScreenshot::releaseResources()
+{
+    if (QOpenGLContext::currentContext()) {
+        for (int i = 0; i < ReadbackSlots; ++i) {
+            if (m_slots[i].fence) glDeleteSync(m_slots[i].fence);
+            if (m_slots[i].buffer) glDeleteBuffers(1, &m_slots[i].buffer);
+        }
+    }
+    for (int i = 0; i < ReadbackSlots; ++i) {
+        m_slots[i] = ReadbackSlot();
+    }
+
+    delete m_framebuffer;
+    delete m_resolveFramebuffer;
+    m_framebuffer = nullptr;
+    m_resolveFramebuffer = nullptr;
+}
@@ -0,0 +1,96 @@
+#ifndef TILEDSCREENSHOT_H
+#define TILEDSCREENSHOT_H
+
+#include <QObject>
+#include <QOpenGLExtraFunctions>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QImage>
+#include <QSize>
+#include <QVector>
+#include "Camera.h"
+
+class Renderer;
+class QOpenGLFramebufferObject;
+
+// 창 해상도보다 큰 스크린샷을 타일 단위로 렌더링
+// 카메라의 부분 절두체로 타일을 오프스크린 FBO에 그리고, PBO 링으로 대기 없이 읽어
+// 작업 스레드에서 이어 붙이고 인코딩함. step()을 이벤트 루프에서 나누어 호출해 UI를 막지 않음
+class TiledScreenshot : public QObject, protected QOpenGLExtraFunctions
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ReadbackSlots = 3;
+    static constexpr int DefaultTileSize = 2048;
+
+    explicit TiledScreenshot(QObject* parent = nullptr);
+    ~TiledScreenshot();
+
+    // 캡처 시작 (GL 컨텍스트가 활성화되어 있어야 함). 카메라/모델 행렬은 이 시점 값으로 고정
+    bool begin(Renderer* renderer, const QSize& imageSize, const QString& filename,
+               int tileSize = DefaultTileSize, int samples = 4);
+
+    // 시간 예산 안에서 타일을 그리고 끝난 readback을 회수 (GL 컨텍스트 필요)
+    // GL 작업이 남아 있으면 true, 모두 끝나 인코딩 단계로 넘어갔으면 false
+    bool step(Renderer* renderer, int timeBudgetMs);
+
+    // 진행 중인 GL 작업 중단 (GL 컨텍스트 필요). 이미 시작된 인코딩은 완료됨
+    void cancel();
+
+    bool isActive() const { return m_active; }
+    int getTileCount() const { return m_tiles.size(); }
+    int getCompletedTileCount() const { return m_retiredCount; }
+
+signals:
+    void progress(int completedTiles, int totalTiles);
+    void finished(const QString& filename, bool success);
+
+private:
+    struct Tile {
+        QRect imageRect;        // 최종 이미지에서 이 타일이 채우는 영역 (위쪽 기준)
+        QRectF window;          // 카메라 투영 창 (NDC)
+    };
+
+    struct ReadbackSlot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        int tile = -1;          // 읽는 중인 타일 (-1이면 비어 있음)
+    };
+
+    bool m_active;
+    bool m_failed;
+    QString m_filename;
+    QSize m_imageSize;
+    QSize m_tileSize;
+    Camera m_camera;
+    QMatrix4x4 m_modelMatrix;
+
+    QVector<Tile> m_tiles;
+    int m_nextTile;
+    int m_retiredCount;
+
+    // GL 리소스 (캡처 동안만 존재)
+    QOpenGLFramebufferObject* m_framebuffer;
+    QOpenGLFramebufferObject* m_resolveFramebuffer;
+    ReadbackSlot m_slots[ReadbackSlots];
+    int m_nextSlot;
+
+    // 최종 이미지와 작업 스레드
+    QImage m_image;
+    uchar* m_imageBits;
+    qsizetype m_bytesPerLine;
+    QVector<QFuture<void>> m_stitches;
+    QThreadPool m_pool;
+    QFutureWatcher<bool> m_encodeWatcher;
+
+    void buildTiles();
+    void renderTile(Renderer* renderer, int index);
+    void readTile(ReadbackSlot& slot, int index);
+    bool retire(ReadbackSlot& slot, bool wait);
+    void stitch(int index, const QByteArray& pixels) const;
+    void startEncode();
+    void releaseResources();
+};
+
+#endif // TILEDSCREENSHOT_H
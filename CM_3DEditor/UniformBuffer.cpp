@@ -0,0 +1,92 @@
+#include "UniformBuffer.h"
+#include <QOpenGLContext>
+#include <QDebug>
+#include <cstring>
+
+UniformBuffer::UniformBuffer() : m_buffer(0), m_bindingPoint(0), m_size(0)
+{
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    destroy();
+}
+
+bool UniformBuffer::create(int size, GLuint bindingPoint)
+{
+    if (!QOpenGLContext::currentContext()) {
+        qDebug() << "UniformBuffer::create called without a current context";
+        return false;
+    }
+
+    initializeOpenGLFunctions();
+    destroy();
+
+    m_size = size;
+    m_bindingPoint = bindingPoint;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // 바인딩 포인트에 영구적으로 연결 (프로그램 쪽은 Shader가 block을 같은 포인트에 연결)
+    glBindBufferBase(GL_UNIFORM_BUFFER, m_bindingPoint, m_buffer);
+    return true;
+}
+
+void UniformBuffer::destroy()
+{
+    if (m_buffer != 0 && QOpenGLContext::currentContext()) {
+        glDeleteBuffers(1, &m_buffer);
+    }
+    m_buffer = 0;
+    m_size = 0;
+}
+
+void UniformBuffer::update(const void* data, int size)
+{
+    if (!m_buffer) return;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    // 전체 버퍼를 덮어쓰므로 orphaning으로 이전 프레임과의 동기화를 피함
+    if (size >= m_size) {
+        glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, qMin(size, m_size), data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::writeMatrix(float* dst, const QMatrix4x4& matrix)
+{
+    // QMatrix4x4는 column-major로 저장되므로 std140 mat4와 그대로 호환됨
+    std::memcpy(dst, matrix.constData(), 16 * sizeof(float));
+}
+
+void UniformBuffer::writeNormalMatrix(float* dst, const QMatrix4x4& model)
+{
+    // 법선 행렬(inverse-transpose)을 mat4에 채워 넣음 (쉐이더에서는 mat3로 사용)
+    QMatrix3x3 normal = model.normalMatrix();
+    const float* src = normal.constData();
+    for (int column = 0; column < 4; ++column) {
+        for (int row = 0; row < 4; ++row) {
+            dst[column * 4 + row] = (column < 3 && row < 3) ? src[column * 3 + row] : (column == row ? 1.0f : 0.0f);
+        }
+    }
+}
+
+void UniformBuffer::writeVector(float* dst, const QVector3D& vector, float w)
+{
+    dst[0] = vector.x();
+    dst[1] = vector.y();
+    dst[2] = vector.z();
+    dst[3] = w;
+}
+
+void UniformBuffer::writeColor(float* dst, const QColor& color)
+{
+    dst[0] = color.redF();
+    dst[1] = color.greenF();
+    dst[2] = color.blueF();
+    dst[3] = color.alphaF();
+}
@@ -0,0 +1,59 @@
+#ifndef UNIFORMBUFFER_H
+#define UNIFORMBUFFER_H
+
+#include <QOpenGLExtraFunctions>
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <QColor>
+
+// 쉐이더의 uniform block 바인딩 포인트
+enum UniformBlockBinding {
+    FrameBlockBinding = 0,
+    ObjectBlockBinding = 1
+};
+
+// std140 레이아웃: 쉐이더의 FrameBlock과 동일한 순서 (vec3는 vec4로 패딩)
+struct FrameUniforms {
+    float view[16];
+    float projection[16];
+    float viewProjection[16];
+    float viewPos[4];
+    float lightPos[4];
+    float lightColor[4];
+};
+
+// std140 레이아웃: 쉐이더의 ObjectBlock과 동일한 순서
+struct ObjectUniforms {
+    float model[16];
+    float normalMatrix[16];
+};
+
+// 프레임마다 한 번 갱신되어 모든 쉐이더가 공유하는 uniform buffer
+class UniformBuffer : protected QOpenGLExtraFunctions
+{
+public:
+    UniformBuffer();
+    ~UniformBuffer();
+
+    // 버퍼 생성 및 바인딩 포인트 연결
+    bool create(int size, GLuint bindingPoint);
+    void destroy();
+
+    // 데이터 갱신
+    void update(const void* data, int size);
+
+    bool isCreated() const { return m_buffer != 0; }
+
+    // std140 헬퍼
+    static void writeMatrix(float* dst, const QMatrix4x4& matrix);
+    static void writeNormalMatrix(float* dst, const QMatrix4x4& model);
+    static void writeVector(float* dst, const QVector3D& vector, float w = 0.0f);
+    static void writeColor(float* dst, const QColor& color);
+
+private:
+    GLuint m_buffer;
+    GLuint m_bindingPoint;
+    int m_size;
+};
+
+#endif // UNIFORMBUFFER_H
@@ -0,0 +1,148 @@
+#include "UniformRingBuffer.h"
+#include <QOpenGLContext>
+#include <QDebug>
+#include <cstring>
+
+UniformRingBuffer::UniformRingBuffer()
+    : m_buffer(0)
+    , m_bindingPoint(0)
+    , m_blockSize(0)
+    , m_alignedBlockSize(0)
+    , m_blocksPerFrame(0)
+    , m_frameIndex(0)
+    , m_blockCount(0)
+    , m_flushedCount(0)
+{
+    for (int i = 0; i < MaxFramesInFlight; ++i) {
+        m_fences[i] = nullptr;
+    }
+}
+
+UniformRingBuffer::~UniformRingBuffer()
+{
+    destroy();
+}
+
+bool UniformRingBuffer::create(int blockSize, int blocksPerFrame, GLuint bindingPoint)
+{
+    if (!QOpenGLContext::currentContext()) {
+        qDebug() << "UniformRingBuffer::create called without a current context";
+        return false;
+    }
+
+    initializeOpenGLFunctions();
+    destroy();
+
+    // glBindBufferRange 오프셋은 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT의 배수여야 함
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment <= 0) alignment = 256;
+
+    m_blockSize = blockSize;
+    m_alignedBlockSize = ((blockSize + alignment - 1) / alignment) * alignment;
+    m_blocksPerFrame = blocksPerFrame;
+    m_bindingPoint = bindingPoint;
+    m_frameIndex = 0;
+    m_blockCount = 0;
+    m_flushedCount = 0;
+    m_staging.resize(m_blocksPerFrame * m_alignedBlockSize);
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, segmentOffset(MaxFramesInFlight), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    return true;
+}
+
+void UniformRingBuffer::destroy()
+{
+    if (QOpenGLContext::currentContext()) {
+        for (int i = 0; i < MaxFramesInFlight; ++i) {
+            if (m_fences[i]) {
+                glDeleteSync(m_fences[i]);
+            }
+        }
+        if (m_buffer != 0) {
+            glDeleteBuffers(1, &m_buffer);
+        }
+    }
+
+    for (int i = 0; i < MaxFramesInFlight; ++i) {
+        m_fences[i] = nullptr;
+    }
+    m_buffer = 0;
+}
+
+void UniformRingBuffer::beginFrame()
+{
+    if (!m_buffer) return;
+
+    m_frameIndex = (m_frameIndex + 1) % MaxFramesInFlight;
+    m_blockCount = 0;
+    m_flushedCount = 0;
+
+    // 이 세그먼트를 읽던 프레임이 끝날 때까지 대기 (보통 이미 완료되어 있음)
+    GLsync fence = m_fences[m_frameIndex];
+    if (fence) {
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+        glDeleteSync(fence);
+        m_fences[m_frameIndex] = nullptr;
+    }
+}
+
+int UniformRingBuffer::push(const void* data)
+{
+    if (!m_buffer) return -1;
+
+    if (m_blockCount >= m_blocksPerFrame) {
+        qDebug() << "UniformRingBuffer overflow:" << m_blocksPerFrame << "blocks per frame";
+        return -1;
+    }
+
+    int local = m_blockCount * m_alignedBlockSize;
+    std::memcpy(m_staging.data() + local, data, m_blockSize);
+    ++m_blockCount;
+
+    return segmentOffset(m_frameIndex) + local;
+}
+
+void UniformRingBuffer::flush()
+{
+    if (!m_buffer || m_flushedCount == m_blockCount) return;
+
+    int localStart = m_flushedCount * m_alignedBlockSize;
+    int size = (m_blockCount - m_flushedCount) * m_alignedBlockSize;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    // 세그먼트는 fence로 보호되므로 동기화 없이 매핑
+    void* ptr = glMapBufferRange(GL_UNIFORM_BUFFER, segmentOffset(m_frameIndex) + localStart, size,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (ptr) {
+        std::memcpy(ptr, m_staging.constData() + localStart, size);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+    } else {
+        glBufferSubData(GL_UNIFORM_BUFFER, segmentOffset(m_frameIndex) + localStart, size,
+                        m_staging.constData() + localStart);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    m_flushedCount = m_blockCount;
+}
+
+void UniformRingBuffer::bind(int offset)
+{
+    if (!m_buffer || offset < 0) return;
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, m_bindingPoint, m_buffer, offset, m_blockSize);
+}
+
+void UniformRingBuffer::endFrame()
+{
+    if (!m_buffer) return;
+
+    m_fences[m_frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,51 @@
+#ifndef UNIFORMRINGBUFFER_H
+#define UNIFORMRINGBUFFER_H
+
+#include <QOpenGLExtraFunctions>
+#include <QByteArray>
+
+// 오브젝트별 uniform 데이터를 위한 동적 UBO 링 버퍼
+// 프레임마다 하나의 세그먼트에 블록을 쌓고, GPU가 아직 읽는 중인 세그먼트는 fence로 보호
+class UniformRingBuffer : protected QOpenGLExtraFunctions
+{
+public:
+    static constexpr int MaxFramesInFlight = 3;
+
+    UniformRingBuffer();
+    ~UniformRingBuffer();
+
+    // 버퍼 생성 (blockSize는 오프셋 정렬 단위로 올림)
+    bool create(int blockSize, int blocksPerFrame, GLuint bindingPoint);
+    void destroy();
+
+    // 프레임 단위 사용
+    void beginFrame();
+    int push(const void* data);
+    void flush();
+    void bind(int offset);
+    void endFrame();
+
+    bool isCreated() const { return m_buffer != 0; }
+    int getAlignedBlockSize() const { return m_alignedBlockSize; }
+    int getBlockSize() const { return m_blockSize; }
+    GLuint getBufferId() const { return m_buffer; }
+    GLuint getBindingPoint() const { return m_bindingPoint; }
+
+private:
+    GLuint m_buffer;
+    GLuint m_bindingPoint;
+    int m_blockSize;
+    int m_alignedBlockSize;
+    int m_blocksPerFrame;
+
+    // 현재 프레임 상태
+    int m_frameIndex;
+    int m_blockCount;
+    int m_flushedCount;
+    QByteArray m_staging;
+    GLsync m_fences[MaxFramesInFlight];
+
+    int segmentOffset(int frameIndex) const { return frameIndex * m_blocksPerFrame * m_alignedBlockSize; }
+};
+
+#endif // UNIFORMRINGBUFFER_H
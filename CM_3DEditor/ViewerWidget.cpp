@@ -1,6 +1,10 @@
 #include "ViewerWidget.h"
 #include <QDebug>
 #include <QtMath>
+#include <QCursor>
+#include <QtConcurrent>
+#include <algorithm>
+#include <numeric>
 
 ViewerWidget::ViewerWidget(QWidget* parent)
     : QOpenGLWidget(parent)
@@ -11,107 +15,1786 @@ ViewerWidget::ViewerWidget(QWidget* parent)
     , m_mouseButton(Qt::NoButton)
     , m_animationTimer(nullptr)
     , m_rotationAngle(0.0f)
+    , m_autoRotate(false)
+    , m_refineFrames(0)
+    , m_tickPending(false)
+    , m_windowFilterInstalled(false)
+    , m_profilerOverlayVisible(false)
+    , m_hoverEnabled(true)
+    , m_pickRequested(false)
+    , m_pickTag(HoverPick)
+    , m_pickTimer(nullptr)
+    , m_spatialCancel(false)
+    , m_bvh(nullptr)
+    , m_bvhWatcher(nullptr)
+    , m_bvhBuilding(false)
+    , m_selector(nullptr)
+    , m_selectorWatcher(nullptr)
+    , m_selectorBuilding(false)
+    , m_selectionTool(NoSelectionTool)
+    , m_regionDragging(false)
+    , m_sculptMode(false)
+    , m_sculpting(false)
+    , m_dabPending(false)
+    , m_dabModifiers(Qt::NoModifier)
+    , m_sculpt(nullptr)
+    , m_sculptWatcher(nullptr)
+    , m_sculptBuilding(false)
+    , m_brushCursorVisible(false)
+    , m_topology(nullptr)
+    , m_loadOrder(SpatialOrder::FileOrder)
+    , m_operation(NoOperation)
+    , m_operationRecorded(true)
+    , m_operationWatcher(nullptr)
+    , m_operationCancel(false)
+    , m_operationProgress(0)
+    , m_operationTimer(nullptr)
+    , m_componentsRevision(-1)
+    , m_componentsVisibilityRevision(-1)
+    , m_activeClipPlane(-1)
+    , m_contourVisible(true)
+    , m_slicerRevision(-1)
+    , m_slicerVertexRevision(-1)
+    , m_slicerVisibilityRevision(-1)
+    , m_measureMode(false)
+    , m_screenshot(nullptr)
+    , m_captureTimer(nullptr)
+    , m_sequenceExporter(nullptr)
 {
     // 마우스 추적 활성화
     setMouseTracking(true);
     setFocusPolicy(Qt::StrongFocus);
     
     // 애니메이션 타이머 설정
+    // 평소에는 변경이 있을 때만 다시 그리고, 애니메이션/점진적 갱신 중에만 틱 (updateTimerState)
     m_animationTimer = new QTimer(this);
+    m_animationTimer->setInterval(16); // ~60 FPS
     connect(m_animationTimer, &QTimer::timeout, this, &ViewerWidget::updateScene);
-    m_animationTimer->start(16); // ~60 FPS
+    
+    // 픽킹 결과 회수 (요청이 남아 있는 동안만)
+    m_pickTimer = new QTimer(this);
+    m_pickTimer->setInterval(2);
+    connect(m_pickTimer, &QTimer::timeout, this, &ViewerWidget::processPicks);
+    
+    // 백그라운드 공간 질의 구조 구축
+    m_bvhWatcher = new QFutureWatcher<Bvh*>(this);
+    connect(m_bvhWatcher, &QFutureWatcher<Bvh*>::finished, this, &ViewerWidget::bvhBuilt);
+    m_selectorWatcher = new QFutureWatcher<RegionSelector*>(this);
+    connect(m_selectorWatcher, &QFutureWatcher<RegionSelector*>::finished, this, &ViewerWidget::selectorBuilt);
+    m_sculptWatcher = new QFutureWatcher<SculptBrush*>(this);
+    connect(m_sculptWatcher, &QFutureWatcher<SculptBrush*>::finished, this, &ViewerWidget::sculptBuilt);
+    
+    // 메시 처리 연산 (진행률은 실행 중에만 주기적으로 알림)
+    m_operationWatcher = new QFutureWatcher<MeshData*>(this);
+    connect(m_operationWatcher, &QFutureWatcher<MeshData*>::finished, this, &ViewerWidget::meshOperationDone);
+    m_operationTimer = new QTimer(this);
+    m_operationTimer->setInterval(100);
+    connect(m_operationTimer, &QTimer::timeout, this, &ViewerWidget::reportOperationProgress);
+    
+    // 타일 스크린샷
+    m_screenshot = new TiledScreenshot(this);
+    connect(m_screenshot, &TiledScreenshot::progress, this, &ViewerWidget::screenshotProgress);
+    connect(m_screenshot, &TiledScreenshot::finished, this, &ViewerWidget::screenshotFinished);
+    
+    m_sequenceExporter = new SequenceExporter(this);
+    connect(m_sequenceExporter, &SequenceExporter::progress, this, &ViewerWidget::sequenceExportProgress);
+    connect(m_sequenceExporter, &SequenceExporter::finished, this, &ViewerWidget::sequenceExportFinished);
+    
+    m_captureTimer = new QTimer(this);
+    m_captureTimer->setInterval(0);
+    connect(m_captureTimer, &QTimer::timeout, this, &ViewerWidget::captureStep);
+}
+
+ViewerWidget::~ViewerWidget()
+{
+    cancelSpatialBuild();
+    if (m_operation != NoOperation) {
+        m_operationCancel = true;
+        m_operationWatcher->waitForFinished();
+        delete m_operationWatcher->result();
+    }
+    delete m_bvh;
+    delete m_selector;
+    delete m_sculpt;
+    delete m_topology;
+    
+    // GL 리소스 해제를 위해 컨텍스트 활성화
+    makeCurrent();
+    delete m_screenshot;
+    delete m_sequenceExporter;
+    m_screenshot = nullptr;
+    m_sequenceExporter = nullptr;
+    delete m_renderer;
+    delete m_mesh;
+    delete m_camera;
+    doneCurrent();
+}
+
+bool ViewerWidget::loadPLYFile(const QString& filename)
+{
+    // 파싱은 컨텍스트 없이 수행하고, 버퍼 생성/업로드만 위젯의 컨텍스트에서 수행
+    MeshData data;
+    if (!Mesh::loadData(filename, data)) {
+        return false;
+    }
+    
+    // 정점 재배치는 업로드 전에 (GPU 버퍼와 질의 구조가 모두 새 순서로 만들어짐)
+    QVector<int> permutation;
+    if (SpatialOrder::computeOrder(data.vertices, m_loadOrder, permutation)) {
+        SpatialOrder::apply(data, permutation);
+    }
+    
+    makeCurrent();
+    if (!m_mesh) {
+        m_mesh = new Mesh();
+    }
+    bool loaded = m_mesh->upload(data);
+    doneCurrent();
+    
+    if (loaded) {
+        m_vertexPermutation.swap(permutation);
+        m_primitives.clear();
+        m_primitiveBaseColors.clear();
+        clearClipPlanes();
+        
+        // 기록은 불러온 메시 안에서만 이어짐 (메시를 바꾸는 처리는 기록에 남기거나 그 자리에서 비움)
+        m_history.clear();
+        emit historyChanged();
+        
+        // 광선 질의 구조는 작업 스레드에서 (로드 완료를 늦추지 않음)
+        startSpatialBuild(data);
+        
+        // 법선이 없는 점군은 조명이 검게 나오므로 작업 스레드에서 추정 (기록에는 남기지 않음)
+        if (data.indices.isEmpty() && !MeshOperators::hasNormals(data.vertices)) {
+            estimatePointNormals();
+            m_operationRecorded = false;
+        }
+        fitToView();
+        update();
+        return true;
+    }
+    
+    return false;
+}
+
+void ViewerWidget::setRenderMode(Renderer::RenderMode mode)
+{
+    if (m_renderer) {
+        m_renderer->setRenderMode(mode);
+        // 점 모드에서는 정점 선택, 그 외에는 면 선택을 표시
+        updateRegionSelection();
+    }
+}
+
+void ViewerWidget::setShaderType(Renderer::ShaderType type)
+{
+    if (m_renderer) {
+        m_renderer->setShaderType(type);
+        update();
+    }
+}
+
+void ViewerWidget::setBackgroundColor(const QColor& color)
+{
+    if (m_renderer) {
+        m_renderer->setBackgroundColor(color);
+        update();
+    }
+}
+
+void ViewerWidget::setWireframeColor(const QColor& color)
+{
+    if (m_renderer) {
+        m_renderer->setWireframeColor(color);
+        update();
+    }
+}
+
+void ViewerWidget::setPointSize(float size)
+{
+    if (m_renderer) {
+        m_renderer->setPointSize(size);
+        update();
+    }
+}
+
+void ViewerWidget::setMultiDrawEnabled(bool enabled)
+{
+    if (m_renderer) {
+        m_renderer->setMultiDrawEnabled(enabled);
+        update();
+    }
+}
+
+void ViewerWidget::setOcclusionCullingEnabled(bool enabled)
+{
+    if (m_renderer) {
+        m_renderer->setOcclusionCullingEnabled(enabled);
+        update();
+    }
+}
+
+void ViewerWidget::setProfilerOverlayVisible(bool visible)
+{
+    m_profilerOverlayVisible = visible;
+    update();
+}
+
+bool ViewerWidget::savePLYFile(const QString& filename) const
+{
+    if (!m_mesh || !m_mesh->hasData()) return false;
+    
+    MeshData data;
+    data.vertices = m_mesh->getVertices();
+    data.indices = m_mesh->getIndices();
+    
+    // 로드할 때 재배치했으면 파일의 정점 번호로 되돌려 저장 (다른 도구의 정점 번호와 맞도록)
+    if (m_vertexPermutation.size() == data.vertices.size()) {
+        SpatialOrder::restore(data, m_vertexPermutation);
+    }
+    return Mesh::saveData(filename, data);
+}
+
+int ViewerWidget::getFileVertexId(int vertex) const
+{
+    if (vertex >= 0 && vertex < m_vertexPermutation.size()) {
+        return m_vertexPermutation[vertex];
+    }
+    return vertex;
+}
+
+bool ViewerWidget::exportProfile(const QString& filename) const
+{
+    const FrameProfiler* profiler = getProfiler();
+    return profiler && profiler->exportCsv(filename);
+}
+
+void ViewerWidget::setAutoRotate(bool enabled)
+{
+    m_autoRotate = enabled;
+    updateTimerState();
+    update();
+}
+
+void ViewerWidget::resetCamera()
+{
+    if (m_camera) {
+        m_camera->reset();
+        update();
+    }
+}
+
+void ViewerWidget::fitToView()
+{
+    if (!m_mesh || !m_camera) return;
+    
+    // 메시의 바운딩 박스 계산
+    QVector3D min, max;
+    m_mesh->getBoundingBox(min, max);
+    
+    // 메시 중심점 계산
+    QVector3D center = (min + max) * 0.5f;
+    float radius = m_mesh->getBoundingRadius();
+    
+    // 카메라 위치 설정
+    float distance = radius * 2.0f;
+    QVector3D cameraPos = center + QVector3D(distance, distance, distance);
+    
+    m_camera->setPosition(cameraPos);
+    m_camera->setTarget(center);
+    
+    update();
+}
+
+void ViewerWidget::setHoverHighlightEnabled(bool enabled)
+{
+    m_hoverEnabled = enabled;
+    if (!enabled && m_hover.isValid()) {
+        m_hover = PickResult();
+        if (m_renderer) {
+            m_renderer->setHoverHighlight(m_hover);
+        }
+        update();
+    }
+}
+
+void ViewerWidget::clearSelection()
+{
+    m_selection = PickResult();
+    if (m_renderer) {
+        m_renderer->setSelectionHighlight(m_selection);
+    }
+    update();
+}
+
+void ViewerWidget::requestPick(const QPoint& position, PickTag tag)
+{
+    // 클릭 요청은 뒤따르는 호버 요청으로 덮어쓰지 않음
+    if (!m_pickRequested || tag == SelectPick) {
+        m_pickTag = tag;
+    }
+    m_pickPosition = position;
+    m_pickRequested = true;
+    processPicks();
+}
+
+void ViewerWidget::refreshHover()
+{
+    // 시점이 바뀌면 커서 아래 대상도 바뀜
+    if (!m_hoverEnabled || m_mousePressed) return;
+    
+    QPoint position = mapFromGlobal(QCursor::pos());
+    if (rect().contains(position)) {
+        requestPick(position, HoverPick);
+    }
+}
+
+void ViewerWidget::processPicks()
+{
+    if (!m_renderer || !isValid()) {
+        m_pickTimer->stop();
+        return;
+    }
+    
+    makeCurrent();
+    
+    PickResult result;
+    while (m_renderer->pollPick(result)) {
+        handlePickResult(result);
+    }
+    if (m_pickRequested && m_renderer->pick(m_pickPosition, m_pickTag)) {
+        m_pickRequested = false;
+    }
+    bool pending = m_pickRequested || m_renderer->hasPendingPicks();
+    
+    doneCurrent();
+    
+    if (pending && !m_pickTimer->isActive()) {
+        m_pickTimer->start();
+    } else if (!pending) {
+        m_pickTimer->stop();
+    }
+}
+
+void ViewerWidget::handlePickResult(const PickResult& result)
+{
+    if (result.tag == SelectPick) {
+        m_selection = result;
+        m_renderer->setSelectionHighlight(m_selection);
+        emit picked(result);
+        update();
+        return;
+    }
+    
+    // 호버 대상이 바뀔 때만 다시 그림
+    if (!m_hoverEnabled || result.isSameTarget(m_hover)) return;
+    m_hover = result;
+    m_renderer->setHoverHighlight(m_hover);
+    update();
+}
+
+void ViewerWidget::startSpatialBuild(const MeshData& data)
+{
+    cancelSpatialBuild();
+    cancelMeshOperation();
+    delete m_bvh;
+    delete m_selector;
+    delete m_sculpt;
+    delete m_topology;
+    m_bvh = nullptr;
+    m_selector = nullptr;
+    m_sculpt = nullptr;
+    m_topology = nullptr;
+    m_sculpting = false;
+    m_dabPending = false;
+    m_brushCursorVisible = false;
+    
+    // 클러스터링에서 구한 연결 성분은 방금 올린 메시의 것이므로 그대로 씀 (없으면 분석할 때 구함)
+    m_components = data.components;
+    m_componentsRevision = m_mesh->getRevision();
+    m_componentsVisibilityRevision = m_mesh->getVisibilityRevision();
+    clearMeasurement();
+    m_vertexSelection.resize(0);
+    m_faceSelection.resize(0);
+    updateRegionSelection();
+    
+    // 정점/인덱스 배열은 암시적 공유라 복사 비용 없음
+    QVector<VertexData> vertices = data.vertices;
+    QVector<unsigned int> indices = data.indices;
+    std::atomic_bool* cancel = &m_spatialCancel;
+    m_spatialCancel = false;
+    
+    m_bvhBuilding = true;
+    m_bvhWatcher->setFuture(QtConcurrent::run([vertices, indices, cancel]() -> Bvh* {
+        Bvh* bvh = new Bvh();
+        if (!bvh->build(vertices, indices, cancel)) {
+            delete bvh;
+            return nullptr;
+        }
+        return bvh;
+    }));
+    
+    m_selectorBuilding = true;
+    m_selectorWatcher->setFuture(QtConcurrent::run([vertices, indices, cancel]() -> RegionSelector* {
+        RegionSelector* selector = new RegionSelector();
+        if (!selector->build(vertices, indices, cancel)) {
+            delete selector;
+            return nullptr;
+        }
+        return selector;
+    }));
+    
+    // 브러시 크기는 모델 크기에 맞춤
+    m_brush.radius = m_mesh->getBoundingRadius() * 0.05f;
+    if (m_sculptMode) {
+        startSculptBuild();
+    }
+}
+
+void ViewerWidget::startSculptBuild()
+{
+    if (m_sculpt || m_sculptBuilding || !m_mesh || m_mesh->getIndices().isEmpty()) return;
+    
+    QVector<unsigned int> indices = m_mesh->getIndices();
+    int vertexCount = m_mesh->getVertices().size();
+    std::atomic_bool* cancel = &m_spatialCancel;
+    
+    m_sculptBuilding = true;
+    m_sculptWatcher->setFuture(QtConcurrent::run([indices, vertexCount, cancel]() -> SculptBrush* {
+        SculptBrush* sculpt = new SculptBrush();
+        if (!sculpt->build(indices, vertexCount, cancel)) {
+            delete sculpt;
+            return nullptr;
+        }
+        return sculpt;
+    }));
+}
+
+void ViewerWidget::cancelSpatialBuild()
+{
+    if (!m_bvhBuilding && !m_selectorBuilding && !m_sculptBuilding) return;
+    
+    // 구축은 단계마다 취소를 확인하므로 곧 끝남. 이미 끝났다면 결과만 버림
+    m_spatialCancel = true;
+    if (m_bvhBuilding) {
+        m_bvhWatcher->waitForFinished();
+        delete m_bvhWatcher->result();
+        m_bvhBuilding = false;
+    }
+    if (m_selectorBuilding) {
+        m_selectorWatcher->waitForFinished();
+        delete m_selectorWatcher->result();
+        m_selectorBuilding = false;
+    }
+    if (m_sculptBuilding) {
+        m_sculptWatcher->waitForFinished();
+        delete m_sculptWatcher->result();
+        m_sculptBuilding = false;
+    }
+}
+
+void ViewerWidget::bvhBuilt()
+{
+    // 취소된 구축의 늦은 알림은 무시
+    if (!m_bvhBuilding) return;
+    m_bvhBuilding = false;
+    
+    m_bvh = m_bvhWatcher->result();
+    if (m_bvh) {
+        emit rayQueryReady();
+    }
+}
+
+void ViewerWidget::selectorBuilt()
+{
+    if (!m_selectorBuilding) return;
+    m_selectorBuilding = false;
+    
+    m_selector = m_selectorWatcher->result();
+    if (m_selector) {
+        m_vertexSelection.resize(m_selector->getElementCount(RegionSelector::Vertices));
+        m_faceSelection.resize(m_selector->getElementCount(RegionSelector::Faces));
+    }
+}
+
+void ViewerWidget::sculptBuilt()
+{
+    if (!m_sculptBuilding) return;
+    m_sculptBuilding = false;
+    
+    m_sculpt = m_sculptWatcher->result();
+}
+
+bool ViewerWidget::screenRay(const QPoint& position, QVector3D& origin, QVector3D& direction) const
+{
+    if (!m_renderer || !m_camera || width() <= 0 || height() <= 0) return false;
+    
+    // 픽셀 중심의 NDC 좌표를 근/원 평면으로 역투영 (모델 행렬까지 풀어 객체 공간으로)
+    float x = 2.0f * (position.x() + 0.5f) / width() - 1.0f;
+    float y = 1.0f - 2.0f * (position.y() + 0.5f) / height();
+    
+    bool invertible = false;
+    QMatrix4x4 inverse = (m_camera->getViewProjectionMatrix() * m_renderer->getModelMatrix()).inverted(&invertible);
+    if (!invertible) return false;
+    
+    origin = inverse.map(QVector3D(x, y, -1.0f));
+    direction = inverse.map(QVector3D(x, y, 1.0f)) - origin;
+    return true;
+}
+
+QPointF ViewerWidget::projectToScreen(const QVector3D& objectPoint) const
+{
+    QVector3D ndc = (m_camera->getViewProjectionMatrix() * m_renderer->getModelMatrix()).map(objectPoint);
+    return QPointF((ndc.x() + 1.0f) * 0.5f * width(), (1.0f - ndc.y()) * 0.5f * height());
+}
+
+bool ViewerWidget::raycast(const QPoint& position, QVector3D& hitPoint, int* vertex, bool snap) const
+{
+    if (vertex) *vertex = -1;
+    if (!m_bvh) return false;
+    
+    QVector3D origin, direction;
+    if (!screenRay(position, origin, direction)) return false;
+    
+    BvhHit hit;
+    if (!m_bvh->raycast(origin, direction, hit, FLT_MAX, hiddenElements(true))) return false;
+    hitPoint = hit.position;
+    
+    if (snap) {
+        // 맞은 삼각형의 꼭짓점 중 화면에서 가장 가까운 것
+        float bestDistance = SnapRadius * SnapRadius;
+        for (int corner = 0; corner < 3; ++corner) {
+            quint32 index = m_bvh->getVertexIndex(hit.triangle, corner);
+            QVector3D candidate = m_bvh->getVertexPosition(index);
+            QPointF offset = projectToScreen(candidate) - QPointF(position);
+            float distance = float(QPointF::dotProduct(offset, offset));
+            if (distance <= bestDistance) {
+                bestDistance = distance;
+                hitPoint = candidate;
+                if (vertex) *vertex = int(index);
+            }
+        }
+    }
+    return true;
+}
+
+void ViewerWidget::setMeasureMode(bool enabled)
+{
+    m_measureMode = enabled;
+    if (!enabled) {
+        clearMeasurement();
+    }
+}
+
+void ViewerWidget::clearMeasurement()
+{
+    if (!m_measurePoints.isEmpty()) {
+        m_measurePoints.clear();
+        update();
+    }
+}
+
+void ViewerWidget::addMeasurePoint(const QPoint& position)
+{
+    QVector3D point;
+    int vertex = -1;
+    if (!raycast(position, point, &vertex, true)) return;
+    
+    // 두 점이 찍혀 있으면 새 측정 시작
+    if (m_measurePoints.size() >= 2) {
+        m_measurePoints.clear();
+    }
+    m_measurePoints.append(point);
+    emit measurePointAdded(point, vertex);
+    
+    if (m_measurePoints.size() == 2) {
+        emit distanceMeasured((m_measurePoints[1] - m_measurePoints[0]).length());
+    }
+    update();
+}
+
+void ViewerWidget::setSelectionTool(SelectionTool tool)
+{
+    m_selectionTool = tool;
+    if (m_regionDragging) {
+        m_regionDragging = false;
+        update();
+    }
+}
+
+void ViewerWidget::setSculptMode(bool enabled)
+{
+    m_sculptMode = enabled;
+    m_sculpting = false;
+    m_dabPending = false;
+    if (m_history.endVertexEdit()) {
+        emit historyChanged();
+    }
+    if (enabled) {
+        // 브러시 커서가 호버 강조를 대신함
+        if (m_hover.isValid()) {
+            m_hover = PickResult();
+            if (m_renderer) {
+                m_renderer->setHoverHighlight(m_hover);
+            }
+            update();
+        }
+        startSculptBuild();
+    } else if (m_brushCursorVisible) {
+        m_brushCursorVisible = false;
+        update();
+    }
+}
+
+void ViewerWidget::setBrushStrength(float strength)
+{
+    m_brush.strength = qBound(0.0f, strength, 1.0f);
+}
+
+void ViewerWidget::scaleBrushRadius(float factor)
+{
+    if (!m_mesh || factor <= 0.0f) return;
+    
+    float maxRadius = m_mesh->getBoundingRadius();
+    m_brush.radius = qBound(maxRadius * 0.001f, m_brush.radius * factor, maxRadius);
+    emit brushRadiusChanged(m_brush.radius);
+    if (m_brushCursorVisible) {
+        update();
+    }
+}
+
+void ViewerWidget::updateBrushCursor(const QPoint& position)
+{
+    QVector3D center;
+    bool visible = raycast(position, center);
+    if (!visible && !m_brushCursorVisible) return;
+    
+    m_brushCursorVisible = visible;
+    m_brushCenter = center;
+    update();
+}
+
+void ViewerWidget::applyPendingDab()
+{
+    m_dabPending = false;
+    if (!m_sculpt || !m_bvh) return;
+    
+    QVector3D origin, direction;
+    if (!screenRay(m_dabPosition, origin, direction)) return;
+    BvhHit hit;
+    if (!m_bvh->raycast(origin, direction, hit, FLT_MAX, hiddenElements(true))) {
+        m_brushCursorVisible = false;
+        return;
+    }
+    m_brushCursorVisible = true;
+    m_brushCenter = hit.position;
+    
+    BrushSettings settings = m_brush;
+    if (m_dabModifiers & Qt::ShiftModifier) {
+        settings.mode = BrushSettings::Smooth;
+    }
+    if (m_dabModifiers & Qt::ControlModifier) {
+        settings.invert = !settings.invert;
+    }
+    
+    BrushResult result;
+    if (!m_sculpt->apply(m_mesh->editVertices(), m_mesh->getIndices().constData(), hit.position, hit.triangle,
+                         settings, result)) {
+        return;
+    }
+    m_history.recordVertices(result.vertices, result.previousPositions, result.previousNormals);
+    
+    // 바뀐 구간만 업로드하고, CPU 질의 구조도 바뀐 부분만 고침 (paintGL 안이므로 컨텍스트는 활성 상태)
+    m_mesh->updateVertices(result.vertices, result.triangles);
+    m_bvh->refit(m_mesh->getVertices(), result.movedVertices, result.triangles);
+    if (m_selector) {
+        m_selector->update(m_mesh->getVertices(), m_mesh->getIndices(), result.movedVertices, result.triangles);
+    }
+}
+
+bool ViewerWidget::isFaceSelection() const
+{
+    return m_renderer && m_renderer->getRenderMode() != Renderer::Points
+        && m_selector && m_selector->getElementCount(RegionSelector::Faces) > 0;
+}
+
+const SelectionSet& ViewerWidget::getRegionSelection() const
+{
+    return isFaceSelection() ? m_faceSelection : m_vertexSelection;
+}
+
+bool ViewerWidget::selectRegion(const SelectionRegion& region, SelectionOperation operation)
+{
+    if (!m_selector || !m_renderer || !m_camera) return false;
+    
+    const bool faces = isFaceSelection();
+    SelectionSet& selection = faces ? m_faceSelection : m_vertexSelection;
+    QMatrix4x4 modelViewProjection = m_camera->getViewProjectionMatrix() * m_renderer->getModelMatrix();
+    
+    SelectionSet hits;
+    m_selector->select(faces ? RegionSelector::Faces : RegionSelector::Vertices,
+                       modelViewProjection, size(), region, hits);
+    if (const SelectionSet* hidden = hiddenElements(faces)) {
+        hits.subtract(*hidden);
+    }
+    
+    switch (operation) {
+        case ReplaceSelection:
+            selection = hits;
+            break;
+        case AddToSelection:
+            selection.unite(hits);
+            break;
+        case SubtractFromSelection:
+            selection.subtract(hits);
+            break;
+        case IntersectSelection:
+            selection.intersect(hits);
+            break;
+    }
+    
+    updateRegionSelection();
+    return true;
+}
+
+void ViewerWidget::selectAll()
+{
+    const bool faces = isFaceSelection();
+    SelectionSet& selection = faces ? m_faceSelection : m_vertexSelection;
+    selection.fill();
+    if (const SelectionSet* hidden = hiddenElements(faces)) {
+        selection.subtract(*hidden);
+    }
+    updateRegionSelection();
+}
+
+void ViewerWidget::invertSelection()
+{
+    const bool faces = isFaceSelection();
+    SelectionSet& selection = faces ? m_faceSelection : m_vertexSelection;
+    selection.invert();
+    if (const SelectionSet* hidden = hiddenElements(faces)) {
+        selection.subtract(*hidden);
+    }
+    updateRegionSelection();
+}
+
+void ViewerWidget::clearRegionSelection()
+{
+    m_vertexSelection.clear();
+    m_faceSelection.clear();
+    updateRegionSelection();
+}
+
+bool ViewerWidget::hideSelection()
+{
+    if (!m_mesh) return false;
+    
+    const bool faces = isFaceSelection();
+    SelectionSet& selection = faces ? m_faceSelection : m_vertexSelection;
+    if (!selection.hasAny()) return false;
+    
+    SelectionSet hidden = faces ? m_mesh->getHiddenFaces() : m_mesh->getHiddenVertices();
+    if (!hidden.unite(selection) || !applyHidden(hidden, faces)) return false;
+    
+    // 숨긴 원소는 선택에서도 빠짐
+    selection.clear();
+    updateRegionSelection();
+    return true;
+}
+
+bool ViewerWidget::isolateSelection()
+{
+    if (!m_mesh) return false;
+    
+    const bool faces = isFaceSelection();
+    const SelectionSet& selection = faces ? m_faceSelection : m_vertexSelection;
+    if (!selection.hasAny()) return false;
+    
+    SelectionSet hidden = selection;
+    hidden.invert();
+    if (!hidden.unite(faces ? m_mesh->getHiddenFaces() : m_mesh->getHiddenVertices())) return false;
+    return applyHidden(hidden, faces);
+}
+
+void ViewerWidget::unhideAll()
+{
+    if (!m_mesh) return;
+    
+    if (m_mesh->getHiddenFaceCount() > 0) {
+        SelectionSet hidden = m_mesh->getHiddenFaces();
+        hidden.clear();
+        applyHidden(hidden, true);
+    }
+    if (m_mesh->getHiddenVertexCount() > 0) {
+        SelectionSet hidden = m_mesh->getHiddenVertices();
+        hidden.clear();
+        applyHidden(hidden, false);
+    }
+}
+
+bool ViewerWidget::applyHidden(const SelectionSet& hidden, bool faces, bool record)
+{
+    // 이전 상태는 암시적 공유라 복사 없음 (바뀐 워드만 기록에 남김)
+    SelectionSet before = faces ? m_mesh->getHiddenFaces() : m_mesh->getHiddenVertices();
+    
+    makeCurrent();
+    bool applied = faces ? m_mesh->setHiddenFaces(hidden) : m_mesh->setHiddenVertices(hidden);
+    doneCurrent();
+    if (!applied) return false;
+    
+    int hiddenCount = faces ? m_mesh->getHiddenFaceCount() : m_mesh->getHiddenVertexCount();
+    
+    if (record && m_history.pushHidden(faces, before, hidden, faces ? "Hide Faces" : "Hide Vertices")) {
+        emit historyChanged();
+    }
+    
+    // 숨긴 대상이 강조된 채 남지 않도록 픽킹 선택 해제
+    clearSelection();
+    emit hiddenChanged(hiddenCount, faces);
+    update();
+    return true;
+}
+
+bool ViewerWidget::undo()
+{
+    return applyHistory(true);
+}
+
+bool ViewerWidget::redo()
+{
+    return applyHistory(false);
+}
+
+bool ViewerWidget::applyHistory(bool undo)
+{
+    // 스트로크 중에는 기록이 아직 닫히지 않음. 메시 처리 결과는 시작 시점의 상태로 만들어짐
+    // 메시를 되돌린 뒤 구축 중인 질의 구조는 그 메시로 만들어지므로 끝난 뒤에 이어서 적용
+    if (!m_mesh || m_sculpting || isMeshOperationRunning()) return false;
+    if (m_bvhBuilding || m_selectorBuilding || m_sculptBuilding) return false;
+    
+    auto apply = [this](EditDelta& delta) {
+        switch (delta.kind) {
+            case EditDelta::Vertices:
+                return swapVertices(delta);
+            case EditDelta::Triangles:
+                return swapTriangles(delta);
+            case EditDelta::WholeMesh:
+                return swapMesh(delta);
+            default:
+                return swapHidden(delta);
+        }
+    };
+    bool applied = undo ? m_history.undo(apply) : m_history.redo(apply);
+    if (!applied) return false;
+    
+    emit historyChanged();
+    return true;
+}
+
+bool ViewerWidget::swapVertices(EditDelta& delta)
+{
+    // 번호는 오름차순이므로 끝 값만 확인
+    const int vertexCount = m_mesh->getVertices().size();
+    if (delta.elements.isEmpty() || delta.elements.first() < 0 || delta.elements.last() >= vertexCount) {
+        return false;
+    }
+    
+    // 메시 전체 연산(스무딩)의 기록이면 모든 삼각형, 스컬프트 기록이면 인접 목록으로 닿은 삼각형
+    QVector<int> triangles;
+    if (delta.elements.size() == vertexCount) {
+        triangles.resize(m_mesh->getIndices().size() / 3);
+        std::iota(triangles.begin(), triangles.end(), 0);
+    } else if (m_sculpt) {
+        m_sculpt->collectTriangles(delta.elements, triangles);
+    } else {
+        // 메시를 되돌린 직후처럼 인접 목록이 없으면 인덱스를 한 번 훑어 닿은 삼각형을 모음
+        SelectionSet touched(vertexCount);
+        for (int v : delta.elements) {
+            touched.set(v);
+        }
+        const QVector<unsigned int>& indices = m_mesh->getIndices();
+        for (int t = 0; t < indices.size() / 3; ++t) {
+            if (touched.test(indices[t * 3]) || touched.test(indices[t * 3 + 1]) || touched.test(indices[t * 3 + 2])) {
+                triangles.append(t);
+            }
+        }
+    }
+    
+    VertexData* vertices = m_mesh->editVertices();
+    for (int i = 0; i < delta.elements.size(); ++i) {
+        const int v = delta.elements[i];
+        std::swap(vertices[v].position, delta.positions[i]);
+        std::swap(vertices[v].normal, delta.normals[i]);
+    }
+    
+    // 저장된 값에 법선도 들어 있으므로 다시 계산 없이 바뀐 구간만 올림
+    makeCurrent();
+    m_mesh->updateVertices(delta.elements, triangles);
+    doneCurrent();
+    if (m_bvh) {
+        m_bvh->refit(m_mesh->getVertices(), delta.elements, triangles);
+    }
+    if (m_selector) {
+        m_selector->update(m_mesh->getVertices(), m_mesh->getIndices(), delta.elements, triangles);
+    }
+    update();
+    return true;
+}
+
+bool ViewerWidget::swapHidden(EditDelta& delta)
+{
+    const bool faces = delta.kind == EditDelta::HiddenFaces;
+    SelectionSet hidden = faces ? m_mesh->getHiddenFaces() : m_mesh->getHiddenVertices();
+    if (delta.elements.isEmpty() || delta.elements.first() < 0
+        || delta.elements.last() >= hidden.getWordCount()) {
+        return false;
+    }
+    
+    quint64* words = hidden.data();
+    for (int i = 0; i < delta.elements.size(); ++i) {
+        std::swap(words[delta.elements[i]], delta.words[i]);
+    }
+    return applyHidden(hidden, faces, false);
+}
+
+bool ViewerWidget::swapTriangles(EditDelta& delta)
+{
+    // 메시를 되돌리면 위상 구조가 지워지므로 필요할 때 다시 만듦
+    if (m_sculptBuilding || delta.elements.isEmpty() || !getTopology()) return false;
+    
+    QVector<unsigned int> current;
+    const QVector<unsigned int>& indices = m_topology->getIndices();
+    for (int t : delta.elements) {
+        if (t < 0 || t >= m_topology->getFaceCount()) return false;
+        current << indices[t * 3] << indices[t * 3 + 1] << indices[t * 3 + 2];
+    }
+    if (!m_topology->replaceTriangles(delta.elements, delta.indices)) return false;
+    
+    delta.indices = current;
+    applyTopologyEdit(delta.elements);
+    return true;
+}
+
+bool ViewerWidget::swapMesh(EditDelta& delta)
+{
+    const MeshData& data = delta.mesh;
+    const int faceWords = (data.indices.size() / 3 + 63) / 64;
+    const int vertexWords = (data.vertices.size() + 63) / 64;
+    if (data.vertices.isEmpty() || delta.words.size() != faceWords + vertexWords) return false;
+    
+    SelectionSet hiddenFaces(data.indices.size() / 3);
+    SelectionSet hiddenVertices(data.vertices.size());
+    std::copy(delta.words.constBegin(), delta.words.constBegin() + faceWords, hiddenFaces.data());
+    std::copy(delta.words.constBegin() + faceWords, delta.words.constEnd(), hiddenVertices.data());
+    
+    // 지금 메시는 같은 기록 자리에 반대 방향으로 남음 (압축은 기록이 작업 스레드에서 함)
+    EditDelta current = getMeshState();
+    
+    makeCurrent();
+    bool uploaded = m_mesh->upload(data);
+    if (uploaded && hiddenFaces.hasAny()) {
+        m_mesh->setHiddenFaces(hiddenFaces);
+    }
+    if (uploaded && hiddenVertices.hasAny()) {
+        m_mesh->setHiddenVertices(hiddenVertices);
+    }
+    doneCurrent();
+    if (!uploaded) return false;
+    
+    // 칠한 도형 색은 정점 색에 남아 있으므로 원래 색 보관만 버림
+    m_vertexPermutation = delta.order;
+    m_primitives.clear();
+    m_primitiveBaseColors.clear();
+    startSpatialBuild(data);
+    
+    delta = current;
+    return true;
+}
+
+EditDelta ViewerWidget::getMeshState() const
+{
+    // 편집으로 갱신된 클러스터 경계까지 현재 상태 그대로 (암시적 공유라 복사 없음)
+    EditDelta state;
+    state.kind = EditDelta::WholeMesh;
+    state.mesh.vertices = m_mesh->getVertices();
+    state.mesh.indices = m_mesh->getIndices();
+    state.mesh.clusters = m_mesh->getClusters();
+    m_mesh->getBoundingBox(state.mesh.boundingBoxMin, state.mesh.boundingBoxMax);
+    state.mesh.boundingRadius = m_mesh->getBoundingRadius();
+    state.order = m_vertexPermutation;
+    
+    const SelectionSet& hiddenFaces = m_mesh->getHiddenFaces();
+    const SelectionSet& hiddenVertices = m_mesh->getHiddenVertices();
+    state.words.resize(hiddenFaces.getWordCount() + hiddenVertices.getWordCount());
+    std::copy(hiddenFaces.constData(), hiddenFaces.constData() + hiddenFaces.getWordCount(), state.words.begin());
+    std::copy(hiddenVertices.constData(), hiddenVertices.constData() + hiddenVertices.getWordCount(),
+              state.words.begin() + hiddenFaces.getWordCount());
+    return state;
+}
+
+const HalfEdgeMesh* ViewerWidget::getTopology()
+{
+    if (!m_topology && m_mesh && !m_mesh->getIndices().isEmpty()) {
+        HalfEdgeMesh* topology = new HalfEdgeMesh();
+        if (topology->build(m_mesh->getIndices(), m_mesh->getVertices().size())) {
+            m_topology = topology;
+        } else {
+            delete topology;
+        }
+    }
+    return m_topology;
+}
+
+ViewerWidget::FlipEdgeResult ViewerWidget::flipSelectedEdge()
+{
+    // 백그라운드 구축 중인 구조는 원래 삼각형으로 만들어지므로 끝난 뒤에만 편집
+    if (m_sculpting || m_bvhBuilding || m_selectorBuilding || m_sculptBuilding || isMeshOperationRunning()) return EdgeNotSelected;
+    if (m_selection.type != PickResult::Face || !getTopology()) return EdgeNotSelected;
+    
+    const int face = int(m_selection.primitive);
+    if (face >= m_topology->getFaceCount()) return EdgeNotSelected;
+    
+    // 클릭한 점에서 가장 가까운 변 (광선 질의가 아직 없으면 첫 변)
+    int halfEdge = face * 3;
+    QVector3D hitPoint;
+    if (raycast(m_selection.position, hitPoint)) {
+        const QVector<VertexData>& vertices = m_mesh->getVertices();
+        float bestDistance = FLT_MAX;
+        for (int h = face * 3; h < face * 3 + 3; ++h) {
+            const QVector3D& a = vertices[m_topology->origin(h)].position;
+            const QVector3D edge = vertices[m_topology->target(h)].position - a;
+            float t = edge.lengthSquared() > 0.0f
+                    ? qBound(0.0f, QVector3D::dotProduct(hitPoint - a, edge) / edge.lengthSquared(), 1.0f) : 0.0f;
+            float distance = (a + edge * t - hitPoint).lengthSquared();
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                halfEdge = h;
+            }
+        }
+    }
+    
+    // 숨긴 면과 이어진 변은 뒤집지 않음
+    const int twin = m_topology->twin(halfEdge);
+    const SelectionSet* hidden = hiddenElements(true);
+    if (twin < 0 || (hidden && (hidden->test(face) || hidden->test(HalfEdgeMesh::face(twin))))) return EdgeNotFlippable;
+    
+    QVector<unsigned int> before;
+    const QVector<unsigned int>& indices = m_topology->getIndices();
+    for (int t : { qMin(face, HalfEdgeMesh::face(twin)), qMax(face, HalfEdgeMesh::face(twin)) }) {
+        before << indices[t * 3] << indices[t * 3 + 1] << indices[t * 3 + 2];
+    }
+    
+    QVector<int> triangles;
+    if (!m_topology->flipEdge(halfEdge, &triangles)) return EdgeNotFlippable;
+    
+    applyTopologyEdit(triangles);
+    if (m_history.pushTriangles(triangles, before, "Flip Edge")) {
+        emit historyChanged();
+    }
+    return EdgeFlipped;
+}
+
+void ViewerWidget::applyTopologyEdit(const QVector<int>& triangles)
+{
+    // 위상 구조의 배열이 곧 인덱스 버퍼 배치이므로 바뀐 삼각형 자리만 그대로 올림
+    const QVector<unsigned int>& indices = m_topology->getIndices();
+    makeCurrent();
+    m_mesh->updateTriangles(indices.constData(), triangles);
+    doneCurrent();
+    if (m_bvh) {
+        m_bvh->updateTriangles(indices, triangles);
+    }
+    if (m_selector) {
+        m_selector->update(m_mesh->getVertices(), indices, QVector<int>(), triangles);
+    }
+    
+    // 정점별 삼각형 목록은 차수가 바뀌므로 버리고 (스컬프트 모드면) 작업 스레드에서 다시 만듦
+    delete m_sculpt;
+    m_sculpt = nullptr;
+    if (m_sculptMode) {
+        startSculptBuild();
+    }
+    update();
+}
+
+bool ViewerWidget::smoothMesh(const SmoothSettings& settings)
+{
+    // 광선 질의 구조는 결과 위치로 리핏하므로 구축이 끝난 뒤에만
+    if (!m_mesh || m_mesh->getIndices().isEmpty() || isMeshOperationRunning() || m_sculpting) return false;
+    if (m_bvhBuilding || m_selectorBuilding) return false;
+    
+    QVector<VertexData> vertices = m_mesh->getVertices();
+    QVector<unsigned int> indices = m_mesh->getIndices();
+    std::atomic_bool* cancel = &m_operationCancel;
+    std::atomic_int* progress = &m_operationProgress;
+    
+    startMeshOperation(SmoothOperation);
+    m_operationWatcher->setFuture(QtConcurrent::run([vertices, indices, settings, cancel, progress]() -> MeshData* {
+        // 작업 스레드의 사본에만 쓰고, 끝까지 진행했을 때만 UI 스레드에서 메시에 반영
+        MeshData* data = new MeshData();
+        data->vertices = vertices;
+        if (!MeshOperators::smooth(data->vertices, indices, settings, cancel, progress)) {
+            delete data;
+            return nullptr;
+        }
+        return data;
+    }));
+    return true;
+}
+
+bool ViewerWidget::estimatePointNormals(int neighbors)
+{
+    // 면이 있는 메시는 면 법선이 더 정확함
+    if (!m_mesh || !m_mesh->hasData() || !m_mesh->getIndices().isEmpty() || isMeshOperationRunning() || m_sculpting) return false;
+    
+    QVector<VertexData> vertices = m_mesh->getVertices();
+    std::atomic_bool* cancel = &m_operationCancel;
+    std::atomic_int* progress = &m_operationProgress;
+    
+    startMeshOperation(NormalsOperation);
+    m_operationWatcher->setFuture(QtConcurrent::run([vertices, neighbors, cancel, progress]() -> MeshData* {
+        MeshData* data = new MeshData();
+        data->vertices = vertices;
+        if (!MeshOperators::estimatePointNormals(data->vertices, neighbors, cancel, progress)) {
+            delete data;
+            return nullptr;
+        }
+        return data;
+    }));
+    return true;
+}
+
+bool ViewerWidget::downsamplePoints(const DownsampleSettings& settings)
+{
+    if (!m_mesh || !m_mesh->hasData() || !m_mesh->getIndices().isEmpty() || isMeshOperationRunning() || m_sculpting) return false;
+    
+    QVector<VertexData> vertices = m_mesh->getVertices();
+    std::atomic_bool* cancel = &m_operationCancel;
+    std::atomic_int* progress = &m_operationProgress;
+    
+    startMeshOperation(DownsampleOperation);
+    const EditDelta before = getMeshState();
+    std::shared_ptr<QByteArray> undo = std::make_shared<QByteArray>();
+    m_undoResult = undo;
+    m_operationWatcher->setFuture(QtConcurrent::run([vertices, settings, cancel, progress, before, undo]() -> MeshData* {
+        MeshData* data = new MeshData();
+        if (!MeshOperators::downsample(vertices, settings, *data, cancel, progress)
+            || cancel->load(std::memory_order_relaxed)) {
+            delete data;
+            return nullptr;
+        }
+        
+        // 줄이기 전 점군도 작업 스레드에서 압축해 결과와 함께 넘김
+        *undo = EditHistory::encodeMesh(before, *data);
+        return data;
+    }));
+    return true;
+}
+
+bool ViewerWidget::analyzeComponents()
+{
+    if (!m_mesh || m_mesh->getIndices().isEmpty() || isMeshOperationRunning() || m_sculpting) return false;
+    
+    QVector<VertexData> vertices = m_mesh->getVertices();
+    QVector<unsigned int> indices = m_mesh->getIndices();
+    std::atomic_bool* cancel = &m_operationCancel;
+    std::atomic_int* progress = &m_operationProgress;
+    std::shared_ptr<MeshComponents> components = std::make_shared<MeshComponents>();
+    m_componentResult = components;
+    
+    startMeshOperation(ComponentsAnalysisOperation);
+    m_operationWatcher->setFuture(QtConcurrent::run([vertices, indices, cancel, progress, components]() -> MeshData* {
+        if (!components->build(vertices, indices, cancel, progress)) return nullptr;
+        
+        // 메시는 그대로이므로 빈 결과로 성공만 알림
+        return new MeshData();
+    }));
+    return true;
+}
+
+const MeshComponents* ViewerWidget::getComponents() const
+{
+    if (!m_components || !m_mesh || m_componentsRevision != m_mesh->getRevision()
+        || m_componentsVisibilityRevision != m_mesh->getVisibilityRevision()) {
+        return nullptr;
+    }
+    return m_components.get();
+}
+
+bool ViewerWidget::removeSmallComponents(int minTriangles)
+{
+    if (!m_mesh || m_mesh->getIndices().isEmpty() || isMeshOperationRunning() || m_sculpting) return false;
+    
+    QVector<VertexData> vertices = m_mesh->getVertices();
+    QVector<unsigned int> indices = m_mesh->getIndices();
+    std::atomic_bool* cancel = &m_operationCancel;
+    std::atomic_int* progress = &m_operationProgress;
+    std::shared_ptr<const MeshComponents> components = getComponents() ? m_components : nullptr;
+    
+    startMeshOperation(ComponentsOperation);
+    const EditDelta before = getMeshState();
+    std::shared_ptr<QByteArray> undo = std::make_shared<QByteArray>();
+    m_undoResult = undo;
+    m_operationWatcher->setFuture(QtConcurrent::run([vertices, indices, minTriangles, cancel, progress,
+                                                     components, before, undo]() -> MeshData* {
+        std::shared_ptr<const MeshComponents> current = components;
+        if (!current) {
+            std::shared_ptr<MeshComponents> built = std::make_shared<MeshComponents>();
+            if (!built->build(vertices, indices, cancel)) return nullptr;
+            current = built;
+        }
+        
+        MeshData* data = new MeshData();
+        if (!MeshOperators::removeSmallComponents(vertices, indices, *current, minTriangles, *data, cancel, progress)
+            || cancel->load(std::memory_order_relaxed)) {
+            delete data;
+            return nullptr;
+        }
+        
+        // 지우기 전 메시도 작업 스레드에서 압축해 결과와 함께 넘김
+        *undo = EditHistory::encodeMesh(before, *data);
+        return data;
+    }));
+    return true;
+}
+
+bool ViewerWidget::detectPrimitives(const PrimitiveSettings& settings)
+{
+    if (!m_mesh || !m_mesh->hasData() || isMeshOperationRunning() || m_sculpting) return false;
+    
+    QVector<VertexData> vertices = m_mesh->getVertices();
+    std::atomic_bool* cancel = &m_operationCancel;
+    std::atomic_int* progress = &m_operationProgress;
+    std::shared_ptr<QVector<DetectedPrimitive>> primitives = std::make_shared<QVector<DetectedPrimitive>>();
+    m_primitiveResult = primitives;
+    
+    startMeshOperation(PrimitivesOperation);
+    m_operationWatcher->setFuture(QtConcurrent::run([vertices, settings, cancel, progress, primitives]() mutable -> MeshData* {
+        // 로드 직후 법선 추정이 끝나지 않은 점군 등 (검출은 법선으로 후보를 만들고 걸러냄)
+        if (!MeshOperators::hasNormals(vertices)
+            && !MeshOperators::estimatePointNormals(vertices, MeshOperators::DefaultNormalNeighbors, cancel)) {
+            return nullptr;
+        }
+        
+        PrimitiveDetector detector;
+        if (!detector.detect(vertices, settings, cancel, progress)) return nullptr;
+        
+        // 결과는 색만 바꾼 정점 배열로 돌려줌
+        MeshData* data = new MeshData();
+        data->vertices = vertices;
+        detector.applyColors(data->vertices);
+        *primitives = detector.getPrimitives();
+        return data;
+    }));
+    return true;
 }
 
-ViewerWidget::~ViewerWidget()
+bool ViewerWidget::clearPrimitiveColors()
 {
-    delete m_renderer;
-    delete m_mesh;
-    delete m_camera;
+    if (!m_mesh || m_primitiveBaseColors.isEmpty() || isMeshOperationRunning()) return false;
+    
+    const int vertexCount = m_mesh->getVertices().size();
+    if (m_primitiveBaseColors.size() == vertexCount) {
+        VertexData* meshVertices = m_mesh->editVertices();
+        for (int v = 0; v < vertexCount; ++v) {
+            meshVertices[v].color = m_primitiveBaseColors[v];
+        }
+        QVector<int> vertices(vertexCount);
+        std::iota(vertices.begin(), vertices.end(), 0);
+        makeCurrent();
+        m_mesh->updateVertices(vertices, QVector<int>());
+        doneCurrent();
+    }
+    m_primitives.clear();
+    m_primitiveBaseColors.clear();
+    update();
+    return true;
 }
 
-bool ViewerWidget::loadPLYFile(const QString& filename)
+bool ViewerWidget::addClipPlane(const QVector3D& normal)
 {
-    if (!m_mesh) {
-        m_mesh = new Mesh();
-    }
+    if (!m_mesh || !m_mesh->hasData() || normal.isNull() || m_clipPlanes.size() >= Shader::MaxClipPlanes) return false;
     
-    if (m_mesh->loadFromPLY(filename)) {
-        fitToView();
-        update();
-        return true;
-    }
+    ClipPlane plane;
+    plane.normal = normal.normalized();
+    plane.offset = QVector3D::dotProduct(plane.normal, m_mesh->getCenter());
+    m_clipPlanes.append(plane);
+    m_activeClipPlane = m_clipPlanes.size() - 1;
+    updateClipPlanes();
+    return true;
+}
+
+bool ViewerWidget::addViewClipPlane()
+{
+    if (!m_renderer || !m_camera) return false;
     
-    return false;
+    // 평면은 모델 행렬의 전치로 객체 공간에 옮김 (회전 중인 모델도 지금 보이는 방향으로 자름)
+    const QVector4D normal = m_renderer->getModelMatrix().transposed() * QVector4D(m_camera->getForward(), 0.0f);
+    return addClipPlane(normal.toVector3D());
 }
 
-void ViewerWidget::setRenderMode(Renderer::RenderMode mode)
+void ViewerWidget::removeClipPlane()
+{
+    if (m_activeClipPlane < 0) return;
+    
+    m_clipPlanes.remove(m_activeClipPlane);
+    m_activeClipPlane = qMin(m_activeClipPlane, int(m_clipPlanes.size()) - 1);
+    updateClipPlanes();
+}
+
+void ViewerWidget::clearClipPlanes()
+{
+    m_clipPlanes.clear();
+    m_activeClipPlane = -1;
+    m_slicer.clear();
+    updateClipPlanes();
+}
+
+void ViewerWidget::flipClipPlane()
+{
+    if (m_activeClipPlane < 0) return;
+    
+    ClipPlane& plane = m_clipPlanes[m_activeClipPlane];
+    plane.normal = -plane.normal;
+    plane.offset = -plane.offset;
+    updateClipPlanes();
+}
+
+void ViewerWidget::setActiveClipPlane(int plane)
+{
+    if (plane < 0 || plane >= m_clipPlanes.size() || plane == m_activeClipPlane) return;
+    
+    m_activeClipPlane = plane;
+    updateContour();
+    emit clipPlanesChanged();
+    update();
+}
+
+void ViewerWidget::setClipPlanePosition(float position)
+{
+    if (m_activeClipPlane < 0 || !m_mesh) return;
+    
+    ClipPlane& plane = m_clipPlanes[m_activeClipPlane];
+    const float radius = m_mesh->getBoundingRadius();
+    plane.offset = QVector3D::dotProduct(plane.normal, m_mesh->getCenter())
+                   + (2.0f * qBound(0.0f, position, 1.0f) - 1.0f) * radius;
+    updateClipPlanes();
+}
+
+float ViewerWidget::getClipPlanePosition() const
+{
+    if (m_activeClipPlane < 0 || !m_mesh) return 0.5f;
+    
+    const ClipPlane& plane = m_clipPlanes[m_activeClipPlane];
+    const float radius = m_mesh->getBoundingRadius();
+    if (radius <= 0.0f) return 0.5f;
+    const float center = QVector3D::dotProduct(plane.normal, m_mesh->getCenter());
+    return qBound(0.0f, ((plane.offset - center) / radius + 1.0f) * 0.5f, 1.0f);
+}
+
+void ViewerWidget::setContourVisible(bool visible)
+{
+    if (m_contourVisible == visible) return;
+    
+    m_contourVisible = visible;
+    updateContour();
+    update();
+}
+
+bool ViewerWidget::exportContours(const QString& filename) const
+{
+    if (m_contours.isEmpty()) return false;
+    return MeshSlicer::saveContours(filename, m_contours);
+}
+
+void ViewerWidget::updateClipPlanes()
 {
     if (m_renderer) {
-        m_renderer->setRenderMode(mode);
-        update();
+        QVector<QVector4D> planes;
+        for (const ClipPlane& plane : m_clipPlanes) {
+            planes.append(QVector4D(plane.normal, -plane.offset));
+        }
+        m_renderer->setClipPlanes(planes);
     }
+    updateContour();
+    emit clipPlanesChanged();
+    update();
 }
 
-void ViewerWidget::setShaderType(Renderer::ShaderType type)
+bool ViewerWidget::isContourCurrent() const
 {
+    // 단면이 필요 없거나 마지막으로 구한 뒤 메시가 바뀌지 않음
+    if (!m_contourVisible || m_activeClipPlane < 0 || !m_mesh) return true;
+    return m_slicerRevision == m_mesh->getRevision() && m_slicerVertexRevision == m_mesh->getVertexRevision()
+           && m_slicerVisibilityRevision == m_mesh->getVisibilityRevision();
+}
+
+void ViewerWidget::updateContour()
+{
+    m_contours.clear();
+    
+    if (m_contourVisible && m_activeClipPlane >= 0 && m_mesh && !m_mesh->getIndices().isEmpty()) {
+        const ClipPlane& plane = m_clipPlanes[m_activeClipPlane];
+        const QVector<VertexData>& vertices = m_mesh->getVertices();
+        const QVector<unsigned int>& indices = m_mesh->getIndices();
+        
+        // 색인은 방향마다 한 번 (뒤집은 평면은 같은 색인에서 오프셋 부호만 바꿈), 메시가 바뀌면 다시
+        float sign = 0.0f;
+        if (m_slicer.isBuilt() && isContourCurrent()) {
+            if (m_slicer.getNormal() == plane.normal) {
+                sign = 1.0f;
+            } else if (m_slicer.getNormal() == -plane.normal) {
+                sign = -1.0f;
+            }
+        }
+        if (sign == 0.0f && m_slicer.build(vertices, indices, plane.normal)) {
+            sign = 1.0f;
+        }
+        if (sign != 0.0f) {
+            m_slicer.slice(vertices, indices, sign * plane.offset, m_contours);
+        }
+    }
+    
+    // 실패해도 같은 메시로 매 프레임 다시 시도하지 않음
+    if (m_mesh) {
+        m_slicerRevision = m_mesh->getRevision();
+        m_slicerVertexRevision = m_mesh->getVertexRevision();
+        m_slicerVisibilityRevision = m_mesh->getVisibilityRevision();
+    }
     if (m_renderer) {
-        m_renderer->setShaderType(type);
-        update();
+        m_renderer->setContours(m_contours);
+    }
+    
+    int closed = 0;
+    for (const SlicePolyline& polyline : m_contours) {
+        closed += polyline.closed;
     }
+    emit contourChanged(m_contours.size(), closed);
 }
 
-void ViewerWidget::setBackgroundColor(const QColor& color)
+bool ViewerWidget::subdivideMesh(int levels)
 {
-    if (m_renderer) {
-        m_renderer->setBackgroundColor(color);
-        update();
+    if (!m_mesh || m_mesh->getIndices().isEmpty() || isMeshOperationRunning() || m_sculpting) return false;
+    
+    QVector<VertexData> vertices = m_mesh->getVertices();
+    QVector<unsigned int> indices = m_mesh->getIndices();
+    std::atomic_bool* cancel = &m_operationCancel;
+    std::atomic_int* progress = &m_operationProgress;
+    
+    startMeshOperation(SubdivideOperation);
+    const EditDelta before = getMeshState();
+    std::shared_ptr<QByteArray> undo = std::make_shared<QByteArray>();
+    m_undoResult = undo;
+    m_operationWatcher->setFuture(QtConcurrent::run([vertices, indices, levels, cancel, progress, before,
+                                                     undo]() -> MeshData* {
+        MeshData* data = new MeshData();
+        if (!MeshOperators::subdivideLoop(vertices, indices, levels, *data, cancel, progress)
+            || cancel->load(std::memory_order_relaxed)) {
+            delete data;
+            return nullptr;
+        }
+        
+        // 되돌리기용 처리 전 메시는 GUI 스레드를 멈추지 않도록 여기서 압축
+        *undo = EditHistory::encodeMesh(before, *data);
+        return data;
+    }));
+    return true;
+}
+
+void ViewerWidget::startMeshOperation(MeshOperation operation)
+{
+    m_operation = operation;
+    m_operationRecorded = true;
+    m_undoResult.reset();
+    m_operationCancel = false;
+    m_operationProgress = 0;
+    m_operationTimer->start();
+    emit meshOperationProgress(0);
+}
+
+void ViewerWidget::cancelMeshOperation()
+{
+    if (m_operation == NoOperation) return;
+    
+    // 연산은 단계/반복마다 취소를 확인하므로 곧 끝남. 이미 끝났다면 결과만 버림
+    const QString name = getOperationName(m_operation);
+    m_operationCancel = true;
+    m_operationWatcher->waitForFinished();
+    delete m_operationWatcher->result();
+    m_operation = NoOperation;
+    m_operationTimer->stop();
+    emit meshOperationFinished(name, false);
+}
+
+void ViewerWidget::reportOperationProgress()
+{
+    emit meshOperationProgress(m_operationProgress.load());
+}
+
+void ViewerWidget::meshOperationDone()
+{
+    // 취소된 연산의 늦은 알림은 무시
+    if (m_operation == NoOperation) return;
+    
+    const MeshOperation operation = m_operation;
+    m_operation = NoOperation;
+    m_operationTimer->stop();
+    
+    MeshData* data = m_operationWatcher->result();
+    bool success = false;
+    bool notRecorded = false;
+    const bool replacesMesh = operation == SubdivideOperation || operation == DownsampleOperation
+                              || operation == ComponentsOperation;
+    if (operation == ComponentsAnalysisOperation) {
+        success = data && m_componentResult;
+        if (success) {
+            m_components = m_componentResult;
+            m_componentsRevision = m_mesh->getRevision();
+            m_componentsVisibilityRevision = m_mesh->getVisibilityRevision();
+        }
+    } else if (data && operation == PrimitivesOperation) {
+        success = applyColorResult(*data);
+        if (success && m_primitiveResult) {
+            m_primitives = *m_primitiveResult;
+        }
+    } else if (data && !replacesMesh) {
+        success = applyVertexResult(*data, getOperationName(operation));
+    } else if (data) {
+        // 정점/면 수가 바뀌므로 버퍼를 새 크기로 다시 만들고 질의 구조도 다시 구축 (시점은 유지)
+        makeCurrent();
+        success = m_mesh->upload(*data);
+        doneCurrent();
+        if (success) {
+            // 처리 전 메시는 작업 스레드가 압축해 둠. 없거나 한도를 넘었으면 이전 기록이 새 메시와 맞지 않으므로 비움
+            const QByteArray undoData = m_undoResult ? *m_undoResult : QByteArray();
+            notRecorded = !m_history.pushMesh(undoData, getOperationName(operation));
+            emit historyChanged();
+            
+            // 새로 만들거나 지우고 당긴 정점은 파일 번호와 맞지 않음
+            m_vertexPermutation.clear();
+            m_primitives.clear();
+            m_primitiveBaseColors.clear();
+            startSpatialBuild(*data);
+        }
+    }
+    delete data;
+    m_primitiveResult.reset();
+    m_componentResult.reset();
+    m_undoResult.reset();
+    
+    update();
+    emit meshOperationFinished(getOperationName(operation), success);
+    if (notRecorded) {
+        emit meshOperationNotRecorded(getOperationName(operation));
     }
 }
 
-void ViewerWidget::setWireframeColor(const QColor& color)
+QString ViewerWidget::getOperationName(MeshOperation operation)
 {
-    if (m_renderer) {
-        m_renderer->setWireframeColor(color);
-        update();
+    switch (operation) {
+        case SmoothOperation:
+            return "Smooth";
+        case SubdivideOperation:
+            return "Subdivide";
+        case NormalsOperation:
+            return "Estimate Normals";
+        case DownsampleOperation:
+            return "Downsample";
+        case ComponentsAnalysisOperation:
+            return "Analyze Components";
+        case ComponentsOperation:
+            return "Remove Small Components";
+        case PrimitivesOperation:
+            return "Detect Primitives";
+        default:
+            return QString();
     }
 }
 
-void ViewerWidget::setPointSize(float size)
+bool ViewerWidget::applyColorResult(const MeshData& data)
+{
+    const int vertexCount = m_mesh->getVertices().size();
+    if (data.vertices.size() != vertexCount) return false;
+    
+    // 처음 칠할 때의 색만 보관 (다시 검출해도 원래 색으로 돌아감)
+    const bool keepBase = m_primitiveBaseColors.size() != vertexCount;
+    if (keepBase) {
+        m_primitiveBaseColors.resize(vertexCount);
+    }
+    VertexData* meshVertices = m_mesh->editVertices();
+    for (int v = 0; v < vertexCount; ++v) {
+        if (keepBase) m_primitiveBaseColors[v] = meshVertices[v].color;
+        meshVertices[v].color = data.vertices[v].color;
+    }
+    
+    // 위치가 그대로이므로 버퍼 내용만 올리고 질의 구조는 건드리지 않음
+    QVector<int> vertices(vertexCount);
+    std::iota(vertices.begin(), vertices.end(), 0);
+    makeCurrent();
+    m_mesh->updateVertices(vertices, QVector<int>());
+    doneCurrent();
+    return true;
+}
+
+bool ViewerWidget::applyVertexResult(const MeshData& data, const QString& text)
+{
+    const int vertexCount = m_mesh->getVertices().size();
+    if (data.vertices.size() != vertexCount) return false;
+    
+    // 모든 정점이 바뀌므로 전체를 한 단계로 기록 (기록 한도를 넘으면 오래된 단계부터 디스크로)
+    QVector<int> vertices(vertexCount);
+    std::iota(vertices.begin(), vertices.end(), 0);
+    QVector<int> triangles(m_mesh->getIndices().size() / 3);
+    std::iota(triangles.begin(), triangles.end(), 0);
+    
+    QVector<QVector3D> positions(vertexCount);
+    QVector<QVector3D> normals(vertexCount);
+    VertexData* meshVertices = m_mesh->editVertices();
+    for (int v = 0; v < vertexCount; ++v) {
+        positions[v] = meshVertices[v].position;
+        normals[v] = meshVertices[v].normal;
+        meshVertices[v].position = data.vertices[v].position;
+        meshVertices[v].normal = data.vertices[v].normal;
+    }
+    if (m_operationRecorded) {
+        m_history.beginVertexEdit(text, vertexCount);
+        m_history.recordVertices(vertices, positions, normals);
+        if (m_history.endVertexEdit()) {
+            emit historyChanged();
+        }
+    }
+    
+    // 정점 수가 그대로이므로 버퍼를 다시 만들지 않고 내용만 올림
+    makeCurrent();
+    m_mesh->updateVertices(vertices, triangles);
+    doneCurrent();
+    if (m_bvh) {
+        m_bvh->refit(m_mesh->getVertices(), vertices, triangles);
+    }
+    if (m_selector) {
+        m_selector->update(m_mesh->getVertices(), m_mesh->getIndices(), vertices, triangles);
+    }
+    return true;
+}
+
+const SelectionSet* ViewerWidget::hiddenElements(bool faces) const
+{
+    if (!m_mesh) return nullptr;
+    if (faces) {
+        return m_mesh->getHiddenFaceCount() > 0 ? &m_mesh->getHiddenFaces() : nullptr;
+    }
+    return m_mesh->getHiddenVertexCount() > 0 ? &m_mesh->getHiddenVertices() : nullptr;
+}
+
+void ViewerWidget::updateRegionSelection()
 {
+    const bool faces = isFaceSelection();
+    const SelectionSet& selection = faces ? m_faceSelection : m_vertexSelection;
     if (m_renderer) {
-        m_renderer->setPointSize(size);
-        update();
+        m_renderer->setRegionSelection(selection, faces);
     }
+    emit regionSelectionChanged(selection.count(), faces);
+    update();
 }
 
-void ViewerWidget::resetCamera()
+void ViewerWidget::finishRegionDrag(Qt::KeyboardModifiers modifiers)
 {
-    if (m_camera) {
-        m_camera->reset();
+    m_regionDragging = false;
+    
+    SelectionRegion region;
+    if (m_selectionTool == LassoSelectionTool) {
+        region.shape = SelectionRegion::Lasso;
+        region.polygon = m_regionPath;
+    } else {
+        region.shape = SelectionRegion::Rectangle;
+        region.rect = QRect(m_regionPath.first(), m_regionPath.last()).normalized();
+    }
+    
+    SelectionOperation operation = ReplaceSelection;
+    bool shift = modifiers & Qt::ShiftModifier;
+    bool control = modifiers & Qt::ControlModifier;
+    if (shift && control) {
+        operation = IntersectSelection;
+    } else if (shift) {
+        operation = AddToSelection;
+    } else if (control) {
+        operation = SubtractFromSelection;
+    }
+    
+    if (!selectRegion(region, operation)) {
         update();
     }
 }
 
-void ViewerWidget::fitToView()
+bool ViewerWidget::saveScreenshot(const QString& filename, const QSize& size)
 {
-    if (!m_mesh || !m_camera) return;
+    if (!m_renderer || !m_mesh || m_screenshot->isActive() || m_sequenceExporter->isActive()) return false;
     
-    // 메시의 바운딩 박스 계산
-    QVector3D min, max;
-    m_mesh->getBoundingBox(min, max);
+    // 마지막으로 그린 프레임의 모델 행렬을 쓰도록 먼저 갱신
+    updateModelMatrix();
     
-    // 메시 중심점 계산
-    QVector3D center = (min + max) * 0.5f;
-    float radius = m_mesh->getBoundingRadius();
+    makeCurrent();
+    bool started = m_screenshot->begin(m_renderer, size, filename);
+    doneCurrent();
     
-    // 카메라 위치 설정
-    float distance = radius * 2.0f;
-    QVector3D cameraPos = center + QVector3D(distance, distance, distance);
+    if (started) {
+        m_captureTimer->start();
+    }
+    return started;
+}
+
+bool ViewerWidget::exportSequence(SequenceExporter::Options options)
+{
+    if (!m_renderer || !m_mesh || m_screenshot->isActive() || m_sequenceExporter->isActive()) return false;
     
-    m_camera->setPosition(cameraPos);
-    m_camera->setTarget(center);
+    if (options.pathType == SequenceExporter::Keyframes) {
+        options.path = m_cameraPath;
+    }
+    updateModelMatrix();
     
-    update();
+    makeCurrent();
+    bool started = m_sequenceExporter->begin(m_renderer, options);
+    doneCurrent();
+    
+    if (started) {
+        m_captureTimer->start();
+    }
+    return started;
+}
+
+void ViewerWidget::cancelSequenceExport()
+{
+    m_sequenceExporter->cancel();
+}
+
+void ViewerWidget::addCameraKeyframe()
+{
+    if (m_camera) {
+        m_cameraPath.addKeyframe(*m_camera);
+    }
+}
+
+void ViewerWidget::clearCameraKeyframes()
+{
+    m_cameraPath.clear();
+}
+
+void ViewerWidget::captureStep()
+{
+    // 한 번에 약 한 프레임 분량만 그려 UI 응답성 유지
+    makeCurrent();
+    bool pending = false;
+    if (m_screenshot->isActive()) {
+        pending = m_screenshot->step(m_renderer, 12);
+    } else if (m_sequenceExporter->isActive()) {
+        pending = m_sequenceExporter->step(m_renderer, 12);
+    }
+    doneCurrent();
+    
+    if (!pending) {
+        m_captureTimer->stop();
+    }
 }
 
 void ViewerWidget::initializeGL()
@@ -122,6 +1805,10 @@ void ViewerWidget::initializeGL()
     m_renderer = new Renderer();
     m_renderer->initialize();
     
+    // 백그라운드에서 쉐이더 변형이 준비되면 다시 그리기
+    connect(m_renderer->getShaderLibrary(), &ShaderLibrary::variantReady,
+            this, QOverload<>::of(&ViewerWidget::update));
+    
     // 카메라 초기화
     m_camera = new Camera();
     setupCamera();
@@ -145,10 +1832,50 @@ void ViewerWidget::resizeGL(int w, int h)
 void ViewerWidget::paintGL()
 {
     if (m_renderer && m_mesh) {
+        FrameProfiler* profiler = m_renderer->getProfiler();
+        profiler->beginFrame();
+        
         m_renderer->setMesh(m_mesh);
         updateModelMatrix();
+        if (m_dabPending) {
+            FrameProfiler::Scope scope(profiler, "Sculpt");
+            applyPendingDab();
+        }
+        if (!m_sculpting && !isContourCurrent()) {
+            FrameProfiler::Scope scope(profiler, "Section");
+            updateContour();
+        }
         m_renderer->render();
+        
+        bool brushOverlay = m_sculptMode && m_brushCursorVisible;
+        if (m_profilerOverlayVisible || !m_measurePoints.isEmpty() || m_regionDragging || brushOverlay) {
+            FrameProfiler::Scope scope(profiler, "Overlay");
+            QPainter painter(this);
+            if (!m_measurePoints.isEmpty()) {
+                drawMeasurementOverlay(painter);
+            }
+            if (m_regionDragging) {
+                drawRegionOverlay(painter);
+            }
+            if (brushOverlay) {
+                drawBrushOverlay(painter);
+            }
+            if (m_profilerOverlayVisible) {
+                drawProfilerOverlay(painter);
+            }
+        }
+        
+        profiler->endFrame(m_renderer->getFrameStats());
+        
+        // 외부 변경으로 그려진 프레임이면, 비동기 결과(GPU 타이머, 컬링 카운터)가
+        // 확정될 때까지 몇 프레임 더 그림
+        if (!m_tickPending && (m_profilerOverlayVisible || m_renderer->isMultiDrawEnabled())) {
+            m_refineFrames = FrameProfiler::QueryLatency;
+        }
     }
+    
+    m_tickPending = false;
+    updateTimerState();
 }
 
 void ViewerWidget::mousePressEvent(QMouseEvent* event)
@@ -156,12 +1883,58 @@ void ViewerWidget::mousePressEvent(QMouseEvent* event)
     m_mousePressed = true;
     m_mouseButton = event->button();
     m_lastMousePos = event->pos();
+    m_pressMousePos = event->pos();
     setFocus();
+    
+    // 선택 도구가 있으면 왼쪽 드래그는 영역 그리기
+    if (m_selectionTool != NoSelectionTool && m_mouseButton == Qt::LeftButton) {
+        m_regionDragging = true;
+        m_regionPath = QPolygon() << event->pos() << event->pos();
+    } else if (m_sculptMode && m_mouseButton == Qt::LeftButton && !isMeshOperationRunning()) {
+        // 스컬프트: 왼쪽 드래그는 브러시 (적용은 다음 프레임에서)
+        m_sculpting = true;
+        m_history.beginVertexEdit("Sculpt", m_mesh ? m_mesh->getVertices().size() : 0);
+        m_dabPending = true;
+        m_dabPosition = event->pos();
+        m_dabModifiers = event->modifiers();
+        update();
+    }
 }
 
 void ViewerWidget::mouseMoveEvent(QMouseEvent* event)
 {
-    if (!m_mousePressed || !m_camera) return;
+    // 버튼을 누르지 않은 이동은 호버 픽킹만 (화면은 강조 대상이 바뀔 때만 다시 그림)
+    if (!m_mousePressed) {
+        if (m_sculptMode) {
+            updateBrushCursor(event->pos());
+        } else if (m_hoverEnabled) {
+            requestPick(event->pos(), HoverPick);
+        }
+        return;
+    }
+    if (!m_camera) return;
+    
+    if (m_sculpting) {
+        // 프레임 사이의 이동은 최신 위치 하나로 합쳐짐
+        m_dabPending = true;
+        m_dabPosition = event->pos();
+        m_dabModifiers = event->modifiers();
+        update();
+        return;
+    }
+    
+    if (m_regionDragging) {
+        if (m_selectionTool == LassoSelectionTool) {
+            // 몇 픽셀 이상 움직였을 때만 꼭짓점 추가
+            if ((event->pos() - m_regionPath.last()).manhattanLength() >= 3) {
+                m_regionPath << event->pos();
+            }
+        } else {
+            m_regionPath.last() = event->pos();
+        }
+        update();
+        return;
+    }
     
     QPoint delta = event->pos() - m_lastMousePos;
     
@@ -183,8 +1956,36 @@ void ViewerWidget::mouseMoveEvent(QMouseEvent* event)
 
 void ViewerWidget::mouseReleaseEvent(QMouseEvent* event)
 {
+    // 거의 움직이지 않은 왼쪽 클릭은 선택
+    bool click = m_mouseButton == Qt::LeftButton
+              && (event->pos() - m_pressMousePos).manhattanLength() < 4;
+    
     m_mousePressed = false;
     m_mouseButton = Qt::NoButton;
+    
+    if (m_sculpting) {
+        // 아직 그려지지 않은 마지막 적용도 이번 스트로크에 포함
+        m_sculpting = false;
+        if (m_dabPending) {
+            makeCurrent();
+            applyPendingDab();
+            doneCurrent();
+            update();
+        }
+        if (m_history.endVertexEdit()) {
+            emit historyChanged();
+        }
+    } else if (m_regionDragging) {
+        finishRegionDrag(event->modifiers());
+        refreshHover();
+    } else if (click && m_measureMode) {
+        addMeasurePoint(event->pos());
+        refreshHover();
+    } else if (click) {
+        requestPick(event->pos(), SelectPick);
+    } else {
+        refreshHover();
+    }
 }
 
 void ViewerWidget::wheelEvent(QWheelEvent* event)
@@ -192,6 +1993,20 @@ void ViewerWidget::wheelEvent(QWheelEvent* event)
     if (m_camera) {
         handleMouseZoom(event->angleDelta().y());
         update();
+        refreshHover();
+    }
+}
+
+void ViewerWidget::leaveEvent(QEvent* event)
+{
+    QOpenGLWidget::leaveEvent(event);
+    
+    if (m_hover.isValid()) {
+        m_hover = PickResult();
+        if (m_renderer) {
+            m_renderer->setHoverHighlight(m_hover);
+        }
+        update();
     }
 }
 
@@ -219,6 +2034,25 @@ void ViewerWidget::keyPressEvent(QKeyEvent* event)
         case Qt::Key_P:
             setShaderType(Renderer::Phong);
             break;
+        case Qt::Key_BracketLeft:
+            scaleBrushRadius(1.0f / 1.25f);
+            break;
+        case Qt::Key_BracketRight:
+            scaleBrushRadius(1.25f);
+            break;
+        case Qt::Key_PageUp:
+        case Qt::Key_PageDown:
+            // 활성 클립 평면을 경계 구 지름의 1% (Shift: 10%)씩
+            if (m_activeClipPlane >= 0) {
+                const float step = event->modifiers() & Qt::ShiftModifier ? 0.1f : 0.01f;
+                setClipPlanePosition(getClipPlanePosition() + (event->key() == Qt::Key_PageUp ? step : -step));
+            }
+            break;
+        case Qt::Key_Escape:
+            clearSelection();
+            clearMeasurement();
+            clearRegionSelection();
+            break;
         default:
             QOpenGLWidget::keyPressEvent(event);
             break;
@@ -227,15 +2061,79 @@ void ViewerWidget::keyPressEvent(QKeyEvent* event)
 
 void ViewerWidget::updateScene()
 {
+    if (!isAnimationAllowed()) {
+        m_animationTimer->stop();
+        return;
+    }
+    
     // 애니메이션 업데이트
-    m_rotationAngle += 0.5f;
-    if (m_rotationAngle >= 360.0f) {
-        m_rotationAngle -= 360.0f;
+    if (m_autoRotate) {
+        m_rotationAngle += 0.5f;
+        if (m_rotationAngle >= 360.0f) {
+            m_rotationAngle -= 360.0f;
+        }
+    }
+    
+    if (m_refineFrames > 0) {
+        --m_refineFrames;
+    }
+    
+    m_tickPending = true;
+    update();
+    
+    if (m_autoRotate) {
+        refreshHover();
+    }
+}
+
+void ViewerWidget::showEvent(QShowEvent* event)
+{
+    QOpenGLWidget::showEvent(event);
+    
+    // 최소화는 최상위 윈도우에만 전달되므로 윈도우의 상태 변경을 감시
+    if (!m_windowFilterInstalled && window() != this) {
+        window()->installEventFilter(this);
+        m_windowFilterInstalled = true;
+    }
+    updateTimerState();
+}
+
+void ViewerWidget::hideEvent(QHideEvent* event)
+{
+    QOpenGLWidget::hideEvent(event);
+    m_animationTimer->stop();
+}
+
+bool ViewerWidget::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == window()) {
+        switch (event->type()) {
+            case QEvent::WindowStateChange:
+            case QEvent::Hide:
+            case QEvent::Show:
+                updateTimerState();
+                break;
+            default:
+                break;
+        }
     }
+    return QOpenGLWidget::eventFilter(watched, event);
+}
+
+bool ViewerWidget::isAnimationAllowed() const
+{
+    return isVisible() && !window()->isMinimized();
+}
+
+void ViewerWidget::updateTimerState()
+{
+    bool needsTicks = (m_autoRotate || m_refineFrames > 0) && isAnimationAllowed();
     
-    // 자동 회전 (선택적)
-    // updateModelMatrix();
-    // update();
+    if (needsTicks && !m_animationTimer->isActive()) {
+        m_animationTimer->start();
+    } else if (!needsTicks && m_animationTimer->isActive()) {
+        m_animationTimer->stop();
+    }
 }
 
 void ViewerWidget::setupCamera()
@@ -264,8 +2162,8 @@ void ViewerWidget::updateModelMatrix()
     QMatrix4x4 modelMatrix;
     modelMatrix.setToIdentity();
     
-    // 자동 회전 (선택적)
-    // modelMatrix.rotate(m_rotationAngle, QVector3D(0, 1, 0));
+    // 자동 회전
+    modelMatrix.rotate(m_rotationAngle, QVector3D(0, 1, 0));
     
     m_renderer->setModelMatrix(modelMatrix);
 }
@@ -290,3 +2188,134 @@ void ViewerWidget::handleMouseZoom(int delta)
         m_camera->zoom(delta);
     }
 }
+
+void ViewerWidget::drawProfilerOverlay(QPainter& painter)
+{
+    const FrameProfiler* profiler = m_renderer->getProfiler();
+    const QVector<FrameProfiler::FrameRecord>& history = profiler->getHistory();
+    
+    auto formatMs = [](double ms) {
+        return ms < 0.0 ? QString("-") : QString::number(ms, 'f', 2);
+    };
+    
+    // 텍스트 줄 구성
+    QStringList lines;
+    lines << QString("FPS: %1").arg(profiler->getAverageFps(), 0, 'f', 1);
+    
+    const FrameProfiler::FrameRecord* latest = profiler->getLatest();
+    if (latest) {
+        lines << QString("Frame: CPU %1 ms / GPU %2 ms").arg(formatMs(latest->cpuMs), formatMs(latest->gpuMs));
+        for (const FrameProfiler::PassTiming& pass : latest->passes) {
+            lines << QString("  %1: %2 / %3 ms").arg(pass.name, -9).arg(formatMs(pass.cpuMs), formatMs(pass.gpuMs));
+        }
+        lines << QString("Draw calls: %1  State changes: %2").arg(latest->drawCalls).arg(latest->stateChanges);
+        lines << QString("Triangles: %1  Points: %2").arg(latest->triangles).arg(latest->points);
+    }
+    
+    if (m_renderer->isMultiDrawEnabled()) {
+        const MultiDrawBatch::CullStats& cull = m_renderer->getCullStats();
+        lines << QString("Culled: %1% (occluded %2%)")
+                     .arg(cull.getCulledFraction() * 100.0f, 0, 'f', 1)
+                     .arg(cull.getOccludedFraction() * 100.0f, 0, 'f', 1);
+    }
+    
+    QFont font("Monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    font.setPointSize(9);
+    painter.setFont(font);
+    
+    const int margin = 8;
+    const int lineHeight = painter.fontMetrics().height();
+    const int histogramWidth = FrameProfiler::HistorySize;
+    const int histogramHeight = 60;
+    const int panelWidth = histogramWidth + margin * 2;
+    const int panelHeight = lines.size() * lineHeight + histogramHeight + margin * 3;
+    
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.fillRect(QRect(margin, margin, panelWidth, panelHeight), QColor(0, 0, 0, 160));
+    
+    painter.setPen(Qt::white);
+    int y = margin * 2;
+    for (const QString& line : lines) {
+        painter.drawText(QRect(margin * 2, y, histogramWidth, lineHeight), Qt::AlignLeft | Qt::AlignVCenter, line);
+        y += lineHeight;
+    }
+    
+    // 프레임 간격 히스토그램 (50 ms 기준, 16.7/33.3 ms 가이드)
+    const double scaleMs = 50.0;
+    QRect graph(margin * 2, y + margin, histogramWidth, histogramHeight);
+    painter.fillRect(graph, QColor(255, 255, 255, 30));
+    
+    int x = graph.right() - history.size() + 1;
+    for (const FrameProfiler::FrameRecord& record : history) {
+        double ms = qMin(record.intervalMs, scaleMs);
+        int barHeight = int(ms / scaleMs * histogramHeight);
+        QColor color = record.intervalMs <= 16.7 ? QColor(80, 200, 80)
+                     : record.intervalMs <= 33.3 ? QColor(220, 200, 60) : QColor(220, 70, 60);
+        painter.fillRect(QRect(x, graph.bottom() - barHeight + 1, 1, barHeight), color);
+        ++x;
+    }
+    
+    painter.setPen(QColor(255, 255, 255, 90));
+    for (double guide : { 16.7, 33.3 }) {
+        int guideY = graph.bottom() - int(guide / scaleMs * histogramHeight);
+        painter.drawLine(graph.left(), guideY, graph.right(), guideY);
+    }
+}
+
+void ViewerWidget::drawMeasurementOverlay(QPainter& painter)
+{
+    // 모델 행렬을 따라 움직이도록 매 프레임 다시 투영
+    QVector<QPointF> screenPoints;
+    for (const QVector3D& point : m_measurePoints) {
+        screenPoints.append(projectToScreen(point));
+    }
+    
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    
+    if (screenPoints.size() == 2) {
+        painter.setPen(QPen(QColor(255, 220, 60), 2.0));
+        painter.drawLine(screenPoints[0], screenPoints[1]);
+        
+        float distance = (m_measurePoints[1] - m_measurePoints[0]).length();
+        QPointF labelPosition = (screenPoints[0] + screenPoints[1]) * 0.5 + QPointF(8, -8);
+        painter.setPen(Qt::white);
+        painter.drawText(labelPosition, QString::number(distance, 'g', 6));
+    }
+    
+    painter.setPen(QPen(Qt::black, 1.0));
+    painter.setBrush(QColor(255, 220, 60));
+    for (const QPointF& point : screenPoints) {
+        painter.drawEllipse(point, 4.0, 4.0);
+    }
+    painter.setBrush(Qt::NoBrush);
+}
+
+void ViewerWidget::drawBrushOverlay(QPainter& painter)
+{
+    // 화면 오른쪽 방향을 객체 공간으로 옮겨 반지름을 화면 픽셀로 환산
+    QVector3D right = m_renderer->getModelMatrix().inverted().mapVector(m_camera->getRight()).normalized();
+    QPointF center = projectToScreen(m_brushCenter);
+    QPointF edge = projectToScreen(m_brushCenter + right * m_brush.radius);
+    qreal radius = QLineF(center, edge).length();
+    
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(QColor(255, 255, 255, 200), 1.5));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawEllipse(center, radius, radius);
+    painter.drawPoint(center);
+}
+
+void ViewerWidget::drawRegionOverlay(QPainter& painter)
+{
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setPen(QPen(QColor(255, 255, 255, 220), 1.0, Qt::DashLine));
+    painter.setBrush(QColor(255, 140, 40, 40));
+    
+    if (m_selectionTool == LassoSelectionTool) {
+        painter.drawPolygon(m_regionPath);
+    } else {
+        painter.drawRect(QRect(m_regionPath.first(), m_regionPath.last()).normalized());
+    }
+    painter.setBrush(Qt::NoBrush);
+}
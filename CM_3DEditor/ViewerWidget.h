@@ -7,22 +7,72 @@
 #include <QWheelEvent>
 #include <QKeyEvent>
 #include <QTimer>
+#include <QPainter>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QFutureWatcher>
+#include <atomic>
+#include <memory>
 #include "Renderer.h"
 #include "Mesh.h"
 #include "Camera.h"
+#include "TiledScreenshot.h"
+#include "SequenceExporter.h"
+#include "CameraPath.h"
+#include "Bvh.h"
+#include "RegionSelector.h"
+#include "SelectionSet.h"
+#include "SculptBrush.h"
+#include "EditHistory.h"
+#include "HalfEdgeMesh.h"
+#include "MeshOperators.h"
+#include "MeshComponents.h"
+#include "PrimitiveDetector.h"
+#include "MeshSlicer.h"
+#include "SpatialOrder.h"
 
 class ViewerWidget : public QOpenGLWidget, protected QOpenGLFunctions
 {
     Q_OBJECT
 
 public:
+    // 왼쪽 드래그로 영역 선택 (도구가 없으면 오비트)
+    enum SelectionTool {
+        NoSelectionTool,
+        RectangleSelectionTool,
+        LassoSelectionTool
+    };
+    
+    // 새 영역 결과와 기존 선택의 결합 (Shift: 추가, Ctrl: 빼기, Shift+Ctrl: 교집합)
+    enum SelectionOperation {
+        ReplaceSelection,
+        AddToSelection,
+        SubtractFromSelection,
+        IntersectSelection
+    };
+    
+    // 변 뒤집기 결과 (메뉴가 상태 표시줄에 이유를 보여줌)
+    enum FlipEdgeResult {
+        EdgeFlipped,
+        EdgeNotSelected,
+        EdgeNotFlippable
+    };
+
     ViewerWidget(QWidget* parent = nullptr);
     ~ViewerWidget();
 
-    // PLY 파일 로드
+    // PLY 파일 로드/저장 (저장은 현재 정점과 면, 숨김과 관계없이 전체)
     bool loadPLYFile(const QString& filename);
+    bool savePLYFile(const QString& filename) const;
+    float getModelRadius() const { return m_mesh ? m_mesh->getBoundingRadius() : 0.0f; }
+    int getVertexCount() const { return m_mesh ? m_mesh->getVertices().size() : 0; }
+    
+    // 로드할 때 정점을 공간 채움 곡선 순서로 재배치 (다음 로드부터 적용, 저장은 파일 순서로 되돌림)
+    void setLoadOrder(SpatialOrder::Curve curve) { m_loadOrder = curve; }
+    SpatialOrder::Curve getLoadOrder() const { return m_loadOrder; }
+    
+    // 재배치 전 파일의 정점 번호 (재배치하지 않았거나 세분화/줄이기로 정점이 새로 만들어졌으면 그대로)
+    int getFileVertexId(int vertex) const;
     
     // 렌더링 설정
     void setRenderMode(Renderer::RenderMode mode);
@@ -30,10 +80,164 @@ public:
     void setBackgroundColor(const QColor& color);
     void setWireframeColor(const QColor& color);
     void setPointSize(float size);
+    void setMultiDrawEnabled(bool enabled);
+    void setOcclusionCullingEnabled(bool enabled);
+    
+    // 프로파일링
+    void setProfilerOverlayVisible(bool visible);
+    bool isProfilerOverlayVisible() const { return m_profilerOverlayVisible; }
+    bool exportProfile(const QString& filename) const;
+    const FrameProfiler* getProfiler() const { return m_renderer ? m_renderer->getProfiler() : nullptr; }
+    
+    // 애니메이션 (켜져 있는 동안만 타이머가 돌아감)
+    void setAutoRotate(bool enabled);
+    bool isAutoRotating() const { return m_autoRotate; }
     
     // 카메라 제어
     void resetCamera();
     void fitToView();
+    
+    // 창 크기와 무관한 해상도로 현재 시점을 타일 렌더링해 저장 (비동기, 완료 시 screenshotFinished)
+    bool saveScreenshot(const QString& filename, const QSize& size);
+    bool isCapturingScreenshot() const { return m_screenshot->isActive(); }
+    
+    // 턴테이블/카메라 경로 이미지 시퀀스 내보내기 (비동기, 완료 시 sequenceExportFinished)
+    bool exportSequence(SequenceExporter::Options options);
+    void cancelSequenceExport();
+    bool isExportingSequence() const { return m_sequenceExporter->isActive(); }
+    
+    // 호버 강조 (커서 아래 면/정점을 GPU 픽킹으로 찾음)
+    void setHoverHighlightEnabled(bool enabled);
+    bool isHoverHighlightEnabled() const { return m_hoverEnabled; }
+    const PickResult& getSelection() const { return m_selection; }
+    void clearSelection();
+    
+    // CPU 광선 질의 (로드 후 백그라운드에서 BVH 구축, 끝나면 rayQueryReady)
+    bool isRayQueryReady() const { return m_bvh != nullptr; }
+    
+    // 화면 위치에서 메시와의 정확한 교차점 (객체 공간)
+    // snap이면 화면에서 SnapRadius 픽셀 안의 삼각형 정점으로 스냅 (vertex에 정점 번호, 아니면 -1)
+    bool raycast(const QPoint& position, QVector3D& hitPoint, int* vertex = nullptr, bool snap = false) const;
+    
+    // 거리 측정 모드 (왼쪽 클릭한 두 점 사이 거리)
+    void setMeasureMode(bool enabled);
+    bool isMeasureMode() const { return m_measureMode; }
+    void clearMeasurement();
+    
+    // 영역 선택 (면이 있는 메시는 면 중심, Points 모드나 포인트 클라우드는 정점 기준)
+    void setSelectionTool(SelectionTool tool);
+    SelectionTool getSelectionTool() const { return m_selectionTool; }
+    bool selectRegion(const SelectionRegion& region, SelectionOperation operation);
+    void selectAll();
+    void invertSelection();
+    void clearRegionSelection();
+    const SelectionSet& getRegionSelection() const;
+    bool isFaceSelection() const;
+    
+    // 숨김/격리 (현재 선택 종류 기준: 면 또는 정점). 숨긴 원소는 그리기/픽킹/선택에서 제외
+    bool hideSelection();
+    bool isolateSelection();
+    void unhideAll();
+    
+    // 스컬프트 (왼쪽 드래그로 브러시 적용. Shift: Smooth, Ctrl: 방향 반전)
+    // 드래그 중 이벤트는 최신 위치로 합쳐져 프레임마다 한 번만 적용됨
+    void setSculptMode(bool enabled);
+    bool isSculptMode() const { return m_sculptMode; }
+    void setBrushMode(BrushSettings::Mode mode) { m_brush.mode = mode; }
+    BrushSettings::Mode getBrushMode() const { return m_brush.mode; }
+    void setBrushStrength(float strength);
+    float getBrushStrength() const { return m_brush.strength; }
+    void scaleBrushRadius(float factor);
+    
+    // 반변 위상 구조 (처음 필요할 때 구축, 면이 없으면 nullptr)
+    const HalfEdgeMesh* getTopology();
+    
+    // 선택한 면(클릭 픽킹)에서 클릭 위치에 가장 가까운 변을 뒤집음
+    FlipEdgeResult flipSelectedEdge();
+    
+    // 메시 처리 (작업 스레드에서 실행, 진행률은 meshOperationProgress, 끝나면 meshOperationFinished)
+    // 스무딩/법선 추정은 되돌리기 기록에 남고, 세분화는 정점/면 수가 바뀌므로 새 메시로 올리고 처리 전 메시를 통째로 기록에 남김
+    // 실행 중에는 스컬프트/위상 편집/되돌리기를 막음
+    bool smoothMesh(const SmoothSettings& settings);
+    bool subdivideMesh(int levels);
+    
+    // 면이 없는 점군의 법선 추정 (k-최근접 이웃 PCA). 법선 없는 점군을 로드하면 자동으로 실행됨
+    bool estimatePointNormals(int neighbors = MeshOperators::DefaultNormalNeighbors);
+    
+    // 면이 없는 점군을 줄여 새 점군으로 바꿈 (세분화처럼 처리 전 점군을 기록에 남김, 저장은 savePLYFile)
+    bool downsamplePoints(const DownsampleSettings& settings);
+    
+    // 현재 메시의 연결 성분을 작업 스레드에서 구함 (진행률/취소는 다른 메시 처리와 같음)
+    // 끝나면 meshOperationFinished("Analyze Components"), 결과는 getComponents(). 삼각형이 없으면 false
+    bool analyzeComponents();
+    
+    // 마지막으로 구한 연결 성분 (로드/메시 처리 때 클러스터링에서 구한 것 포함, 그 뒤 메시나 삼각형이 바뀌었으면 nullptr)
+    const MeshComponents* getComponents() const;
+    
+    // 삼각형이 minTriangles개 미만인 연결 성분을 지운 메시로 바꿈 (세분화처럼 처리 전 메시를 기록에 남김)
+    // 구해 둔 성분이 현재 메시의 것이면 다시 쓰고, 아니면 작업 스레드에서 다시 구함
+    bool removeSmallComponents(int minTriangles);
+    
+    // 평면/구/원기둥을 검출해 정점 색을 도형별 색으로 바꿈 (법선이 없으면 먼저 추정)
+    // 칠하기 전 색은 보관했다가 clearPrimitiveColors()로 되돌림 (되돌리기 기록에는 남지 않음)
+    bool detectPrimitives(const PrimitiveSettings& settings);
+    bool clearPrimitiveColors();
+    bool hasPrimitiveColors() const { return !m_primitiveBaseColors.isEmpty(); }
+    const QVector<DetectedPrimitive>& getPrimitives() const { return m_primitives; }
+    void cancelMeshOperation();
+    bool isMeshOperationRunning() const { return m_operation != NoOperation; }
+    
+    // 클립 평면 (객체 공간, 최대 Shader::MaxClipPlanes개). 법선 쪽만 남기고 GPU에서 자름. 새 파일을 로드하면 지움
+    // 활성 평면의 단면 윤곽선은 평면 방향마다 한 번 만드는 구간 색인(호출 스레드에서 병렬 구축)으로 구하므로
+    // 평면을 옮길 때는 단면 근처 삼각형만 교차시킴. 메시가 바뀌면 (스트로크 중이면 끝난 뒤) 다시 구함
+    bool addClipPlane(const QVector3D& normal);     // 모델 중심을 지나는 평면
+    bool addViewClipPlane();                        // 시선 방향 법선 (카메라 쪽 절반을 자름)
+    void removeClipPlane();                         // 활성 평면
+    void clearClipPlanes();
+    void flipClipPlane();                           // 같은 자리에서 남기는 쪽만 바꿈
+    int getClipPlaneCount() const { return m_clipPlanes.size(); }
+    int getActiveClipPlane() const { return m_activeClipPlane; }
+    void setActiveClipPlane(int plane);
+    
+    // 활성 평면 위치 (0~1: 경계 구를 법선 방향으로 뒤 끝에서 앞 끝까지)
+    void setClipPlanePosition(float position);
+    float getClipPlanePosition() const;
+    
+    // 단면 윤곽선 표시와 내보내기 (객체 공간 ASCII PLY)
+    void setContourVisible(bool visible);
+    bool isContourVisible() const { return m_contourVisible; }
+    const QVector<SlicePolyline>& getContours() const { return m_contours; }
+    bool exportContours(const QString& filename) const;
+    
+    // 되돌리기/다시 하기 (스컬프트 스트로크, 스무딩, 숨김/격리, 변 뒤집기). 새 파일을 로드하면 비움
+    bool undo();
+    bool redo();
+    const EditHistory& getHistory() const { return m_history; }
+    void setUndoMemoryLimit(qint64 bytes) { m_history.setMemoryLimit(bytes); }
+    
+    // 카메라 경로 키프레임 (현재 시점 추가)
+    void addCameraKeyframe();
+    void clearCameraKeyframes();
+    int getCameraKeyframeCount() const { return m_cameraPath.getKeyframeCount(); }
+
+signals:
+    void picked(const PickResult& result);
+    void rayQueryReady();
+    void measurePointAdded(const QVector3D& position, int vertex);
+    void distanceMeasured(float distance);
+    void regionSelectionChanged(int count, bool faces);
+    void hiddenChanged(int hiddenCount, bool faces);
+    void brushRadiusChanged(float radius);
+    void historyChanged();
+    void meshOperationProgress(int percent);
+    void meshOperationFinished(const QString& name, bool success);
+    void meshOperationNotRecorded(const QString& name);
+    void clipPlanesChanged();
+    void contourChanged(int polylines, int closed);
+    void screenshotProgress(int completedTiles, int totalTiles);
+    void screenshotFinished(const QString& filename, bool success);
+    void sequenceExportProgress(int encodedFrames, int totalFrames);
+    void sequenceExportFinished(const QString& directory, bool success);
 
 protected:
     void initializeGL() override;
@@ -45,12 +249,25 @@ protected:
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
     void wheelEvent(QWheelEvent* event) override;
+    void leaveEvent(QEvent* event) override;
     
     // 키보드 이벤트
     void keyPressEvent(QKeyEvent* event) override;
+    
+    // 표시 상태 (숨김/최소화 시 타이머 정지)
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private slots:
     void updateScene();
+    void captureStep();
+    void processPicks();
+    void bvhBuilt();
+    void selectorBuilt();
+    void sculptBuilt();
+    void meshOperationDone();
+    void reportOperationProgress();
 
 private:
     // 렌더링 시스템
@@ -60,12 +277,129 @@ private:
     
     // 마우스 제어
     QPoint m_lastMousePos;
+    QPoint m_pressMousePos;
     bool m_mousePressed;
     Qt::MouseButton m_mouseButton;
     
     // 애니메이션
     QTimer* m_animationTimer;
     float m_rotationAngle;
+    bool m_autoRotate;
+    int m_refineFrames;         // 점진적 갱신을 위해 더 그릴 프레임 수
+    bool m_tickPending;         // 타이머가 요청한 다시 그리기인지
+    bool m_windowFilterInstalled;
+    
+    // 프로파일러 오버레이
+    bool m_profilerOverlayVisible;
+    
+    // 픽킹 (요청은 readback 슬롯이 빌 때까지 최신 위치로 합쳐짐)
+    enum PickTag {
+        HoverPick,
+        SelectPick
+    };
+    bool m_hoverEnabled;
+    bool m_pickRequested;
+    QPoint m_pickPosition;
+    int m_pickTag;
+    PickResult m_hover;
+    PickResult m_selection;
+    QTimer* m_pickTimer;
+    
+    // CPU 공간 질의 구조 (BVH, 영역 선택 커널). 새 파일을 로드하면 진행 중인 구축을 취소
+    static constexpr int SnapRadius = 10;
+    std::atomic_bool m_spatialCancel;
+    Bvh* m_bvh;
+    QFutureWatcher<Bvh*>* m_bvhWatcher;
+    bool m_bvhBuilding;
+    RegionSelector* m_selector;
+    QFutureWatcher<RegionSelector*>* m_selectorWatcher;
+    bool m_selectorBuilding;
+    
+    // 영역 선택
+    SelectionTool m_selectionTool;
+    bool m_regionDragging;
+    QPolygon m_regionPath;          // 사각형은 시작/현재 두 점, 올가미는 지나간 점들
+    SelectionSet m_vertexSelection;
+    SelectionSet m_faceSelection;
+    
+    // 스컬프트 (인접 목록은 처음 켤 때 백그라운드에서 구축)
+    bool m_sculptMode;
+    bool m_sculpting;
+    bool m_dabPending;
+    QPoint m_dabPosition;
+    Qt::KeyboardModifiers m_dabModifiers;
+    BrushSettings m_brush;
+    SculptBrush* m_sculpt;
+    QFutureWatcher<SculptBrush*>* m_sculptWatcher;
+    bool m_sculptBuilding;
+    bool m_brushCursorVisible;
+    QVector3D m_brushCenter;        // 객체 공간
+    
+    // 편집 기록과 위상 구조
+    EditHistory m_history;
+    HalfEdgeMesh* m_topology;
+    
+    // 로드 시 정점 재배치 (m_vertexPermutation[현재 번호] = 파일 번호, 재배치하지 않았으면 비어 있음)
+    SpatialOrder::Curve m_loadOrder;
+    QVector<int> m_vertexPermutation;
+    
+    // 메시 처리 연산 (결과는 작업 스레드가 만든 새 데이터, 진행률은 타이머로 읽음)
+    enum MeshOperation {
+        NoOperation,
+        SmoothOperation,
+        SubdivideOperation,
+        NormalsOperation,
+        DownsampleOperation,
+        ComponentsAnalysisOperation,
+        ComponentsOperation,
+        PrimitivesOperation
+    };
+    MeshOperation m_operation;
+    bool m_operationRecorded;       // 결과를 되돌리기 기록에 남길지 (로드 직후 자동 실행은 남기지 않음)
+    QFutureWatcher<MeshData*>* m_operationWatcher;
+    std::atomic_bool m_operationCancel;
+    std::atomic_int m_operationProgress;
+    QTimer* m_operationTimer;
+    
+    // 연결 성분 분석 결과 (작업 스레드가 채우고 끝나면 옮김). 구할 때의 메시/삼각형 리비전과 함께 보관
+    std::shared_ptr<MeshComponents> m_componentResult;
+    std::shared_ptr<const MeshComponents> m_components;
+    int m_componentsRevision;
+    int m_componentsVisibilityRevision;
+    
+    // 메시를 바꾸는 처리의 되돌리기 기록 (작업 스레드가 처리 전 메시를 압축해 채움, 한도를 넘으면 비어 있음)
+    std::shared_ptr<QByteArray> m_undoResult;
+    
+    // 마지막 도형 검출 결과 (작업 스레드가 채우고 끝나면 옮김)와 칠하기 전 정점 색
+    std::shared_ptr<QVector<DetectedPrimitive>> m_primitiveResult;
+    QVector<DetectedPrimitive> m_primitives;
+    QVector<QVector3D> m_primitiveBaseColors;
+    
+    // 클립 평면 (dot(normal, p) >= offset인 쪽을 그림)과 활성 평면의 단면
+    struct ClipPlane {
+        QVector3D normal;
+        float offset;
+    };
+    QVector<ClipPlane> m_clipPlanes;
+    int m_activeClipPlane;          // 평면이 없으면 -1
+    bool m_contourVisible;
+    MeshSlicer m_slicer;
+    int m_slicerRevision;           // 색인을 만든 메시의 (업로드, 정점, 숨김/위상) 갱신 번호
+    int m_slicerVertexRevision;
+    int m_slicerVisibilityRevision;
+    QVector<SlicePolyline> m_contours;
+    
+    // 거리 측정 (객체 공간 점, 최대 2개)
+    bool m_measureMode;
+    QVector<QVector3D> m_measurePoints;
+    
+    // 타일 스크린샷 (이벤트 루프가 비어 있을 때마다 몇 타일씩 진행)
+    TiledScreenshot* m_screenshot;
+    QTimer* m_captureTimer;
+    
+    // 이미지 시퀀스 내보내기 (캡처 타이머 공유)
+    SequenceExporter* m_sequenceExporter;
+    CameraPath m_cameraPath;
     
     // 헬퍼 함수들
     void setupCamera();
@@ -74,6 +408,41 @@ private:
     void handleMouseOrbit(const QPoint& delta);
     void handleMousePan(const QPoint& delta);
     void handleMouseZoom(int delta);
+    void drawProfilerOverlay(QPainter& painter);
+    void drawMeasurementOverlay(QPainter& painter);
+    void drawRegionOverlay(QPainter& painter);
+    void drawBrushOverlay(QPainter& painter);
+    void startSpatialBuild(const MeshData& data);
+    void cancelSpatialBuild();
+    void startSculptBuild();
+    void applyPendingDab();
+    void updateBrushCursor(const QPoint& position);
+    void finishRegionDrag(Qt::KeyboardModifiers modifiers);
+    void updateRegionSelection();
+    bool applyHidden(const SelectionSet& hidden, bool faces, bool record = true);
+    bool applyHistory(bool undo);
+    bool swapVertices(EditDelta& delta);
+    bool swapHidden(EditDelta& delta);
+    bool swapTriangles(EditDelta& delta);
+    bool swapMesh(EditDelta& delta);
+    EditDelta getMeshState() const;
+    void applyTopologyEdit(const QVector<int>& triangles);
+    void startMeshOperation(MeshOperation operation);
+    bool applyVertexResult(const MeshData& data, const QString& text);
+    bool applyColorResult(const MeshData& data);
+    static QString getOperationName(MeshOperation operation);
+    void updateClipPlanes();
+    void updateContour();
+    bool isContourCurrent() const;
+    const SelectionSet* hiddenElements(bool faces) const;
+    bool screenRay(const QPoint& position, QVector3D& origin, QVector3D& direction) const;
+    QPointF projectToScreen(const QVector3D& objectPoint) const;
+    void addMeasurePoint(const QPoint& position);
+    void requestPick(const QPoint& position, PickTag tag);
+    void refreshHover();
+    void handlePickResult(const PickResult& result);
+    bool isAnimationAllowed() const;
+    void updateTimerState();
 };
 
 #endif // VIEWERWIDGET_H
@@ -0,0 +1,263 @@
+#include "VoxelGrid.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+    // 이보다 작은 작업은 한 스레드로
+    const int ParallelGrain = 1 << 14;
+
+    // 버킷 수 = 2^BucketBits (스레드 수와 무관하게 고정)
+    const int BucketBits = 10;
+    const int BucketCount = 1 << BucketBits;
+
+    const int AxisMask = (1 << VoxelGrid::AxisBits) - 1;
+
+    inline quint64 cellKey(int x, int y, int z)
+    {
+        return (quint64(x) << (2 * VoxelGrid::AxisBits)) | (quint64(y) << VoxelGrid::AxisBits) | quint64(z);
+    }
+
+    // splitmix64 마무리 단계: 상위 비트는 버킷, 하위 비트는 버킷 안의 표 자리
+    inline quint64 hashKey(quint64 key)
+    {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    inline int bucketOf(quint64 hash)
+    {
+        return int(hash >> (64 - BucketBits));
+    }
+
+    inline int tableSize(int count)
+    {
+        // 채움률 1/2 이하
+        int size = 2;
+        while (size < count * 2) size <<= 1;
+        return size;
+    }
+}
+
+VoxelGrid::VoxelGrid()
+    : m_cellSize(0.0f)
+{
+}
+
+void VoxelGrid::clear()
+{
+    m_origin = QVector3D();
+    m_cellSize = 0.0f;
+    m_cellKeys.clear();
+    m_cellStarts.clear();
+    m_points.clear();
+    m_tableStarts.clear();
+    m_table.clear();
+}
+
+bool VoxelGrid::build(const QVector<VertexData>& vertices, float cellSize, const std::atomic_bool* cancel)
+{
+    QElapsedTimer timer;
+    timer.start();
+    clear();
+
+    const int count = vertices.size();
+    if (count == 0 || !(cellSize > 0.0f) || !std::isfinite(cellSize)) return false;
+
+    // 경계 상자 (조각별 최소/최대를 모아 합침)
+    const int chunks = Parallel::chunkCount(count, ParallelGrain);
+    QVector<QVector3D> chunkMin(chunks, vertices.first().position);
+    QVector<QVector3D> chunkMax(chunks, vertices.first().position);
+    Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        QVector3D boxMin = vertices[begin].position;
+        QVector3D boxMax = boxMin;
+        for (qsizetype i = begin + 1; i < end; ++i) {
+            const QVector3D& p = vertices[i].position;
+            boxMin = QVector3D(qMin(boxMin.x(), p.x()), qMin(boxMin.y(), p.y()), qMin(boxMin.z(), p.z()));
+            boxMax = QVector3D(qMax(boxMax.x(), p.x()), qMax(boxMax.y(), p.y()), qMax(boxMax.z(), p.z()));
+        }
+        chunkMin[chunk] = boxMin;
+        chunkMax[chunk] = boxMax;
+    });
+    QVector3D boxMin = chunkMin[0];
+    QVector3D boxMax = chunkMax[0];
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        const QVector3D& a = chunkMin[chunk];
+        const QVector3D& b = chunkMax[chunk];
+        boxMin = QVector3D(qMin(boxMin.x(), a.x()), qMin(boxMin.y(), a.y()), qMin(boxMin.z(), a.z()));
+        boxMax = QVector3D(qMax(boxMax.x(), b.x()), qMax(boxMax.y(), b.y()), qMax(boxMax.z(), b.z()));
+    }
+
+    const QVector3D extent = (boxMax - boxMin) / cellSize;
+    if (!std::isfinite(extent.x()) || !std::isfinite(extent.y()) || !std::isfinite(extent.z())
+        || qMax(extent.x(), qMax(extent.y(), extent.z())) >= float(AxisMask)) {
+        qDebug() << "Voxel grid too fine for the point extent:" << cellSize;
+        return false;
+    }
+
+    // 점마다 셀 키, 조각별 버킷 개수
+    const float inverseSize = 1.0f / cellSize;
+    QVector<quint64> keys(count);
+    QVector<int> histograms(chunks * BucketCount, 0);
+    quint64* keyData = keys.data();
+    Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int* histogram = histograms.data() + chunk * BucketCount;
+        for (qsizetype i = begin; i < end; ++i) {
+            const QVector3D cell = (vertices[i].position - boxMin) * inverseSize;
+            const quint64 key = cellKey(qBound(0, int(cell.x()), AxisMask), qBound(0, int(cell.y()), AxisMask),
+                                        qBound(0, int(cell.z()), AxisMask));
+            keyData[i] = key;
+            ++histogram[bucketOf(hashKey(key))];
+        }
+    });
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    // 버킷 우선, 같은 버킷 안에서는 조각 순서로 쓰기 위치를 정함 (원래 번호 오름차순 유지)
+    QVector<int> bucketStarts(BucketCount + 1);
+    int offset = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        bucketStarts[bucket] = offset;
+        for (int chunk = 0; chunk < chunks; ++chunk) {
+            int& slot = histograms[chunk * BucketCount + bucket];
+            const int n = slot;
+            slot = offset;
+            offset += n;
+        }
+    }
+    bucketStarts[BucketCount] = offset;
+
+    QVector<int> bucketed(count);
+    int* bucketedData = bucketed.data();
+    Parallel::forEachChunk(count, ParallelGrain, [&](int chunk, qsizetype begin, qsizetype end) {
+        int* cursor = histograms.data() + chunk * BucketCount;
+        for (qsizetype i = begin; i < end; ++i) {
+            bucketedData[cursor[bucketOf(hashKey(keyData[i]))]++] = int(i);
+        }
+    });
+
+    // 버킷마다 지역 셀 번호를 매김 (처음 나온 순서). 점 수 크기의 임시 표를 조각마다 재사용
+    QVector<int> localCells(count);
+    QVector<QVector<quint64>> bucketKeys(BucketCount);
+    QVector<QVector<int>> bucketCounts(BucketCount);
+    Parallel::parallelFor(BucketCount, 4, [&](qsizetype first, qsizetype last) {
+        QVector<int> scratch;
+        for (qsizetype bucket = first; bucket < last; ++bucket) {
+            const int size = tableSize(bucketStarts[bucket + 1] - bucketStarts[bucket]);
+            scratch.fill(-1, size);
+            int* table = scratch.data();
+            const quint64 mask = quint64(size - 1);
+            QVector<quint64>& cellKeys = bucketKeys[bucket];
+            QVector<int>& cellCounts = bucketCounts[bucket];
+            
+            // 스캔 순서로 저장된 점군은 연달아 같은 셀에 드는 경우가 많음
+            quint64 lastKey = 0;
+            int lastCell = -1;
+            for (int j = bucketStarts[bucket]; j < bucketStarts[bucket + 1]; ++j) {
+                const quint64 key = keyData[bucketedData[j]];
+                if (lastCell < 0 || key != lastKey) {
+                    quint64 slot = hashKey(key) & mask;
+                    while (table[slot] >= 0 && cellKeys[table[slot]] != key) {
+                        slot = (slot + 1) & mask;
+                    }
+                    if (table[slot] < 0) {
+                        table[slot] = cellKeys.size();
+                        cellKeys.append(key);
+                        cellCounts.append(0);
+                    }
+                    lastKey = key;
+                    lastCell = table[slot];
+                }
+                localCells[j] = lastCell;
+                ++cellCounts[lastCell];
+            }
+        }
+    });
+    if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+    QVector<int> cellBases(BucketCount + 1);
+    int cellCount = 0;
+    m_tableStarts.resize(BucketCount + 1);
+    int tableOffset = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        cellBases[bucket] = cellCount;
+        cellCount += bucketKeys[bucket].size();
+        m_tableStarts[bucket] = tableOffset;
+        tableOffset += tableSize(bucketKeys[bucket].size());
+    }
+    cellBases[BucketCount] = cellCount;
+    m_tableStarts[BucketCount] = tableOffset;
+    m_table.fill({ 0, -1 }, tableOffset);
+
+    // 전역 셀 번호로 셀 구간과 질의 표를 만들고, 버킷 구간 안에서 셀별로 점을 모음 (오름차순 유지)
+    m_cellKeys.resize(cellCount);
+    m_cellStarts.resize(cellCount + 1);
+    m_cellStarts[cellCount] = count;
+    m_points.resize(count);
+    quint64* cellKeyData = m_cellKeys.data();
+    int* cellStartData = m_cellStarts.data();
+    int* pointData = m_points.data();
+    TableEntry* tableData = m_table.data();
+    Parallel::parallelFor(BucketCount, 4, [&](qsizetype first, qsizetype last) {
+        for (qsizetype bucket = first; bucket < last; ++bucket) {
+            const int base = cellBases[bucket];
+            const QVector<quint64>& cellKeys = bucketKeys[bucket];
+            QVector<int>& cursors = bucketCounts[bucket];
+            TableEntry* table = tableData + m_tableStarts[bucket];
+            const quint64 mask = quint64(m_tableStarts[bucket + 1] - m_tableStarts[bucket] - 1);
+            int start = bucketStarts[bucket];
+            for (int local = 0; local < cellKeys.size(); ++local) {
+                const quint64 key = cellKeys[local];
+                cellKeyData[base + local] = key;
+                cellStartData[base + local] = start;
+                const int n = cursors[local];
+                cursors[local] = start;
+                start += n;
+
+                quint64 slot = hashKey(key) & mask;
+                while (table[slot].cell >= 0) {
+                    slot = (slot + 1) & mask;
+                }
+                table[slot] = { key, base + local };
+            }
+            for (int j = bucketStarts[bucket]; j < bucketStarts[bucket + 1]; ++j) {
+                pointData[cursors[localCells[j]]++] = bucketedData[j];
+            }
+        }
+    });
+
+    m_origin = boxMin;
+    m_cellSize = cellSize;
+
+    qDebug() << "Voxel grid built:" << count << "points," << cellCount << "cells in" << timer.elapsed() << "ms";
+    return true;
+}
+
+void VoxelGrid::getCellCoordinates(int cell, int& x, int& y, int& z) const
+{
+    const quint64 key = m_cellKeys[cell];
+    x = int(key >> (2 * AxisBits)) & AxisMask;
+    y = int(key >> AxisBits) & AxisMask;
+    z = int(key) & AxisMask;
+}
+
+int VoxelGrid::findCell(int x, int y, int z) const
+{
+    if (m_table.isEmpty() || x < 0 || y < 0 || z < 0 || x > AxisMask || y > AxisMask || z > AxisMask) return -1;
+
+    const quint64 key = cellKey(x, y, z);
+    const quint64 hash = hashKey(key);
+    const int bucket = bucketOf(hash);
+    const TableEntry* table = m_table.constData() + m_tableStarts[bucket];
+    const quint64 mask = quint64(m_tableStarts[bucket + 1] - m_tableStarts[bucket] - 1);
+    quint64 slot = hash & mask;
+    while (table[slot].cell >= 0) {
+        if (table[slot].key == key) return table[slot].cell;
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
@@ -0,0 +1,57 @@
+#ifndef VOXELGRID_H
+#define VOXELGRID_H
+
+#include <QVector>
+#include <QVector3D>
+#include <atomic>
+#include "Mesh.h"
+
+// 점의 희소 균일 격자 (병렬 공간 해시)
+// 점을 셀 좌표 키의 해시 상위 비트로 버킷에 안정 분배(조각별 개수 + 누적)한 뒤,
+// 버킷마다 독립적으로 열린 주소 해시 표를 만들어 셀 → 점 목록을 구함.
+// 버킷 수가 고정이라 셀 번호와 점 순서는 스레드 수와 관계없이 같음
+class VoxelGrid
+{
+public:
+    static constexpr int AxisBits = 21;     // 축마다 셀 좌표는 0 ~ 2^21-1
+
+    VoxelGrid();
+
+    // 한 변 cellSize인 셀로 구축 (GL 호출 없음, 스레드 안전)
+    // 셀 수가 축마다 2^21을 넘거나 cancel이 설정되면 false
+    bool build(const QVector<VertexData>& vertices, float cellSize, const std::atomic_bool* cancel = nullptr);
+    void clear();
+
+    int getCellCount() const { return m_cellKeys.size(); }
+    float getCellSize() const { return m_cellSize; }
+
+    // 셀에 든 점의 원래 정점 번호 (오름차순)
+    const int* getCellPoints(int cell) const { return m_points.constData() + m_cellStarts[cell]; }
+    int getCellPointCount(int cell) const { return m_cellStarts[cell + 1] - m_cellStarts[cell]; }
+
+    // 셀의 점들이 셀 순서 배열에서 시작하는 위치 (점 수 크기의 보조 배열을 셀 구간별로 쓸 때)
+    int getCellOffset(int cell) const { return m_cellStarts[cell]; }
+
+    // 셀 좌표 (격자 원점 = 점들의 최소 모서리)
+    void getCellCoordinates(int cell, int& x, int& y, int& z) const;
+
+    // 셀 좌표의 셀 번호 (비었거나 범위 밖이면 -1). 읽기만 하므로 여러 스레드에서 동시에 호출 가능
+    int findCell(int x, int y, int z) const;
+
+private:
+    // 질의 한 번에 캐시 줄 하나만 읽도록 키를 셀 번호와 함께 둠
+    struct TableEntry {
+        quint64 key;
+        int cell;       // -1이면 빈 자리
+    };
+
+    QVector3D m_origin;
+    float m_cellSize;
+    QVector<quint64> m_cellKeys;        // 셀 → 좌표 키
+    QVector<int> m_cellStarts;          // 셀 → m_points 구간 시작 (셀 수 + 1)
+    QVector<int> m_points;              // 셀 순서로 모은 원래 정점 번호
+    QVector<int> m_tableStarts;         // 버킷 → m_table 구간 시작 (버킷마다 셀 수의 두 배 이상인 2의 거듭제곱)
+    QVector<TableEntry> m_table;
+};
+
+#endif // VOXELGRID_H
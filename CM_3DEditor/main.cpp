@@ -1,10 +1,162 @@
 #include "mainwindow.h"
+#include "ThumbnailBatch.h"
+#include "OrderBenchmark.h"
+#include "PrimitiveBenchmark.h"
+#include "SliceBenchmark.h"
 
 #include <QApplication>
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QSurfaceFormat>
+#include <QFile>
+#include <QTextStream>
+#include <QThreadPool>
+
+namespace {
+    void setupCommandLine(QCommandLineParser& parser)
+    {
+        parser.setApplicationDescription("CM 3D Editor - PLY viewer");
+        parser.addHelpOption();
+        parser.addPositionalArgument("inputs", "PLY files or directories to render in thumbnail mode.", "[inputs...]");
+        parser.addOption({ { "t", "thumbnails" }, "Render thumbnails of <inputs> into <dir> without opening a window.", "dir" });
+        parser.addOption({ "list", "Read additional input paths from <file>, one per line.", "file" });
+        parser.addOption({ "presets", "Comma-separated camera presets (" + Camera::getPresetNames().join(", ") + ").", "names", "iso" });
+        parser.addOption({ "size", "Thumbnail size as WIDTHxHEIGHT.", "size", "256x256" });
+        parser.addOption({ "format", "Image format (png, jpg, ...).", "format", "png" });
+        parser.addOption({ "threads", "Worker threads for loading and encoding (0 = all cores).", "count", "0" });
+        parser.addOption({ "force", "Re-render outputs that are already up to date." });
+        parser.addOption({ "benchmark-order", "Compare query and render times of <file> in file, Morton and Hilbert vertex order.", "file" });
+        parser.addOption({ "frames", "Frames to render per order in --benchmark-order (0 = skip rendering).", "count", "100" });
+        parser.addOption({ "benchmark-primitives", "Time primitive detection on <file>, or on a synthetic room with room:<points>.", "file" });
+        parser.addOption({ "benchmark-slice", "Time cross-section index builds and slices of <file>, or of a synthetic torus with torus:<triangles>.", "file" });
+        parser.addOption({ "steps", "Slice positions per axis in --benchmark-slice.", "count", "100" });
+    }
+
+    // WIDTHxHEIGHT
+    bool parseSize(const QString& text, QSize& size)
+    {
+        QStringList parts = text.split('x');
+        if (parts.size() != 2 || parts[0].toInt() <= 0 || parts[1].toInt() <= 0) {
+            qWarning() << "Invalid --size:" << text;
+            return false;
+        }
+        size = QSize(parts[0].toInt(), parts[1].toInt());
+        return true;
+    }
+
+    int runThumbnails(const QCommandLineParser& parser)
+    {
+        ThumbnailBatch::Options options;
+        options.inputs = parser.positionalArguments();
+        options.outputDirectory = parser.value("thumbnails");
+        options.presets = parser.value("presets").split(',', Qt::SkipEmptyParts);
+        options.format = parser.value("format");
+        options.force = parser.isSet("force");
+        options.threads = parser.value("threads").toInt();
+
+        if (!parseSize(parser.value("size"), options.size)) {
+            return 2;
+        }
+
+        if (parser.isSet("list")) {
+            QFile file(parser.value("list"));
+            if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                qWarning() << "Cannot read input list:" << parser.value("list");
+                return 2;
+            }
+            QTextStream stream(&file);
+            while (!stream.atEnd()) {
+                QString line = stream.readLine().trimmed();
+                if (!line.isEmpty()) {
+                    options.inputs << line;
+                }
+            }
+        }
+
+        ThumbnailBatch batch(options);
+        return batch.run();
+    }
+
+    int runOrderBenchmark(const QCommandLineParser& parser)
+    {
+        OrderBenchmark::Options options;
+        options.input = parser.value("benchmark-order");
+        options.frames = qMax(0, parser.value("frames").toInt());
+
+        // 썸네일 기본 크기는 렌더링 측정에 너무 작으므로 명시했을 때만 사용
+        if (parser.isSet("size") && !parseSize(parser.value("size"), options.size)) {
+            return 2;
+        }
+        if (parser.value("threads").toInt() > 0) {
+            QThreadPool::globalInstance()->setMaxThreadCount(parser.value("threads").toInt());
+        }
+
+        OrderBenchmark benchmark(options);
+        return benchmark.run();
+    }
+
+    int runPrimitiveBenchmark(const QCommandLineParser& parser)
+    {
+        PrimitiveBenchmark::Options options;
+        options.input = parser.value("benchmark-primitives");
+        if (parser.value("threads").toInt() > 0) {
+            QThreadPool::globalInstance()->setMaxThreadCount(parser.value("threads").toInt());
+        }
+
+        PrimitiveBenchmark benchmark(options);
+        return benchmark.run();
+    }
+
+    int runSliceBenchmark(const QCommandLineParser& parser)
+    {
+        SliceBenchmark::Options options;
+        options.input = parser.value("benchmark-slice");
+        options.steps = qMax(1, parser.value("steps").toInt());
+        if (parser.value("threads").toInt() > 0) {
+            QThreadPool::globalInstance()->setMaxThreadCount(parser.value("threads").toInt());
+        }
+
+        SliceBenchmark benchmark(options);
+        return benchmark.run();
+    }
+}
 
 int main(int argc, char *argv[])
 {
+    // Uniform buffer 등을 사용하므로 OpenGL 3.3 Core Profile 요청
+    QSurfaceFormat format;
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setDepthBufferSize(24);
+    QSurfaceFormat::setDefaultFormat(format);
+
+    // 애플리케이션 종류를 정하기 위해 생성 전에 인자를 먼저 해석
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i) {
+        arguments << QString::fromLocal8Bit(argv[i]);
+    }
+    QCommandLineParser parser;
+    setupCommandLine(parser);
+    parser.parse(arguments);
+
+    if (parser.isSet("thumbnails") || parser.isSet("benchmark-order") || parser.isSet("benchmark-primitives")
+        || parser.isSet("benchmark-slice")) {
+        // 디스플레이 없는 서버에서는 offscreen 플랫폼 사용 (명시한 플랫폼이 있으면 유지)
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") && qEnvironmentVariableIsEmpty("DISPLAY")
+            && qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+
+        QGuiApplication a(argc, argv);
+        parser.process(a);
+        if (parser.isSet("thumbnails")) return runThumbnails(parser);
+        if (parser.isSet("benchmark-order")) return runOrderBenchmark(parser);
+        if (parser.isSet("benchmark-primitives")) return runPrimitiveBenchmark(parser);
+        return runSliceBenchmark(parser);
+    }
+
     QApplication a(argc, argv);
+    parser.process(a);
     MainWindow w;
     w.show();
     return a.exec();
@@ -2,6 +2,9 @@
 #include "ui_mainwindow.h"
 #include <QApplication>
 #include <QDebug>
+#include <QInputDialog>
+#include <QActionGroup>
+#include "KdTree.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -9,20 +12,30 @@ MainWindow::MainWindow(QWidget *parent)
     , m_viewerWidget(nullptr)
     , m_fileMenu(nullptr)
     , m_viewMenu(nullptr)
+    , m_selectMenu(nullptr)
+    , m_editMenu(nullptr)
+    , m_undoAction(nullptr)
+    , m_redoAction(nullptr)
+    , m_meshMenu(nullptr)
     , m_renderMenu(nullptr)
     , m_helpMenu(nullptr)
     , m_mainToolBar(nullptr)
     , m_controlPanel(nullptr)
     , m_renderGroup(nullptr)
     , m_cameraGroup(nullptr)
+    , m_sectionGroup(nullptr)
     , m_lightingGroup(nullptr)
     , m_renderModeCombo(nullptr)
     , m_shaderTypeCombo(nullptr)
     , m_pointSizeSlider(nullptr)
     , m_bgColorButton(nullptr)
     , m_wireframeColorButton(nullptr)
+    , m_clipPlaneCombo(nullptr)
+    , m_clipPositionSlider(nullptr)
+    , m_contourLabel(nullptr)
     , m_statusProgress(nullptr)
     , m_statusLabel(nullptr)
+    , m_statusTimer(nullptr)
 {
     ui->setupUi(this);
     
@@ -73,8 +86,47 @@ void MainWindow::openPLYFile()
     }
 }
 
+void MainWindow::savePLYFile()
+{
+    QString filename = QFileDialog::getSaveFileName(
+        this,
+        "Save PLY File",
+        QString(),
+        "PLY Files (*.ply);;All Files (*)"
+    );
+    
+    if (!filename.isEmpty()) {
+        if (m_viewerWidget->savePLYFile(filename)) {
+            statusBar()->showMessage("PLY file saved: " + filename, 3000);
+        } else {
+            QMessageBox::critical(this, "Error", "Failed to save PLY file: " + filename);
+        }
+    }
+}
+
 void MainWindow::saveScreenshot()
 {
+    if (m_viewerWidget->isCapturingScreenshot()) {
+        statusBar()->showMessage("Screenshot already in progress", 2000);
+        return;
+    }
+    
+    // 현재 뷰의 실제 픽셀 크기를 기준으로 배율 선택 (한 변 16384 이하)
+    QSize baseSize = m_viewerWidget->size() * m_viewerWidget->devicePixelRatioF();
+    QStringList items;
+    QList<QSize> sizes;
+    for (int scale : { 1, 2, 4, 8, 16 }) {
+        QSize size = baseSize * scale;
+        if (scale > 1 && qMax(size.width(), size.height()) > 16384) break;
+        items << QString("%1x (%2 x %3)").arg(scale).arg(size.width()).arg(size.height());
+        sizes << size;
+    }
+    
+    bool ok = false;
+    QString item = QInputDialog::getItem(this, "Save Screenshot", "Resolution:", items, 0, false, &ok);
+    if (!ok) return;
+    QSize size = sizes[items.indexOf(item)];
+    
     QString filename = QFileDialog::getSaveFileName(
         this,
         "Save Screenshot",
@@ -83,11 +135,119 @@ void MainWindow::saveScreenshot()
     );
     
     if (!filename.isEmpty()) {
-        QPixmap screenshot = m_viewerWidget->grab();
-        if (screenshot.save(filename)) {
-            statusBar()->showMessage("Screenshot saved: " + filename, 3000);
+        if (m_viewerWidget->saveScreenshot(filename, size)) {
+            m_statusProgress->setValue(0);
+            m_statusProgress->setVisible(true);
+            statusBar()->showMessage(QString("Rendering %1 x %2 screenshot...").arg(size.width()).arg(size.height()));
         } else {
-            QMessageBox::critical(this, "Error", "Failed to save screenshot");
+            QMessageBox::critical(this, "Error", "Failed to start screenshot");
+        }
+    }
+}
+
+void MainWindow::screenshotProgress(int completedTiles, int totalTiles)
+{
+    m_statusProgress->setMaximum(totalTiles);
+    m_statusProgress->setValue(completedTiles);
+    if (completedTiles == totalTiles) {
+        statusBar()->showMessage("Encoding screenshot...");
+    }
+}
+
+void MainWindow::screenshotFinished(const QString& filename, bool success)
+{
+    m_statusProgress->setVisible(false);
+    if (success) {
+        statusBar()->showMessage("Screenshot saved: " + filename, 3000);
+    } else {
+        statusBar()->clearMessage();
+        QMessageBox::critical(this, "Error", "Failed to save screenshot");
+    }
+}
+
+void MainWindow::exportSequence()
+{
+    if (m_viewerWidget->isExportingSequence()) {
+        if (QMessageBox::question(this, "Export Image Sequence", "Cancel the running export?") == QMessageBox::Yes) {
+            m_viewerWidget->cancelSequenceExport();
+        }
+        return;
+    }
+    
+    // 경로 종류 (키프레임이 2개 이상일 때만 카메라 경로 선택 가능)
+    QStringList paths;
+    paths << "Turntable (360°)";
+    int keyframeCount = m_viewerWidget->getCameraKeyframeCount();
+    if (keyframeCount >= 2) {
+        paths << QString("Camera path (%1 keyframes)").arg(keyframeCount);
+    }
+    
+    bool ok = false;
+    QString path = QInputDialog::getItem(this, "Export Image Sequence", "Camera:", paths, 0, false, &ok);
+    if (!ok) return;
+    
+    int frameCount = QInputDialog::getInt(this, "Export Image Sequence", "Frames:", 120, 1, 100000, 1, &ok);
+    if (!ok) return;
+    
+    QSize viewSize = m_viewerWidget->size() * m_viewerWidget->devicePixelRatioF();
+    QList<QSize> sizes = { viewSize, QSize(1280, 720), QSize(1920, 1080), QSize(3840, 2160) };
+    QStringList sizeItems;
+    for (const QSize& size : sizes) {
+        sizeItems << QString("%1 x %2").arg(size.width()).arg(size.height());
+    }
+    sizeItems[0] += " (view)";
+    QString sizeItem = QInputDialog::getItem(this, "Export Image Sequence", "Resolution:", sizeItems, 2, false, &ok);
+    if (!ok) return;
+    
+    QString directory = QFileDialog::getExistingDirectory(this, "Export Image Sequence");
+    if (directory.isEmpty()) return;
+    
+    SequenceExporter::Options options;
+    options.directory = directory;
+    options.frameCount = frameCount;
+    options.size = sizes[sizeItems.indexOf(sizeItem)];
+    options.pathType = paths.indexOf(path) == 0 ? SequenceExporter::Turntable : SequenceExporter::Keyframes;
+    
+    if (m_viewerWidget->exportSequence(options)) {
+        m_statusProgress->setMaximum(frameCount);
+        m_statusProgress->setValue(0);
+        m_statusProgress->setVisible(true);
+        statusBar()->showMessage(QString("Exporting %1 frames...").arg(frameCount));
+    } else {
+        QMessageBox::critical(this, "Error", "Failed to start image sequence export");
+    }
+}
+
+void MainWindow::sequenceExportProgress(int encodedFrames, int totalFrames)
+{
+    m_statusProgress->setMaximum(totalFrames);
+    m_statusProgress->setValue(encodedFrames);
+}
+
+void MainWindow::sequenceExportFinished(const QString& directory, bool success)
+{
+    m_statusProgress->setVisible(false);
+    if (success) {
+        statusBar()->showMessage("Image sequence exported: " + directory, 3000);
+    } else {
+        statusBar()->showMessage("Image sequence export cancelled or incomplete: " + directory, 5000);
+    }
+}
+
+void MainWindow::exportProfile()
+{
+    QString filename = QFileDialog::getSaveFileName(
+        this,
+        "Export Profile",
+        QString(),
+        "CSV Files (*.csv);;All Files (*)"
+    );
+    
+    if (!filename.isEmpty()) {
+        if (m_viewerWidget->exportProfile(filename)) {
+            statusBar()->showMessage("Profile exported: " + filename, 3000);
+        } else {
+            QMessageBox::critical(this, "Error", "Failed to export profile");
         }
     }
 }
@@ -109,6 +269,382 @@ void MainWindow::fitToView()
     statusBar()->showMessage("Fit to view", 2000);
 }
 
+void MainWindow::addCameraKeyframe()
+{
+    m_viewerWidget->addCameraKeyframe();
+    statusBar()->showMessage(QString("Camera keyframe %1 added").arg(m_viewerWidget->getCameraKeyframeCount()), 2000);
+}
+
+void MainWindow::clearCameraKeyframes()
+{
+    m_viewerWidget->clearCameraKeyframes();
+    statusBar()->showMessage("Camera keyframes cleared", 2000);
+}
+
+void MainWindow::showPickResult(const PickResult& result)
+{
+    switch (result.type) {
+        case PickResult::Face:
+            statusBar()->showMessage(QString("Selected object %1, face %2").arg(result.objectId).arg(result.primitive), 5000);
+            break;
+        case PickResult::Point:
+            statusBar()->showMessage(QString("Selected object %1, vertex %2").arg(result.objectId)
+                                         .arg(m_viewerWidget->getFileVertexId(result.primitive)), 5000);
+            break;
+        case PickResult::None:
+        default:
+            statusBar()->showMessage("Selection cleared", 2000);
+            break;
+    }
+}
+
+void MainWindow::showMeasurePoint(const QVector3D& position, int vertex)
+{
+    QString message = QString("Measure point (%1, %2, %3)")
+                          .arg(position.x(), 0, 'g', 6).arg(position.y(), 0, 'g', 6).arg(position.z(), 0, 'g', 6);
+    if (vertex >= 0) {
+        message += QString(" snapped to vertex %1").arg(m_viewerWidget->getFileVertexId(vertex));
+    }
+    statusBar()->showMessage(message, 5000);
+}
+
+void MainWindow::showDistance(float distance)
+{
+    statusBar()->showMessage(QString("Distance: %1").arg(distance, 0, 'g', 6), 10000);
+}
+
+void MainWindow::addClipPlane(const QVector3D& normal)
+{
+    bool added = normal.isNull() ? m_viewerWidget->addViewClipPlane() : m_viewerWidget->addClipPlane(normal);
+    if (added) {
+        statusBar()->showMessage(QString("Clip plane %1 added").arg(m_viewerWidget->getClipPlaneCount()), 2000);
+    } else if (m_viewerWidget->getClipPlaneCount() >= Shader::MaxClipPlanes) {
+        statusBar()->showMessage(QString("At most %1 clip planes").arg(Shader::MaxClipPlanes), 3000);
+    }
+}
+
+void MainWindow::exportContours()
+{
+    if (m_viewerWidget->getContours().isEmpty()) {
+        QMessageBox::information(this, "Export Section Contour", "The active clip plane does not cut the mesh");
+        return;
+    }
+    
+    QString filename = QFileDialog::getSaveFileName(
+        this,
+        "Export Section Contour",
+        QString(),
+        "PLY Files (*.ply);;All Files (*)"
+    );
+    
+    if (!filename.isEmpty()) {
+        if (m_viewerWidget->exportContours(filename)) {
+            statusBar()->showMessage("Section contour exported: " + filename, 3000);
+        } else {
+            QMessageBox::critical(this, "Error", "Failed to export section contour");
+        }
+    }
+}
+
+void MainWindow::updateClipPlaneControls()
+{
+    // 뷰어에서 바뀐 값을 다시 뷰어로 보내지 않도록
+    const QSignalBlocker comboBlocker(m_clipPlaneCombo);
+    const QSignalBlocker sliderBlocker(m_clipPositionSlider);
+    
+    const int count = m_viewerWidget->getClipPlaneCount();
+    if (m_clipPlaneCombo->count() != count) {
+        m_clipPlaneCombo->clear();
+        for (int plane = 0; plane < count; ++plane) {
+            m_clipPlaneCombo->addItem(QString("Plane %1").arg(plane + 1));
+        }
+    }
+    m_clipPlaneCombo->setCurrentIndex(m_viewerWidget->getActiveClipPlane());
+    m_clipPositionSlider->setValue(qRound(m_viewerWidget->getClipPlanePosition() * m_clipPositionSlider->maximum()));
+    m_sectionGroup->setEnabled(count > 0);
+    if (count == 0) {
+        m_contourLabel->setText("No clip planes");
+    }
+}
+
+void MainWindow::showContour(int polylines, int closed)
+{
+    if (m_viewerWidget->getClipPlaneCount() == 0) return;
+    
+    if (!m_viewerWidget->isContourVisible()) {
+        m_contourLabel->setText("Contour hidden");
+    } else {
+        m_contourLabel->setText(QString("Contour: %1 lines (%2 closed)").arg(polylines).arg(closed));
+    }
+}
+
+void MainWindow::showRegionSelection(int count, bool faces)
+{
+    statusBar()->showMessage(QString("%1 %2 selected").arg(count).arg(faces ? "faces" : "vertices"), 3000);
+}
+
+void MainWindow::showHidden(int hiddenCount, bool faces)
+{
+    if (hiddenCount == 0) {
+        statusBar()->showMessage(QString("All %1 visible").arg(faces ? "faces" : "vertices"), 3000);
+    } else {
+        statusBar()->showMessage(QString("%1 %2 hidden").arg(hiddenCount).arg(faces ? "faces" : "vertices"), 3000);
+    }
+}
+
+void MainWindow::updateHistoryActions()
+{
+    const EditHistory& history = m_viewerWidget->getHistory();
+    m_undoAction->setEnabled(history.canUndo());
+    m_redoAction->setEnabled(history.canRedo());
+    m_undoAction->setText(history.canUndo() ? QString("&Undo %1").arg(history.getUndoText()) : QString("&Undo"));
+    m_redoAction->setText(history.canRedo() ? QString("&Redo %1").arg(history.getRedoText()) : QString("&Redo"));
+}
+
+void MainWindow::setUndoMemoryLimit()
+{
+    const EditHistory& history = m_viewerWidget->getHistory();
+    bool ok = false;
+    int megabytes = QInputDialog::getInt(this, "Undo Memory Limit",
+                                         "Memory for undo history (MB, older steps spill to disk):",
+                                         int(history.getMemoryLimit() / (1024 * 1024)), 1, 16384, 1, &ok);
+    if (!ok) return;
+    
+    m_viewerWidget->setUndoMemoryLimit(qint64(megabytes) * 1024 * 1024);
+    statusBar()->showMessage(QString("Undo history: %1 KB in memory, %2 KB on disk")
+                                 .arg(history.getMemoryUsage() / 1024)
+                                 .arg(history.getDiskUsage() / 1024), 3000);
+}
+
+void MainWindow::showTopologyInfo()
+{
+    const HalfEdgeMesh* topology = m_viewerWidget->getTopology();
+    if (!topology) {
+        QMessageBox::information(this, "Topology", "No triangle mesh loaded.");
+        return;
+    }
+    
+    QMessageBox::information(this, "Topology",
+                             QString("Vertices: %1\nFaces: %2\nHalf-edges: %3\n"
+                                     "Boundary half-edges: %4\nNon-manifold edges: %5")
+                                 .arg(topology->getVertexCount())
+                                 .arg(topology->getFaceCount())
+                                 .arg(topology->getHalfEdgeCount())
+                                 .arg(topology->getBoundaryHalfEdgeCount())
+                                 .arg(topology->getNonManifoldEdgeCount()));
+}
+
+bool MainWindow::confirmCancelMeshOperation()
+{
+    if (!m_viewerWidget->isMeshOperationRunning()) return false;
+    
+    if (QMessageBox::question(this, "Mesh", "Cancel the running mesh operation?") == QMessageBox::Yes) {
+        m_viewerWidget->cancelMeshOperation();
+    }
+    return true;
+}
+
+void MainWindow::smoothMesh()
+{
+    if (confirmCancelMeshOperation()) return;
+    
+    QStringList methods = { "Taubin (keeps volume)", "Laplacian" };
+    bool ok = false;
+    QString method = QInputDialog::getItem(this, "Smooth Mesh", "Method:", methods, 0, false, &ok);
+    if (!ok) return;
+    
+    SmoothSettings settings;
+    settings.method = methods.indexOf(method) == 0 ? SmoothSettings::Taubin : SmoothSettings::Laplacian;
+    settings.iterations = QInputDialog::getInt(this, "Smooth Mesh", "Iterations:", settings.iterations, 1, 1000, 1, &ok);
+    if (!ok) return;
+    
+    if (m_viewerWidget->smoothMesh(settings)) {
+        meshOperationProgress(0);
+        statusBar()->showMessage(QString("Smoothing mesh (%1 iterations)...").arg(settings.iterations));
+    } else {
+        statusBar()->showMessage("Smoothing needs a triangle mesh (wait for loading to finish, not while sculpting)", 3000);
+    }
+}
+
+void MainWindow::subdivideMesh()
+{
+    if (confirmCancelMeshOperation()) return;
+    
+    bool ok = false;
+    int levels = QInputDialog::getInt(this, "Subdivide Mesh", "Levels (each level makes 4x triangles):",
+                                      1, 1, 4, 1, &ok);
+    if (!ok) return;
+    
+    if (m_viewerWidget->subdivideMesh(levels)) {
+        meshOperationProgress(0);
+        statusBar()->showMessage(QString("Subdividing mesh (%1 levels)...").arg(levels));
+    } else {
+        statusBar()->showMessage("Subdivision needs a triangle mesh", 3000);
+    }
+}
+
+void MainWindow::estimateNormals()
+{
+    if (confirmCancelMeshOperation()) return;
+    
+    bool ok = false;
+    int neighbors = QInputDialog::getInt(this, "Estimate Normals", "Neighbors per point:",
+                                         MeshOperators::DefaultNormalNeighbors, 3, KdTree::MaxNeighbors, 1, &ok);
+    if (!ok) return;
+    
+    if (m_viewerWidget->estimatePointNormals(neighbors)) {
+        meshOperationProgress(0);
+        statusBar()->showMessage(QString("Estimating normals (%1 neighbors)...").arg(neighbors));
+    } else {
+        statusBar()->showMessage("Normal estimation needs a point cloud without faces", 3000);
+    }
+}
+
+void MainWindow::downsamplePoints()
+{
+    if (confirmCancelMeshOperation()) return;
+    
+    QStringList methods = { "Voxel grid (centroid)", "Voxel grid (nearest point)", "Poisson disk (minimum spacing)" };
+    bool ok = false;
+    QString method = QInputDialog::getItem(this, "Downsample Points", "Method:", methods, 0, false, &ok);
+    if (!ok) return;
+    
+    DownsampleSettings settings;
+    settings.method = static_cast<DownsampleSettings::Method>(methods.indexOf(method));
+    const float radius = m_viewerWidget->getModelRadius();
+    settings.spacing = QInputDialog::getDouble(this, "Downsample Points",
+                                               settings.method == DownsampleSettings::PoissonDisk ? "Minimum spacing:" : "Voxel size:",
+                                               radius * 0.01, radius * 1e-5, radius, 6, &ok);
+    if (!ok) return;
+    
+    if (m_viewerWidget->downsamplePoints(settings)) {
+        meshOperationProgress(0);
+        statusBar()->showMessage("Downsampling points...");
+    } else {
+        statusBar()->showMessage("Downsampling needs a point cloud without faces", 3000);
+    }
+}
+
+void MainWindow::removeSmallComponents()
+{
+    if (confirmCancelMeshOperation()) return;
+    
+    // 로드할 때 구해 둔 성분이 지금 메시와 맞으면 바로 기준을 고름
+    if (m_viewerWidget->getComponents()) {
+        chooseComponentThreshold();
+        return;
+    }
+    
+    // 없으면 작업 스레드에서 구하고, 끝나면 기준을 고르는 창을 띄움 (chooseComponentThreshold)
+    if (m_viewerWidget->analyzeComponents()) {
+        meshOperationProgress(0);
+        statusBar()->showMessage("Finding connected components...");
+    } else {
+        statusBar()->showMessage("Removing components needs a triangle mesh", 3000);
+    }
+}
+
+void MainWindow::chooseComponentThreshold()
+{
+    // 기준을 고를 수 있도록 성분 수와 가장 큰 성분을 먼저 보여줌
+    const MeshComponents* components = m_viewerWidget->getComponents();
+    if (!components || components->getComponentCount() == 0) return;
+    const MeshComponent& largest = components->getComponent(components->getLargestComponent());
+    const QVector3D size = largest.boundsMax - largest.boundsMin;
+    
+    bool ok = false;
+    int minTriangles = QInputDialog::getInt(this, "Remove Small Components",
+                                            QString("%1 connected components, largest %2 triangles (%3 x %4 x %5).\n"
+                                                    "Remove components with fewer triangles than:")
+                                                .arg(components->getComponentCount())
+                                                .arg(largest.triangleCount)
+                                                .arg(size.x(), 0, 'g', 4).arg(size.y(), 0, 'g', 4).arg(size.z(), 0, 'g', 4),
+                                            qMax(1, largest.triangleCount / 100), 1, largest.triangleCount, 1, &ok);
+    if (!ok) return;
+    
+    int removedCount = 0;
+    for (const MeshComponent& component : components->getComponents()) {
+        if (component.triangleCount < minTriangles) ++removedCount;
+    }
+    if (removedCount == 0) {
+        statusBar()->showMessage("No component is smaller than the threshold", 3000);
+        return;
+    }
+    
+    // 창이 떠 있는 동안 메시가 바뀌지 않으므로 구한 성분을 그대로 다시 씀
+    const int componentCount = components->getComponentCount();
+    if (m_viewerWidget->removeSmallComponents(minTriangles)) {
+        meshOperationProgress(0);
+        statusBar()->showMessage(QString("Removing %1 of %2 components...").arg(removedCount).arg(componentCount));
+    }
+}
+
+void MainWindow::detectPrimitives()
+{
+    if (confirmCancelMeshOperation()) return;
+    
+    QStringList shapes = { "Planes", "Planes, spheres and cylinders" };
+    bool ok = false;
+    QString shape = QInputDialog::getItem(this, "Detect Primitives", "Shapes:", shapes, 0, false, &ok);
+    if (!ok) return;
+    
+    PrimitiveSettings settings;
+    settings.spheres = settings.cylinders = shapes.indexOf(shape) == 1;
+    const float radius = m_viewerWidget->getModelRadius();
+    settings.epsilon = QInputDialog::getDouble(this, "Detect Primitives", "Distance tolerance:",
+                                               radius * 0.005, radius * 1e-5, radius, 6, &ok);
+    if (!ok) return;
+    
+    const int vertexCount = m_viewerWidget->getVertexCount();
+    settings.minPoints = QInputDialog::getInt(this, "Detect Primitives", "Minimum points per shape:",
+                                              qBound(3, vertexCount / 200, 100000), 3, qMax(3, vertexCount), 1, &ok);
+    if (!ok) return;
+    
+    if (m_viewerWidget->detectPrimitives(settings)) {
+        meshOperationProgress(0);
+        statusBar()->showMessage("Detecting primitives...");
+    } else {
+        statusBar()->showMessage("Detecting primitives needs a loaded model", 3000);
+    }
+}
+
+void MainWindow::clearPrimitiveColors()
+{
+    if (m_viewerWidget->clearPrimitiveColors()) {
+        statusBar()->showMessage("Primitive colors cleared", 2000);
+    }
+}
+
+void MainWindow::meshOperationProgress(int percent)
+{
+    // 로드 직후 자동으로 시작된 작업도 진행률이 보이도록
+    m_statusProgress->setMaximum(100);
+    m_statusProgress->setValue(percent);
+    m_statusProgress->setVisible(true);
+}
+
+void MainWindow::meshOperationFinished(const QString& name, bool success)
+{
+    m_statusProgress->setVisible(false);
+    if (success && name == "Detect Primitives") {
+        // 도형 종류별 개수
+        int counts[3] = { 0, 0, 0 };
+        for (const DetectedPrimitive& primitive : m_viewerWidget->getPrimitives()) {
+            ++counts[primitive.type];
+        }
+        statusBar()->showMessage(QString("Detected %1 planes, %2 spheres, %3 cylinders")
+                                     .arg(counts[DetectedPrimitive::Plane])
+                                     .arg(counts[DetectedPrimitive::Sphere])
+                                     .arg(counts[DetectedPrimitive::Cylinder]), 5000);
+    } else if (success && name == "Analyze Components") {
+        chooseComponentThreshold();
+    } else if (success) {
+        statusBar()->showMessage(name + " finished", 3000);
+    } else {
+        statusBar()->showMessage(name + " cancelled or failed", 5000);
+    }
+}
+
 void MainWindow::setRenderMode(int mode)
 {
     m_viewerWidget->setRenderMode(static_cast<Renderer::RenderMode>(mode));
@@ -149,8 +685,21 @@ void MainWindow::setPointSize(int size)
 
 void MainWindow::updateStatusBar()
 {
-    // 메시 정보 업데이트 (나중에 구현)
-    m_statusLabel->setText("Ready");
+    // 가장 최근에 확정된 프레임의 프로파일 요약
+    const FrameProfiler* profiler = m_viewerWidget ? m_viewerWidget->getProfiler() : nullptr;
+    const FrameProfiler::FrameRecord* latest = profiler ? profiler->getLatest() : nullptr;
+    if (!latest) {
+        m_statusLabel->setText("Ready");
+        return;
+    }
+    
+    QString gpu = latest->gpuMs < 0.0 ? QString("-") : QString::number(latest->gpuMs, 'f', 2);
+    m_statusLabel->setText(QString("%1 FPS | CPU %2 ms | GPU %3 ms | Draw calls: %4 | Triangles: %5")
+                               .arg(profiler->getAverageFps(), 0, 'f', 1)
+                               .arg(latest->cpuMs, 0, 'f', 2)
+                               .arg(gpu)
+                               .arg(latest->drawCalls)
+                               .arg(latest->triangles));
 }
 
 void MainWindow::createMenus()
@@ -163,11 +712,44 @@ void MainWindow::createMenus()
     connect(openAction, &QAction::triggered, this, &MainWindow::openPLYFile);
     m_fileMenu->addAction(openAction);
     
+    QAction* savePLYAction = new QAction("Save P&LY...", this);
+    savePLYAction->setShortcut(QKeySequence::SaveAs);
+    connect(savePLYAction, &QAction::triggered, this, &MainWindow::savePLYFile);
+    m_fileMenu->addAction(savePLYAction);
+    
+    // 다음에 여는 파일의 정점 순서 (저장은 항상 파일 순서)
+    QMenu* loadOrderMenu = m_fileMenu->addMenu("Vertex &Order on Load");
+    QActionGroup* loadOrderGroup = new QActionGroup(this);
+    const QPair<QString, SpatialOrder::Curve> loadOrders[] = {
+        { "&File Order", SpatialOrder::FileOrder },
+        { "&Morton Curve", SpatialOrder::Morton },
+        { "&Hilbert Curve", SpatialOrder::Hilbert }
+    };
+    for (const auto& loadOrder : loadOrders) {
+        QAction* orderAction = new QAction(loadOrder.first, this);
+        orderAction->setCheckable(true);
+        orderAction->setChecked(loadOrder.second == SpatialOrder::FileOrder);
+        SpatialOrder::Curve curve = loadOrder.second;
+        connect(orderAction, &QAction::triggered, [this, curve]() {
+            m_viewerWidget->setLoadOrder(curve);
+        });
+        loadOrderGroup->addAction(orderAction);
+        loadOrderMenu->addAction(orderAction);
+    }
+    
     QAction* saveAction = new QAction("&Save Screenshot...", this);
     saveAction->setShortcut(QKeySequence::Save);
     connect(saveAction, &QAction::triggered, this, &MainWindow::saveScreenshot);
     m_fileMenu->addAction(saveAction);
     
+    QAction* exportSequenceAction = new QAction("Export Image Se&quence...", this);
+    connect(exportSequenceAction, &QAction::triggered, this, &MainWindow::exportSequence);
+    m_fileMenu->addAction(exportSequenceAction);
+    
+    QAction* exportProfileAction = new QAction("Export &Profile CSV...", this);
+    connect(exportProfileAction, &QAction::triggered, this, &MainWindow::exportProfile);
+    m_fileMenu->addAction(exportProfileAction);
+    
     m_fileMenu->addSeparator();
     
     QAction* exitAction = new QAction("E&xit", this);
@@ -188,6 +770,295 @@ void MainWindow::createMenus()
     connect(fitAction, &QAction::triggered, this, &MainWindow::fitToView);
     m_viewMenu->addAction(fitAction);
     
+    m_viewMenu->addSeparator();
+    
+    QAction* autoRotateAction = new QAction("&Auto Rotate", this);
+    autoRotateAction->setShortcut(QKeySequence("A"));
+    autoRotateAction->setCheckable(true);
+    connect(autoRotateAction, &QAction::toggled, [this](bool checked) {
+        m_viewerWidget->setAutoRotate(checked);
+    });
+    m_viewMenu->addAction(autoRotateAction);
+    
+    QAction* hoverAction = new QAction("&Hover Highlight", this);
+    hoverAction->setShortcut(QKeySequence("H"));
+    hoverAction->setCheckable(true);
+    hoverAction->setChecked(true);
+    connect(hoverAction, &QAction::toggled, [this](bool checked) {
+        m_viewerWidget->setHoverHighlightEnabled(checked);
+    });
+    m_viewMenu->addAction(hoverAction);
+    
+    QAction* measureAction = new QAction("&Measure Distance", this);
+    measureAction->setShortcut(QKeySequence("D"));
+    measureAction->setCheckable(true);
+    connect(measureAction, &QAction::toggled, [this](bool checked) {
+        m_viewerWidget->setMeasureMode(checked);
+        if (checked) {
+            statusBar()->showMessage(m_viewerWidget->isRayQueryReady()
+                                         ? "Click two points to measure"
+                                         : "Building ray query structure...", 3000);
+        }
+    });
+    m_viewMenu->addAction(measureAction);
+    
+    m_viewMenu->addSeparator();
+    
+    QAction* addKeyframeAction = new QAction("Add Camera &Keyframe", this);
+    addKeyframeAction->setShortcut(QKeySequence("K"));
+    connect(addKeyframeAction, &QAction::triggered, this, &MainWindow::addCameraKeyframe);
+    m_viewMenu->addAction(addKeyframeAction);
+    
+    QAction* clearKeyframesAction = new QAction("&Clear Camera Keyframes", this);
+    connect(clearKeyframesAction, &QAction::triggered, this, &MainWindow::clearCameraKeyframes);
+    m_viewMenu->addAction(clearKeyframesAction);
+    
+    m_viewMenu->addSeparator();
+    
+    // 클립 평면 (활성 평면은 컨트롤 패널 슬라이더 또는 PageUp/PageDown으로 이동)
+    QMenu* clipMenu = m_viewMenu->addMenu("Clip &Planes");
+    
+    QAction* clipViewAction = new QAction("Add Plane Along &View", this);
+    clipViewAction->setShortcut(QKeySequence("C"));
+    connect(clipViewAction, &QAction::triggered, [this]() { addClipPlane(QVector3D()); });
+    clipMenu->addAction(clipViewAction);
+    
+    QAction* clipXAction = new QAction("Add Plane &X", this);
+    connect(clipXAction, &QAction::triggered, [this]() { addClipPlane(QVector3D(1, 0, 0)); });
+    clipMenu->addAction(clipXAction);
+    
+    QAction* clipYAction = new QAction("Add Plane &Y", this);
+    connect(clipYAction, &QAction::triggered, [this]() { addClipPlane(QVector3D(0, 1, 0)); });
+    clipMenu->addAction(clipYAction);
+    
+    QAction* clipZAction = new QAction("Add Plane &Z", this);
+    connect(clipZAction, &QAction::triggered, [this]() { addClipPlane(QVector3D(0, 0, 1)); });
+    clipMenu->addAction(clipZAction);
+    
+    clipMenu->addSeparator();
+    
+    QAction* flipClipAction = new QAction("&Flip Active Plane", this);
+    connect(flipClipAction, &QAction::triggered, [this]() { m_viewerWidget->flipClipPlane(); });
+    clipMenu->addAction(flipClipAction);
+    
+    QAction* removeClipAction = new QAction("&Remove Active Plane", this);
+    connect(removeClipAction, &QAction::triggered, [this]() { m_viewerWidget->removeClipPlane(); });
+    clipMenu->addAction(removeClipAction);
+    
+    QAction* clearClipAction = new QAction("&Clear Planes", this);
+    connect(clearClipAction, &QAction::triggered, [this]() { m_viewerWidget->clearClipPlanes(); });
+    clipMenu->addAction(clearClipAction);
+    
+    clipMenu->addSeparator();
+    
+    QAction* contourAction = new QAction("Show Section C&ontour", this);
+    contourAction->setCheckable(true);
+    contourAction->setChecked(true);
+    connect(contourAction, &QAction::toggled, [this](bool checked) {
+        m_viewerWidget->setContourVisible(checked);
+    });
+    clipMenu->addAction(contourAction);
+    
+    QAction* exportContourAction = new QAction("&Export Section Contour...", this);
+    connect(exportContourAction, &QAction::triggered, this, &MainWindow::exportContours);
+    clipMenu->addAction(exportContourAction);
+    
+    // 선택 메뉴
+    m_selectMenu = menuBar()->addMenu("&Select");
+    
+    QAction* rectangleSelectAction = new QAction("&Rectangle Select", this);
+    rectangleSelectAction->setShortcut(QKeySequence("S"));
+    rectangleSelectAction->setCheckable(true);
+    m_selectMenu->addAction(rectangleSelectAction);
+    
+    QAction* lassoSelectAction = new QAction("&Lasso Select", this);
+    lassoSelectAction->setShortcut(QKeySequence("L"));
+    lassoSelectAction->setCheckable(true);
+    m_selectMenu->addAction(lassoSelectAction);
+    
+    // 측정, 영역 선택, 스컬프트는 왼쪽 드래그/클릭을 공유하므로 하나만 켜지도록
+    QActionGroup* toolGroup = new QActionGroup(this);
+    toolGroup->setExclusionPolicy(QActionGroup::ExclusionPolicy::ExclusiveOptional);
+    toolGroup->addAction(measureAction);
+    toolGroup->addAction(rectangleSelectAction);
+    toolGroup->addAction(lassoSelectAction);
+    connect(toolGroup, &QActionGroup::triggered, [this, rectangleSelectAction, lassoSelectAction]() {
+        if (rectangleSelectAction->isChecked()) {
+            m_viewerWidget->setSelectionTool(ViewerWidget::RectangleSelectionTool);
+        } else if (lassoSelectAction->isChecked()) {
+            m_viewerWidget->setSelectionTool(ViewerWidget::LassoSelectionTool);
+        } else {
+            m_viewerWidget->setSelectionTool(ViewerWidget::NoSelectionTool);
+        }
+    });
+    
+    m_selectMenu->addSeparator();
+    
+    QAction* selectAllAction = new QAction("Select &All", this);
+    selectAllAction->setShortcut(QKeySequence::SelectAll);
+    connect(selectAllAction, &QAction::triggered, [this]() {
+        m_viewerWidget->selectAll();
+    });
+    m_selectMenu->addAction(selectAllAction);
+    
+    QAction* invertSelectionAction = new QAction("&Invert Selection", this);
+    invertSelectionAction->setShortcut(QKeySequence("Ctrl+I"));
+    connect(invertSelectionAction, &QAction::triggered, [this]() {
+        m_viewerWidget->invertSelection();
+    });
+    m_selectMenu->addAction(invertSelectionAction);
+    
+    QAction* clearSelectionAction = new QAction("&Clear Selection", this);
+    connect(clearSelectionAction, &QAction::triggered, [this]() {
+        m_viewerWidget->clearRegionSelection();
+    });
+    m_selectMenu->addAction(clearSelectionAction);
+    
+    m_selectMenu->addSeparator();
+    
+    QAction* hideAction = new QAction("&Hide Selected", this);
+    hideAction->setShortcut(QKeySequence("Ctrl+H"));
+    connect(hideAction, &QAction::triggered, [this]() {
+        m_viewerWidget->hideSelection();
+    });
+    m_selectMenu->addAction(hideAction);
+    
+    QAction* isolateAction = new QAction("I&solate Selected", this);
+    isolateAction->setShortcut(QKeySequence("Ctrl+Shift+H"));
+    connect(isolateAction, &QAction::triggered, [this]() {
+        m_viewerWidget->isolateSelection();
+    });
+    m_selectMenu->addAction(isolateAction);
+    
+    QAction* unhideAction = new QAction("&Unhide All", this);
+    unhideAction->setShortcut(QKeySequence("Alt+H"));
+    connect(unhideAction, &QAction::triggered, [this]() {
+        m_viewerWidget->unhideAll();
+    });
+    m_selectMenu->addAction(unhideAction);
+    
+    // 편집 메뉴
+    m_editMenu = menuBar()->addMenu("&Edit");
+    
+    m_undoAction = new QAction("&Undo", this);
+    m_undoAction->setShortcut(QKeySequence::Undo);
+    m_undoAction->setEnabled(false);
+    connect(m_undoAction, &QAction::triggered, [this]() {
+        m_viewerWidget->undo();
+    });
+    m_editMenu->addAction(m_undoAction);
+    
+    m_redoAction = new QAction("&Redo", this);
+    m_redoAction->setShortcut(QKeySequence::Redo);
+    m_redoAction->setEnabled(false);
+    connect(m_redoAction, &QAction::triggered, [this]() {
+        m_viewerWidget->redo();
+    });
+    m_editMenu->addAction(m_redoAction);
+    
+    QAction* undoLimitAction = new QAction("Undo &Memory Limit...", this);
+    connect(undoLimitAction, &QAction::triggered, this, &MainWindow::setUndoMemoryLimit);
+    m_editMenu->addAction(undoLimitAction);
+    
+    m_editMenu->addSeparator();
+    
+    QAction* sculptAction = new QAction("Sculpt &Brush", this);
+    sculptAction->setShortcut(QKeySequence("E"));
+    sculptAction->setCheckable(true);
+    connect(sculptAction, &QAction::toggled, [this](bool checked) {
+        m_viewerWidget->setSculptMode(checked);
+        if (checked) {
+            statusBar()->showMessage("Drag to sculpt (Shift: smooth, Ctrl: invert, [ ]: radius)", 3000);
+        }
+    });
+    m_editMenu->addAction(sculptAction);
+    toolGroup->addAction(sculptAction);
+    
+    m_editMenu->addSeparator();
+    
+    QActionGroup* brushGroup = new QActionGroup(this);
+    const QPair<QString, BrushSettings::Mode> brushModes[] = {
+        { "&Draw", BrushSettings::Draw },
+        { "&Inflate", BrushSettings::Inflate },
+        { "S&mooth", BrushSettings::Smooth }
+    };
+    for (const auto& brushMode : brushModes) {
+        QAction* brushAction = new QAction(brushMode.first, this);
+        brushAction->setCheckable(true);
+        brushAction->setChecked(brushMode.second == BrushSettings().mode);
+        BrushSettings::Mode mode = brushMode.second;
+        connect(brushAction, &QAction::triggered, [this, mode]() {
+            m_viewerWidget->setBrushMode(mode);
+        });
+        brushGroup->addAction(brushAction);
+        m_editMenu->addAction(brushAction);
+    }
+    
+    QAction* strengthAction = new QAction("Brush &Strength...", this);
+    connect(strengthAction, &QAction::triggered, [this]() {
+        bool ok = false;
+        double strength = QInputDialog::getDouble(this, "Brush Strength", "Strength (0-1):",
+                                                  m_viewerWidget->getBrushStrength(), 0.0, 1.0, 2, &ok);
+        if (ok) {
+            m_viewerWidget->setBrushStrength(float(strength));
+        }
+    });
+    m_editMenu->addAction(strengthAction);
+    
+    m_editMenu->addSeparator();
+    
+    QAction* flipEdgeAction = new QAction("&Flip Edge", this);
+    flipEdgeAction->setShortcut(QKeySequence("Ctrl+E"));
+    connect(flipEdgeAction, &QAction::triggered, [this]() {
+        switch (m_viewerWidget->flipSelectedEdge()) {
+            case ViewerWidget::EdgeFlipped:
+                break;
+            case ViewerWidget::EdgeNotSelected:
+                statusBar()->showMessage("Click a face near an interior edge to flip it", 3000);
+                break;
+            case ViewerWidget::EdgeNotFlippable:
+                statusBar()->showMessage("Edge cannot be flipped (boundary, hidden face or existing diagonal)", 3000);
+                break;
+        }
+    });
+    m_editMenu->addAction(flipEdgeAction);
+    
+    QAction* topologyAction = new QAction("&Topology Info", this);
+    connect(topologyAction, &QAction::triggered, this, &MainWindow::showTopologyInfo);
+    m_editMenu->addAction(topologyAction);
+    
+    // 메시 메뉴
+    m_meshMenu = menuBar()->addMenu("&Mesh");
+    
+    QAction* smoothAction = new QAction("&Smooth...", this);
+    connect(smoothAction, &QAction::triggered, this, &MainWindow::smoothMesh);
+    m_meshMenu->addAction(smoothAction);
+    
+    QAction* subdivideAction = new QAction("Su&bdivide (Loop)...", this);
+    connect(subdivideAction, &QAction::triggered, this, &MainWindow::subdivideMesh);
+    m_meshMenu->addAction(subdivideAction);
+    
+    QAction* normalsAction = new QAction("Estimate &Normals...", this);
+    connect(normalsAction, &QAction::triggered, this, &MainWindow::estimateNormals);
+    m_meshMenu->addAction(normalsAction);
+    
+    QAction* downsampleAction = new QAction("&Downsample Points...", this);
+    connect(downsampleAction, &QAction::triggered, this, &MainWindow::downsamplePoints);
+    m_meshMenu->addAction(downsampleAction);
+    
+    QAction* componentsAction = new QAction("Remove Small &Components...", this);
+    connect(componentsAction, &QAction::triggered, this, &MainWindow::removeSmallComponents);
+    m_meshMenu->addAction(componentsAction);
+    
+    m_meshMenu->addSeparator();
+    QAction* primitivesAction = new QAction("Detect &Primitives...", this);
+    connect(primitivesAction, &QAction::triggered, this, &MainWindow::detectPrimitives);
+    m_meshMenu->addAction(primitivesAction);
+    
+    QAction* clearPrimitivesAction = new QAction("C&lear Primitive Colors", this);
+    connect(clearPrimitivesAction, &QAction::triggered, this, &MainWindow::clearPrimitiveColors);
+    m_meshMenu->addAction(clearPrimitivesAction);
+    
     // 렌더 메뉴
     m_renderMenu = menuBar()->addMenu("&Render");
     
@@ -206,6 +1077,34 @@ void MainWindow::createMenus()
     connect(pointsAction, &QAction::triggered, [this]() { setRenderMode(2); });
     m_renderMenu->addAction(pointsAction);
     
+    m_renderMenu->addSeparator();
+    
+    QAction* multiDrawAction = new QAction("&Multi-Draw Indirect", this);
+    multiDrawAction->setShortcut(QKeySequence("M"));
+    multiDrawAction->setCheckable(true);
+    connect(multiDrawAction, &QAction::toggled, [this](bool checked) {
+        m_viewerWidget->setMultiDrawEnabled(checked);
+    });
+    m_renderMenu->addAction(multiDrawAction);
+    
+    QAction* occlusionAction = new QAction("&Occlusion Culling", this);
+    occlusionAction->setShortcut(QKeySequence("O"));
+    occlusionAction->setCheckable(true);
+    connect(occlusionAction, &QAction::toggled, [this](bool checked) {
+        m_viewerWidget->setOcclusionCullingEnabled(checked);
+    });
+    m_renderMenu->addAction(occlusionAction);
+    
+    m_renderMenu->addSeparator();
+    
+    QAction* profilerAction = new QAction("Show &Profiler", this);
+    profilerAction->setShortcut(QKeySequence("F3"));
+    profilerAction->setCheckable(true);
+    connect(profilerAction, &QAction::toggled, [this](bool checked) {
+        m_viewerWidget->setProfilerOverlayVisible(checked);
+    });
+    m_renderMenu->addAction(profilerAction);
+    
     // 도움말 메뉴
     m_helpMenu = menuBar()->addMenu("&Help");
     
@@ -241,7 +1140,7 @@ void MainWindow::createToolBar()
     
     // 뷰 액션들
     m_mainToolBar->addAction(m_viewMenu->actions().first()); // Reset Camera
-    m_mainToolBar->addAction(m_viewMenu->actions().last());  // Fit to View
+    m_mainToolBar->addAction(m_viewMenu->actions().at(1));   // Fit to View
 }
 
 void MainWindow::createControlPanel()
@@ -301,6 +1200,29 @@ void MainWindow::createControlPanel()
     
     mainLayout->addWidget(m_cameraGroup);
     
+    // 단면 그룹 (활성 클립 평면 선택과 위치)
+    m_sectionGroup = new QGroupBox("Section", m_controlPanel);
+    QVBoxLayout* sectionLayout = new QVBoxLayout(m_sectionGroup);
+    
+    QLabel* clipPlaneLabel = new QLabel("Active Plane:", m_sectionGroup);
+    m_clipPlaneCombo = new QComboBox(m_sectionGroup);
+    sectionLayout->addWidget(clipPlaneLabel);
+    sectionLayout->addWidget(m_clipPlaneCombo);
+    
+    QLabel* clipPositionLabel = new QLabel("Position:", m_sectionGroup);
+    m_clipPositionSlider = new QSlider(Qt::Horizontal, m_sectionGroup);
+    m_clipPositionSlider->setRange(0, 1000);
+    m_clipPositionSlider->setValue(500);
+    sectionLayout->addWidget(clipPositionLabel);
+    sectionLayout->addWidget(m_clipPositionSlider);
+    
+    m_contourLabel = new QLabel("No clip planes", m_sectionGroup);
+    m_contourLabel->setWordWrap(true);
+    sectionLayout->addWidget(m_contourLabel);
+    
+    m_sectionGroup->setEnabled(false);
+    mainLayout->addWidget(m_sectionGroup);
+    
     // 조명 그룹
     m_lightingGroup = new QGroupBox("Lighting", m_controlPanel);
     QVBoxLayout* lightingLayout = new QVBoxLayout(m_lightingGroup);
@@ -330,10 +1252,76 @@ void MainWindow::createStatusBar()
     
     statusBar()->addWidget(m_statusLabel);
     statusBar()->addPermanentWidget(m_statusProgress);
+    
+    // 프레임 통계 주기적 갱신
+    m_statusTimer = new QTimer(this);
+    connect(m_statusTimer, &QTimer::timeout, this, &MainWindow::updateStatusBar);
+    m_statusTimer->start(500);
 }
 
 void MainWindow::setupConnections()
 {
+    // 클릭 픽킹 결과
+    connect(m_viewerWidget, &ViewerWidget::picked,
+            this, &MainWindow::showPickResult);
+    
+    // 거리 측정
+    connect(m_viewerWidget, &ViewerWidget::measurePointAdded,
+            this, &MainWindow::showMeasurePoint);
+    connect(m_viewerWidget, &ViewerWidget::distanceMeasured,
+            this, &MainWindow::showDistance);
+    connect(m_viewerWidget, &ViewerWidget::rayQueryReady, [this]() {
+        if (m_viewerWidget->isMeasureMode()) {
+            statusBar()->showMessage("Click two points to measure", 3000);
+        }
+    });
+    
+    // 영역 선택
+    connect(m_viewerWidget, &ViewerWidget::regionSelectionChanged,
+            this, &MainWindow::showRegionSelection);
+    connect(m_viewerWidget, &ViewerWidget::hiddenChanged,
+            this, &MainWindow::showHidden);
+    
+    // 편집 기록
+    connect(m_viewerWidget, &ViewerWidget::historyChanged,
+            this, &MainWindow::updateHistoryActions);
+    
+    // 스컬프트
+    connect(m_viewerWidget, &ViewerWidget::brushRadiusChanged, [this](float radius) {
+        statusBar()->showMessage(QString("Brush radius: %1").arg(radius, 0, 'g', 4), 2000);
+    });
+    
+    // 메시 처리 진행 상황
+    connect(m_viewerWidget, &ViewerWidget::meshOperationProgress,
+            this, &MainWindow::meshOperationProgress);
+    connect(m_viewerWidget, &ViewerWidget::meshOperationFinished,
+            this, &MainWindow::meshOperationFinished);
+    connect(m_viewerWidget, &ViewerWidget::meshOperationNotRecorded, [this](const QString& name) {
+        statusBar()->showMessage(QString("%1 cannot be undone, undo history cleared").arg(name), 5000);
+    });
+    
+    // 비동기 스크린샷 진행 상황
+    connect(m_viewerWidget, &ViewerWidget::screenshotProgress,
+            this, &MainWindow::screenshotProgress);
+    connect(m_viewerWidget, &ViewerWidget::screenshotFinished,
+            this, &MainWindow::screenshotFinished);
+    connect(m_viewerWidget, &ViewerWidget::sequenceExportProgress,
+            this, &MainWindow::sequenceExportProgress);
+    connect(m_viewerWidget, &ViewerWidget::sequenceExportFinished,
+            this, &MainWindow::sequenceExportFinished);
+    
+    // 클립 평면과 단면 (슬라이더는 움직이는 동안 계속 단면을 다시 구함)
+    connect(m_viewerWidget, &ViewerWidget::clipPlanesChanged,
+            this, &MainWindow::updateClipPlaneControls);
+    connect(m_viewerWidget, &ViewerWidget::contourChanged,
+            this, &MainWindow::showContour);
+    connect(m_clipPlaneCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int plane) {
+        m_viewerWidget->setActiveClipPlane(plane);
+    });
+    connect(m_clipPositionSlider, &QSlider::valueChanged, [this](int value) {
+        m_viewerWidget->setClipPlanePosition(float(value) / m_clipPositionSlider->maximum());
+    });
+    
     // 렌더링 설정 연결
     connect(m_renderModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::setRenderMode);
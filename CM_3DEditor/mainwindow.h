@@ -19,6 +19,7 @@
 #include <QMessageBox>
 #include <QProgressBar>
 #include <QDockWidget>
+#include <QTimer>
 #include "ViewerWidget.h"
 
 QT_BEGIN_NAMESPACE
@@ -38,12 +39,48 @@ public:
 private slots:
     // 파일 메뉴
     void openPLYFile();
+    void savePLYFile();
     void saveScreenshot();
+    void exportProfile();
+    void screenshotProgress(int completedTiles, int totalTiles);
+    void screenshotFinished(const QString& filename, bool success);
+    void exportSequence();
+    void sequenceExportProgress(int encodedFrames, int totalFrames);
+    void sequenceExportFinished(const QString& directory, bool success);
     void exit();
     
     // 뷰 메뉴
     void resetCamera();
     void fitToView();
+    void addCameraKeyframe();
+    void clearCameraKeyframes();
+    void showPickResult(const PickResult& result);
+    void showMeasurePoint(const QVector3D& position, int vertex);
+    void showDistance(float distance);
+    void addClipPlane(const QVector3D& normal);
+    void exportContours();
+    void updateClipPlaneControls();
+    void showContour(int polylines, int closed);
+    
+    // 선택 메뉴
+    void showRegionSelection(int count, bool faces);
+    void showHidden(int hiddenCount, bool faces);
+    
+    // 편집 메뉴
+    void updateHistoryActions();
+    void setUndoMemoryLimit();
+    void showTopologyInfo();
+    
+    // 메시 메뉴
+    void smoothMesh();
+    void subdivideMesh();
+    void estimateNormals();
+    void downsamplePoints();
+    void removeSmallComponents();
+    void detectPrimitives();
+    void clearPrimitiveColors();
+    void meshOperationProgress(int percent);
+    void meshOperationFinished(const QString& name, bool success);
     
     // 렌더링 설정
     void setRenderMode(int mode);
@@ -62,6 +99,11 @@ private:
     // UI 컴포넌트들
     QMenu* m_fileMenu;
     QMenu* m_viewMenu;
+    QMenu* m_selectMenu;
+    QMenu* m_editMenu;
+    QAction* m_undoAction;
+    QAction* m_redoAction;
+    QMenu* m_meshMenu;
     QMenu* m_renderMenu;
     QMenu* m_helpMenu;
     
@@ -70,6 +112,7 @@ private:
     QWidget* m_controlPanel;
     QGroupBox* m_renderGroup;
     QGroupBox* m_cameraGroup;
+    QGroupBox* m_sectionGroup;
     QGroupBox* m_lightingGroup;
     
     QComboBox* m_renderModeCombo;
@@ -77,12 +120,18 @@ private:
     QSlider* m_pointSizeSlider;
     QPushButton* m_bgColorButton;
     QPushButton* m_wireframeColorButton;
+    QComboBox* m_clipPlaneCombo;
+    QSlider* m_clipPositionSlider;
+    QLabel* m_contourLabel;
     
     QProgressBar* m_statusProgress;
     QLabel* m_statusLabel;
+    QTimer* m_statusTimer;
     
     // 헬퍼 함수들
     void createMenus();
+    bool confirmCancelMeshOperation();
+    void chooseComponentThreshold();
     void createToolBar();
     void createControlPanel();
     void createStatusBar();